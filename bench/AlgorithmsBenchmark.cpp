@@ -0,0 +1,56 @@
+#include"Algorithms.h"
+#include"Benchmark.h"
+
+static const char* IsaName(SimdIsa isa)
+{
+	switch (isa) {
+	case SimdIsa::Scalar: return "scalar";
+	case SimdIsa::Vector128: return "128-bit";
+	case SimdIsa::Avx2: return "AVX2";
+	case SimdIsa::Avx512: return "AVX-512";
+	}
+	return "";
+}
+
+// Runs function over the whole range enough times to stream about 1 GiB and reports the time per element.
+template<typename Function>
+static void RunPasses(const char* algorithm, SimdIsa isa, size_t elements, size_t elementBytes, Function function)
+{
+	const size_t passes = std::max<size_t>(1, (size_t{ 1 } << 30) / (elements * elementBytes));
+	char name[64];
+	std::snprintf(name, sizeof(name), "%s, %s", algorithm, IsaName(isa));
+	Measure(name, passes * elements, [&] {
+		for (size_t i = 0; i < passes; ++i)
+			DoNotOptimize(function());
+	});
+}
+
+void AlgorithmsBenchmarks()
+{
+	const SimdIsa detected = ActiveSimdIsa();
+
+	// From L1-resident to well past the last-level cache.
+	for (size_t bytes : { size_t{ 16 } << 10, size_t{ 1 } << 20, size_t{ 64 } << 20, size_t{ 1 } << 30 }) {
+		const size_t count = bytes / sizeof(float);
+		Vector<float> floats(count, 1.0f);
+		Vector<float> otherFloats(count, 1.0f);
+		Vector<int32_t> ints(count, 7);
+		ints[count / 3] = -1;
+		ints[count / 2] = 1000;
+
+		std::printf(" %zu KiB per range\n", bytes >> 10);
+		for (SimdIsa isa : { SimdIsa::Scalar, SimdIsa::Vector128, SimdIsa::Avx2, SimdIsa::Avx512 }) {
+			if (isa > detected)
+				continue;
+			SetSimdIsa(isa);
+			RunPasses("Sum<float>", isa, count, sizeof(float), [&] { return floats.Sum(); });
+			RunPasses("Dot<float>", isa, count, 2 * sizeof(float), [&] { return floats.Dot(otherFloats); });
+			RunPasses("Equal<float>", isa, count, 2 * sizeof(float), [&] { return floats == otherFloats; });
+			RunPasses("MinMax<int32_t>", isa, count, sizeof(int32_t), [&] { return ints.MinMax().max; });
+			RunPasses("IndexOf<int32_t>, absent", isa, count, sizeof(int32_t), [&] { return ints.IndexOf(8); });
+			RunPasses("Count<int32_t>", isa, count, sizeof(int32_t), [&] { return ints.Count(7); });
+		}
+	}
+
+	SetSimdIsa(detected);
+}
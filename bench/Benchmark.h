@@ -0,0 +1,95 @@
+#ifndef _BENCHMARK_
+#define _BENCHMARK_
+
+#include<chrono>
+#include<cstdint>
+#include<cstdio>
+#include<memory>
+#include<random>
+#include<thread>
+
+#include"Vector.h"
+
+// Keeps the compiler from discarding a computed value.
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const T* sink;
+	sink = &value;
+#endif
+}
+
+class Timer
+{
+public:
+	Timer() : m_start(std::chrono::steady_clock::now()) {}
+
+	void Reset() { m_start = std::chrono::steady_clock::now(); }
+
+	double Seconds() const
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+private:
+	std::chrono::steady_clock::time_point m_start;
+};
+
+// Prints one result line: the case name, the time per operation and the throughput.
+inline void Report(const char* name, size_t operations, double seconds)
+{
+	std::printf("  %-48s %10.2f ns/op %12.2f Mops/s\n", name, seconds * 1e9 / operations, operations / seconds / 1e6);
+}
+
+// Runs the function once and reports the time it took for the given number of operations.
+template<typename Function>
+inline void Measure(const char* name, size_t operations, Function function)
+{
+	Timer timer;
+	function();
+	Report(name, operations, timer.Seconds());
+}
+
+// Runs function(thread index) on the given number of threads and returns the wall time until all finished.
+template<typename Function>
+inline double RunThreads(size_t threads, Function function)
+{
+	std::unique_ptr<std::thread[]> workers(new std::thread[threads]);
+	Timer timer;
+	for (size_t i = 0; i < threads; ++i)
+		workers[i] = std::thread(function, i);
+	for (size_t i = 0; i < threads; ++i)
+		workers[i].join();
+	return timer.Seconds();
+}
+
+inline Vector<uint64_t> RandomKeys(size_t count, uint64_t seed)
+{
+	std::mt19937_64 random(seed);
+	Vector<uint64_t> keys;
+	for (size_t i = 0; i < count; ++i)
+		keys.PushBack(random());
+	return keys;
+}
+
+void AlgorithmsBenchmarks();
+void BitVectorBenchmarks();
+void ConcurrentVectorBenchmarks();
+void FlatHashMapBenchmarks();
+void HashTableBenchmarks();
+void LockFreeHashMapBenchmarks();
+void MemoryResourceBenchmarks();
+void PageAllocatorBenchmarks();
+void ParallelAlgorithmsBenchmarks();
+void RoaringBitmapBenchmarks();
+void SegmentedVectorBenchmarks();
+void ShardedHashTableBenchmarks();
+void SmallVectorBenchmarks();
+void SortBenchmarks();
+void SoAVectorBenchmarks();
+void VectorBenchmarks();
+
+#endif //_BENCHMARK_
@@ -0,0 +1,117 @@
+#include<algorithm>
+
+#include"Benchmark.h"
+#include"BitVector.h"
+
+namespace
+{
+	// Sets the flags of both vectors from the same random words, a bit being set with probability 1 / 2^sparsity.
+	void Fill(BitVector& bits, Vector<bool>& bytes, size_t count, uint64_t seed, unsigned sparsity)
+	{
+		Vector<uint64_t> keys = RandomKeys(count, seed);
+		bits.Resize(count);
+		bytes.Resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			bool value = (keys[i] >> (64 - sparsity)) == 0;
+			bits.Set(i, value);
+			bytes[i] = value;
+		}
+	}
+}
+
+void BitVectorBenchmarks()
+{
+	const size_t count = size_t{ 1 } << 26;
+	const size_t queries = size_t{ 1 } << 22;
+
+	BitVector bits;
+	BitVector otherBits;
+	Vector<bool> bytes;
+	Vector<bool> otherBytes;
+	Fill(bits, bytes, count, 21, 1);
+	Fill(otherBits, otherBytes, count, 22, 1);
+	bits.BuildIndex();
+	std::printf(" %zu flags: BitVector %zu KiB (%zu KiB with the rank index), Vector<bool> %zu KiB\n", count,
+		bits.Words().size() * sizeof(uint64_t) >> 10, bits.Bytes() >> 10, bytes.Capacity() * sizeof(bool) >> 10);
+
+	Vector<uint64_t> positions = RandomKeys(queries, 23);
+	for (uint64_t& position : positions.Span())
+		position %= count;
+
+	Measure("BitVector Set (random)", queries, [&] {
+		for (uint64_t position : positions.Span())
+			bits.Set(position, position & 1);
+	});
+	Measure("Vector<bool> set (random)", queries, [&] {
+		bool* data = bytes.Data();
+		for (uint64_t position : positions.Span())
+			data[position] = position & 1;
+	});
+
+	Measure("BitVector Test (random)", queries, [&] {
+		size_t hits = 0;
+		for (uint64_t position : positions.Span())
+			hits += bits.Test(position);
+		DoNotOptimize(hits);
+	});
+	Measure("Vector<bool> test (random)", queries, [&] {
+		const bool* data = bytes.Data();
+		size_t hits = 0;
+		for (uint64_t position : positions.Span())
+			hits += data[position];
+		DoNotOptimize(hits);
+	});
+
+	// Bulk operations, reported per flag
+	Measure("BitVector &=", count, [&] { bits &= otherBits; });
+	Measure("Vector<bool> && loop", count, [&] {
+		bool* data = bytes.Data();
+		const bool* other = otherBytes.Data();
+		for (size_t i = 0; i < count; ++i)
+			data[i] = data[i] && other[i];
+	});
+	Measure("BitVector AndNot", count, [&] { bits.AndNot(otherBits); });
+	Measure("BitVector ^=", count, [&] { bits ^= otherBits; });
+	Measure("BitVector Count", count, [&] { DoNotOptimize(bits.Count()); });
+	Measure("Vector<bool> std::count", count, [&] {
+		DoNotOptimize(std::count(bytes.Data(), bytes.Data() + count, true));
+	});
+
+	// Rank and Select need a scan of the flags without the index
+	for (unsigned sparsity : { 1u, 6u }) {
+		Fill(bits, bytes, count, 24, sparsity);
+		std::printf(" Rank and Select, 1 in %u flags set\n", 1u << sparsity);
+		Measure("BitVector BuildIndex", count, [&] { bits.BuildIndex(); });
+
+		Measure("BitVector Rank (random)", queries, [&] {
+			size_t sum = 0;
+			for (uint64_t position : positions.Span())
+				sum += bits.Rank(position);
+			DoNotOptimize(sum);
+		});
+
+		size_t ones = bits.Count();
+		Vector<uint64_t> ranks = RandomKeys(queries, 25);
+		for (uint64_t& rank : ranks.Span())
+			rank %= ones;
+		Measure("BitVector Select (random)", queries, [&] {
+			size_t sum = 0;
+			for (uint64_t rank : ranks.Span())
+				sum += bits.Select(rank);
+			DoNotOptimize(sum);
+		});
+		Measure("BitVector SelectZero (random)", queries, [&] {
+			size_t sum = 0;
+			for (uint64_t rank : ranks.Span())
+				sum += bits.SelectZero(rank);
+			DoNotOptimize(sum);
+		});
+
+		Measure("BitVector FindNext over all ones", ones, [&] {
+			size_t sum = 0;
+			for (size_t i = bits.FindFirst(); i != NotFound; i = bits.FindNext(i + 1))
+				sum += i;
+			DoNotOptimize(sum);
+		});
+	}
+}
@@ -0,0 +1,49 @@
+#include<mutex>
+
+#include"Benchmark.h"
+#include"ConcurrentVector.h"
+
+// The usual baseline: one Vector behind one mutex.
+class LockedVector
+{
+public:
+	size_t PushBack(uint64_t value)
+	{
+		std::lock_guard lock(m_mutex);
+		m_vector.PushBack(value);
+		return m_vector.Size() - 1;
+	}
+
+private:
+	std::mutex m_mutex;
+	Vector<uint64_t> m_vector;
+};
+
+// Every thread appends elements / threads values; the vector starts empty, so growth is part of the cost.
+template<typename Appendable>
+static void RunAppend(const char* vectorName, size_t threads, size_t elements)
+{
+	Appendable vector;
+	const size_t perThread = elements / threads;
+	double seconds = RunThreads(threads, [&](size_t thread) {
+		size_t last = 0;
+		for (size_t i = 0; i < perThread; ++i)
+			last = vector.PushBack(thread * perThread + i);
+		DoNotOptimize(last);
+	});
+
+	char name[64];
+	std::snprintf(name, sizeof(name), "%s, %zu threads", vectorName, threads);
+	Report(name, perThread * threads, seconds);
+}
+
+void ConcurrentVectorBenchmarks()
+{
+	const size_t elements = size_t{ 1 } << 24;
+
+	std::printf(" PushBack of %zu uint64_t, %u hardware threads\n", elements, std::thread::hardware_concurrency());
+	for (size_t threads = 1; threads <= 16; threads *= 2) {
+		RunAppend<LockedVector>("Mutex + Vector", threads, elements);
+		RunAppend<ConcurrentVector<uint64_t>>("ConcurrentVector", threads, elements);
+	}
+}
@@ -0,0 +1,53 @@
+#include"Benchmark.h"
+#include"FlatHashMap.h"
+#include"HashTable.h"
+
+template<typename Map>
+static void RunLookups(const char* mapName, const Vector<uint64_t>& keys, const Vector<uint64_t>& missingKeys)
+{
+	const size_t count = keys.Size();
+	char name[64];
+	Map map;
+
+	std::snprintf(name, sizeof(name), "%s Insert", mapName);
+	Measure(name, count, [&] {
+		for (size_t i = 0; i < count; ++i)
+			map.Insert(keys[i], i);
+	});
+
+	std::snprintf(name, sizeof(name), "%s Find (hit)", mapName);
+	Measure(name, count, [&] {
+		size_t sum = 0;
+		for (size_t i = 0; i < count; ++i)
+			sum += *map.Find(keys[i]);
+		DoNotOptimize(sum);
+	});
+
+	std::snprintf(name, sizeof(name), "%s Find (miss)", mapName);
+	Measure(name, count, [&] {
+		size_t found = 0;
+		for (size_t i = 0; i < count; ++i)
+			found += map.Find(missingKeys[i]) != nullptr;
+		DoNotOptimize(found);
+	});
+
+	std::snprintf(name, sizeof(name), "%s Find (90%% miss)", mapName);
+	Measure(name, count, [&] {
+		size_t found = 0;
+		for (size_t i = 0; i < count; ++i)
+			found += map.Find(i % 10 == 0 ? keys[i] : missingKeys[i]) != nullptr;
+		DoNotOptimize(found);
+	});
+}
+
+void FlatHashMapBenchmarks()
+{
+	for (size_t count : { size_t{ 1 } << 12, size_t{ 1 } << 20 }) {
+		const Vector<uint64_t> keys = RandomKeys(count, 1);
+		const Vector<uint64_t> missingKeys = RandomKeys(count, 2);
+
+		std::printf(" %zu keys\n", count);
+		RunLookups<HashTable<uint64_t, size_t>>("HashTable", keys, missingKeys);
+		RunLookups<FlatHashMap<uint64_t, size_t>>("FlatHashMap", keys, missingKeys);
+	}
+}
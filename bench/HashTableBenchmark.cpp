@@ -0,0 +1,189 @@
+#include<algorithm>
+#include<filesystem>
+#include<span>
+#include<string>
+#include<vector>
+
+#include"Benchmark.h"
+#include"HashTable.h"
+#include"HashTableSnapshot.h"
+
+template<typename Table, typename KeyFunction>
+static void RunTable(const char* name, size_t count, KeyFunction key)
+{
+	char caseName[96];
+	Table table;
+
+	std::snprintf(caseName, sizeof(caseName), "%s Insert", name);
+	Measure(caseName, count, [&] {
+		for (size_t i = 0; i < count; ++i)
+			table.Insert(key(i), i);
+	});
+
+	std::snprintf(caseName, sizeof(caseName), "%s Find", name);
+	Measure(caseName, count, [&] {
+		size_t sum = 0;
+		for (size_t i = 0; i < count; ++i)
+			sum += *table.Find(key(i));
+		DoNotOptimize(sum);
+	});
+}
+
+static void RunBatchLookups(size_t count, size_t batch)
+{
+	using Table = HashTable<uint64_t, uint64_t, FastHash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoBuckets>;
+	const Vector<uint64_t> keys = RandomKeys(count, 3);
+	const Vector<uint64_t> lookups = RandomKeys(count, 4);
+	Table table;
+	for (size_t i = 0; i < count; ++i)
+		table.Insert(keys[i], i);
+	// Half of the lookups hit, in an order unrelated to insertion.
+	std::vector<uint64_t> queries(count);
+	for (size_t i = 0; i < count; ++i)
+		queries[i] = (lookups[i] & 1) ? keys[lookups[i] % count] : lookups[i];
+
+	std::printf(" %zu keys, batches of %zu\n", count, batch);
+	Measure("Find loop", count, [&] {
+		size_t found = 0;
+		for (size_t i = 0; i < count; ++i)
+			found += table.Find(queries[i]) != nullptr;
+		DoNotOptimize(found);
+	});
+
+	std::vector<uint64_t*> results(batch);
+	Measure("FindBatch", count, [&] {
+		size_t found = 0;
+		for (size_t begin = 0; begin < count; begin += batch) {
+			std::span<const uint64_t> group(queries.data() + begin, std::min(batch, count - begin));
+			table.FindBatch(group, std::span<uint64_t*>(results.data(), group.size()));
+			for (size_t i = 0; i < group.size(); ++i)
+				found += results[i] != nullptr;
+		}
+		DoNotOptimize(found);
+	});
+
+	Table batchTable;
+	std::vector<uint64_t> values(count);
+	Measure("Insert loop", count, [&] {
+		for (size_t i = 0; i < count; ++i)
+			batchTable.Insert(queries[i], i);
+	});
+	batchTable.Clear();
+	Measure("InsertBatch", count, [&] {
+		for (size_t begin = 0; begin < count; begin += batch) {
+			size_t size = std::min(batch, count - begin);
+			batchTable.InsertBatch(std::span<const uint64_t>(queries.data() + begin, size), std::span<const uint64_t>(values.data() + begin, size));
+		}
+	});
+}
+
+// 70% of the lookups miss, with and without a Bloom filter in front of the chains.
+template<typename Table, typename KeyFunction>
+static void RunFilteredLookups(const char* name, size_t count, KeyFunction key)
+{
+	const Vector<uint64_t> lookups = RandomKeys(count, 6);
+	std::vector<size_t> queries(count);
+	for (size_t i = 0; i < count; ++i)
+		queries[i] = lookups[i] % 10 < 3 ? lookups[i] % count : count + lookups[i] % count;
+
+	std::printf(" %zu %s, 70%% misses\n", count, name);
+	for (double bitsPerKey : { 0.0, 8.0, 12.0 }) {
+		Table table;
+		if (bitsPerKey > 0)
+			table.AttachBloomFilter(bitsPerKey);
+		for (size_t i = 0; i < count; ++i)
+			table.Insert(key(i), i);
+		table.ResetFilterStats();
+
+		char caseName[96];
+		std::snprintf(caseName, sizeof(caseName), bitsPerKey > 0 ? "Find, filter %.0f bits/key" : "Find, no filter", bitsPerKey);
+		Measure(caseName, count, [&] {
+			size_t found = 0;
+			for (size_t i = 0; i < count; ++i)
+				found += table.Find(key(queries[i])) != nullptr;
+			DoNotOptimize(found);
+		});
+		if (const BloomFilter* filter = table.Filter()) {
+			BloomFilterStats stats = filter->Stats();
+			std::printf("   %zu KiB, %.1f%% of lookups skipped, %.2f%% false positives\n", filter->Bytes() / 1024,
+				100.0 * stats.NegativeRate(), 100.0 * stats.FalsePositiveRate());
+		}
+	}
+}
+
+// A restart either rebuilds the table entry by entry or maps a snapshot of it.
+static void RunSnapshot(size_t count)
+{
+	using Table = HashTable<uint64_t, uint64_t, FastHash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoBuckets>;
+	const Vector<uint64_t> keys = RandomKeys(count, 7);
+	const std::string path = (std::filesystem::temp_directory_path() / "HashTableBenchmark.snapshot").string();
+	{
+		Table table;
+		for (size_t i = 0; i < count; ++i)
+			table.Insert(keys[i], i);
+		std::printf(" %zu keys, snapshot of %zu MiB\n", count, (count * sizeof(SnapshotEntry<uint64_t, uint64_t>)) >> 20);
+		Measure("Save", count, [&] { table.Save(path); });
+	}
+
+	Measure("Rebuild with Insert", count, [&] {
+		Table table;
+		for (size_t i = 0; i < count; ++i)
+			table.Insert(keys[i], i);
+		DoNotOptimize(table.Count());
+	});
+	Measure("Open view, checksum verified", count, [&] {
+		HashTableView<uint64_t, uint64_t> view(path);
+		DoNotOptimize(view.Count());
+	});
+	Measure("Open view, header only", count, [&] {
+		HashTableView<uint64_t, uint64_t> view(path, false);
+		DoNotOptimize(view.Count());
+	});
+
+	HashTableView<uint64_t, uint64_t> view(path);
+	Measure("View Find", count, [&] {
+		size_t sum = 0;
+		for (size_t i = 0; i < count; ++i)
+			sum += *view.Find(keys[i]);
+		DoNotOptimize(sum);
+	});
+	std::filesystem::remove(path);
+}
+
+void HashTableBenchmarks()
+{
+	const size_t count = size_t{ 1 } << 20;
+
+	std::printf(" %zu sequential integer keys\n", count);
+	auto sequential = [](size_t i) { return static_cast<uint64_t>(i) << 8; };
+	RunTable<HashTable<uint64_t, size_t>>("std::hash, modulo", count, sequential);
+	RunTable<HashTable<uint64_t, size_t, FastHash<uint64_t>>>("FastHash, modulo", count, sequential);
+	RunTable<HashTable<uint64_t, size_t, FastHash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoBuckets>>(
+		"FastHash, power of two", count, sequential);
+
+	const size_t stringCount = size_t{ 1 } << 18;
+	std::vector<std::string> strings;
+	for (size_t i = 0; i < stringCount; ++i)
+		strings.push_back("/api/v1/resources/" + std::to_string(i * 7919) + "/attributes");
+	auto string = [&](size_t i) -> const std::string& { return strings[i]; };
+
+	std::printf(" %zu string keys\n", stringCount);
+	RunTable<HashTable<std::string, size_t>>("std::hash, modulo", stringCount, string);
+	RunTable<HashTable<std::string, size_t, FastHash<std::string>, std::equal_to<std::string>, PowerOfTwoBuckets>>(
+		"FastHash, power of two", stringCount, string);
+	RunTable<HashTable<std::string, size_t, FastHash<std::string>, std::equal_to<std::string>, PowerOfTwoBuckets, true>>(
+		"FastHash, power of two, cached hash", stringCount, string);
+
+	RunBatchLookups(size_t{ 1 } << 16, 256);
+	RunBatchLookups(size_t{ 1 } << 22, 256);
+
+	using IntegerTable = HashTable<uint64_t, size_t, FastHash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoBuckets>;
+	auto scattered = [](size_t i) { return HashMix64(i); };
+	RunFilteredLookups<IntegerTable>("integer keys", size_t{ 1 } << 16, scattered);
+	RunFilteredLookups<IntegerTable>("integer keys", size_t{ 1 } << 22, scattered);
+	for (size_t i = stringCount; i < 2 * stringCount; ++i)
+		strings.push_back("/api/v1/resources/" + std::to_string(i * 7919) + "/attributes");
+	RunFilteredLookups<HashTable<std::string, size_t, FastHash<std::string>>>("string keys", stringCount, string);
+
+	RunSnapshot(size_t{ 1 } << 22);
+}
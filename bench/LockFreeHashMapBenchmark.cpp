@@ -0,0 +1,74 @@
+#include<shared_mutex>
+
+#include"Benchmark.h"
+#include"LockFreeHashMap.h"
+#include"ShardedHashTable.h"
+
+// The usual read-mostly baseline: one HashTable behind one reader-writer lock.
+class SharedLockHashTable
+{
+public:
+	bool Find(uint64_t key, uint64_t& value) const
+	{
+		std::shared_lock lock(m_mutex);
+		const uint64_t* found = m_table.Find(key);
+		if (found != nullptr)
+			value = *found;
+		return found != nullptr;
+	}
+
+	void Insert(uint64_t key, uint64_t value)
+	{
+		std::unique_lock lock(m_mutex);
+		m_table.Insert(key, value);
+	}
+
+private:
+	mutable std::shared_mutex m_mutex;
+	HashTable<uint64_t, uint64_t, FastHash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoBuckets> m_table;
+};
+
+// Every thread runs operations / threads operations on random keys, one in every writeEvery of them an Insert.
+template<typename Table>
+static void RunReadMostly(const char* tableName, size_t threads, size_t writeEvery, const Vector<uint64_t>& keys,
+	size_t operations)
+{
+	Table table;
+	for (size_t i = 0; i < keys.Size(); i += 2)
+		table.Insert(keys[i], i);
+
+	const size_t perThread = operations / threads;
+	double seconds = RunThreads(threads, [&](size_t thread) {
+		std::mt19937_64 random(thread + 1);
+		uint64_t value = 0;
+		size_t found = 0;
+		for (size_t i = 0; i < perThread; ++i) {
+			uint64_t key = keys[random() % keys.Size()];
+			if (i % writeEvery == 0)
+				table.Insert(key, i);
+			else
+				found += table.Find(key, value);
+		}
+		DoNotOptimize(found);
+	});
+
+	char name[64];
+	std::snprintf(name, sizeof(name), "%s, %zu threads", tableName, threads);
+	Report(name, perThread * threads, seconds);
+}
+
+void LockFreeHashMapBenchmarks()
+{
+	const Vector<uint64_t> keys = RandomKeys(size_t{ 1 } << 18, 7);
+	const size_t operations = size_t{ 1 } << 22;
+
+	for (size_t writeEvery : { size_t{ 100 }, size_t{ 10 } }) {
+		std::printf(" %zu%% Find / %zu%% Insert, %u hardware threads\n", 100 - 100 / writeEvery, 100 / writeEvery,
+			std::thread::hardware_concurrency());
+		for (size_t threads = 1; threads <= 64; threads *= 2) {
+			RunReadMostly<SharedLockHashTable>("Reader-writer lock", threads, writeEvery, keys, operations);
+			RunReadMostly<ShardedHashTable<uint64_t, uint64_t>>("ShardedHashTable", threads, writeEvery, keys, operations);
+			RunReadMostly<LockFreeHashMap<uint64_t, uint64_t>>("LockFreeHashMap", threads, writeEvery, keys, operations);
+		}
+	}
+}
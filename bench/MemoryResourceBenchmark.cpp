@@ -0,0 +1,68 @@
+#include<memory_resource>
+
+#include"Benchmark.h"
+#include"HashTable.h"
+#include"LinkedList.h"
+#include"MemoryResource.h"
+
+// One request's worth of temporary containers: a vector, a list and a hash table of a few dozen elements.
+template<typename VectorType, typename ListType, typename TableType, typename... Resource>
+static uint64_t HandleRequest(uint64_t seed, Resource*... resource)
+{
+	VectorType vector(resource...);
+	ListType list(resource...);
+	TableType table(16, 1.0f, FastHash<uint64_t>(), std::equal_to<uint64_t>(), resource...);
+	for (uint64_t i = 0; i < 64; ++i) {
+		vector.PushBack(seed + i);
+		if (i % 2 == 0)
+			list.PushBack(seed * i);
+		table.Insert(seed ^ i, i);
+	}
+	return vector[63] + list.Back() + *table.Find(seed);
+}
+
+// Runs requests / threads requests on every thread; makeResource() gives each thread the resource its
+// containers allocate from, and afterRequest(resource) runs between requests.
+template<typename MakeResource, typename AfterRequest>
+static void RunRequests(const char* resourceName, size_t threads, size_t requests, MakeResource makeResource, AfterRequest afterRequest)
+{
+	using Table = PmrHashTable<uint64_t, uint64_t, FastHash<uint64_t>>;
+	const size_t perThread = requests / threads;
+	double seconds = RunThreads(threads, [&](size_t thread) {
+		auto resource = makeResource();
+		uint64_t sum = 0;
+		for (size_t i = 0; i < perThread; ++i) {
+			sum += HandleRequest<PmrVector<uint64_t>, PmrLinkedList<uint64_t>, Table>(thread * perThread + i, resource.get());
+			afterRequest(*resource);
+		}
+		DoNotOptimize(sum);
+	});
+
+	char name[64];
+	std::snprintf(name, sizeof(name), "%s, %zu threads", resourceName, threads);
+	Report(name, perThread * threads, seconds);
+}
+
+void MemoryResourceBenchmarks()
+{
+	const size_t requests = size_t{ 1 } << 18;
+
+	std::printf(" %zu requests of 64 vector, 32 list and 64 hash table elements\n", requests);
+	for (size_t threads : { 1, 2, 4 }) {
+		const size_t perThread = requests / threads;
+		double seconds = RunThreads(threads, [&](size_t thread) {
+			uint64_t sum = 0;
+			for (size_t i = 0; i < perThread; ++i)
+				sum += HandleRequest<Vector<uint64_t>, LinkedList<uint64_t>, HashTable<uint64_t, uint64_t, FastHash<uint64_t>>>(thread * perThread + i);
+			DoNotOptimize(sum);
+		});
+		char name[64];
+		std::snprintf(name, sizeof(name), "std::allocator, %zu threads", threads);
+		Report(name, perThread * threads, seconds);
+
+		RunRequests("MonotonicArena, Reset per request", threads, requests,
+			[] { return std::make_unique<MonotonicArena>(64 * 1024); }, [](MonotonicArena& arena) { arena.Reset(); });
+		RunRequests("PoolResource", threads, requests,
+			[] { return std::make_unique<PoolResource>(); }, [](PoolResource&) {});
+	}
+}
@@ -0,0 +1,67 @@
+#include<cstring>
+#include<fstream>
+#include<string>
+
+#include"Benchmark.h"
+#include"PageAllocator.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#ifdef __linux__
+// Resets the peak resident set size of the process that PeakResidentMiB reports.
+static void ResetPeakResident()
+{
+	std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+static double PeakResidentMiB()
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.compare(0, 6, "VmHWM:") == 0)
+			return std::stod(line.substr(6)) / 1024;
+	}
+	return 0;
+}
+#else
+static void ResetPeakResident() {}
+static double PeakResidentMiB() { return 0; }
+#endif
+
+// Appends count elements one by one and reports the time per PushBack and the peak resident size.
+template<typename Container>
+static void RunGrowth(const char* name, size_t count, Container container)
+{
+	ResetPeakResident();
+	Measure(name, count, [&] {
+		for (size_t i = 0; i < count; ++i)
+			container.PushBack(static_cast<typename Container::ValueType>(i));
+		DoNotOptimize(container.Data());
+	});
+	std::printf("  %-48s %10.0f MiB peak resident, %.0f MiB of elements\n", "", PeakResidentMiB(),
+		container.Size() * sizeof(typename Container::ValueType) / 1048576.0);
+}
+
+void PageAllocatorBenchmarks()
+{
+	const size_t count = 1000000000;
+
+	std::printf(" Growth to %zu uint8_t\n", count);
+	RunGrowth("Vector<uint8_t>", count, Vector<uint8_t>());
+	RunGrowth("PageVector<uint8_t>", count, PageVector<uint8_t>());
+	RunGrowth("PageVector<uint8_t>, huge pages", count, PageVector<uint8_t>(PageAllocator<uint8_t>(true)));
+
+	std::printf(" Growth to %zu uint32_t\n", count / 4);
+	RunGrowth("Vector<uint32_t>", count / 4, Vector<uint32_t>());
+	RunGrowth("PageVector<uint32_t>", count / 4, PageVector<uint32_t>());
+}
+
+#else
+
+void PageAllocatorBenchmarks()
+{
+	std::printf(" PageAllocator needs a POSIX system\n");
+}
+
+#endif
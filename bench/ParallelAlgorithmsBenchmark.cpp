@@ -0,0 +1,55 @@
+#include<algorithm>
+#include<cstring>
+
+#include"Benchmark.h"
+#include"ParallelAlgorithms.h"
+
+// Times one call of function on a pool of the given number of threads; the setup call before every run restores
+// the input and is not timed.
+template<typename Setup, typename Function>
+static void RunScaling(const char* algorithm, size_t threads, size_t elements, Setup setup, Function function)
+{
+	ThreadPool pool(threads);
+	ParallelOptions options{ &pool, 0 };
+	setup();
+	char name[64];
+	std::snprintf(name, sizeof(name), "%s, %zu threads", algorithm, threads);
+	Measure(name, elements, [&] { function(options); });
+}
+
+void ParallelAlgorithmsBenchmarks()
+{
+	const size_t sortCount = size_t{ 1 } << 24;
+	const size_t count = size_t{ 1 } << 26;
+	const size_t cores = ThreadPool::DefaultThreadCount();
+	Vector<size_t> threadCounts;
+	for (size_t threads = 1; threads < cores; threads *= 2)
+		threadCounts.PushBack(threads);
+	threadCounts.PushBack(cores);
+
+	Vector<uint64_t> keys = RandomKeys(sortCount, 1);
+	Vector<uint64_t> sorted(sortCount, 0);
+	std::printf(" Sort of %zu random uint64_t\n", sortCount);
+	Measure("std::sort", sortCount, [&] {
+		sorted = keys;
+		std::sort(sorted.Data(), sorted.Data() + sortCount);
+	});
+	for (size_t threads : threadCounts) {
+		RunScaling("ParallelSort", threads, sortCount, [&] { sorted = keys; },
+			[&](const ParallelOptions& options) { ParallelSort(sorted, std::less<>(), options); });
+	}
+
+	Vector<uint64_t> values(count, 3);
+	Vector<float> floats(count, 1.5f);
+	Vector<uint64_t> scanned(count, 0);
+	std::printf(" %zu elements\n", count);
+	for (size_t threads : threadCounts) {
+		RunScaling("ParallelReduce<uint64_t>", threads, count, [] {},
+			[&](const ParallelOptions& options) { DoNotOptimize(ParallelReduce(values, uint64_t{ 0 }, std::plus<>(), options)); });
+		RunScaling("ParallelTransform<float>", threads, count, [] {},
+			[&](const ParallelOptions& options) { ParallelTransform(floats, floats, [](float x) { return x * 0.5f + 1.0f; }, options); });
+		RunScaling("ParallelInclusiveScan<uint64_t>", threads, count, [] {},
+			[&](const ParallelOptions& options) { ParallelInclusiveScan(values, scanned, std::plus<>(), options); });
+	}
+	DoNotOptimize(scanned[count - 1]);
+}
@@ -0,0 +1,164 @@
+#include<algorithm>
+
+#include"Benchmark.h"
+#include"BinaryTree.h"
+#include"RoaringBitmap.h"
+
+namespace
+{
+	// Sorted distinct IDs shaped like posting lists over a collection of documents.
+	Vector<uint32_t> SortedIds(Vector<uint32_t> ids)
+	{
+		std::sort(ids.Data(), ids.Data() + ids.Size());
+		ids.Resize(std::unique(ids.Data(), ids.Data() + ids.Size()) - ids.Data());
+		return ids;
+	}
+
+	// A rare term: IDs spread uniformly over the collection, a few hundred per chunk of 65536.
+	Vector<uint32_t> SparseIds(size_t count, uint32_t documents, uint64_t seed)
+	{
+		Vector<uint32_t> ids;
+		Vector<uint64_t> keys = RandomKeys(count, seed);
+		for (uint64_t key : keys.Span())
+			ids.PushBack(static_cast<uint32_t>(key % documents));
+		return SortedIds(std::move(ids));
+	}
+
+	// A term of documents added together: runs of up to 64 consecutive IDs with gaps of up to 512.
+	Vector<uint32_t> ClusteredIds(size_t count, uint64_t seed)
+	{
+		Vector<uint32_t> ids;
+		Vector<uint64_t> keys = RandomKeys(count, seed);
+		uint32_t id = 0;
+		for (size_t i = 0; ids.Size() < count; ++i) {
+			id += static_cast<uint32_t>(keys[i % count] % 512);
+			for (uint64_t length = keys[i % count] >> 58; length > 0 && ids.Size() < count; --length)
+				ids.PushBack(id++);
+		}
+		return ids;
+	}
+
+	// A common term: every document with probability 1 / 2.
+	Vector<uint32_t> DenseIds(uint32_t documents, uint64_t seed)
+	{
+		Vector<uint32_t> ids;
+		Vector<uint64_t> keys = RandomKeys(documents / 64, seed);
+		for (uint32_t id = 0; id < documents; ++id) {
+			if ((keys[id / 64] >> (id % 64)) & 1)
+				ids.PushBack(id);
+		}
+		return ids;
+	}
+
+	RoaringBitmap ToRoaring(const Vector<uint32_t>& ids)
+	{
+		RoaringBitmap bitmap;
+		for (uint32_t id : ids.Span())
+			bitmap.Add(id);
+		bitmap.Optimize();
+		return bitmap;
+	}
+
+	void CompareSetOperations(const char* workload, const Vector<uint32_t>& firstIds, const Vector<uint32_t>& secondIds)
+	{
+		RoaringBitmap first = ToRoaring(firstIds);
+		RoaringBitmap second = ToRoaring(secondIds);
+		size_t ids = firstIds.Size() + secondIds.Size();
+		std::printf(" %s: %zu and %zu IDs, RoaringBitmap %.2f bytes/ID (serialized %.2f), Vector<uint32_t> %zu bytes/ID\n",
+			workload, firstIds.Size(), secondIds.Size(), static_cast<double>(first.Bytes() + second.Bytes()) / ids,
+			static_cast<double>(first.SerializedBytes() + second.SerializedBytes()) / ids, sizeof(uint32_t));
+
+		// Set operations, reported per input ID
+		Vector<uint32_t> output;
+		output.Resize(ids);
+		Measure("RoaringBitmap &", ids, [&] { DoNotOptimize(first & second); });
+		Measure("Vector<uint32_t> std::set_intersection", ids, [&] {
+			DoNotOptimize(std::set_intersection(firstIds.Data(), firstIds.Data() + firstIds.Size(), secondIds.Data(),
+				secondIds.Data() + secondIds.Size(), output.Data()) - output.Data());
+		});
+		Measure("RoaringBitmap AndCardinality", ids, [&] { DoNotOptimize(first.AndCardinality(second)); });
+		Measure("RoaringBitmap |", ids, [&] { DoNotOptimize(first | second); });
+		Measure("Vector<uint32_t> std::set_union", ids, [&] {
+			DoNotOptimize(std::set_union(firstIds.Data(), firstIds.Data() + firstIds.Size(), secondIds.Data(),
+				secondIds.Data() + secondIds.Size(), output.Data()) - output.Data());
+		});
+		RoaringBitmap difference = first;
+		Measure("RoaringBitmap AndNot", ids, [&] { DoNotOptimize(difference.AndNot(second)); });
+		Measure("Vector<uint32_t> std::set_difference", ids, [&] {
+			DoNotOptimize(std::set_difference(firstIds.Data(), firstIds.Data() + firstIds.Size(), secondIds.Data(),
+				secondIds.Data() + secondIds.Size(), output.Data()) - output.Data());
+		});
+
+		Measure("RoaringBitmap ForEach", firstIds.Size(), [&] {
+			uint64_t sum = 0;
+			first.ForEach([&sum](uint32_t id) { sum += id; });
+			DoNotOptimize(sum);
+		});
+		Measure("RoaringBitmap iteration", firstIds.Size(), [&] {
+			uint64_t sum = 0;
+			for (uint32_t id : first)
+				sum += id;
+			DoNotOptimize(sum);
+		});
+		const size_t counts = 1000;
+		Measure("RoaringBitmap Cardinality", counts, [&] {
+			for (size_t i = 0; i < counts; ++i)
+				DoNotOptimize(first.Cardinality());
+		});
+	}
+}
+
+void RoaringBitmapBenchmarks()
+{
+	const uint32_t documents = 1u << 26;
+	const size_t queries = size_t{ 1 } << 20;
+
+	CompareSetOperations("Sparse", SparseIds(1u << 20, documents, 31), SparseIds(1u << 20, documents, 32));
+	CompareSetOperations("Sparse and rare", SparseIds(1u << 20, documents, 33), SparseIds(1u << 13, documents, 34));
+	CompareSetOperations("Clustered", ClusteredIds(1u << 20, 35), ClusteredIds(1u << 20, 36));
+	CompareSetOperations("Dense", DenseIds(1u << 23, 37), DenseIds(1u << 23, 38));
+
+	// Lookups of random documents in a sparse list, also against a tree of the IDs inserted in random order
+	Vector<uint64_t> keys = RandomKeys(1u << 20, 39);
+	Vector<uint32_t> ids;
+	BinaryTree<uint32_t> tree;
+	for (uint64_t key : keys.Span()) {
+		ids.PushBack(static_cast<uint32_t>(key % documents));
+		tree.Insert(ids[ids.Size() - 1]);
+	}
+	ids = SortedIds(std::move(ids));
+	RoaringBitmap bitmap = ToRoaring(ids);
+	Vector<unsigned char> bytes = bitmap.Serialize();
+	RoaringView view(bytes.Span());
+	std::printf(" Contains on %zu sparse IDs: BinaryTree<uint32_t> >= %zu bytes/ID\n", ids.Size(),
+		sizeof(uint32_t) + 3 * sizeof(void*));
+
+	Vector<uint64_t> probes = RandomKeys(queries, 40);
+	for (uint64_t& probe : probes.Span())
+		probe %= documents;
+	Measure("RoaringBitmap Contains (random)", queries, [&] {
+		size_t hits = 0;
+		for (uint64_t probe : probes.Span())
+			hits += bitmap.Contains(static_cast<uint32_t>(probe));
+		DoNotOptimize(hits);
+	});
+	Measure("RoaringView Contains (random)", queries, [&] {
+		size_t hits = 0;
+		for (uint64_t probe : probes.Span())
+			hits += view.Contains(static_cast<uint32_t>(probe));
+		DoNotOptimize(hits);
+	});
+	Measure("Vector<uint32_t> std::binary_search (random)", queries, [&] {
+		size_t hits = 0;
+		for (uint64_t probe : probes.Span())
+			hits += std::binary_search(ids.Data(), ids.Data() + ids.Size(), static_cast<uint32_t>(probe));
+		DoNotOptimize(hits);
+	});
+	Measure("BinaryTree<uint32_t> Find (random)", queries, [&] {
+		size_t hits = 0;
+		for (uint64_t probe : probes.Span())
+			hits += tree.Find(static_cast<uint32_t>(probe));
+		DoNotOptimize(hits);
+	});
+	Measure("RoaringBitmap::Deserialize", ids.Size(), [&] { DoNotOptimize(RoaringBitmap::Deserialize(bytes.Span())); });
+}
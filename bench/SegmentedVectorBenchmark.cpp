@@ -0,0 +1,62 @@
+#include<algorithm>
+
+#include"Benchmark.h"
+#include"SegmentedVector.h"
+
+// Appends count elements, timing every PushBack, and reports the mean and the worst single call. The clock reads
+// dominate the mean; the worst call shows the reallocation copies.
+template<typename Container>
+static void RunPushBackLatency(const char* name, size_t count)
+{
+	Container container;
+	double worst = 0;
+	Timer total;
+	for (size_t i = 0; i < count; ++i) {
+		Timer timer;
+		container.PushBack(i);
+		worst = std::max(worst, timer.Seconds());
+	}
+	double seconds = total.Seconds();
+	DoNotOptimize(container[count - 1]);
+	Report(name, count, seconds);
+	std::printf("  %-48s %10.2f ms worst PushBack\n", "", worst * 1e3);
+}
+
+template<typename Container>
+static void RunReads(const char* name, const Container& container, const Vector<uint64_t>& indices)
+{
+	char caseName[96];
+	std::snprintf(caseName, sizeof(caseName), "%s, random reads", name);
+	Measure(caseName, indices.Size(), [&] {
+		uint64_t sum = 0;
+		for (size_t i = 0; i < indices.Size(); ++i)
+			sum += container[indices[i] % container.Size()];
+		DoNotOptimize(sum);
+	});
+	std::snprintf(caseName, sizeof(caseName), "%s, sequential iteration", name);
+	Measure(caseName, container.Size(), [&] {
+		uint64_t sum = 0;
+		for (uint64_t value : const_cast<Container&>(container))
+			sum += value;
+		DoNotOptimize(sum);
+	});
+}
+
+void SegmentedVectorBenchmarks()
+{
+	const size_t count = size_t{ 1 } << 26;
+
+	std::printf(" %zu uint64_t PushBacks\n", count);
+	RunPushBackLatency<Vector<uint64_t>>("Vector", count);
+	RunPushBackLatency<SegmentedVector<uint64_t>>("SegmentedVector", count);
+
+	Vector<uint64_t> vector;
+	SegmentedVector<uint64_t> segmented;
+	for (size_t i = 0; i < count; ++i) {
+		vector.PushBack(i);
+		segmented.PushBack(i);
+	}
+	Vector<uint64_t> indices = RandomKeys(size_t{ 1 } << 24, 3);
+	RunReads("Vector", vector, indices);
+	RunReads("SegmentedVector", segmented, indices);
+}
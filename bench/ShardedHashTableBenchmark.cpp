@@ -0,0 +1,68 @@
+#include<mutex>
+
+#include"Benchmark.h"
+#include"ShardedHashTable.h"
+
+// The baseline the sharded table replaces: one HashTable behind one global mutex.
+class GlobalLockHashTable
+{
+public:
+	bool Find(uint64_t key, uint64_t& value) const
+	{
+		std::lock_guard lock(m_mutex);
+		const uint64_t* found = m_table.Find(key);
+		if (found != nullptr)
+			value = *found;
+		return found != nullptr;
+	}
+
+	void Insert(uint64_t key, uint64_t value)
+	{
+		std::lock_guard lock(m_mutex);
+		m_table.Insert(key, value);
+	}
+
+private:
+	mutable std::mutex m_mutex;
+	HashTable<uint64_t, uint64_t, FastHash<uint64_t>, std::equal_to<uint64_t>, PowerOfTwoBuckets> m_table;
+};
+
+// Every thread runs operations / threads lookups and inserts, one insert in every ten operations.
+template<typename Table>
+static void RunMixed(const char* tableName, size_t threads, const Vector<uint64_t>& keys, size_t operations)
+{
+	Table table;
+	for (size_t i = 0; i < keys.Size(); i += 2)
+		table.Insert(keys[i], i);
+
+	const size_t perThread = operations / threads;
+	double seconds = RunThreads(threads, [&](size_t thread) {
+		std::mt19937_64 random(thread + 1);
+		uint64_t value = 0;
+		size_t found = 0;
+		for (size_t i = 0; i < perThread; ++i) {
+			uint64_t key = keys[random() % keys.Size()];
+			if (i % 10 == 0)
+				table.Insert(key, i);
+			else
+				found += table.Find(key, value);
+		}
+		DoNotOptimize(found);
+	});
+
+	char name[64];
+	std::snprintf(name, sizeof(name), "%s, %zu threads", tableName, threads);
+	Report(name, perThread * threads, seconds);
+}
+
+void ShardedHashTableBenchmarks()
+{
+	const Vector<uint64_t> keys = RandomKeys(size_t{ 1 } << 20, 5);
+	const size_t operations = size_t{ 1 } << 22;
+
+	std::printf(" 90%% Find / 10%% Insert, %u hardware threads\n", std::thread::hardware_concurrency());
+	for (size_t threads = 1; threads <= 64; threads *= 2) {
+		RunMixed<GlobalLockHashTable>("Global mutex", threads, keys, operations);
+		RunMixed<ShardedHashTable<uint64_t, uint64_t>>("ShardedHashTable", threads, keys, operations);
+	}
+}
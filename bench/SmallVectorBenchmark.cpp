@@ -0,0 +1,56 @@
+#include<cstdlib>
+#include<new>
+
+#include"Benchmark.h"
+#include"SmallVector.h"
+
+// Heap allocations made by the current thread. The replaced global operator new counts them for every
+// benchmark in the executable, which costs one thread-local increment per allocation.
+static thread_local size_t t_allocations = 0;
+
+void* operator new(size_t size)
+{
+	++t_allocations;
+	if (void* data = std::malloc(size > 0 ? size : 1))
+		return data;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* data) noexcept
+{
+	std::free(data);
+}
+
+void operator delete(void* data, size_t) noexcept
+{
+	std::free(data);
+}
+
+// Builds and destroys count short vectors of length elements and reports the time and allocations per vector.
+template<typename Container, typename Element>
+static void RunShortVectors(const char* name, size_t count, size_t length, const Element& element)
+{
+	char caseName[96];
+	std::snprintf(caseName, sizeof(caseName), "%s, %zu elements", name, length);
+	size_t allocations = t_allocations;
+	Measure(caseName, count, [&] {
+		for (size_t i = 0; i < count; ++i) {
+			Container container;
+			for (size_t j = 0; j < length; ++j)
+				container.PushBack(element);
+			DoNotOptimize(container.Size());
+		}
+	});
+	std::printf("  %-48s %10.2f allocations/op\n", "", static_cast<double>(t_allocations - allocations) / count);
+}
+
+void SmallVectorBenchmarks()
+{
+	const size_t count = size_t{ 1 } << 20;
+
+	std::printf(" %zu int vectors\n", count);
+	for (size_t length : { 0, 4, 8, 16 }) {
+		RunShortVectors<Vector<int>>("Vector<int>", count, length, 1);
+		RunShortVectors<SmallVector<int, 8>>("SmallVector<int, 8>", count, length, 1);
+	}
+}
@@ -0,0 +1,80 @@
+#include"Benchmark.h"
+#include"SoAVector.h"
+
+namespace
+{
+	// A 64-byte record of which the scans below touch one or two fields.
+	struct Record
+	{
+		double x, y, z;
+		double vx, vy, vz;
+		float mass;
+		uint32_t id;
+		uint64_t flags;
+	};
+
+	using Records = SoAVector<double, double, double, double, double, double, float, uint32_t, uint64_t>;
+	enum Field { X, Y, Z, VX, VY, VZ, Mass, Id, Flags };
+}
+
+void SoAVectorBenchmarks()
+{
+	const size_t count = size_t{ 1 } << 23;
+	const size_t passes = 8;
+
+	Vector<Record> records;
+	Records columns;
+	records.Reserve(count);
+	columns.Reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		double value = static_cast<double>(i % 1000);
+		records.PushBack(Record{ value, value, value, 1.0, 1.0, 1.0, 1.5f, static_cast<uint32_t>(i), 0 });
+		columns.PushBack(value, value, value, 1.0, 1.0, 1.0, 1.5f, static_cast<uint32_t>(i), 0);
+	}
+
+	std::printf(" %zu 64-byte records\n", count);
+	Measure("sum of one float field, Vector<Record>", passes * count, [&] {
+		for (size_t pass = 0; pass < passes; ++pass) {
+			float sum = 0;
+			for (const Record& record : std::span<const Record>(records.Data(), count))
+				sum += record.mass;
+			DoNotOptimize(sum);
+		}
+	});
+	Measure("sum of one float field, SoAVector loop", passes * count, [&] {
+		for (size_t pass = 0; pass < passes; ++pass) {
+			float sum = 0;
+			for (float mass : columns.Column<Mass>())
+				sum += mass;
+			DoNotOptimize(sum);
+		}
+	});
+	Measure("sum of one float field, SoAVector Sum", passes * count, [&] {
+		for (size_t pass = 0; pass < passes; ++pass)
+			DoNotOptimize(Sum(std::span<const float>(columns.Column<Mass>())));
+	});
+
+	Measure("x += vx * dt, Vector<Record>", passes * count, [&] {
+		for (size_t pass = 0; pass < passes; ++pass) {
+			for (Record& record : std::span<Record>(records.Data(), count))
+				record.x += record.vx * 0.01;
+			DoNotOptimize(records.Data());
+		}
+	});
+	Measure("x += vx * dt, SoAVector columns", passes * count, [&] {
+		for (size_t pass = 0; pass < passes; ++pass) {
+			double* x = columns.Data<X>();
+			const double* vx = columns.Data<VX>();
+			for (size_t i = 0; i < count; ++i)
+				x[i] += vx[i] * 0.01;
+			DoNotOptimize(x);
+		}
+	});
+	Measure("x += vx * dt, SoAVector rows", passes * count, [&] {
+		for (size_t pass = 0; pass < passes; ++pass) {
+			for (auto row : columns)
+				std::get<X>(row) += std::get<VX>(row) * 0.01;
+			DoNotOptimize(columns.Data<X>());
+		}
+	});
+}
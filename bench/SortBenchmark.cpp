@@ -0,0 +1,77 @@
+#include<algorithm>
+#include<string>
+
+#include"Benchmark.h"
+#include"Sort.h"
+
+namespace
+{
+	enum class Pattern { Random, Sorted, Reversed, FewUnique };
+
+	const char* PatternName(Pattern pattern)
+	{
+		static const char* const names[] = { "random", "sorted", "reversed", "few unique" };
+		return names[static_cast<int>(pattern)];
+	}
+
+	template<typename T>
+	Vector<T> MakeInput(Pattern pattern, size_t count)
+	{
+		Vector<uint64_t> keys = RandomKeys(count, 11);
+		Vector<T> values;
+		values.Reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			uint64_t key = pattern == Pattern::FewUnique ? keys[i] % 16 : keys[i];
+			if constexpr (std::is_floating_point_v<T>)
+				values.PushBack(static_cast<T>(static_cast<int64_t>(key)) * T(1e-9));
+			else
+				values.PushBack(static_cast<T>(key));
+		}
+		if (pattern == Pattern::Sorted)
+			std::sort(values.Data(), values.Data() + count);
+		else if (pattern == Pattern::Reversed)
+			std::sort(values.Data(), values.Data() + count, std::greater<>());
+		return values;
+	}
+
+	// Times sort on a fresh copy of input, so every case starts from the same order.
+	template<typename T, typename SortFunction>
+	void RunSort(const char* sortName, const Vector<T>& input, SortFunction sort)
+	{
+		Vector<T> values(input);
+		Measure(sortName, values.Size(), [&] { sort(values.Span()); });
+		if (!std::is_sorted(values.Data(), values.Data() + values.Size()))
+			std::printf("  %s did not sort\n", sortName);
+	}
+
+	template<typename T>
+	void RunSorts(const char* typeName, size_t count)
+	{
+		for (Pattern pattern : { Pattern::Random, Pattern::Sorted, Pattern::Reversed, Pattern::FewUnique }) {
+			const Vector<T> input = MakeInput<T>(pattern, count);
+			std::printf(" %zu %s, %s\n", count, typeName, PatternName(pattern));
+			RunSort("std::sort", input, [](std::span<T> values) { std::sort(values.begin(), values.end()); });
+			RunSort("Sort (radix)", input, [](std::span<T> values) { Sort(values); });
+			RunSort("Sort with comparator (pdqsort)", input, [](std::span<T> values) { Sort(values, std::less<>()); });
+			RunSort("std::stable_sort", input, [](std::span<T> values) { std::stable_sort(values.begin(), values.end()); });
+			RunSort("StableSort (radix)", input, [](std::span<T> values) { StableSort(values); });
+		}
+	}
+}
+
+void SortBenchmarks()
+{
+	const size_t count = size_t{ 1 } << 22;
+	RunSorts<uint64_t>("uint64_t", count);
+	RunSorts<int32_t>("int32_t", count);
+	RunSorts<double>("double", count);
+
+	// Strings have no radix key, so Sort is the pattern-defeating quicksort with branches.
+	Vector<uint64_t> keys = RandomKeys(count / 8, 13);
+	Vector<std::string> words;
+	for (uint64_t key : std::span<const uint64_t>(keys.Data(), keys.Size()))
+		words.PushBack(std::to_string(key));
+	std::printf(" %zu std::string, random\n", words.Size());
+	RunSort("std::sort", words, [](std::span<std::string> values) { std::sort(values.begin(), values.end()); });
+	RunSort("Sort (pdqsort)", words, [](std::span<std::string> values) { Sort(values); });
+}
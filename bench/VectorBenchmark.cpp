@@ -0,0 +1,54 @@
+#include<string>
+#include<vector>
+
+#include"Benchmark.h"
+
+// Appends count copies of element one at a time, optionally reserving the final size first.
+template<typename Container, typename Element>
+static void RunPushBack(const char* name, size_t count, const Element& element, bool reserve)
+{
+	Measure(name, count, [&] {
+		Container container;
+		if (reserve) {
+			if constexpr (requires { container.Reserve(count); })
+				container.Reserve(count);
+			else
+				container.reserve(count);
+		}
+		for (size_t i = 0; i < count; ++i) {
+			if constexpr (requires { container.PushBack(element); })
+				container.PushBack(element);
+			else
+				container.push_back(element);
+		}
+		DoNotOptimize(&container);
+	});
+}
+
+void VectorBenchmarks()
+{
+	const size_t count = size_t{ 1 } << 24;
+	const size_t stringCount = size_t{ 1 } << 20;
+	const std::string text = "a string long enough to live on the heap";
+
+	std::printf(" %zu ints\n", count);
+	RunPushBack<Vector<int>>("Vector PushBack", count, 1, false);
+	RunPushBack<Vector<int, GeometricGrowth<3, 2>>>("Vector PushBack, growth 1.5", count, 1, false);
+	RunPushBack<Vector<int>>("Vector Reserve + PushBack", count, 1, true);
+	RunPushBack<std::vector<int>>("std::vector push_back", count, 1, false);
+
+	Vector<int> source(count, 1);
+	Measure("Vector Append", count, [&] {
+		Vector<int> vector;
+		vector.Append(source.Data(), source.Data() + count);
+		DoNotOptimize(vector.Data());
+	});
+	Measure("Vector sized constructor", count, [&] {
+		Vector<int> vector(count, 1);
+		DoNotOptimize(vector.Data());
+	});
+
+	std::printf(" %zu strings\n", stringCount);
+	RunPushBack<Vector<std::string>>("Vector PushBack", stringCount, text, false);
+	RunPushBack<std::vector<std::string>>("std::vector push_back", stringCount, text, false);
+}
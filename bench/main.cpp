@@ -0,0 +1,48 @@
+#include<cstdio>
+#include<cstring>
+
+#include"Benchmark.h"
+
+struct BenchmarkEntry
+{
+	const char* name;
+	void (*run)();
+};
+
+static const BenchmarkEntry benchmarks[] = {
+	{ "Algorithms", AlgorithmsBenchmarks },
+	{ "BitVector", BitVectorBenchmarks },
+	{ "ConcurrentVector", ConcurrentVectorBenchmarks },
+	{ "FlatHashMap", FlatHashMapBenchmarks },
+	{ "HashTable", HashTableBenchmarks },
+	{ "LockFreeHashMap", LockFreeHashMapBenchmarks },
+	{ "MemoryResource", MemoryResourceBenchmarks },
+	{ "PageAllocator", PageAllocatorBenchmarks },
+	{ "ParallelAlgorithms", ParallelAlgorithmsBenchmarks },
+	{ "RoaringBitmap", RoaringBitmapBenchmarks },
+	{ "SegmentedVector", SegmentedVectorBenchmarks },
+	{ "ShardedHashTable", ShardedHashTableBenchmarks },
+	{ "SmallVector", SmallVectorBenchmarks },
+	{ "Sort", SortBenchmarks },
+	{ "SoAVector", SoAVectorBenchmarks },
+	{ "Vector", VectorBenchmarks },
+};
+
+// Usage: Benchmarks [name filter]
+int main(int argc, char** argv)
+{
+#ifndef NDEBUG
+	std::printf("Warning: assertions are enabled, build with CMAKE_BUILD_TYPE=Release for meaningful numbers\n");
+#endif
+
+	const char* filter = argc > 1 ? argv[1] : "";
+	for (const BenchmarkEntry& benchmark : benchmarks) {
+		if (std::strstr(benchmark.name, filter) == nullptr)
+			continue;
+
+		std::printf("%s\n", benchmark.name);
+		benchmark.run();
+	}
+
+	return 0;
+}
@@ -0,0 +1,610 @@
+#ifndef _ALGORITHMS_
+#define _ALGORITHMS_
+
+#include<atomic>
+#include<bit>
+#include<cstddef>
+#include<cstdint>
+#include<span>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+// Vectorized algorithms over contiguous arithmetic elements. The kernels are written once with GCC/Clang vector
+// extensions and compiled three times: for 16-byte registers with the baseline instruction set (SSE2 on x86-64,
+// NEON on ARM), and on x86 for AVX2 and AVX-512 through target attributes. The widest version the CPU supports
+// is picked at run time, so one binary runs everywhere. Other compilers, bool, long double and constant
+// evaluation use the scalar loops.
+#if defined(__GNUC__) || defined(__clang__)
+#define ALGORITHMS_VECTOR
+#if defined(__x86_64__) || defined(__i386__)
+#define ALGORITHMS_X86
+// Every CPU with AVX2 also has popcnt, which PopCount uses.
+#define ALGORITHMS_TARGET_AVX2 __attribute__((target("avx2,fma,popcnt")))
+#define ALGORITHMS_TARGET_AVX512 __attribute__((target("avx2,fma,popcnt,avx512f,avx512bw,avx512dq,avx512vl")))
+#endif
+#endif
+
+// Returned by IndexOf when the value is absent.
+inline constexpr size_t NotFound = static_cast<size_t>(-1);
+
+enum class SimdIsa
+{
+	Scalar,
+	Vector128,
+	Avx2,
+	Avx512,
+};
+
+// The widest instruction set both this build and the running CPU support.
+inline SimdIsa DetectSimdIsa() noexcept
+{
+#if defined(ALGORITHMS_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq")
+		&& __builtin_cpu_supports("avx512vl"))
+		return SimdIsa::Avx512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return SimdIsa::Avx2;
+	return SimdIsa::Vector128;
+#elif defined(ALGORITHMS_VECTOR)
+	return SimdIsa::Vector128;
+#else
+	return SimdIsa::Scalar;
+#endif
+}
+
+inline std::atomic<SimdIsa>& ActiveSimdIsaState() noexcept
+{
+	static std::atomic<SimdIsa> isa{ DetectSimdIsa() };
+	return isa;
+}
+
+// The instruction set the algorithms currently dispatch to.
+inline SimdIsa ActiveSimdIsa() noexcept
+{
+	return ActiveSimdIsaState().load(std::memory_order_relaxed);
+}
+
+// Restricts the algorithms to isa, or to the widest supported one below it, and returns the previous choice.
+// Meant for tests and benchmarks that compare the versions.
+inline SimdIsa SetSimdIsa(SimdIsa isa) noexcept
+{
+	SimdIsa supported = DetectSimdIsa();
+	return ActiveSimdIsaState().exchange(isa < supported ? isa : supported, std::memory_order_relaxed);
+}
+
+template<typename T>
+struct MinMaxResult
+{
+	T min;
+	T max;
+};
+
+// Scalar reference versions, also used where no vector version exists.
+template<typename T>
+constexpr T ScalarSum(std::span<const T> values) noexcept
+{
+	T sum{};
+	for (const T& value : values)
+		sum += value;
+	return sum;
+}
+
+template<typename T>
+constexpr MinMaxResult<T> ScalarMinMax(std::span<const T> values) noexcept
+{
+	MinMaxResult<T> result{ values[0], values[0] };
+	for (const T& value : values) {
+		result.min = value < result.min ? value : result.min;
+		result.max = result.max < value ? value : result.max;
+	}
+	return result;
+}
+
+template<typename T>
+constexpr size_t ScalarIndexOf(std::span<const T> values, const T& value) noexcept
+{
+	for (size_t i = 0; i < values.size(); ++i) {
+		if (values[i] == value)
+			return i;
+	}
+	return NotFound;
+}
+
+template<typename T>
+constexpr size_t ScalarCount(std::span<const T> values, const T& value) noexcept
+{
+	size_t count = 0;
+	for (const T& element : values)
+		count += element == value;
+	return count;
+}
+
+template<typename T>
+constexpr bool ScalarEqual(std::span<const T> first, std::span<const T> second) noexcept
+{
+	if (first.size() != second.size())
+		return false;
+	for (size_t i = 0; i < first.size(); ++i) {
+		if (!(first[i] == second[i]))
+			return false;
+	}
+	return true;
+}
+
+template<typename T>
+constexpr T ScalarDot(std::span<const T> first, std::span<const T> second) noexcept
+{
+	T sum{};
+	for (size_t i = 0; i < first.size(); ++i)
+		sum += first[i] * second[i];
+	return sum;
+}
+
+constexpr size_t ScalarPopCount(std::span<const uint64_t> words) noexcept
+{
+	size_t count = 0;
+	for (uint64_t word : words)
+		count += static_cast<size_t>(std::popcount(word));
+	return count;
+}
+
+#ifdef ALGORITHMS_VECTOR
+// Vector extension types are returned from the always-inline helpers below by value, which GCC warns would
+// change the ABI of an out-of-line call without AVX; they are never called out of line. Vector parameters are
+// taken by reference, since GCC also notes their alignment ABI change in a way this pragma does not silence.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// Same-width integer for every integral type, so that character types map to vectorizable lanes.
+template<size_t Size, bool Signed> struct SimdInteger;
+template<> struct SimdInteger<1, true> { using Type = int8_t; };
+template<> struct SimdInteger<1, false> { using Type = uint8_t; };
+template<> struct SimdInteger<2, true> { using Type = int16_t; };
+template<> struct SimdInteger<2, false> { using Type = uint16_t; };
+template<> struct SimdInteger<4, true> { using Type = int32_t; };
+template<> struct SimdInteger<4, false> { using Type = uint32_t; };
+template<> struct SimdInteger<8, true> { using Type = int64_t; };
+template<> struct SimdInteger<8, false> { using Type = uint64_t; };
+
+template<typename T, bool Signed = std::is_signed_v<T>>
+struct SimdLaneOf
+{
+	using Type = typename SimdInteger<sizeof(T), Signed>::Type;
+};
+
+template<typename T, bool Signed>
+	requires std::is_floating_point_v<T>
+struct SimdLaneOf<T, Signed>
+{
+	using Type = T;
+};
+
+// Lane type for comparisons, minimum and maximum, and for sums, where integers wrap as unsigned lanes.
+template<typename T>
+using SimdLane = typename SimdLaneOf<T>::Type;
+template<typename T>
+using SimdSumLane = typename SimdLaneOf<T, std::is_floating_point_v<T>>::Type;
+
+template<typename T>
+inline constexpr bool IsSimdElement = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>
+	&& (std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+template<typename Lane, size_t Bytes>
+using SimdVector [[gnu::vector_size(Bytes)]] = Lane;
+
+// Number of registers every loop iteration of the kernels works on, to hide the latency of the additions.
+inline constexpr size_t SimdUnroll = 4;
+
+template<typename Vector, typename T>
+[[gnu::always_inline]] inline Vector SimdLoad(const T* data) noexcept
+{
+	Vector vector;
+	__builtin_memcpy(&vector, data, sizeof(Vector));
+	return vector;
+}
+
+// Lane by lane rather than Vector{} + value, which would turn -0.0 into 0.0.
+template<typename Vector, typename T>
+[[gnu::always_inline]] inline Vector SimdBroadcast(T value) noexcept
+{
+	Vector vector;
+	for (size_t i = 0; i < sizeof(Vector) / sizeof(T); ++i)
+		vector[i] = value;
+	return vector;
+}
+
+// True if any lane of a comparison result is set.
+template<typename Mask>
+[[gnu::always_inline]] inline bool SimdAny(const Mask& mask) noexcept
+{
+	using Words = SimdVector<uint64_t, sizeof(Mask)>;
+	Words words;
+	__builtin_memcpy(&words, &mask, sizeof(Mask));
+	uint64_t any = 0;
+	for (size_t i = 0; i < sizeof(Mask) / 8; ++i)
+		any |= words[i];
+	return any != 0;
+}
+
+template<typename T, size_t Bytes>
+[[gnu::always_inline]] inline T SimdSumKernel(const T* data, size_t size) noexcept
+{
+	using Lane = SimdSumLane<T>;
+	using Vector = SimdVector<Lane, Bytes>;
+	constexpr size_t Lanes = Bytes / sizeof(T);
+
+	Vector sums[SimdUnroll] = {};
+	size_t i = 0;
+	for (; i + SimdUnroll * Lanes <= size; i += SimdUnroll * Lanes) {
+		for (size_t j = 0; j < SimdUnroll; ++j)
+			sums[j] += SimdLoad<Vector>(data + i + j * Lanes);
+	}
+	for (; i + Lanes <= size; i += Lanes)
+		sums[0] += SimdLoad<Vector>(data + i);
+
+	Vector total = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	Lane sum = 0;
+	for (size_t j = 0; j < Lanes; ++j)
+		sum += total[j];
+	for (; i < size; ++i)
+		sum += static_cast<Lane>(data[i]);
+	return static_cast<T>(sum);
+}
+
+template<typename T, size_t Bytes>
+[[gnu::always_inline]] inline MinMaxResult<T> SimdMinMaxKernel(const T* data, size_t size) noexcept
+{
+	using Lane = SimdLane<T>;
+	using Vector = SimdVector<Lane, Bytes>;
+	constexpr size_t Lanes = Bytes / sizeof(T);
+
+	Vector minimum = SimdBroadcast<Vector>(data[0]);
+	Vector maximum = minimum;
+	size_t i = 0;
+	for (; i + Lanes <= size; i += Lanes) {
+		Vector values = SimdLoad<Vector>(data + i);
+		minimum = values < minimum ? values : minimum;
+		maximum = maximum < values ? values : maximum;
+	}
+
+	MinMaxResult<T> result{ static_cast<T>(minimum[0]), static_cast<T>(maximum[0]) };
+	for (size_t j = 1; j < Lanes; ++j) {
+		result.min = static_cast<T>(minimum[j]) < result.min ? static_cast<T>(minimum[j]) : result.min;
+		result.max = result.max < static_cast<T>(maximum[j]) ? static_cast<T>(maximum[j]) : result.max;
+	}
+	for (; i < size; ++i) {
+		result.min = data[i] < result.min ? data[i] : result.min;
+		result.max = result.max < data[i] ? data[i] : result.max;
+	}
+	return result;
+}
+
+// Tests SimdUnroll registers per branch and only locates the match within them once one is found. The comparison
+// results are added rather than or-ed: at most SimdUnroll lanes of -1 cannot wrap to zero, and GCC turns the
+// addition into masked AVX-512 instructions where it would expand the or lane by lane.
+template<typename T, size_t Bytes>
+[[gnu::always_inline]] inline size_t SimdIndexOfKernel(const T* data, size_t size, T value) noexcept
+{
+	using Vector = SimdVector<SimdLane<T>, Bytes>;
+	constexpr size_t Lanes = Bytes / sizeof(T);
+
+	const Vector key = SimdBroadcast<Vector>(value);
+	size_t i = 0;
+	for (; i + SimdUnroll * Lanes <= size; i += SimdUnroll * Lanes) {
+		auto found = SimdLoad<Vector>(data + i) == key;
+		for (size_t j = 1; j < SimdUnroll; ++j)
+			found += SimdLoad<Vector>(data + i + j * Lanes) == key;
+		if (SimdAny(found))
+			break;
+	}
+	for (; i < size; ++i) {
+		if (data[i] == value)
+			return i;
+	}
+	return NotFound;
+}
+
+// Matching lanes compare to -1, so the negated lane sums count the matches. Narrow lanes are drained into the
+// total before they can overflow.
+template<typename T, size_t Bytes>
+[[gnu::always_inline]] inline size_t SimdCountKernel(const T* data, size_t size, T value) noexcept
+{
+	using Vector = SimdVector<SimdLane<T>, Bytes>;
+	using Mask = decltype(Vector{} == Vector{});
+	constexpr size_t Lanes = Bytes / sizeof(T);
+	constexpr size_t MaxBlocks = sizeof(T) >= 4 ? size_t{ 1 } << 30 : size_t{ 1 } << (8 * sizeof(T) - 1);
+
+	const Vector key = SimdBroadcast<Vector>(value);
+	size_t count = 0;
+	size_t i = 0;
+	while (i + Lanes <= size) {
+		Mask matches = {};
+		for (size_t blocks = 0; blocks + 1 < MaxBlocks && i + Lanes <= size; ++blocks, i += Lanes)
+			matches += SimdLoad<Vector>(data + i) == key;
+		for (size_t j = 0; j < Lanes; ++j)
+			count -= static_cast<size_t>(static_cast<int64_t>(matches[j]));
+	}
+	for (; i < size; ++i)
+		count += data[i] == value;
+	return count;
+}
+
+// Adds the comparison results for the same reason as SimdIndexOfKernel.
+template<typename T, size_t Bytes>
+[[gnu::always_inline]] inline bool SimdEqualKernel(const T* first, const T* second, size_t size) noexcept
+{
+	using Vector = SimdVector<SimdLane<T>, Bytes>;
+	constexpr size_t Lanes = Bytes / sizeof(T);
+
+	size_t i = 0;
+	for (; i + SimdUnroll * Lanes <= size; i += SimdUnroll * Lanes) {
+		auto different = SimdLoad<Vector>(first + i) != SimdLoad<Vector>(second + i);
+		for (size_t j = 1; j < SimdUnroll; ++j)
+			different += SimdLoad<Vector>(first + i + j * Lanes) != SimdLoad<Vector>(second + i + j * Lanes);
+		if (SimdAny(different))
+			return false;
+	}
+	for (; i < size; ++i) {
+		if (!(first[i] == second[i]))
+			return false;
+	}
+	return true;
+}
+
+template<typename T, size_t Bytes>
+[[gnu::always_inline]] inline T SimdDotKernel(const T* first, const T* second, size_t size) noexcept
+{
+	using Lane = SimdSumLane<T>;
+	using Vector = SimdVector<Lane, Bytes>;
+	constexpr size_t Lanes = Bytes / sizeof(T);
+
+	Vector sums[SimdUnroll] = {};
+	size_t i = 0;
+	for (; i + SimdUnroll * Lanes <= size; i += SimdUnroll * Lanes) {
+		for (size_t j = 0; j < SimdUnroll; ++j)
+			sums[j] += SimdLoad<Vector>(first + i + j * Lanes) * SimdLoad<Vector>(second + i + j * Lanes);
+	}
+	for (; i + Lanes <= size; i += Lanes)
+		sums[0] += SimdLoad<Vector>(first + i) * SimdLoad<Vector>(second + i);
+
+	Vector total = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	Lane sum = 0;
+	for (size_t j = 0; j < Lanes; ++j)
+		sum += total[j];
+	for (; i < size; ++i)
+		sum += static_cast<Lane>(first[i]) * static_cast<Lane>(second[i]);
+	return static_cast<T>(sum);
+}
+
+// Plain loop that the compiler vectorizes for the instruction set of the function it is inlined into.
+template<typename T, typename Result, typename Function>
+[[gnu::always_inline]] inline void SimdTransformKernel(const T* input, Result* output, size_t size, Function& function)
+{
+	for (size_t i = 0; i < size; ++i)
+		output[i] = function(input[i]);
+}
+
+template<typename T, typename U, typename Result, typename Function>
+[[gnu::always_inline]] inline void SimdTransformKernel(const T* first, const U* second, Result* output, size_t size,
+	Function& function)
+{
+	for (size_t i = 0; i < size; ++i)
+		output[i] = function(first[i], second[i]);
+}
+
+// One popcnt per word where the instruction set has it; the four sums keep the additions independent.
+[[gnu::always_inline]] inline size_t SimdPopCountKernel(const uint64_t* data, size_t size) noexcept
+{
+	size_t counts[SimdUnroll] = {};
+	size_t i = 0;
+	for (; i + SimdUnroll <= size; i += SimdUnroll) {
+		for (size_t j = 0; j < SimdUnroll; ++j)
+			counts[j] += static_cast<size_t>(std::popcount(data[i + j]));
+	}
+	for (; i < size; ++i)
+		counts[0] += static_cast<size_t>(std::popcount(data[i]));
+	return (counts[0] + counts[1]) + (counts[2] + counts[3]);
+}
+
+// One instantiation of every kernel per register width, compiled for the matching instruction set.
+#define ALGORITHMS_DEFINE_KERNELS(Name, Target, Bytes) \
+	struct Name \
+	{ \
+		template<typename T> Target static T Sum(const T* data, size_t size) noexcept \
+		{ return SimdSumKernel<T, Bytes>(data, size); } \
+		template<typename T> Target static MinMaxResult<T> MinMax(const T* data, size_t size) noexcept \
+		{ return SimdMinMaxKernel<T, Bytes>(data, size); } \
+		template<typename T> Target static size_t IndexOf(const T* data, size_t size, T value) noexcept \
+		{ return SimdIndexOfKernel<T, Bytes>(data, size, value); } \
+		template<typename T> Target static size_t Count(const T* data, size_t size, T value) noexcept \
+		{ return SimdCountKernel<T, Bytes>(data, size, value); } \
+		template<typename T> Target static bool Equal(const T* first, const T* second, size_t size) noexcept \
+		{ return SimdEqualKernel<T, Bytes>(first, second, size); } \
+		template<typename T> Target static T Dot(const T* first, const T* second, size_t size) noexcept \
+		{ return SimdDotKernel<T, Bytes>(first, second, size); } \
+		template<typename T, typename Result, typename Function> \
+		Target static void Transform(const T* input, Result* output, size_t size, Function& function) \
+		{ SimdTransformKernel(input, output, size, function); } \
+		template<typename T, typename U, typename Result, typename Function> \
+		Target static void Transform(const T* first, const U* second, Result* output, size_t size, Function& function) \
+		{ SimdTransformKernel(first, second, output, size, function); } \
+		Target static size_t PopCount(const uint64_t* data, size_t size) noexcept \
+		{ return SimdPopCountKernel(data, size); } \
+	};
+
+ALGORITHMS_DEFINE_KERNELS(SimdKernels128, , 16)
+#ifdef ALGORITHMS_X86
+ALGORITHMS_DEFINE_KERNELS(SimdKernelsAvx2, ALGORITHMS_TARGET_AVX2, 32)
+ALGORITHMS_DEFINE_KERNELS(SimdKernelsAvx512, ALGORITHMS_TARGET_AVX512, 64)
+#endif
+#undef ALGORITHMS_DEFINE_KERNELS
+
+#pragma GCC diagnostic pop
+
+// Calls call(Kernels) with the kernel set of the active instruction set.
+template<typename Call>
+inline decltype(auto) SimdDispatch(Call&& call)
+{
+#ifdef ALGORITHMS_X86
+	switch (ActiveSimdIsa()) {
+	case SimdIsa::Avx512:
+		return call(SimdKernelsAvx512{});
+	case SimdIsa::Avx2:
+		return call(SimdKernelsAvx2{});
+	default:
+		break;
+	}
+#endif
+	return call(SimdKernels128{});
+}
+
+template<typename T>
+inline bool UseSimd() noexcept
+{
+	return IsSimdElement<T> && ActiveSimdIsa() != SimdIsa::Scalar;
+}
+#endif
+
+// Integer sums wrap like std::accumulate with a T initial value. Floating-point sums add in a different order
+// than a sequential loop, so their last bits may differ from it.
+template<typename T>
+	requires std::is_arithmetic_v<T>
+constexpr T Sum(std::span<const T> values) noexcept
+{
+#ifdef ALGORITHMS_VECTOR
+	if constexpr (IsSimdElement<T>) {
+		if (!std::is_constant_evaluated() && UseSimd<T>())
+			return SimdDispatch([&](auto kernels) { return kernels.template Sum<T>(values.data(), values.size()); });
+	}
+#endif
+	return ScalarSum(values);
+}
+
+// Smallest and largest element. The result is unspecified if the elements include a NaN.
+template<typename T>
+	requires std::is_arithmetic_v<T>
+constexpr MinMaxResult<T> MinMax(std::span<const T> values)
+{
+	if (values.empty())
+		throw std::invalid_argument("MinMax of an empty range");
+#ifdef ALGORITHMS_VECTOR
+	if constexpr (IsSimdElement<T>) {
+		if (!std::is_constant_evaluated() && UseSimd<T>())
+			return SimdDispatch([&](auto kernels) { return kernels.template MinMax<T>(values.data(), values.size()); });
+	}
+#endif
+	return ScalarMinMax(values);
+}
+
+// Index of the first element equal to value, or NotFound.
+template<typename T>
+	requires std::is_arithmetic_v<T>
+constexpr size_t IndexOf(std::span<const T> values, const T& value) noexcept
+{
+#ifdef ALGORITHMS_VECTOR
+	if constexpr (IsSimdElement<T>) {
+		if (!std::is_constant_evaluated() && UseSimd<T>())
+			return SimdDispatch([&](auto kernels) { return kernels.template IndexOf<T>(values.data(), values.size(), value); });
+	}
+#endif
+	return ScalarIndexOf(values, value);
+}
+
+template<typename T>
+	requires std::is_arithmetic_v<T>
+constexpr bool Find(std::span<const T> values, const T& value) noexcept
+{
+	return IndexOf(values, value) != NotFound;
+}
+
+template<typename T>
+	requires std::is_arithmetic_v<T>
+constexpr size_t Count(std::span<const T> values, const T& value) noexcept
+{
+#ifdef ALGORITHMS_VECTOR
+	if constexpr (IsSimdElement<T>) {
+		if (!std::is_constant_evaluated() && UseSimd<T>())
+			return SimdDispatch([&](auto kernels) { return kernels.template Count<T>(values.data(), values.size(), value); });
+	}
+#endif
+	return ScalarCount(values, value);
+}
+
+// Element-wise ==, so a NaN makes two ranges unequal and 0.0 equals -0.0.
+template<typename T>
+	requires std::is_arithmetic_v<T>
+constexpr bool Equal(std::span<const T> first, std::span<const T> second) noexcept
+{
+	if (first.size() != second.size())
+		return false;
+#ifdef ALGORITHMS_VECTOR
+	if constexpr (IsSimdElement<T>) {
+		if (!std::is_constant_evaluated() && UseSimd<T>())
+			return SimdDispatch([&](auto kernels) { return kernels.template Equal<T>(first.data(), second.data(), first.size()); });
+	}
+#endif
+	return ScalarEqual(first, second);
+}
+
+// Sum of the products of corresponding elements, with the rounding caveats of Sum.
+template<typename T>
+	requires std::is_arithmetic_v<T>
+constexpr T Dot(std::span<const T> first, std::span<const T> second)
+{
+	if (first.size() != second.size())
+		throw std::invalid_argument("Dot of ranges of different sizes");
+#ifdef ALGORITHMS_VECTOR
+	if constexpr (IsSimdElement<T>) {
+		if (!std::is_constant_evaluated() && UseSimd<T>())
+			return SimdDispatch([&](auto kernels) { return kernels.template Dot<T>(first.data(), second.data(), first.size()); });
+	}
+#endif
+	return ScalarDot(first, second);
+}
+
+// Stores function(input[i]) to output[i]. The loop is compiled for every instruction set, so a function the
+// compiler can inline, such as a lambda doing arithmetic, runs on the widest registers available. output may
+// be input itself.
+template<typename T, typename Result, typename Function>
+void Transform(std::span<const T> input, std::span<Result> output, Function function)
+{
+	if (output.size() < input.size())
+		throw std::invalid_argument("Transform output is smaller than its input");
+#ifdef ALGORITHMS_VECTOR
+	if (ActiveSimdIsa() != SimdIsa::Scalar)
+		return SimdDispatch([&](auto kernels) { kernels.Transform(input.data(), output.data(), input.size(), function); });
+#endif
+	for (size_t i = 0; i < input.size(); ++i)
+		output[i] = function(input[i]);
+}
+
+// Stores function(first[i], second[i]) to output[i], compiled like the Transform above. output may be first or
+// second.
+template<typename T, typename U, typename Result, typename Function>
+void Transform(std::span<const T> first, std::span<const U> second, std::span<Result> output, Function function)
+{
+	if (second.size() != first.size())
+		throw std::invalid_argument("Transform of ranges of different sizes");
+	if (output.size() < first.size())
+		throw std::invalid_argument("Transform output is smaller than its input");
+#ifdef ALGORITHMS_VECTOR
+	if (ActiveSimdIsa() != SimdIsa::Scalar)
+		return SimdDispatch([&](auto kernels) { kernels.Transform(first.data(), second.data(), output.data(), first.size(), function); });
+#endif
+	for (size_t i = 0; i < first.size(); ++i)
+		output[i] = function(first[i], second[i]);
+}
+
+// Number of set bits in the words.
+inline size_t PopCount(std::span<const uint64_t> words) noexcept
+{
+#ifdef ALGORITHMS_VECTOR
+	if (ActiveSimdIsa() != SimdIsa::Scalar)
+		return SimdDispatch([&](auto kernels) { return kernels.PopCount(words.data(), words.size()); });
+#endif
+	return ScalarPopCount(words);
+}
+
+#endif //_ALGORITHMS_
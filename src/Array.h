@@ -1,10 +1,14 @@
 #ifndef _ARRAY_
 #define _ARRAY_
 
+#include<span>
 #include<stdexcept>
 #include<string>
 #include<utility>
 
+#include"Algorithms.h"
+#include"Sort.h"
+
 template<typename Array>
 class BaseArrayIterator
 {
@@ -94,13 +98,11 @@ public:
 	using ReverseIterator = ArrayReverseIterator<Array<T, size>>;
 public:
 	//Constructors
-	Array()
-	{
-		for (size_t i = 0; i < size; ++i)
-			m_data[i] = 0;
-	}
+	// Elements are value-initialized, which zeroes arithmetic types and keeps the array usable in constant
+	// expressions.
+	constexpr Array() : m_data{} {}
 
-	Array(std::initializer_list<T> list) : Array()
+	constexpr Array(std::initializer_list<T> list) : Array()
 	{
 		if (list.size() > size)
 			throw std::out_of_range("Too many elements in initializer_list");
@@ -113,41 +115,51 @@ public:
 	}
 
 	// Element access
-	const T& operator[](size_t index) const
+	constexpr const T& operator[](size_t index) const
 	{
 		if (index >= size)
 			throw std::out_of_range{ "Index out of range: " + std::to_string(index) };
 		return m_data[index];
 	};
 
-	T& operator[](size_t index)
+	constexpr T& operator[](size_t index)
 	{
 		return const_cast<T&>(std::as_const(*this)[index]);
 	};
 
-	T* Data() noexcept
+	constexpr T* Data() noexcept
 	{
 		return m_data;
 	}
 
-	const T* Data() const noexcept
+	constexpr const T* Data() const noexcept
 	{
 		return m_data;
 	}
 
+	constexpr std::span<T, size> Span() noexcept
+	{
+		return std::span<T, size>(m_data);
+	}
+
+	constexpr std::span<const T, size> Span() const noexcept
+	{
+		return std::span<const T, size>(m_data);
+	}
+
 	//Capacity
-	size_t Size() const noexcept
+	constexpr size_t Size() const noexcept
 	{
 		return size;
 	};
 
-	bool Empty() const noexcept
+	constexpr bool Empty() const noexcept
 	{
 		return size == 0;
 	};
 
 	//Operations
-	void Fill(const T& value)
+	constexpr void Fill(const T& value)
 	{
 		for (size_t i = 0; i < size; ++i) {
 			m_data[i] = value;
@@ -159,6 +171,77 @@ public:
 		std::swap(m_data, other.m_data);
 	}
 
+	//Algorithms
+	// Vectorized versions of the Algorithms.h functions over the elements; they fall back to the scalar loops
+	// in constant expressions.
+	constexpr T Sum() const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::Sum<T>(Span());
+	}
+
+	constexpr MinMaxResult<T> MinMax() const requires std::is_arithmetic_v<T>
+	{
+		return ::MinMax<T>(Span());
+	}
+
+	constexpr bool Find(const T& value) const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::Find<T>(Span(), value);
+	}
+
+	constexpr size_t IndexOf(const T& value) const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::IndexOf<T>(Span(), value);
+	}
+
+	constexpr size_t Count(const T& value) const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::Count<T>(Span(), value);
+	}
+
+	constexpr T Dot(const Array& other) const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::Dot<T>(Span(), other.Span());
+	}
+
+	// Replaces every element with function(element).
+	template<typename Function>
+	void Transform(Function function)
+	{
+		::Transform<T, T>(Span(), std::span<T>(Span()), function);
+	}
+
+	// Replaces every element with function(element, other[i]).
+	template<typename U, typename Function>
+	void Transform(const Array<U, size>& other, Function function)
+	{
+		::Transform<T, U, T>(Span(), other.Span(), std::span<T>(Span()), function);
+	}
+
+	// Sorts in place: radix sort for integers, floating-point numbers and enums, a pattern-defeating quicksort
+	// otherwise and whenever a comparator is given. See Sort.h.
+	void Sort()
+	{
+		::Sort(std::span<T>(Span()));
+	}
+
+	template<typename Compare>
+	void Sort(Compare compare)
+	{
+		::Sort(std::span<T>(Span()), compare);
+	}
+
+	void StableSort()
+	{
+		::StableSort(std::span<T>(Span()));
+	}
+
+	template<typename Compare>
+	void StableSort(Compare compare)
+	{
+		::StableSort(std::span<T>(Span()), compare);
+	}
+
 	//Iterators
 	Iterator begin() { return Iterator(m_data); };
 	Iterator end() { return Iterator(m_data, size); }
@@ -1,6 +1,11 @@
 #ifndef _BINARYTREE_
 #define _BINARYTREE_
 
+#include<initializer_list>
+#include<memory>
+#include<memory_resource>
+#include<utility>
+
 template<typename BinaryTree>
 class BaseTreeIterator
 {
@@ -161,41 +166,53 @@ public:
 	}
 };
 
-template<typename T>
+// Nodes come from Allocator, rebound to the node type, and the elements are constructed with uses-allocator
+// construction.
+template<typename T, typename Allocator = std::allocator<T>>
 class BinaryTree
 {
 private:
 	struct Node
 	{
-		Node() : data{ 0 }, left{ nullptr }, right{ nullptr }, parent{ nullptr } {}
-		Node(const T& value) : data{ value }, left{ nullptr }, right{ nullptr }, parent{ nullptr } {}
+		template<typename NodeAllocator>
+		Node(const NodeAllocator& allocator, const T& value)
+			: data(std::make_obj_using_allocator<T>(allocator, value)), left{ nullptr }, right{ nullptr }, parent{ nullptr } {}
 		T data;
 		Node* left;
 		Node* right;
 		Node* parent;
 	};
 
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using NodeTraits = std::allocator_traits<NodeAllocator>;
+
 public:
 	using ValueType = T;
+	using AllocatorType = Allocator;
 	using NodePtr = Node*;
-	using Iterator = TreeIterator<BinaryTree<T>>;
-	using ReverseIterator = TreeReverseIterator<BinaryTree<T>>;
+	using Iterator = TreeIterator<BinaryTree>;
+	using ReverseIterator = TreeReverseIterator<BinaryTree>;
 public:
 	//Constructors
 	BinaryTree() = default;
 
-	BinaryTree(std::initializer_list<T> list)
+	explicit BinaryTree(const Allocator& allocator) : m_allocator(allocator) {}
+
+	BinaryTree(std::initializer_list<T> list, const Allocator& allocator = Allocator()) : m_allocator(allocator)
 	{
 		for (const T& value : list)
 			Insert(value);
 	}
 
 	BinaryTree(const BinaryTree& other)
+		: BinaryTree(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.GetAllocator())) {}
+
+	BinaryTree(const BinaryTree& other, const Allocator& allocator) : m_allocator(allocator)
 	{
 		Copy(root, other.root);
 	}
 
-	BinaryTree(BinaryTree&& other) noexcept :root(other.root)
+	BinaryTree(BinaryTree&& other) noexcept :root(other.root), m_allocator(other.m_allocator)
 	{
 		other.root = nullptr;
 	}
@@ -210,18 +227,33 @@ public:
 	{
 		if (this != &other) {
 			Clear();
+			if constexpr (NodeTraits::propagate_on_container_copy_assignment::value)
+				m_allocator = other.m_allocator;
 			Copy(root, other.root);
 		}
 		return *this;
 	}
 
-	BinaryTree operator=(BinaryTree&& other) noexcept
+	BinaryTree& operator=(BinaryTree&& other) noexcept(NodeTraits::propagate_on_container_move_assignment::value
+		|| NodeTraits::is_always_equal::value)
 	{
-		if (this != &other) {
-			Clear();
-			root = other.root;
-			other.root = nullptr;
+		if (this == &other)
+			return *this;
+
+		Clear();
+		if constexpr (!NodeTraits::propagate_on_container_move_assignment::value && !NodeTraits::is_always_equal::value) {
+			// Nodes of another allocator cannot be adopted, so they are copied into this tree's allocator.
+			if (m_allocator != other.m_allocator) {
+				Copy(root, other.root);
+				other.Clear();
+				return *this;
+			}
 		}
+
+		if constexpr (NodeTraits::propagate_on_container_move_assignment::value)
+			m_allocator = other.m_allocator;
+		root = other.root;
+		other.root = nullptr;
 		return *this;
 	}
 
@@ -274,12 +306,11 @@ public:
 		}
 	}
 
+	// The node is only allocated once the value is known to be absent.
 	bool Insert(const T& value)
 	{
-		Node* newNode = new Node(value);
-
 		if (root == nullptr) {
-			root = newNode;
+			root = CreateNode(value);
 			return true;
 		}
 
@@ -294,16 +325,16 @@ public:
 			}
 			else if (currentNode->data > value) {
 				if (currentNode->left == nullptr) {
-					currentNode->left = newNode;
-					newNode->parent = parentNode;
+					currentNode->left = CreateNode(value);
+					currentNode->left->parent = parentNode;
 					return true;
 				}
 				currentNode = currentNode->left;
 			}
 			else {
 				if (currentNode->right == nullptr) {
-					currentNode->right = newNode;
-					newNode->parent = parentNode;
+					currentNode->right = CreateNode(value);
+					currentNode->right->parent = parentNode;
 					return true;
 				}
 				currentNode = currentNode->right;
@@ -314,6 +345,11 @@ public:
 	}
 
 
+	Allocator GetAllocator() const noexcept
+	{
+		return Allocator(m_allocator);
+	}
+
 	//Capacity
 	size_t Size() const noexcept
 	{
@@ -357,6 +393,25 @@ public:
 	}
 
 private:
+	NodePtr CreateNode(const T& value)
+	{
+		NodePtr node = NodeTraits::allocate(m_allocator, 1);
+		try {
+			NodeTraits::construct(m_allocator, node, m_allocator, value);
+		}
+		catch (...) {
+			NodeTraits::deallocate(m_allocator, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void DestroyNode(NodePtr node) noexcept
+	{
+		NodeTraits::destroy(m_allocator, node);
+		NodeTraits::deallocate(m_allocator, node, 1);
+	}
+
 	void RemoveSubTree(Node* node)
 	{
 		if (node->left != nullptr) {
@@ -367,7 +422,7 @@ private:
 			RemoveSubTree(node->right);
 		}
 
-		delete node;
+		DestroyNode(node);
 	}
 
 	Node* Delete(Node* node, const T& value)
@@ -383,17 +438,17 @@ private:
 		}
 		else {
 			if (node->left == nullptr && node->right == nullptr) {
-				delete node;
+				DestroyNode(node);
 				node = nullptr;
 			}
 			else if (node->left == nullptr) {
 				Node* temp = node->right;
-				delete node;
+				DestroyNode(node);
 				node = temp;
 			}
 			else if (node->right == nullptr) {
 				Node* temp = node->left;
-				delete node;
+				DestroyNode(node);
 				node = temp;
 			}
 			else {
@@ -414,7 +469,7 @@ private:
 	{
 		if (tree2 == nullptr) return;
 
-		tree1 = new Node{ tree2->data };
+		tree1 = CreateNode(tree2->data);
 		tree1->parent = parent;
 		Copy(tree1->left, tree2->left, tree1);
 		Copy(tree1->right, tree2->right, tree1);
@@ -436,8 +491,13 @@ private:
 
 private:
 	Node* root = nullptr;
+	[[no_unique_address]] NodeAllocator m_allocator;
 };
 
+// BinaryTree whose nodes come from a std::pmr::memory_resource, such as a PoolResource or a MonotonicArena.
+template<typename T>
+using PmrBinaryTree = BinaryTree<T, std::pmr::polymorphic_allocator<T>>;
+
 
 
 #endif //_BINARYTREE_
\ No newline at end of file
@@ -0,0 +1,559 @@
+#ifndef _BITVECTOR_
+#define _BITVECTOR_
+
+#include<algorithm>
+#include<bit>
+#include<cstddef>
+#include<cstdint>
+#include<initializer_list>
+#include<span>
+#include<stdexcept>
+#include<utility>
+
+#if defined(__BMI2__)
+#include<immintrin.h>
+#endif
+
+#include"Algorithms.h"
+#include"Vector.h"
+
+#ifdef ALGORITHMS_X86
+#define BITVECTOR_TARGET_POPCNT ALGORITHMS_TARGET_AVX2
+#else
+#define BITVECTOR_TARGET_POPCNT
+#endif
+#ifdef ALGORITHMS_VECTOR
+#define BITVECTOR_INLINE [[gnu::always_inline]] inline
+#else
+#define BITVECTOR_INLINE inline
+#endif
+
+// Vector of bits packed 64 to a word, an eighth of the memory of a Vector<bool>. Besides the single-bit Set,
+// Reset, Flip and Test, it combines whole vectors with &=, |=, ^= and AndNot through the vectorized Transform of
+// Algorithms.h, and counts bits with popcnt. Rank and Select make it a building block for succinct structures:
+// Rank(i) counts the ones before bit i in O(1) and Select(k) finds the k-th one in O(log n) at worst. Both use
+// an index built on first use after a change: the ones before every 4096-bit superblock in a 64-bit count, the
+// ones before every 512-bit block relative to its superblock in a 16-bit count, and the superblock of every
+// 4096th one (and zero) as a starting point for Select. The index takes about 5% of the bits; BuildIndex builds it
+// up front, which a const BitVector shared between threads needs. Bits beyond Size are always zero.
+class BitVector
+{
+public:
+	using WordType = uint64_t;
+
+	static constexpr size_t WordBits = 64;
+public:
+	//Constructors
+	BitVector() : m_size(0), m_indexed(false) {}
+
+	explicit BitVector(size_t size, bool value = false) : m_size(0), m_indexed(false)
+	{
+		Resize(size, value);
+	}
+
+	BitVector(std::initializer_list<bool> values) : BitVector()
+	{
+		m_words.Reserve(WordCount(values.size()));
+		for (bool value : values)
+			PushBack(value);
+	}
+
+	BitVector(const BitVector& other) = default;
+
+	BitVector(BitVector&& other) noexcept
+		: m_words(std::move(other.m_words)), m_size(std::exchange(other.m_size, 0)),
+		m_superCounts(std::move(other.m_superCounts)), m_blockCounts(std::move(other.m_blockCounts)),
+		m_oneSamples(std::move(other.m_oneSamples)), m_zeroSamples(std::move(other.m_zeroSamples)),
+		m_indexed(std::exchange(other.m_indexed, false)) {}
+
+	//Operators
+	BitVector& operator=(const BitVector& other) = default;
+
+	BitVector& operator=(BitVector&& other) noexcept
+	{
+		BitVector moved(std::move(other));
+		Swap(moved);
+		return *this;
+	}
+
+	bool operator[](size_t index) const
+	{
+		return Test(index);
+	}
+
+	bool operator==(const BitVector& other) const
+	{
+		return m_size == other.m_size && m_words == other.m_words;
+	}
+
+	bool operator!=(const BitVector& other) const
+	{
+		return !(*this == other);
+	}
+
+	// The bulk operations need both vectors to have the same size and throw std::invalid_argument otherwise.
+	BitVector& operator&=(const BitVector& other)
+	{
+		Combine(other, [](WordType first, WordType second) { return first & second; });
+		return *this;
+	}
+
+	BitVector& operator|=(const BitVector& other)
+	{
+		Combine(other, [](WordType first, WordType second) { return first | second; });
+		return *this;
+	}
+
+	BitVector& operator^=(const BitVector& other)
+	{
+		Combine(other, [](WordType first, WordType second) { return first ^ second; });
+		return *this;
+	}
+
+	BitVector operator~() const
+	{
+		BitVector flipped(*this);
+		flipped.Flip();
+		return flipped;
+	}
+
+	friend BitVector operator&(BitVector first, const BitVector& second)
+	{
+		return first &= second;
+	}
+
+	friend BitVector operator|(BitVector first, const BitVector& second)
+	{
+		return first |= second;
+	}
+
+	friend BitVector operator^(BitVector first, const BitVector& second)
+	{
+		return first ^= second;
+	}
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	size_t Size() const noexcept
+	{
+		return m_size;
+	}
+
+	void Reserve(size_t size)
+	{
+		m_words.Reserve(WordCount(size));
+	}
+
+	// Memory held by the bits and the rank and select index.
+	size_t Bytes() const noexcept
+	{
+		return m_words.Capacity() * sizeof(WordType) + m_superCounts.Capacity() * sizeof(uint64_t)
+			+ m_blockCounts.Capacity() * sizeof(uint16_t) + m_oneSamples.Capacity() * sizeof(uint64_t)
+			+ m_zeroSamples.Capacity() * sizeof(uint64_t);
+	}
+
+	//Element access
+	bool Test(size_t index) const
+	{
+		CheckIndex(index);
+		return (m_words.Data()[index / WordBits] >> (index % WordBits)) & 1;
+	}
+
+	// The words holding the bits, bit i in bit i % 64 of word i / 64.
+	std::span<const WordType> Words() const noexcept
+	{
+		return m_words.Span();
+	}
+
+	//Modifiers
+	void Set(size_t index, bool value = true)
+	{
+		CheckIndex(index);
+		WordType& word = m_words.Data()[index / WordBits];
+		word = (word & ~Bit(index)) | (WordType{ value } << (index % WordBits));
+		m_indexed = false;
+	}
+
+	void Reset(size_t index)
+	{
+		Set(index, false);
+	}
+
+	void Flip(size_t index)
+	{
+		CheckIndex(index);
+		m_words.Data()[index / WordBits] ^= Bit(index);
+		m_indexed = false;
+	}
+
+	// Sets, resets or flips every bit.
+	void Set() noexcept
+	{
+		std::fill(m_words.Data(), m_words.Data() + m_words.Size(), ~WordType{ 0 });
+		ClearUnusedBits();
+		m_indexed = false;
+	}
+
+	void Reset() noexcept
+	{
+		std::fill(m_words.Data(), m_words.Data() + m_words.Size(), WordType{ 0 });
+		m_indexed = false;
+	}
+
+	void Flip()
+	{
+		Transform<WordType, WordType>(m_words.Span(), m_words.Span(), [](WordType word) { return ~word; });
+		ClearUnusedBits();
+		m_indexed = false;
+	}
+
+	// Clears the bits that are set in other.
+	BitVector& AndNot(const BitVector& other)
+	{
+		Combine(other, [](WordType first, WordType second) { return first & ~second; });
+		return *this;
+	}
+
+	void PushBack(bool value)
+	{
+		if (m_size % WordBits == 0)
+			m_words.PushBack(0);
+		m_words.Data()[m_size / WordBits] |= WordType{ value } << (m_size % WordBits);
+		++m_size;
+		m_indexed = false;
+	}
+
+	void PopBack() noexcept
+	{
+		if (m_size == 0)
+			return;
+		--m_size;
+		if (m_size % WordBits == 0)
+			m_words.PopBack();
+		else
+			ClearUnusedBits();
+		m_indexed = false;
+	}
+
+	// New bits are set to value.
+	void Resize(size_t size, bool value = false)
+	{
+		size_t oldSize = m_size;
+		m_words.Resize(WordCount(size), value ? ~WordType{ 0 } : WordType{ 0 });
+		m_size = size;
+		if (value && oldSize % WordBits != 0 && size > oldSize)
+			m_words.Data()[oldSize / WordBits] |= ~WordType{ 0 } << (oldSize % WordBits);
+		ClearUnusedBits();
+		m_indexed = false;
+	}
+
+	void Clear() noexcept
+	{
+		m_words.Clear();
+		m_size = 0;
+		m_indexed = false;
+	}
+
+	void Swap(BitVector& other) noexcept
+	{
+		m_words.Swap(other.m_words);
+		std::swap(m_size, other.m_size);
+		m_superCounts.Swap(other.m_superCounts);
+		m_blockCounts.Swap(other.m_blockCounts);
+		m_oneSamples.Swap(other.m_oneSamples);
+		m_zeroSamples.Swap(other.m_zeroSamples);
+		std::swap(m_indexed, other.m_indexed);
+	}
+
+	//Operations
+	// Number of set bits.
+	size_t Count() const noexcept
+	{
+		return m_indexed ? static_cast<size_t>(m_superCounts.Data()[m_superCounts.Size() - 1]) : PopCount(m_words.Span());
+	}
+
+	bool Any() const noexcept
+	{
+		return std::any_of(m_words.Data(), m_words.Data() + m_words.Size(), [](WordType word) { return word != 0; });
+	}
+
+	bool None() const noexcept
+	{
+		return !Any();
+	}
+
+	bool All() const noexcept
+	{
+		return Count() == m_size;
+	}
+
+	// Index of the first set bit at or after index, or NotFound.
+	size_t FindNext(size_t index) const noexcept
+	{
+		if (index >= m_size)
+			return NotFound;
+		const WordType* words = m_words.Data();
+		size_t word = index / WordBits;
+		WordType bits = words[word] & (~WordType{ 0 } << (index % WordBits));
+		while (bits == 0) {
+			if (++word == m_words.Size())
+				return NotFound;
+			bits = words[word];
+		}
+		return word * WordBits + static_cast<size_t>(std::countr_zero(bits));
+	}
+
+	size_t FindFirst() const noexcept
+	{
+		return FindNext(0);
+	}
+
+	// Builds the rank and select index now instead of at the next Rank or Select.
+	void BuildIndex() const
+	{
+		if (m_indexed)
+			return;
+		size_t ones = UsePopcnt() ? CountBlocksPopcnt() : CountBlocks();
+		BuildSamples<true>(m_oneSamples, ones);
+		BuildSamples<false>(m_zeroSamples, m_size - ones);
+		m_indexed = true;
+	}
+
+	// Number of set bits before index, which may be Size(). O(1).
+	size_t Rank(size_t index) const
+	{
+		if (index > m_size)
+			throw std::out_of_range("index out of range");
+		BuildIndex();
+		if (index == m_size)
+			return Count();
+		return UsePopcnt() ? RankPopcnt(index) : RankInIndex(index);
+	}
+
+	// Number of clear bits before index.
+	size_t RankZero(size_t index) const
+	{
+		return index - Rank(index);
+	}
+
+	// Index of the set bit with rank bits set before it, or NotFound if fewer than rank + 1 bits are set.
+	size_t Select(size_t rank) const
+	{
+		BuildIndex();
+		if (rank >= Count())
+			return NotFound;
+		return UsePopcnt() ? SelectPopcnt<true>(rank) : SelectInIndex<true>(rank);
+	}
+
+	// Index of the clear bit with rank clear bits before it, or NotFound.
+	size_t SelectZero(size_t rank) const
+	{
+		BuildIndex();
+		if (rank >= m_size - Count())
+			return NotFound;
+		return UsePopcnt() ? SelectPopcnt<false>(rank) : SelectInIndex<false>(rank);
+	}
+
+private:
+	static constexpr size_t BlockWords = 8;
+	static constexpr size_t BlockBits = BlockWords * WordBits;
+	static constexpr size_t SuperBlocks = 8;
+	static constexpr size_t SuperBits = SuperBlocks * BlockBits;
+	// Every SampleRate-th one and zero records its superblock.
+	static constexpr size_t SampleRate = 4096;
+
+	static size_t WordCount(size_t size) noexcept
+	{
+		return (size + WordBits - 1) / WordBits;
+	}
+
+	static WordType Bit(size_t index) noexcept
+	{
+		return WordType{ 1 } << (index % WordBits);
+	}
+
+	// Index of the set bit of word with rank set bits before it.
+	static size_t SelectInWord(WordType word, size_t rank) noexcept
+	{
+#if defined(__BMI2__)
+		return static_cast<size_t>(std::countr_zero(_pdep_u64(WordType{ 1 } << rank, word)));
+#else
+		constexpr WordType Bytes = 0x0101010101010101;
+		// Byte i of counts becomes the number of set bits in bytes 0 to i.
+		WordType counts = word - ((word >> 1) & 0x5555555555555555);
+		counts = (counts & 0x3333333333333333) + ((counts >> 2) & 0x3333333333333333);
+		counts = ((counts + (counts >> 4)) & 0x0F0F0F0F0F0F0F0F) * Bytes;
+		// The high bit of each byte of atMost is set if that count is at most rank, and the bytes holding such
+		// counts precede the byte with the bit.
+		WordType atMost = ((rank * Bytes | 0x80 * Bytes) - counts) & 0x80 * Bytes;
+		size_t shift = static_cast<size_t>(((atMost >> 7) * Bytes) >> 56) * 8;
+		rank -= static_cast<size_t>(((counts << 8) >> shift) & 0xFF);
+		WordType bits = (word >> shift) & 0xFF;
+		for (; rank > 0; --rank)
+			bits &= bits - 1;
+		return shift + static_cast<size_t>(std::countr_zero(bits));
+#endif
+	}
+
+	void CheckIndex(size_t index) const
+	{
+		if (index >= m_size)
+			throw std::out_of_range("index out of range");
+	}
+
+	void ClearUnusedBits() noexcept
+	{
+		if (m_size % WordBits != 0)
+			m_words.Data()[m_size / WordBits] &= Bit(m_size) - 1;
+	}
+
+	template<typename Function>
+	void Combine(const BitVector& other, Function function)
+	{
+		if (other.m_size != m_size)
+			throw std::invalid_argument("BitVector operation on vectors of different sizes");
+		Transform<WordType, WordType>(m_words.Span(), other.m_words.Span(), m_words.Span(), function);
+		m_indexed = false;
+	}
+
+	// Ones or zeros before superblock, counting the padding after the last bit as zeros.
+	template<bool Ones>
+	size_t CountBefore(size_t superblock) const noexcept
+	{
+		size_t ones = static_cast<size_t>(m_superCounts.Data()[superblock]);
+		return Ones ? ones : superblock * SuperBits - ones;
+	}
+
+	template<bool Ones>
+	size_t CountBeforeBlock(size_t block) const noexcept
+	{
+		size_t ones = m_blockCounts.Data()[block];
+		return Ones ? ones : block % SuperBlocks * BlockBits - ones;
+	}
+
+	template<bool Ones>
+	void BuildSamples(Vector<uint64_t>& samples, size_t total) const
+	{
+		samples.Clear();
+		size_t superCount = m_superCounts.Size() - 1;
+		size_t superblock = 0;
+		for (size_t rank = 0; rank < total; rank += SampleRate) {
+			while (superblock + 1 < superCount && CountBefore<Ones>(superblock + 1) <= rank)
+				++superblock;
+			samples.PushBack(superblock);
+		}
+	}
+
+	// Rank, Select and BuildIndex count bits with popcnt where the CPU has it, which the AVX2 instruction set
+	// of Algorithms.h implies, and with the portable bit tricks of std::popcount elsewhere.
+	static bool UsePopcnt() noexcept
+	{
+#ifdef ALGORITHMS_X86
+		return ActiveSimdIsa() >= SimdIsa::Avx2;
+#else
+		return false;
+#endif
+	}
+
+	BITVECTOR_TARGET_POPCNT size_t CountBlocksPopcnt() const
+	{
+		return CountBlocks();
+	}
+
+	BITVECTOR_TARGET_POPCNT size_t RankPopcnt(size_t index) const noexcept
+	{
+		return RankInIndex(index);
+	}
+
+	template<bool Ones>
+	BITVECTOR_TARGET_POPCNT size_t SelectPopcnt(size_t rank) const noexcept
+	{
+		return SelectInIndex<Ones>(rank);
+	}
+
+	// Fills the superblock and block counts and returns the number of set bits.
+	BITVECTOR_INLINE size_t CountBlocks() const
+	{
+		const WordType* words = m_words.Data();
+		size_t wordCount = m_words.Size();
+		size_t blockCount = (wordCount + BlockWords - 1) / BlockWords;
+		size_t superCount = (blockCount + SuperBlocks - 1) / SuperBlocks;
+		m_superCounts.Resize(superCount + 1);
+		m_blockCounts.Resize(blockCount);
+
+		uint64_t* superCounts = m_superCounts.Data();
+		uint16_t* blockCounts = m_blockCounts.Data();
+		uint64_t ones = 0;
+		for (size_t block = 0; block < blockCount; ++block) {
+			if (block % SuperBlocks == 0)
+				superCounts[block / SuperBlocks] = ones;
+			blockCounts[block] = static_cast<uint16_t>(ones - superCounts[block / SuperBlocks]);
+			size_t last = std::min(block * BlockWords + BlockWords, wordCount);
+			for (size_t word = block * BlockWords; word < last; ++word)
+				ones += static_cast<uint64_t>(std::popcount(words[word]));
+		}
+		superCounts[superCount] = ones;
+		return static_cast<size_t>(ones);
+	}
+
+	BITVECTOR_INLINE size_t RankInIndex(size_t index) const noexcept
+	{
+		const WordType* words = m_words.Data();
+		size_t word = index / WordBits;
+		size_t block = word / BlockWords;
+		size_t rank = static_cast<size_t>(m_superCounts.Data()[block / SuperBlocks]) + m_blockCounts.Data()[block];
+		for (size_t i = block * BlockWords; i < word; ++i)
+			rank += static_cast<size_t>(std::popcount(words[i]));
+		return rank + static_cast<size_t>(std::popcount(words[word] & (Bit(index) - 1)));
+	}
+
+	// Narrows down to the superblock by binary search between two samples, then to the block, the word and the
+	// bit. rank must be below the number of ones or zeros.
+	template<bool Ones>
+	BITVECTOR_INLINE size_t SelectInIndex(size_t rank) const noexcept
+	{
+		const Vector<uint64_t>& samples = Ones ? m_oneSamples : m_zeroSamples;
+		size_t sample = rank / SampleRate;
+		size_t low = static_cast<size_t>(samples.Data()[sample]);
+		size_t high = sample + 1 < samples.Size() ? static_cast<size_t>(samples.Data()[sample + 1]) + 1 : m_superCounts.Size() - 1;
+		// The steps select rather than branch, as the comparisons are unpredictable.
+		for (size_t length = high - low; length > 1; length -= length / 2) {
+			size_t middle = low + length / 2;
+			low = CountBefore<Ones>(middle) <= rank ? middle : low;
+		}
+		rank -= CountBefore<Ones>(low);
+
+		size_t firstBlock = low * SuperBlocks;
+		size_t blocks = std::min(SuperBlocks, m_blockCounts.Size() - firstBlock);
+		size_t block = firstBlock;
+		for (size_t i = 1; i < SuperBlocks; ++i)
+			block += i < blocks && CountBeforeBlock<Ones>(firstBlock + i) <= rank;
+		rank -= CountBeforeBlock<Ones>(block);
+
+		const WordType* words = m_words.Data();
+		size_t word = block * BlockWords;
+		for (;; ++word) {
+			WordType bits = Ones ? words[word] : ~words[word];
+			size_t count = static_cast<size_t>(std::popcount(bits));
+			if (rank < count)
+				return word * WordBits + SelectInWord(bits, rank);
+			rank -= count;
+		}
+	}
+
+private:
+	Vector<WordType> m_words;
+	size_t m_size;
+	// The rank and select index, valid while m_indexed is set.
+	mutable Vector<uint64_t> m_superCounts;
+	mutable Vector<uint16_t> m_blockCounts;
+	mutable Vector<uint64_t> m_oneSamples;
+	mutable Vector<uint64_t> m_zeroSamples;
+	mutable bool m_indexed;
+};
+
+#endif //_BITVECTOR_
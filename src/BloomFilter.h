@@ -0,0 +1,226 @@
+#ifndef _BLOOMFILTER_
+#define _BLOOMFILTER_
+
+#include<algorithm>
+#include<atomic>
+#include<cmath>
+#include<cstdint>
+#include<memory>
+
+#include"Hash.h"
+
+#if defined(__AVX2__)
+#include<immintrin.h>
+#define BLOOMFILTER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include<emmintrin.h>
+#define BLOOMFILTER_SSE2
+#endif
+
+struct BloomFilterStats
+{
+	size_t queries = 0;
+	// Queries the filter answered with "absent", each one a skipped table probe.
+	size_t negatives = 0;
+	// Queries the filter let through for keys that turned out to be absent.
+	size_t falsePositives = 0;
+
+	float NegativeRate() const noexcept
+	{
+		return queries == 0 ? 0.0f : static_cast<float>(negatives) / queries;
+	}
+
+	float FalsePositiveRate() const noexcept
+	{
+		return negatives + falsePositives == 0 ? 0.0f : static_cast<float>(falsePositives) / (negatives + falsePositives);
+	}
+};
+
+// Split-block Bloom filter: every key maps to one 32-byte block of eight 32-bit words and sets one bit in each
+// word, so an insert or a query touches a single cache line and the eight bit tests run as one SIMD compare.
+// Keys are given as 64-bit hashes, which are remixed, so weak hashes such as the identity work too. About 10
+// bits per key give a false-positive rate near 1%.
+class BloomFilter
+{
+private:
+	static constexpr size_t BlockWords = 8;
+
+	struct alignas(32) Block
+	{
+		uint32_t words[BlockWords];
+	};
+
+public:
+	static constexpr size_t BlockBits = BlockWords * 32;
+
+public:
+	//Constructors
+	explicit BloomFilter(size_t expectedKeys = 0, double bitsPerKey = 10.0)
+		: m_bitsPerKey(bitsPerKey)
+	{
+		double bits = std::ceil(static_cast<double>(std::max<size_t>(expectedKeys, 1)) * std::max(bitsPerKey, 1.0));
+		m_blockCount = std::max<size_t>(static_cast<size_t>(std::ceil(bits / BlockBits)), 1);
+		m_blocks.reset(new Block[m_blockCount]());
+	}
+
+	BloomFilter(const BloomFilter& other)
+		: m_blocks(new Block[other.m_blockCount]), m_blockCount(other.m_blockCount), m_bitsPerKey(other.m_bitsPerKey)
+	{
+		std::copy(other.m_blocks.get(), other.m_blocks.get() + m_blockCount, m_blocks.get());
+		SetStats(other.Stats());
+	}
+
+	BloomFilter& operator=(const BloomFilter& other)
+	{
+		if (this != &other) {
+			BloomFilter copy(other);
+			std::swap(m_blocks, copy.m_blocks);
+			m_blockCount = copy.m_blockCount;
+			m_bitsPerKey = copy.m_bitsPerKey;
+			SetStats(copy.Stats());
+		}
+		return *this;
+	}
+
+	//Lookup
+	// False means the key was never added; true means it probably was. Counts the query in the statistics.
+	bool MayContain(uint64_t hash) const noexcept
+	{
+		hash = HashMix64(hash);
+		Increment(m_queries);
+		if (Test(m_blocks[BlockIndex(hash)], static_cast<uint32_t>(hash)))
+			return true;
+
+		Increment(m_negatives);
+		return false;
+	}
+
+	// Reports that a key the filter let through was not present after all.
+	void RecordFalsePositive() const noexcept
+	{
+		Increment(m_falsePositives);
+	}
+
+	//Capacity
+	size_t Bytes() const noexcept
+	{
+		return m_blockCount * sizeof(Block);
+	}
+
+	double BitsPerKey() const noexcept
+	{
+		return m_bitsPerKey;
+	}
+
+	//Statistics
+	// Counters are updated without read-modify-writes, so with concurrent readers they are approximate.
+	BloomFilterStats Stats() const noexcept
+	{
+		BloomFilterStats stats;
+		stats.queries = m_queries.load(std::memory_order_relaxed);
+		stats.negatives = m_negatives.load(std::memory_order_relaxed);
+		stats.falsePositives = m_falsePositives.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	void SetStats(const BloomFilterStats& stats) noexcept
+	{
+		m_queries.store(stats.queries, std::memory_order_relaxed);
+		m_negatives.store(stats.negatives, std::memory_order_relaxed);
+		m_falsePositives.store(stats.falsePositives, std::memory_order_relaxed);
+	}
+
+	void ResetStats() noexcept
+	{
+		SetStats(BloomFilterStats());
+	}
+
+	//Modifiers
+	void Add(uint64_t hash) noexcept
+	{
+		hash = HashMix64(hash);
+		Block& block = m_blocks[BlockIndex(hash)];
+		uint32_t masks[BlockWords];
+		Masks(static_cast<uint32_t>(hash), masks);
+		for (size_t i = 0; i < BlockWords; ++i)
+			block.words[i] |= masks[i];
+	}
+
+	void Clear() noexcept
+	{
+		std::fill(m_blocks.get(), m_blocks.get() + m_blockCount, Block{});
+	}
+
+private:
+	// Odd multipliers that derive the eight in-word bit positions from the low half of the hash.
+	static constexpr uint32_t Salts[BlockWords] = {
+		0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du, 0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u };
+
+	static void Masks(uint32_t key, uint32_t* masks) noexcept
+	{
+		for (size_t i = 0; i < BlockWords; ++i)
+			masks[i] = uint32_t{ 1 } << ((key * Salts[i]) >> 27);
+	}
+
+	static bool Test(const Block& block, uint32_t key) noexcept
+	{
+#if defined(BLOOMFILTER_AVX2)
+		const __m256i salts = _mm256_setr_epi32(static_cast<int>(Salts[0]), static_cast<int>(Salts[1]),
+			static_cast<int>(Salts[2]), static_cast<int>(Salts[3]), static_cast<int>(Salts[4]), static_cast<int>(Salts[5]),
+			static_cast<int>(Salts[6]), static_cast<int>(Salts[7]));
+		__m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts), 27);
+		__m256i masks = _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+		return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(block.words)), masks) != 0;
+#elif defined(BLOOMFILTER_SSE2)
+		const __m128i* words = reinterpret_cast<const __m128i*>(block.words);
+		__m128i missing = _mm_or_si128(_mm_andnot_si128(_mm_load_si128(words), MaskVector(key, 0)),
+			_mm_andnot_si128(_mm_load_si128(words + 1), MaskVector(key, 4)));
+		return _mm_movemask_epi8(_mm_cmpeq_epi32(missing, _mm_setzero_si128())) == 0xFFFF;
+#else
+		uint32_t masks[BlockWords];
+		Masks(key, masks);
+		uint32_t missing = 0;
+		for (size_t i = 0; i < BlockWords; ++i)
+			missing |= masks[i] & ~block.words[i];
+		return missing == 0;
+#endif
+	}
+
+#ifdef BLOOMFILTER_SSE2
+	// Masks of words first to first + 3. SSE2 has neither a 32-bit multiply nor per-lane shifts: the products
+	// come from two 32x32->64 multiplies, and 1 << n is built as the float 2^n and converted back, where the
+	// out-of-range conversion of 2^31 happens to yield 0x80000000 as well.
+	static __m128i MaskVector(uint32_t key, size_t first) noexcept
+	{
+		const __m128i keys = _mm_set1_epi32(static_cast<int>(key));
+		const __m128i salts = _mm_setr_epi32(static_cast<int>(Salts[first]), static_cast<int>(Salts[first + 1]),
+			static_cast<int>(Salts[first + 2]), static_cast<int>(Salts[first + 3]));
+		__m128i even = _mm_mul_epu32(keys, salts);
+		__m128i odd = _mm_mul_epu32(keys, _mm_srli_epi64(salts, 32));
+		__m128i products = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		__m128i exponents = _mm_slli_epi32(_mm_add_epi32(_mm_srli_epi32(products, 27), _mm_set1_epi32(127)), 23);
+		return _mm_cvttps_epi32(_mm_castsi128_ps(exponents));
+	}
+#endif
+
+	// The block comes from the high half of the hash by multiply-shift range reduction.
+	size_t BlockIndex(uint64_t hash) const noexcept
+	{
+		return static_cast<size_t>(((hash >> 32) * static_cast<uint64_t>(m_blockCount)) >> 32);
+	}
+
+	static void Increment(std::atomic<size_t>& counter) noexcept
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+private:
+	std::unique_ptr<Block[]> m_blocks;
+	size_t m_blockCount;
+	double m_bitsPerKey;
+	mutable std::atomic<size_t> m_queries{ 0 };
+	mutable std::atomic<size_t> m_negatives{ 0 };
+	mutable std::atomic<size_t> m_falsePositives{ 0 };
+};
+
+#endif //_BLOOMFILTER_
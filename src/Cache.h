@@ -0,0 +1,421 @@
+#ifndef _CACHE_
+#define _CACHE_
+
+#include<algorithm>
+#include<bit>
+#include<cstdint>
+#include<functional>
+#include<memory>
+
+#include"HashTable.h"
+#include"LinkedList.h"
+
+enum class CachePolicy
+{
+	// Evicts the least recently used entry.
+	Lru,
+	// W-TinyLFU: new entries pass through a small LRU window, and an entry leaving it only enters the main
+	// segmented LRU if it has been used more often than the entry it would displace. This keeps one-off scans
+	// from flushing the frequently used entries.
+	WTinyLfu
+};
+
+struct CacheStats
+{
+	size_t hits = 0;
+	size_t misses = 0;
+	size_t evictions = 0;
+
+	float HitRate() const noexcept
+	{
+		return hits + misses == 0 ? 0.0f : static_cast<float>(hits) / (hits + misses);
+	}
+
+	CacheStats& operator+=(const CacheStats& other) noexcept
+	{
+		hits += other.hits;
+		misses += other.misses;
+		evictions += other.evictions;
+		return *this;
+	}
+};
+
+// Default charge of an entry: the size of the key and value objects plus the elements of containers such as
+// std::string that own their storage.
+struct CacheWeigher
+{
+	template<typename Key, typename Value>
+	size_t operator()(const Key& key, const Value& value) const noexcept
+	{
+		return ByteSize(key) + ByteSize(value);
+	}
+
+	template<typename T>
+	static size_t ByteSize(const T& value) noexcept
+	{
+		if constexpr (requires { value.size(); typename T::value_type; })
+			return sizeof(T) + value.size() * sizeof(typename T::value_type);
+		else
+			return sizeof(T);
+	}
+};
+
+// Count-min sketch with four 4-bit counters per key that estimates how often keys were used recently. All
+// counters are halved once the number of recorded uses reaches ten times the table size, so old popularity ages
+// out.
+class FrequencySketch
+{
+public:
+	explicit FrequencySketch(size_t entries = 16)
+	{
+		Resize(entries);
+	}
+
+	// Grows the table to suit the number of cached entries. The counters of a key keep the low bits of their
+	// positions when the table doubles, so copying the old table into every part of the new one keeps all counts.
+	void EnsureCapacity(size_t entries)
+	{
+		if (entries <= m_words)
+			return;
+		size_t oldWords = m_words;
+		std::unique_ptr<uint64_t[]> old = std::move(m_table);
+		size_t additions = m_additions;
+		Resize(entries * 2);
+		for (size_t i = 0; i < m_words; ++i)
+			m_table[i] = old[i & (oldWords - 1)];
+		m_additions = additions;
+	}
+
+	void Increment(uint64_t hash) noexcept
+	{
+		bool added = false;
+		for (uint64_t i = 0; i < 4; ++i) {
+			size_t counter = Counter(hash, i);
+			uint64_t& word = m_table[counter >> 4];
+			size_t shift = (counter & 15) * 4;
+			if (((word >> shift) & 15) != 15) {
+				word += uint64_t{ 1 } << shift;
+				added = true;
+			}
+		}
+
+		if (added && ++m_additions >= m_sampleSize)
+			Age();
+	}
+
+	unsigned Estimate(uint64_t hash) const noexcept
+	{
+		unsigned frequency = 15;
+		for (uint64_t i = 0; i < 4; ++i) {
+			size_t counter = Counter(hash, i);
+			frequency = std::min(frequency, static_cast<unsigned>((m_table[counter >> 4] >> ((counter & 15) * 4)) & 15));
+		}
+		return frequency;
+	}
+
+private:
+	void Resize(size_t entries)
+	{
+		m_words = std::bit_ceil(std::max<size_t>(entries, 16));
+		m_table.reset(new uint64_t[m_words]());
+		m_sampleSize = 10 * m_words;
+		m_additions = 0;
+	}
+
+	void Age() noexcept
+	{
+		for (size_t i = 0; i < m_words; ++i)
+			m_table[i] = (m_table[i] >> 1) & 0x7777777777777777ull;
+		m_additions /= 2;
+	}
+
+	size_t Counter(uint64_t hash, uint64_t row) const noexcept
+	{
+		return static_cast<size_t>(HashMix64(hash, row)) & (m_words * 16 - 1);
+	}
+
+	std::unique_ptr<uint64_t[]> m_table;
+	size_t m_words = 0;
+	size_t m_sampleSize = 0;
+	size_t m_additions = 0;
+};
+
+// Bounded key-value cache with O(1) Get, Put and eviction. A HashTable maps each key to its node in one of the
+// LinkedList segments, and a hit only relinks that node. The capacity is a number of bytes, and every entry is
+// charged Weigher()(key, value) against it.
+template<typename Key, typename Value, CachePolicy Policy = CachePolicy::Lru, typename Weigher = CacheWeigher,
+	typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+class Cache
+{
+private:
+	enum class Segment : uint8_t { Window, Probation, Protected };
+
+	struct Entry
+	{
+		Key key;
+		Value value;
+		size_t charge;
+		Segment segment;
+	};
+
+	using List = LinkedList<Entry>;
+	using Handle = typename List::Iterator;
+
+	// Share of the capacity given to the W-TinyLFU admission window, and to the protected part of the main space.
+	static constexpr size_t WindowPercent = 1;
+	static constexpr size_t ProtectedPercent = 80;
+
+public:
+	using ValueType = Value;
+	using KeyType = Key;
+public:
+	//Constructors
+	explicit Cache(size_t capacityBytes, const Weigher& weigher = Weigher(), const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+		: m_index(16, 1.0f, hash, equal), m_weigher(weigher)
+	{
+		SetCapacity(capacityBytes);
+	}
+
+	Cache(const Cache&) = delete;
+	Cache& operator=(const Cache&) = delete;
+
+	//Lookup
+	// Returns the cached value and marks it as recently used, or nullptr on a miss. The pointer stays valid
+	// until the entry is erased or evicted.
+	Value* Get(const Key& key)
+	{
+		Handle* handle = m_index.Find(key);
+		if constexpr (Policy == CachePolicy::WTinyLfu)
+			m_sketch.Increment(KeyHash(key));
+		if (handle == nullptr) {
+			++m_stats.misses;
+			return nullptr;
+		}
+
+		++m_stats.hits;
+		Touch(*handle);
+		return &(**handle).value;
+	}
+
+	// Looks the key up without counting a hit or changing the eviction order.
+	bool Contains(const Key& key) const
+	{
+		return m_index.Contains(key);
+	}
+
+	//Capacity
+	size_t Count() const noexcept
+	{
+		return m_index.Count();
+	}
+
+	bool IsEmpty() const noexcept
+	{
+		return Count() == 0;
+	}
+
+	// Sum of the charges of all cached entries.
+	size_t Bytes() const noexcept
+	{
+		return m_windowBytes + m_probationBytes + m_protectedBytes;
+	}
+
+	size_t Capacity() const noexcept
+	{
+		return m_capacity;
+	}
+
+	// Changes the capacity, evicting entries right away if they no longer fit.
+	void SetCapacity(size_t capacityBytes)
+	{
+		m_capacity = capacityBytes;
+		if constexpr (Policy == CachePolicy::WTinyLfu) {
+			m_windowCapacity = std::max<size_t>(capacityBytes * WindowPercent / 100, 1);
+			m_protectedCapacity = (capacityBytes - std::min(m_windowCapacity, capacityBytes)) * ProtectedPercent / 100;
+		}
+		else {
+			m_windowCapacity = capacityBytes;
+			m_protectedCapacity = 0;
+		}
+		Evict();
+	}
+
+	CacheStats Stats() const noexcept
+	{
+		return m_stats;
+	}
+
+	void ResetStats() noexcept
+	{
+		m_stats = CacheStats();
+	}
+
+	//Modifiers
+	// Inserts or replaces the value of the key and evicts entries until the cache fits its capacity again. An
+	// entry larger than the whole capacity is not kept.
+	void Put(const Key& key, const Value& value)
+	{
+		size_t charge = m_weigher(key, value);
+		Handle* handle = m_index.Find(key);
+		if (handle != nullptr) {
+			Entry& entry = **handle;
+			SegmentBytes(entry.segment) += charge;
+			SegmentBytes(entry.segment) -= entry.charge;
+			entry.value = value;
+			entry.charge = charge;
+			Touch(*handle);
+		}
+		else {
+			if constexpr (Policy == CachePolicy::WTinyLfu) {
+				m_sketch.EnsureCapacity(Count() + 1);
+				m_sketch.Increment(KeyHash(key));
+			}
+			m_index.Insert(key, m_window.PushFront(Entry{ key, value, charge, Segment::Window }));
+			m_windowBytes += charge;
+		}
+		Evict();
+	}
+
+	bool Erase(const Key& key)
+	{
+		Handle* handle = m_index.Find(key);
+		if (handle == nullptr)
+			return false;
+
+		Remove(*handle);
+		return true;
+	}
+
+	void Clear()
+	{
+		m_index.Clear();
+		m_window.Clear();
+		m_probation.Clear();
+		m_protected.Clear();
+		m_windowBytes = m_probationBytes = m_protectedBytes = 0;
+	}
+
+private:
+	// The full hash of the key for the sketch. HashFunction of the index gives the bucket, which is shared by
+	// other keys and changes when the index grows.
+	uint64_t KeyHash(const Key& key) const
+	{
+		return static_cast<uint64_t>(m_index.HashFunctionObject()(key));
+	}
+
+	List& SegmentList(Segment segment) noexcept
+	{
+		return segment == Segment::Window ? m_window : segment == Segment::Probation ? m_probation : m_protected;
+	}
+
+	size_t& SegmentBytes(Segment segment) noexcept
+	{
+		return segment == Segment::Window ? m_windowBytes : segment == Segment::Probation ? m_probationBytes : m_protectedBytes;
+	}
+
+	void MoveTo(Handle handle, Segment segment)
+	{
+		Entry& entry = *handle;
+		SegmentBytes(entry.segment) -= entry.charge;
+		SegmentList(segment).Splice(SegmentList(segment).begin(), SegmentList(entry.segment), handle);
+		SegmentBytes(segment) += entry.charge;
+		entry.segment = segment;
+	}
+
+	// A hit in the probation segment promotes the entry to the protected one, whose least recently used
+	// entries fall back to probation when it overflows.
+	void Touch(Handle handle)
+	{
+		Entry& entry = *handle;
+		if (entry.segment != Segment::Probation) {
+			SegmentList(entry.segment).MoveToFront(handle);
+			return;
+		}
+
+		MoveTo(handle, Segment::Protected);
+		while (m_protectedBytes > m_protectedCapacity && m_protected.Size() > 1)
+			MoveTo(m_protected.Last(), Segment::Probation);
+	}
+
+	void Remove(Handle handle)
+	{
+		Entry& entry = *handle;
+		SegmentBytes(entry.segment) -= entry.charge;
+		m_index.Erase(entry.key);
+		SegmentList(entry.segment).Erase(handle);
+	}
+
+	void EvictEntry(Handle handle)
+	{
+		++m_stats.evictions;
+		Remove(handle);
+	}
+
+	void Evict()
+	{
+		if constexpr (Policy == CachePolicy::WTinyLfu)
+			EvictWindow();
+
+		while (Bytes() > m_capacity) {
+			if (!m_probation.Empty())
+				EvictEntry(m_probation.Last());
+			else if (!m_protected.Empty())
+				EvictEntry(m_protected.Last());
+			else
+				EvictEntry(m_window.Last());
+		}
+	}
+
+	// Entries overflowing the window become candidates for the main space. While a candidate does not fit, it
+	// competes with the main space's victim, the least recently used probation entry, and the one used less
+	// often according to the sketch is evicted; ties favour the incumbent.
+	void EvictWindow()
+	{
+		const size_t mainCapacity = m_capacity - std::min(m_windowCapacity, m_capacity);
+		while (m_windowBytes > m_windowCapacity && !m_window.Empty()) {
+			Handle candidate = m_window.Last();
+			bool admitted = true;
+			while ((*candidate).charge + m_probationBytes + m_protectedBytes > mainCapacity) {
+				if (m_probation.Empty() && m_protected.Empty()) {
+					admitted = false;
+					break;
+				}
+
+				Handle victim = m_probation.Empty() ? m_protected.Last() : m_probation.Last();
+				if (m_sketch.Estimate(KeyHash((*candidate).key)) <= m_sketch.Estimate(KeyHash((*victim).key))) {
+					admitted = false;
+					break;
+				}
+				EvictEntry(victim);
+			}
+
+			if (admitted)
+				MoveTo(candidate, Segment::Probation);
+			else
+				EvictEntry(candidate);
+		}
+	}
+
+private:
+	HashTable<Key, Handle, Hash, KeyEqual, PowerOfTwoBuckets> m_index;
+	List m_window;
+	List m_probation;
+	List m_protected;
+	size_t m_capacity = 0;
+	size_t m_windowCapacity = 0;
+	size_t m_protectedCapacity = 0;
+	size_t m_windowBytes = 0;
+	size_t m_probationBytes = 0;
+	size_t m_protectedBytes = 0;
+	FrequencySketch m_sketch;
+	Weigher m_weigher;
+	CacheStats m_stats;
+};
+
+template<typename Key, typename Value, typename Weigher = CacheWeigher, typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+using LruCache = Cache<Key, Value, CachePolicy::Lru, Weigher, Hash, KeyEqual>;
+
+template<typename Key, typename Value, typename Weigher = CacheWeigher, typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+using TinyLfuCache = Cache<Key, Value, CachePolicy::WTinyLfu, Weigher, Hash, KeyEqual>;
+
+#endif //_CACHE_
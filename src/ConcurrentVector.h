@@ -0,0 +1,283 @@
+#ifndef _CONCURRENTVECTOR_
+#define _CONCURRENTVECTOR_
+
+#include<algorithm>
+#include<atomic>
+#include<bit>
+#include<cstddef>
+#include<iterator>
+#include<memory>
+#include<new>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+template<typename ConcurrentVector>
+class ConcIterator
+{
+public:
+	using ValueType = std::conditional_t<std::is_const_v<ConcurrentVector>,
+		const typename ConcurrentVector::ValueType, typename ConcurrentVector::ValueType>;
+	using PointerType = ValueType*;
+	using ReferenceType = ValueType&;
+
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = std::remove_const_t<ValueType>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = PointerType;
+	using reference = ReferenceType;
+public:
+	ConcIterator() noexcept : m_vector(nullptr), m_index(0) {}
+	ConcIterator(ConcurrentVector* vector, size_t index) noexcept : m_vector(vector), m_index(index) {}
+
+	PointerType operator->() const noexcept { return &**this; }
+	ReferenceType operator*() const noexcept { return m_vector->Element(m_index); }
+
+	bool operator==(const ConcIterator& other) const noexcept { return m_index == other.m_index; }
+	bool operator!=(const ConcIterator& other) const noexcept { return m_index != other.m_index; }
+
+	ConcIterator& operator++() noexcept { ++m_index; return *this; }
+	ConcIterator operator++(int) noexcept {
+		ConcIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+	ConcIterator& operator--() noexcept { --m_index; return *this; }
+	ConcIterator operator--(int) noexcept {
+		ConcIterator iterator = *this;
+		--(*this);
+		return iterator;
+	}
+
+private:
+	ConcurrentVector* m_vector;
+	size_t m_index;
+};
+
+// Append-only vector that any number of threads may push to and read from at once. PushBack claims an index with
+// one fetch_add, constructs the element in place and then publishes it through a per-element flag, so appenders
+// never wait for each other. Storage grows by adding segments that double in size, FirstSegmentSize elements
+// first. The appender that claims the first index of a segment allocates the next one, a whole segment before it
+// is needed, so appenders seldom find a segment missing and race to allocate it. A segment never moves, so a
+// reader that found an element can keep using it while other threads append. Reading an element is wait-free:
+// two acquire loads and the element. Size counts claimed indices, so an element below Size may not be published
+// yet; TryGet tells. Clear, the iterators and destruction need all appenders to be finished.
+template<typename T, size_t FirstSegmentSize = 64>
+class ConcurrentVector
+{
+	static_assert(std::has_single_bit(FirstSegmentSize), "the first segment size of a ConcurrentVector must be a power of two");
+
+	template<typename> friend class ConcIterator;
+
+public:
+	using ValueType = T;
+	using Iterator = ConcIterator<ConcurrentVector>;
+	using ConstIterator = ConcIterator<const ConcurrentVector>;
+public:
+	//Constructors
+	ConcurrentVector() noexcept : m_segments{}, m_size(0) {}
+
+	ConcurrentVector(const ConcurrentVector&) = delete;
+	ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+	~ConcurrentVector()
+	{
+		Clear();
+		for (size_t k = 0; k < SegmentCount; ++k) {
+			if (Segment* segment = m_segments[k].load(std::memory_order_relaxed))
+				FreeSegment(segment, k);
+		}
+	}
+
+	//Operators
+	// The element at index, which must have been published. Throws std::out_of_range otherwise.
+	const T& operator[](size_t index) const
+	{
+		const T* element = TryGet(index);
+		if (element == nullptr)
+			throw std::out_of_range("index out of range or not yet published");
+		return *element;
+	}
+
+	T& operator[](size_t index)
+	{
+		return const_cast<T&>(std::as_const(*this)[index]);
+	}
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return Size() == 0;
+	}
+
+	// Number of indices handed out, including elements that are still being constructed.
+	size_t Size() const noexcept
+	{
+		return m_size.load(std::memory_order_acquire);
+	}
+
+	// Allocates the segments that hold the first capacity elements. Safe to call while others append.
+	void Reserve(size_t capacity)
+	{
+		if (capacity == 0)
+			return;
+		for (size_t k = 0; k <= SegmentOf(capacity - 1); ++k)
+			GetSegment(k);
+	}
+
+	//Element access
+	// The element at index if it is published, or else nullptr. Wait-free.
+	const T* TryGet(size_t index) const noexcept
+	{
+		if (index >= Size())
+			return nullptr;
+		size_t k = SegmentOf(index);
+		Segment* segment = m_segments[k].load(std::memory_order_acquire);
+		if (segment == nullptr)
+			return nullptr;
+		size_t offset = index - SegmentStart(k);
+		if (!segment->Published(k)[offset].load(std::memory_order_acquire))
+			return nullptr;
+		return segment->Elements() + offset;
+	}
+
+	T* TryGet(size_t index) noexcept
+	{
+		return const_cast<T*>(std::as_const(*this).TryGet(index));
+	}
+
+	//Modifiers
+	size_t PushBack(const T& value)
+	{
+		return EmplaceBack(value);
+	}
+
+	size_t PushBack(T&& value)
+	{
+		return EmplaceBack(std::move(value));
+	}
+
+	// Constructs an element at the next free index and returns that index once the element is published. If the
+	// constructor or a segment allocation throws, the index stays claimed and never becomes published.
+	template<typename... Args>
+	size_t EmplaceBack(Args&&... args)
+	{
+		size_t index = m_size.fetch_add(1, std::memory_order_relaxed);
+		size_t k = SegmentOf(index);
+		Segment* segment = GetSegment(k);
+		size_t offset = index - SegmentStart(k);
+		if (offset == 0 && k + 1 < SegmentCount)
+			GetSegment(k + 1);
+		::new (static_cast<void*>(segment->Elements() + offset)) T(std::forward<Args>(args)...);
+		segment->Published(k)[offset].store(true, std::memory_order_release);
+		return index;
+	}
+
+	//Operations
+	// Destroys the elements but keeps the segments. No thread may append or read meanwhile.
+	void Clear() noexcept
+	{
+		size_t size = m_size.load(std::memory_order_relaxed);
+		for (size_t k = 0; k < SegmentCount && SegmentStart(k) < size; ++k) {
+			Segment* segment = m_segments[k].load(std::memory_order_relaxed);
+			if (segment == nullptr)
+				continue;
+			for (size_t offset = 0; offset < SegmentSize(k) && SegmentStart(k) + offset < size; ++offset) {
+				if (segment->Published(k)[offset].load(std::memory_order_relaxed)) {
+					std::destroy_at(segment->Elements() + offset);
+					segment->Published(k)[offset].store(false, std::memory_order_relaxed);
+				}
+			}
+		}
+		m_size.store(0, std::memory_order_relaxed);
+	}
+
+	//Iterators
+	// Walk [0, Size()) and require every element in it to be published, so use them once the appenders are done.
+	Iterator begin() { return Iterator(this, 0); };
+	Iterator end() { return Iterator(this, Size()); };
+	ConstIterator begin() const { return ConstIterator(this, 0); };
+	ConstIterator end() const { return ConstIterator(this, Size()); };
+
+private:
+	// A segment allocation: the elements, followed by one published flag per element.
+	struct Segment
+	{
+		T* Elements() noexcept
+		{
+			return reinterpret_cast<T*>(this);
+		}
+
+		std::atomic<bool>* Published(size_t k) noexcept
+		{
+			return reinterpret_cast<std::atomic<bool>*>(reinterpret_cast<unsigned char*>(this) + SegmentSize(k) * sizeof(T));
+		}
+	};
+
+	// Segment k holds FirstSegmentSize << k elements, enough segments for any size_t index.
+	static constexpr size_t SegmentCount = 64 - std::countr_zero(FirstSegmentSize);
+	static constexpr size_t Alignment = std::max(alignof(T), alignof(std::atomic<bool>));
+
+	static constexpr size_t SegmentSize(size_t k) noexcept
+	{
+		return FirstSegmentSize << k;
+	}
+
+	static constexpr size_t SegmentStart(size_t k) noexcept
+	{
+		return FirstSegmentSize * ((size_t{ 1 } << k) - 1);
+	}
+
+	static constexpr size_t SegmentOf(size_t index) noexcept
+	{
+		return static_cast<size_t>(std::bit_width(index / FirstSegmentSize + 1)) - 1;
+	}
+
+	static size_t SegmentBytes(size_t k) noexcept
+	{
+		return SegmentSize(k) * (sizeof(T) + sizeof(std::atomic<bool>));
+	}
+
+	// Returns segment k, allocating it if no thread has yet. Segments are normally allocated ahead by EmplaceBack,
+	// so racing here is rare; threads that lose the race free their copy.
+	Segment* GetSegment(size_t k)
+	{
+		Segment* segment = m_segments[k].load(std::memory_order_acquire);
+		if (segment != nullptr)
+			return segment;
+
+		Segment* created = static_cast<Segment*>(::operator new(SegmentBytes(k), std::align_val_t(Alignment)));
+		std::atomic<bool>* published = created->Published(k);
+		for (size_t i = 0; i < SegmentSize(k); ++i)
+			::new (static_cast<void*>(published + i)) std::atomic<bool>(false);
+
+		if (m_segments[k].compare_exchange_strong(segment, created, std::memory_order_acq_rel, std::memory_order_acquire))
+			return created;
+		FreeSegment(created, k);
+		return segment;
+	}
+
+	static void FreeSegment(Segment* segment, size_t k) noexcept
+	{
+		::operator delete(segment, SegmentBytes(k), std::align_val_t(Alignment));
+	}
+
+	// Unchecked access for the iterators.
+	T& Element(size_t index) noexcept
+	{
+		size_t k = SegmentOf(index);
+		return m_segments[k].load(std::memory_order_acquire)->Elements()[index - SegmentStart(k)];
+	}
+
+	const T& Element(size_t index) const noexcept
+	{
+		size_t k = SegmentOf(index);
+		return m_segments[k].load(std::memory_order_acquire)->Elements()[index - SegmentStart(k)];
+	}
+
+private:
+	std::atomic<Segment*> m_segments[SegmentCount];
+	alignas(64) std::atomic<size_t> m_size;
+};
+
+#endif //_CONCURRENTVECTOR_
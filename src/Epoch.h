@@ -0,0 +1,218 @@
+#ifndef _EPOCH_
+#define _EPOCH_
+
+#include<atomic>
+#include<cstdint>
+#include<mutex>
+#include<stdexcept>
+
+// Epoch-based memory reclamation for the lock-free containers. A thread that reads shared nodes holds an
+// EpochReclaimer::Guard; a writer that unlinks a node retires it, and the node is only freed once every thread
+// that was inside a guard at the time has left it. Entering a guard is a store and a fence, never a
+// read-modify-write, so guarded readers do not contend on any shared cache line.
+class EpochReclaimer
+{
+private:
+	static constexpr uint64_t Idle = UINT64_MAX;
+	static constexpr size_t MaxThreads = 256;
+	// Number of objects a thread retires between attempts to advance the epoch and free them.
+	static constexpr size_t ReclaimThreshold = 64;
+
+	struct Retired
+	{
+		void* pointer;
+		void (*deleter)(void*);
+		uint64_t epoch;
+		Retired* next;
+	};
+
+	struct alignas(64) Slot
+	{
+		std::atomic<uint64_t> epoch{ Idle };
+		std::atomic<bool> used{ false };
+	};
+
+	struct Shared
+	{
+		~Shared()
+		{
+			FreeList(orphans.load(std::memory_order_relaxed));
+		}
+
+		std::atomic<uint64_t> epoch{ 0 };
+		Slot slots[MaxThreads];
+		std::mutex orphanMutex;
+		// Written under orphanMutex; atomic so that Reclaim can skip the lock while the list is empty.
+		std::atomic<Retired*> orphans{ nullptr };
+	};
+
+	struct ThreadState
+	{
+		ThreadState()
+		{
+			Shared& shared = GetShared();
+			for (size_t i = 0; i < MaxThreads; ++i) {
+				bool expected = false;
+				if (!shared.slots[i].used.load(std::memory_order_relaxed) &&
+					shared.slots[i].used.compare_exchange_strong(expected, true)) {
+					slot = &shared.slots[i];
+					return;
+				}
+			}
+			throw std::runtime_error("EpochReclaimer: too many threads");
+		}
+
+		// Objects a finished thread could not free yet are handed to the shared orphan list.
+		~ThreadState()
+		{
+			Reclaim(*this);
+			if (retired != nullptr) {
+				Shared& shared = GetShared();
+				std::lock_guard lock(shared.orphanMutex);
+				Retired* last = retired;
+				while (last->next != nullptr)
+					last = last->next;
+				last->next = shared.orphans.load(std::memory_order_relaxed);
+				shared.orphans.store(retired, std::memory_order_relaxed);
+			}
+			slot->epoch.store(Idle, std::memory_order_release);
+			slot->used.store(false, std::memory_order_release);
+		}
+
+		Slot* slot = nullptr;
+		size_t nesting = 0;
+		Retired* retired = nullptr;
+		size_t retiredCount = 0;
+		size_t reclaimAt = ReclaimThreshold;
+	};
+
+public:
+	// Marks the calling thread as reading shared nodes for its lifetime. Guards nest and are bound to the thread
+	// that created them.
+	class Guard
+	{
+	public:
+		Guard() { Enter(); }
+		Guard(const Guard&) { Enter(); }
+		Guard& operator=(const Guard&) { return *this; }
+		~Guard() { Leave(); }
+	};
+
+	template<typename T>
+	static void Retire(T* pointer)
+	{
+		Retire(pointer, [](void* p) { delete static_cast<T*>(p); });
+	}
+
+	// Frees the object with deleter once no thread can still see it.
+	static void Retire(void* pointer, void (*deleter)(void*))
+	{
+		ThreadState& state = Local();
+		uint64_t epoch = GetShared().epoch.load(std::memory_order_acquire);
+		state.retired = new Retired{ pointer, deleter, epoch, state.retired };
+		if (++state.retiredCount >= state.reclaimAt)
+			Reclaim(state);
+	}
+
+private:
+	static Shared& GetShared()
+	{
+		static Shared shared;
+		return shared;
+	}
+
+	static ThreadState& Local()
+	{
+		thread_local ThreadState state;
+		return state;
+	}
+
+	static void Enter()
+	{
+		ThreadState& state = Local();
+		if (state.nesting++ != 0)
+			return;
+
+		// Announce the current epoch and make the announcement visible before any shared node is read.
+		std::atomic<uint64_t>& global = GetShared().epoch;
+		uint64_t epoch;
+		do {
+			epoch = global.load(std::memory_order_relaxed);
+			state.slot->epoch.store(epoch, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		} while (epoch != global.load(std::memory_order_relaxed));
+	}
+
+	static void Leave()
+	{
+		ThreadState& state = Local();
+		if (--state.nesting == 0)
+			state.slot->epoch.store(Idle, std::memory_order_release);
+	}
+
+	// The epoch moves forward once every thread inside a guard has observed the current one.
+	static void TryAdvance()
+	{
+		Shared& shared = GetShared();
+		uint64_t epoch = shared.epoch.load(std::memory_order_acquire);
+		for (const Slot& slot : shared.slots) {
+			uint64_t announced = slot.epoch.load(std::memory_order_acquire);
+			if (announced != Idle && announced != epoch)
+				return;
+		}
+		shared.epoch.compare_exchange_strong(epoch, epoch + 1);
+	}
+
+	// An object retired in epoch e can no longer be referenced once the global epoch reached e + 2.
+	static void Reclaim(ThreadState& state)
+	{
+		TryAdvance();
+		Shared& shared = GetShared();
+		uint64_t epoch = shared.epoch.load(std::memory_order_acquire);
+
+		state.retiredCount = 0;
+		for (Retired** link = &state.retired; *link != nullptr;) {
+			Retired* retired = *link;
+			if (retired->epoch + 2 <= epoch) {
+				*link = retired->next;
+				retired->deleter(retired->pointer);
+				delete retired;
+			}
+			else {
+				link = &retired->next;
+				++state.retiredCount;
+			}
+		}
+		// Objects still pending are not rescanned until another ReclaimThreshold have been retired.
+		state.reclaimAt = state.retiredCount + ReclaimThreshold;
+
+		if (shared.orphans.load(std::memory_order_relaxed) != nullptr && shared.orphanMutex.try_lock()) {
+			Retired* orphans = shared.orphans.load(std::memory_order_relaxed);
+			for (Retired** link = &orphans; *link != nullptr;) {
+				Retired* retired = *link;
+				if (retired->epoch + 2 <= epoch) {
+					*link = retired->next;
+					retired->deleter(retired->pointer);
+					delete retired;
+				}
+				else {
+					link = &retired->next;
+				}
+			}
+			shared.orphans.store(orphans, std::memory_order_relaxed);
+			shared.orphanMutex.unlock();
+		}
+	}
+
+	static void FreeList(Retired* retired)
+	{
+		while (retired != nullptr) {
+			Retired* next = retired->next;
+			retired->deleter(retired->pointer);
+			delete retired;
+			retired = next;
+		}
+	}
+};
+
+#endif //_EPOCH_
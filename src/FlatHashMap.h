@@ -0,0 +1,452 @@
+#ifndef _FLATHASHMAP_
+#define _FLATHASHMAP_
+
+#include<bit>
+#include<cstdint>
+#include<cstring>
+#include<functional>
+#include<new>
+#include<utility>
+
+#include"Hash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include<emmintrin.h>
+#define FLATHASHMAP_SSE2
+#endif
+
+// Sixteen control bytes probed at once. A control byte is either Empty (high bit set) or the low 7 bits
+// of the hash of the key stored in the matching slot. Bit i of a returned mask refers to byte i of the group.
+class FlatGroup
+{
+public:
+	static constexpr size_t Width = 16;
+	static constexpr int8_t Empty = -128;
+
+public:
+	explicit FlatGroup(const int8_t* ctrl) noexcept
+	{
+#ifdef FLATHASHMAP_SSE2
+		m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+		std::memcpy(m_ctrl, ctrl, Width);
+#endif
+	}
+
+	uint32_t Match(int8_t h2) const noexcept
+	{
+#ifdef FLATHASHMAP_SSE2
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+#else
+		uint32_t mask = 0;
+		for (size_t i = 0; i < Width; ++i)
+			mask |= static_cast<uint32_t>(m_ctrl[i] == h2) << i;
+		return mask;
+#endif
+	}
+
+	uint32_t MatchEmpty() const noexcept
+	{
+#ifdef FLATHASHMAP_SSE2
+		return static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl));
+#else
+		uint32_t mask = 0;
+		for (size_t i = 0; i < Width; ++i)
+			mask |= static_cast<uint32_t>(m_ctrl[i] < 0) << i;
+		return mask;
+#endif
+	}
+
+private:
+#ifdef FLATHASHMAP_SSE2
+	__m128i m_ctrl;
+#else
+	int8_t m_ctrl[Width];
+#endif
+};
+
+template<typename FlatHashMap>
+class FlatHashIterator
+{
+public:
+	using ValueType = typename FlatHashMap::ValueType;
+	using KeyType = typename FlatHashMap::KeyType;
+	using ReferenceType = ValueType&;
+	using PointerType = ValueType*;
+
+public:
+	explicit FlatHashIterator(const int8_t* ctrl, KeyType* keys, ValueType* values, size_t index, size_t size) noexcept
+		: m_ctrl(ctrl), m_keys(keys), m_values(values), m_index(index), m_size(size)
+	{
+		SkipEmpty();
+	}
+
+	ReferenceType operator*() const noexcept { return m_values[m_index]; }
+
+	const ReferenceType Value() const noexcept { return m_values[m_index]; }
+	const KeyType& Key() const noexcept { return m_keys[m_index]; }
+	PointerType operator->() const noexcept { return &m_values[m_index]; }
+	bool operator==(const FlatHashIterator& other) const noexcept { return m_index == other.m_index; }
+	bool operator!=(const FlatHashIterator& other) const noexcept { return m_index != other.m_index; }
+	FlatHashIterator& operator++() noexcept
+	{
+		++m_index;
+		SkipEmpty();
+		return *this;
+	}
+	FlatHashIterator operator++(int) noexcept
+	{
+		FlatHashIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+
+private:
+	void SkipEmpty() noexcept
+	{
+		while (m_index < m_size && m_ctrl[m_index] < 0)
+			++m_index;
+	}
+
+private:
+	const int8_t* m_ctrl;
+	KeyType* m_keys;
+	ValueType* m_values;
+	size_t m_index;
+	size_t m_size;
+};
+
+// Open-addressing hash map in the style of Swiss tables. Keys and values live in two flat slot arrays and a
+// separate control byte per slot holds 7 bits of the key's hash, so a probe compares sixteen slots with a
+// single SIMD instruction and touches the key array only on a likely hit. Probing is linear, which lets Erase
+// shift the following entries back instead of leaving tombstones that would lengthen later probes.
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+private:
+	// Maximum load is MaxLoadNumerator / MaxLoadDenominator of the slots.
+	static constexpr size_t MaxLoadNumerator = 7;
+	static constexpr size_t MaxLoadDenominator = 8;
+
+public:
+	using ValueType = Value;
+	using KeyType = Key;
+	using Iterator = FlatHashIterator<FlatHashMap>;
+	using Hasher = Hash;
+	using KeyEqualType = KeyEqual;
+public:
+	//Constructors
+	FlatHashMap(size_t size = FlatGroup::Width, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+		: m_hash(hash), m_equal(equal)
+	{
+		Allocate(RoundUpCapacity(size));
+	}
+
+	FlatHashMap(const FlatHashMap& other) : m_hash(other.m_hash), m_equal(other.m_equal)
+	{
+		Allocate(other.m_size);
+		std::memcpy(m_ctrl, other.m_ctrl, m_size + FlatGroup::Width - 1);
+		for (size_t i = 0; i < m_size; ++i) {
+			if (m_ctrl[i] >= 0) {
+				new(&m_keys[i]) Key(other.m_keys[i]);
+				new(&m_values[i]) Value(other.m_values[i]);
+			}
+		}
+		m_count = other.m_count;
+	}
+
+	FlatHashMap(FlatHashMap&& other) noexcept
+		: m_ctrl(other.m_ctrl), m_keys(other.m_keys), m_values(other.m_values), m_size(other.m_size), m_count(other.m_count),
+		m_hash(other.m_hash), m_equal(other.m_equal)
+	{
+		other.m_ctrl = nullptr;
+		other.m_keys = nullptr;
+		other.m_values = nullptr;
+		other.m_size = 0;
+		other.m_count = 0;
+	}
+
+	~FlatHashMap()
+	{
+		Clear();
+		Deallocate();
+	}
+
+	//Operators
+	FlatHashMap& operator=(const FlatHashMap& other)
+	{
+		if (this == &other)
+			return *this;
+
+		FlatHashMap(other).Swap(*this);
+		return *this;
+	}
+
+	FlatHashMap& operator=(FlatHashMap&& other) noexcept
+	{
+		FlatHashMap moved(std::move(other));
+		Swap(moved);
+		return *this;
+	}
+
+	bool operator==(const FlatHashMap& other) const
+	{
+		if (m_count != other.m_count)
+			return false;
+
+		for (size_t i = 0; i < m_size; ++i) {
+			if (m_ctrl[i] < 0)
+				continue;
+			const Value* otherValue = other.Find(m_keys[i]);
+			if (otherValue == nullptr || *otherValue != m_values[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	bool operator!=(const FlatHashMap& other) const
+	{
+		return !(*this == other);
+	}
+
+	Value& operator[](const Key& key)
+	{
+		size_t hash = HashOf(key);
+		size_t index = FindIndex(key, hash);
+		if (index != m_size)
+			return m_values[index];
+
+		return EmplaceSlot(key, Value{}, hash);
+	}
+
+	//Lookup
+	Value* Find(const Key& key)
+	{
+		size_t index = FindIndex(key, HashOf(key));
+		return index != m_size ? &m_values[index] : nullptr;
+	}
+
+	const Value* Find(const Key& key) const
+	{
+		size_t index = FindIndex(key, HashOf(key));
+		return index != m_size ? &m_values[index] : nullptr;
+	}
+
+	bool Contains(const Key& key) const
+	{
+		return FindIndex(key, HashOf(key)) != m_size;
+	}
+
+	//Capacity
+	// Number of slots.
+	size_t Size() const noexcept
+	{
+		return m_size;
+	}
+
+	// Number of stored elements.
+	size_t Count() const noexcept
+	{
+		return m_count;
+	}
+
+	bool IsEmpty() const noexcept
+	{
+		return m_count == 0;
+	}
+
+	float LoadFactor() const noexcept
+	{
+		return static_cast<float>(m_count) / static_cast<float>(m_size);
+	}
+
+	void Reserve(size_t count)
+	{
+		size_t size = RoundUpCapacity(count * MaxLoadDenominator / MaxLoadNumerator + 1);
+		if (size > m_size)
+			Resize(size);
+	}
+
+	//Modifiers
+	void Clear()
+	{
+		for (size_t i = 0; i < m_size; ++i) {
+			if (m_ctrl[i] >= 0) {
+				m_keys[i].~Key();
+				m_values[i].~Value();
+			}
+		}
+		if (m_ctrl != nullptr)
+			std::memset(m_ctrl, FlatGroup::Empty, m_size + FlatGroup::Width - 1);
+		m_count = 0;
+	}
+
+	void Insert(const Key& key, const Value& value)
+	{
+		size_t hash = HashOf(key);
+		size_t index = FindIndex(key, hash);
+		if (index != m_size) {
+			m_values[index] = value;
+			return;
+		}
+
+		EmplaceSlot(key, value, hash);
+	}
+
+	// Removes the key by shifting the rest of its probe run one slot back, so no tombstone is left behind.
+	bool Erase(const Key& key)
+	{
+		size_t hole = FindIndex(key, HashOf(key));
+		if (hole == m_size)
+			return false;
+
+		size_t mask = m_size - 1;
+		for (size_t next = (hole + 1) & mask; m_ctrl[next] >= 0; next = (next + 1) & mask) {
+			size_t home = (HashOf(m_keys[next]) >> 7) & mask;
+			// The entry may only move back if the hole is not before its home slot.
+			if (((next - home) & mask) >= ((next - hole) & mask)) {
+				m_keys[hole] = std::move(m_keys[next]);
+				m_values[hole] = std::move(m_values[next]);
+				SetCtrl(hole, m_ctrl[next]);
+				hole = next;
+			}
+		}
+
+		m_keys[hole].~Key();
+		m_values[hole].~Value();
+		SetCtrl(hole, FlatGroup::Empty);
+		--m_count;
+		return true;
+	}
+
+	void Swap(FlatHashMap& other) noexcept
+	{
+		std::swap(m_ctrl, other.m_ctrl);
+		std::swap(m_keys, other.m_keys);
+		std::swap(m_values, other.m_values);
+		std::swap(m_size, other.m_size);
+		std::swap(m_count, other.m_count);
+		std::swap(m_hash, other.m_hash);
+		std::swap(m_equal, other.m_equal);
+	}
+
+	//Iterators
+	Iterator begin() { return Iterator(m_ctrl, m_keys, m_values, 0, m_size); }
+	Iterator end() { return Iterator(m_ctrl, m_keys, m_values, m_size, m_size); }
+
+private:
+	// std::hash is the identity for integers on common standard libraries; mixing spreads it over all bits
+	// so that both the slot index (high bits) and the control byte (low 7 bits) are well distributed.
+	size_t HashOf(const Key& key) const
+	{
+		return static_cast<size_t>(HashMix64(static_cast<uint64_t>(m_hash(key))));
+	}
+
+	static size_t RoundUpCapacity(size_t size)
+	{
+		return size <= FlatGroup::Width ? FlatGroup::Width : std::bit_ceil(size);
+	}
+
+	size_t FindIndex(const Key& key, size_t hash) const
+	{
+		size_t mask = m_size - 1;
+		int8_t h2 = static_cast<int8_t>(hash & 0x7F);
+		for (size_t position = (hash >> 7) & mask;; position = (position + FlatGroup::Width) & mask) {
+			FlatGroup group(m_ctrl + position);
+			for (uint32_t match = group.Match(h2); match != 0; match &= match - 1) {
+				size_t index = (position + std::countr_zero(match)) & mask;
+				if (m_equal(m_keys[index], key))
+					return index;
+			}
+			// Linear probing never leaves an empty slot between a key's home slot and the key itself.
+			if (group.MatchEmpty() != 0)
+				return m_size;
+		}
+	}
+
+	size_t FindEmpty(size_t hash) const
+	{
+		size_t mask = m_size - 1;
+		for (size_t position = (hash >> 7) & mask;; position = (position + FlatGroup::Width) & mask) {
+			uint32_t empty = FlatGroup(m_ctrl + position).MatchEmpty();
+			if (empty != 0)
+				return (position + std::countr_zero(empty)) & mask;
+		}
+	}
+
+	Value& EmplaceSlot(const Key& key, const Value& value, size_t hash)
+	{
+		if ((m_count + 1) * MaxLoadDenominator > m_size * MaxLoadNumerator)
+			Resize(m_size * 2);
+
+		size_t index = FindEmpty(hash);
+		new(&m_keys[index]) Key(key);
+		new(&m_values[index]) Value(value);
+		SetCtrl(index, static_cast<int8_t>(hash & 0x7F));
+		++m_count;
+
+		return m_values[index];
+	}
+
+	// The first Width - 1 control bytes are mirrored past the end so a group can be loaded at any slot.
+	void SetCtrl(size_t index, int8_t ctrl) noexcept
+	{
+		m_ctrl[index] = ctrl;
+		if (index < FlatGroup::Width - 1)
+			m_ctrl[m_size + index] = ctrl;
+	}
+
+	void Resize(size_t size)
+	{
+		int8_t* oldCtrl = m_ctrl;
+		Key* oldKeys = m_keys;
+		Value* oldValues = m_values;
+		size_t oldSize = m_size;
+
+		Allocate(size);
+		for (size_t i = 0; i < oldSize; ++i) {
+			if (oldCtrl[i] < 0)
+				continue;
+
+			size_t hash = HashOf(oldKeys[i]);
+			size_t index = FindEmpty(hash);
+			new(&m_keys[index]) Key(std::move(oldKeys[i]));
+			new(&m_values[index]) Value(std::move(oldValues[i]));
+			SetCtrl(index, static_cast<int8_t>(hash & 0x7F));
+			oldKeys[i].~Key();
+			oldValues[i].~Value();
+		}
+
+		delete[] oldCtrl;
+		::operator delete(oldKeys, oldSize * sizeof(Key));
+		::operator delete(oldValues, oldSize * sizeof(Value));
+	}
+
+	void Allocate(size_t size)
+	{
+		m_ctrl = new int8_t[size + FlatGroup::Width - 1];
+		std::memset(m_ctrl, FlatGroup::Empty, size + FlatGroup::Width - 1);
+		m_keys = static_cast<Key*>(::operator new(size * sizeof(Key)));
+		m_values = static_cast<Value*>(::operator new(size * sizeof(Value)));
+		m_size = size;
+	}
+
+	void Deallocate()
+	{
+		delete[] m_ctrl;
+		::operator delete(m_keys, m_size * sizeof(Key));
+		::operator delete(m_values, m_size * sizeof(Value));
+	}
+
+private:
+	int8_t* m_ctrl = nullptr;
+	Key* m_keys = nullptr;
+	Value* m_values = nullptr;
+	size_t m_size = 0;
+	size_t m_count = 0;
+	Hash m_hash;
+	KeyEqual m_equal;
+};
+
+#endif //_FLATHASHMAP_
@@ -0,0 +1,238 @@
+#ifndef _HASH_
+#define _HASH_
+
+#include<bit>
+#include<cstdint>
+#include<cstring>
+#include<functional>
+#include<string>
+#include<string_view>
+#include<type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include<intrin.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include<xmmintrin.h>
+#endif
+
+constexpr uint64_t HashSecret0 = 0xa0761d6478bd642full;
+constexpr uint64_t HashSecret1 = 0xe7037ed1a0b428dbull;
+constexpr uint64_t HashSecret2 = 0x8ebc6af09c88c6e3ull;
+constexpr uint64_t HashSecret3 = 0x589965cc75374cc3ull;
+
+// Full 64x64 -> 128 bit multiplication; a receives the low and b the high half. The hashing core is constexpr
+// so that compile-time tables such as StaticMap hash exactly like the runtime lookups.
+constexpr void HashMultiply(uint64_t& a, uint64_t& b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t product = static_cast<__uint128_t>(a) * b;
+	a = static_cast<uint64_t>(product);
+	b = static_cast<uint64_t>(product >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+	if (!std::is_constant_evaluated()) {
+		a = _umul128(a, b, &b);
+		return;
+	}
+#endif
+	uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+	uint64_t hi = ha * hb, mid0 = ha * lb, mid1 = la * hb, lo = la * lb;
+	uint64_t t = lo + (mid0 << 32);
+	uint64_t carry = t < lo;
+	uint64_t low = t + (mid1 << 32);
+	carry += low < t;
+	a = low;
+	b = hi + (mid0 >> 32) + (mid1 >> 32) + carry;
+#endif
+}
+
+// Multiplies and folds the 128 bit product back to 64 bits, the core mixing step of wyhash.
+constexpr uint64_t HashMultiplyFold(uint64_t a, uint64_t b) noexcept
+{
+	HashMultiply(a, b);
+	return a ^ b;
+}
+
+// Finalizer for integer keys: a single folded multiplication spreads every input bit over the whole result,
+// so sequential IDs no longer land in neighbouring buckets.
+constexpr uint64_t HashMix64(uint64_t value, uint64_t seed = 0) noexcept
+{
+	return HashMultiplyFold(value ^ seed ^ HashSecret0, HashSecret1);
+}
+
+template<typename Byte>
+concept HashByte = std::is_same_v<Byte, char> || std::is_same_v<Byte, unsigned char> || std::is_same_v<Byte, char8_t>;
+
+// Unaligned native-endian load; the constant-evaluated path assembles the same value byte by byte.
+template<typename T, HashByte Byte>
+constexpr T HashReadWord(const Byte* p) noexcept
+{
+	if (std::is_constant_evaluated()) {
+		T value = 0;
+		for (size_t i = 0; i < sizeof(T); ++i) {
+			size_t shift = std::endian::native == std::endian::little ? i : sizeof(T) - 1 - i;
+			value |= static_cast<T>(static_cast<uint8_t>(p[i])) << (8 * shift);
+		}
+		return value;
+	}
+
+	T value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+template<HashByte Byte>
+constexpr uint64_t HashRead64(const Byte* p) noexcept
+{
+	return HashReadWord<uint64_t>(p);
+}
+
+template<HashByte Byte>
+constexpr uint64_t HashRead32(const Byte* p) noexcept
+{
+	return HashReadWord<uint32_t>(p);
+}
+
+// wyhash-style hash of a byte range: 48 bytes per round over three independent lanes, with short inputs read
+// as a few overlapping words instead of byte by byte.
+template<HashByte Byte>
+constexpr uint64_t HashBytes(const Byte* p, size_t length, uint64_t seed = 0) noexcept
+{
+	seed ^= HashMultiplyFold(seed ^ HashSecret0, HashSecret1);
+
+	uint64_t a, b;
+	if (length <= 16) {
+		if (length >= 4) {
+			a = (HashRead32(p) << 32) | HashRead32(p + ((length >> 3) << 2));
+			b = (HashRead32(p + length - 4) << 32) | HashRead32(p + length - 4 - ((length >> 3) << 2));
+		}
+		else if (length > 0) {
+			a = (static_cast<uint64_t>(static_cast<uint8_t>(p[0])) << 16) |
+				(static_cast<uint64_t>(static_cast<uint8_t>(p[length >> 1])) << 8) | static_cast<uint8_t>(p[length - 1]);
+			b = 0;
+		}
+		else {
+			a = b = 0;
+		}
+	}
+	else {
+		size_t remaining = length;
+		if (remaining > 48) {
+			uint64_t seed1 = seed, seed2 = seed;
+			do {
+				seed = HashMultiplyFold(HashRead64(p) ^ HashSecret1, HashRead64(p + 8) ^ seed);
+				seed1 = HashMultiplyFold(HashRead64(p + 16) ^ HashSecret2, HashRead64(p + 24) ^ seed1);
+				seed2 = HashMultiplyFold(HashRead64(p + 32) ^ HashSecret3, HashRead64(p + 40) ^ seed2);
+				p += 48;
+				remaining -= 48;
+			} while (remaining > 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (remaining > 16) {
+			seed = HashMultiplyFold(HashRead64(p) ^ HashSecret1, HashRead64(p + 8) ^ seed);
+			p += 16;
+			remaining -= 16;
+		}
+		a = HashRead64(p + remaining - 16);
+		b = HashRead64(p + remaining - 8);
+	}
+
+	a ^= HashSecret1;
+	b ^= seed;
+	HashMultiply(a, b);
+	return HashMultiplyFold(a ^ HashSecret0 ^ length, b ^ HashSecret1);
+}
+
+inline uint64_t HashBytes(const void* data, size_t length, uint64_t seed = 0) noexcept
+{
+	return HashBytes(static_cast<const uint8_t*>(data), length, seed);
+}
+
+// Hasher bundled with the hash containers: a mixing finalizer for integers, enums and pointers and HashBytes
+// for strings. Any other type falls back to std::hash. The seed makes hashes unpredictable across instances.
+template<typename T>
+struct FastHash : std::hash<T>
+{
+	FastHash(uint64_t = 0) noexcept {}
+};
+
+template<typename T>
+	requires std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>
+struct FastHash<T>
+{
+	constexpr FastHash(uint64_t seed = 0) noexcept : seed(seed) {}
+
+	constexpr size_t operator()(T value) const noexcept
+	{
+		if constexpr (std::is_pointer_v<T>)
+			return static_cast<size_t>(HashMix64(reinterpret_cast<uintptr_t>(value), seed));
+		else
+			return static_cast<size_t>(HashMix64(static_cast<uint64_t>(value), seed));
+	}
+
+	uint64_t seed;
+};
+
+template<>
+struct FastHash<std::string_view>
+{
+	constexpr FastHash(uint64_t seed = 0) noexcept : seed(seed) {}
+
+	constexpr size_t operator()(std::string_view value) const noexcept
+	{
+		return static_cast<size_t>(HashBytes(value.data(), value.size(), seed));
+	}
+
+	uint64_t seed;
+};
+
+template<>
+struct FastHash<std::string> : FastHash<std::string_view>
+{
+	using FastHash<std::string_view>::FastHash;
+};
+
+// Hints the CPU to start loading the cache line at the address; a no-op on unsupported compilers.
+inline void HashPrefetch(const void* address) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+	(void)address;
+#endif
+}
+
+// Bucket index as the remainder of the hash; works with any bucket count but costs an integer division.
+struct ModuloBuckets
+{
+	static size_t BucketCount(size_t buckets) noexcept
+	{
+		return buckets > 0 ? buckets : 1;
+	}
+
+	static size_t Index(size_t hash, size_t buckets) noexcept
+	{
+		return hash % buckets;
+	}
+};
+
+// Power-of-two bucket counts indexed by Fibonacci hashing: a multiplication by 2^64 / phi keeps the top bits,
+// which replaces the division and still spreads weak hashes such as the identity over all buckets.
+struct PowerOfTwoBuckets
+{
+	static size_t BucketCount(size_t buckets) noexcept
+	{
+		return std::bit_ceil(buckets > 0 ? buckets : 1);
+	}
+
+	static size_t Index(size_t hash, size_t buckets) noexcept
+	{
+		uint64_t product = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>((product >> (63 - std::countr_zero(buckets))) >> 1);
+	}
+};
+
+#endif //_HASH_
@@ -1,6 +1,24 @@
 #ifndef _HASHTABLE_
 #define _HASHTABLE_
 
+#include<cmath>
+#include<type_traits>
+#include<algorithm>
+#include<functional>
+#include<memory>
+#include<memory_resource>
+#include<span>
+#include<stdexcept>
+#include<string>
+#include<utility>
+
+#include"BloomFilter.h"
+#include"Hash.h"
+
+// Defined in HashTableSnapshot.h, which must be included to call HashTable::Save.
+template<typename Key, typename Value, typename Hash, typename ForEach>
+void WriteHashTableSnapshot(const std::string& path, uint64_t seed, size_t count, ForEach forEach);
+
 template<typename HashTable>
 class HashIterator
 {
@@ -13,17 +31,8 @@ public:
 	using PointerType = ValueType*;
 
 public:
-	explicit HashIterator(NodePtr ptr, Table t, size_t s) noexcept
-		: m_current(ptr), table(t), size(s), index(0)
-	{
-		for (size_t i = 0; i < size; ++i)
-		{
-			if (table[i] != nullptr) {
-				index = i;
-				break;
-			}
-		}
-	}
+	explicit HashIterator(NodePtr ptr, Table t, size_t s, size_t i) noexcept
+		: m_current(ptr), table(t), size(s), index(i) {}
 
 	ReferenceType operator*() const noexcept { return m_current->value; }
 
@@ -40,14 +49,19 @@ public:
 			m_current = m_current->next;
 		else {
 			index++;
-			while (table[index] == nullptr)
+			while (index < size && table[index] == nullptr)
 				index++;
 			m_current = (index == size) ? nullptr : table[index];
 		}
 
 		return *this;
 	}
-	HashIterator operator++(int) noexcept { NodePtr tempNode{ *this }; m_current = m_current->next; return tempNode; }
+	HashIterator operator++(int) noexcept
+	{
+		HashIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
 private:
 	NodePtr m_current;
 	Table table;
@@ -55,101 +69,151 @@ private:
 	size_t index;
 };
 
-template<typename Key, typename Value>
+// Storage for the hash of a node's key when the table caches it.
+template<bool CacheHash>
+struct HashNodeHash
+{
+	HashNodeHash(size_t) noexcept {}
+};
+
+template<>
+struct HashNodeHash<true>
+{
+	HashNodeHash(size_t h) noexcept : hash(h) {}
+	size_t hash;
+};
+
+// Hash and KeyEqual are the hasher and key comparison, BucketPolicy maps hashes to buckets (ModuloBuckets or
+// PowerOfTwoBuckets) and CacheHash stores every key's hash in its node, so rehashing never recomputes it and
+// lookups only compare keys whose full hashes match. Nodes and bucket arrays come from Allocator, rebound to
+// them, and keys and values are constructed with uses-allocator construction.
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+	typename BucketPolicy = ModuloBuckets, bool CacheHash = false, typename Allocator = std::allocator<std::pair<const Key, Value>>>
 class HashTable
 {
 private:
-	struct Node
+	struct Node : HashNodeHash<CacheHash>
 	{
-		Node() : key{ 0 }, value{ 0 }, next{ nullptr } {}
-		Node(Key k, Value v, Node* n = nullptr) : key{ k }, value{ v }, next{ n } {}
+		template<typename NodeAllocator>
+		Node(const NodeAllocator& allocator, const Key& k, const Value& v, size_t h, Node* n = nullptr)
+			: HashNodeHash<CacheHash>(h), key(std::make_obj_using_allocator<Key>(allocator, k)),
+			value(std::make_obj_using_allocator<Value>(allocator, v)), next{ n } {}
 		Key key;
 		Value value;
 		Node* next;
 	};
 
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using NodeTraits = std::allocator_traits<NodeAllocator>;
+	using BucketAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node*>;
+	using BucketTraits = std::allocator_traits<BucketAllocator>;
+
+	// Number of non-empty buckets migrated to the new table by every operation while a rehash is in progress.
+	// Empty buckets are skipped for free up to ten times this amount, so a single step stays bounded.
+	static constexpr size_t RehashStepBuckets = 4;
+
+	// Number of keys whose buckets and first nodes the batch operations prefetch before resolving any of them.
+	static constexpr size_t BatchSize = 32;
+
 public:
 	using ValueType = Value;
 	using KeyType = Key;
 	using NodePtr = Node*;
 	using Table = Node**;
-	using Iterator = HashIterator <HashTable<Key, Value>>;
+	using Iterator = HashIterator<HashTable>;
+	using Hasher = Hash;
+	using KeyEqualType = KeyEqual;
+	using AllocatorType = Allocator;
 public:
 	//Constructors
-	HashTable(size_t size = 10) : m_size(size), m_table(new Node* [size] {}) {}
+	HashTable(size_t size = 10, float maxLoadFactor = 1.0f, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+		const Allocator& allocator = Allocator())
+		: m_allocator(allocator), m_table(AllocateBuckets(BucketPolicy::BucketCount(size))), m_size(BucketPolicy::BucketCount(size)),
+		m_rehashTable(nullptr), m_rehashSize(0), m_rehashIndex(0), m_count(0), m_maxLoadFactor(maxLoadFactor),
+		m_hash(hash), m_equal(equal), m_filterErased(0) {}
+
+	explicit HashTable(const Allocator& allocator) : HashTable(10, 1.0f, Hash(), KeyEqual(), allocator) {}
 
-	HashTable(const HashTable& other) : HashTable(other.m_size)
+	HashTable(const HashTable& other)
+		: HashTable(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.GetAllocator())) {}
+
+	HashTable(const HashTable& other, const Allocator& allocator)
+		: HashTable(other.Size(), other.m_maxLoadFactor, other.m_hash, other.m_equal, allocator)
 	{
-		for (size_t i = 0; i < m_size; ++i) {
-			if (other.m_table[i] != nullptr) {
-				m_table[i] = new Node(other.m_table[i]->key, other.m_table[i]->value);
-				Node* current = m_table[i];
-				Node* otherCurrent = other.m_table[i]->next;
-				while (otherCurrent) {
-					current->next = otherCurrent;
-					otherCurrent = otherCurrent->next;
-				}
-			}
-		}
+		if (other.m_filter != nullptr)
+			AttachBloomFilter(other.m_filter->BitsPerKey());
+		other.ForEachNode([this, &other](const Node* node) { EmplaceNode(node->key, node->value, other.NodeHash(node)); });
 	}
 
 	HashTable(HashTable&& other) noexcept
-		: m_size(other.m_size), m_table(other.m_table)
+		: m_allocator(other.m_allocator), m_table(other.m_table), m_size(other.m_size),
+		m_rehashTable(other.m_rehashTable), m_rehashSize(other.m_rehashSize), m_rehashIndex(other.m_rehashIndex),
+		m_count(other.m_count), m_maxLoadFactor(other.m_maxLoadFactor), m_hash(other.m_hash), m_equal(other.m_equal),
+		m_filter(std::move(other.m_filter)), m_rehashFilter(std::move(other.m_rehashFilter)), m_filterErased(other.m_filterErased)
 	{
-		other.m_size = 0;
 		other.m_table = nullptr;
+		other.m_size = 0;
+		other.m_rehashTable = nullptr;
+		other.m_rehashSize = 0;
+		other.m_rehashIndex = 0;
+		other.m_count = 0;
+		other.m_filterErased = 0;
 	}
 
 	~HashTable()
 	{
 		Clear();
-		delete[] m_table;
+		FreeBuckets(m_table, m_size);
 	}
 
 	//Operators
 	HashTable& operator=(const HashTable& other)
 	{
-		if (*this == other)
+		if (this == &other)
 			return *this;
 
-		HashTable(other).Swap(*this);
+		constexpr bool propagate = NodeTraits::propagate_on_container_copy_assignment::value;
+		HashTable copy(other, propagate ? other.GetAllocator() : GetAllocator());
+		SwapContents(copy);
+		if constexpr (propagate)
+			std::swap(m_allocator, copy.m_allocator);
 		return *this;
 	}
 
-	HashTable& operator=(HashTable&& other) noexcept
+	HashTable& operator=(HashTable&& other) noexcept(NodeTraits::propagate_on_container_move_assignment::value
+		|| NodeTraits::is_always_equal::value)
 	{
-		Clear();
-		m_size = other.m_size;
-		m_table = other.m_table;
-
-		other.m_size = 0;
-		other.m_table = nullptr;
+		constexpr bool propagate = NodeTraits::propagate_on_container_move_assignment::value;
+		if constexpr (!propagate && !NodeTraits::is_always_equal::value) {
+			// Nodes of another allocator cannot be adopted, so they are copied into this table's allocator.
+			if (m_allocator != other.m_allocator) {
+				HashTable copy(other, GetAllocator());
+				SwapContents(copy);
+				other.Clear();
+				return *this;
+			}
+		}
 
+		HashTable moved(std::move(other));
+		SwapContents(moved);
+		if constexpr (propagate)
+			std::swap(m_allocator, moved.m_allocator);
 		return *this;
 	}
 
 	bool operator==(const HashTable& other) const
 	{
-		if (m_size != other.m_size)
+		if (m_count != other.m_count)
 			return false;
 
-		for (size_t i = 0; i < m_size; ++i) {
-			Node* current = m_table[i];
-			Node* otherCurrent = other.m_table[i];
-
-			while (current != nullptr && otherCurrent != nullptr) {
-				if (current->key != otherCurrent->key || current->value != otherCurrent->value)
-					return false;
-				current = current->next;
-				otherCurrent = otherCurrent->next;
-			}
+		bool equal = true;
+		ForEachNode([&](const Node* node) {
+			const Node* otherNode = other.FindNode(node->key, other.m_hash(node->key));
+			if (otherNode == nullptr || otherNode->value != node->value)
+				equal = false;
+		});
 
-			// If one list has more elements than the other
-			if (current != nullptr || otherCurrent != nullptr)
-				return false;
-		}
-
-		return true;
+		return equal;
 	}
 
 	bool operator!=(const HashTable& other) const
@@ -159,107 +223,549 @@ public:
 
 	Value& operator[](const Key& key)
 	{
-		size_t index = HashFunction(key);
-		Node*& current = m_table[index];
-		while (current != nullptr) {
-			if (current->key == key)
-				return current->value;
-			current = current->next;
-		}
+		RehashStep();
+		size_t hash = m_hash(key);
+		if (Node* node = FindNode(key, hash))
+			return node->value;
 
-		Node* newNode = new Node{ key, Value{} };
-		m_table[index] = newNode;
+		return EmplaceNode(key, Value{}, hash)->value;
+	}
 
-		return newNode->value;
+	//Lookup
+	Value* Find(const Key& key)
+	{
+		RehashStep();
+		Node* node = FindNode(key, m_hash(key));
+		return node != nullptr ? &node->value : nullptr;
+	}
+
+	const Value* Find(const Key& key) const
+	{
+		const Node* node = FindNode(key, m_hash(key));
+		return node != nullptr ? &node->value : nullptr;
+	}
+
+	bool Contains(const Key& key) const
+	{
+		return FindNode(key, m_hash(key)) != nullptr;
+	}
+
+	// Looks up every key and stores a pointer to its value, or nullptr, at the same position of results.
+	// Hashing and the bucket and first-node loads run ahead of the chain walks, so the cache misses of many
+	// lookups overlap instead of being paid one after another. Throws std::invalid_argument if results is shorter
+	// than keys.
+	void FindBatch(std::span<const Key> keys, std::span<Value*> results)
+	{
+		if (results.size() < keys.size())
+			throw std::invalid_argument("FindBatch results are fewer than its keys");
+		RehashStep();
+		ForEachBatchKey(keys, [&](size_t i, size_t hash) {
+			Node* node = FindNode(keys[i], hash);
+			results[i] = node != nullptr ? &node->value : nullptr;
+		});
+	}
+
+	void ContainsBatch(std::span<const Key> keys, std::span<bool> results) const
+	{
+		if (results.size() < keys.size())
+			throw std::invalid_argument("ContainsBatch results are fewer than its keys");
+		ForEachBatchKey(keys, [&](size_t i, size_t hash) { results[i] = FindNode(keys[i], hash) != nullptr; });
+	}
+
+	// Inserts or overwrites keys[i] with values[i] for every i. Throws std::invalid_argument if values is
+	// shorter than keys.
+	void InsertBatch(std::span<const Key> keys, std::span<const Value> values)
+	{
+		if (values.size() < keys.size())
+			throw std::invalid_argument("InsertBatch values are fewer than its keys");
+		Reserve(m_count + keys.size());
+		ForEachBatchKey(keys, [&](size_t i, size_t hash) {
+			RehashStep();
+			if (Node* node = FindNode(keys[i], hash))
+				node->value = values[i];
+			else
+				EmplaceNode(keys[i], values[i], hash);
+		});
 	}
 
 	//Capacity
+	// Number of buckets; while a rehash is in progress this is the bucket count of the table being filled.
 	size_t Size() const noexcept
 	{
-		return m_size;
+		return IsRehashing() ? m_rehashSize : m_size;
+	}
+
+	// Number of stored elements.
+	size_t Count() const noexcept
+	{
+		return m_count;
 	}
 
 	bool IsEmpty() const noexcept
 	{
-		for (size_t index = 0; index < m_size; ++index) {
-			Node* current = m_table[index];
-			if (current != nullptr)
-				return false;
-		}
-		return true;
+		return m_count == 0;
+	}
+
+	float LoadFactor() const noexcept
+	{
+		return static_cast<float>(m_count) / static_cast<float>(Size());
+	}
+
+	float MaxLoadFactor() const noexcept
+	{
+		return m_maxLoadFactor;
+	}
+
+	void SetMaxLoadFactor(float maxLoadFactor)
+	{
+		m_maxLoadFactor = maxLoadFactor;
+		if (LoadFactor() > m_maxLoadFactor)
+			Rehash(0);
+	}
+
+	bool IsRehashing() const noexcept
+	{
+		return m_rehashTable != nullptr;
 	}
 
 	size_t HashFunction(const Key& key) const
 	{
-		return std::hash<Key>()(key) % m_size;
+		return BucketPolicy::Index(m_hash(key), Size());
+	}
+
+	Hash HashFunctionObject() const
+	{
+		return m_hash;
+	}
+
+	KeyEqual KeyEqualFunction() const
+	{
+		return m_equal;
+	}
+
+	Allocator GetAllocator() const noexcept
+	{
+		return Allocator(m_allocator);
+	}
+
+	//Bloom filter
+	// Puts a BloomFilter with the given bits per key in front of the buckets, so most lookups of absent keys
+	// return without touching a chain. The filter follows inserts, is rebuilt alongside every rehash, and is
+	// rebuilt by a rehash into as many buckets once erased keys make up a third of the keys it was filled with.
+	void AttachBloomFilter(double bitsPerKey = 10.0)
+	{
+		FinishRehash();
+		m_filter = std::make_unique<BloomFilter>(FilterKeys(m_size), bitsPerKey);
+		ForEachNode([this](const Node* node) { m_filter->Add(NodeHash(node)); });
+		m_filterErased = 0;
+	}
+
+	void DetachBloomFilter() noexcept
+	{
+		m_filter.reset();
+		m_rehashFilter.reset();
+		m_filterErased = 0;
+	}
+
+	// The attached filter, whose Stats() count skipped and false-positive lookups, or nullptr.
+	const BloomFilter* Filter() const noexcept
+	{
+		return m_filter.get();
+	}
+
+	void ResetFilterStats() noexcept
+	{
+		if (m_filter != nullptr)
+			m_filter->ResetStats();
 	}
 
 	//Modifiers
 	void Clear()
 	{
-		for (size_t i = 0; i < m_size; ++i) {
-			Node* current = m_table[i];
-			while (current != nullptr) {
-				Node* next = current->next;
-				delete current;
-				current = next;
-				next = nullptr;
-			}
-			m_table[i] = nullptr;
+		ClearTable(m_table, m_size);
+		if (IsRehashing()) {
+			ClearTable(m_rehashTable, m_rehashSize);
+			FreeBuckets(m_table, m_size);
+			m_table = m_rehashTable;
+			m_size = m_rehashSize;
+			m_rehashTable = nullptr;
+			m_rehashSize = 0;
+			m_rehashIndex = 0;
+		}
+		m_count = 0;
+		if (m_filter != nullptr) {
+			m_filter->Clear();
+			m_rehashFilter.reset();
+			m_filterErased = 0;
 		}
 	}
 
 	void Insert(const Key& key, const Value& value)
 	{
-		size_t index = HashFunction(key);
-		Node* current = m_table[index];
-
-		while (current != nullptr) {
-			if (current->key == key) {
-				current->value = value;
-				return;
-			}
-			current = current->next;
+		RehashStep();
+		size_t hash = m_hash(key);
+		if (Node* node = FindNode(key, hash)) {
+			node->value = value;
+			return;
 		}
 
-		Node* newNode = new Node{ key, value };
+		EmplaceNode(key, value, hash);
+	}
 
-		if (m_table[index] == nullptr) {
-			m_table[index] = newNode;
-		}
-		else {
-			Node* last = m_table[index];
-			while (last->next != nullptr) {
-				last = last->next;
-			}
-			last->next = newNode;
+	bool Erase(const Key& key)
+	{
+		RehashStep();
+		size_t hash = m_hash(key);
+		if (!(IsRehashing() && EraseFromBucket(m_rehashTable[BucketPolicy::Index(hash, m_rehashSize)], key, hash))
+			&& !EraseFromBucket(m_table[BucketPolicy::Index(hash, m_size)], key, hash))
+			return false;
+
+		// A Bloom filter cannot forget a key. Once a third of its keys are gone, a rehash into as many buckets
+		// rebuilds it a few buckets per operation; a rehash in progress rebuilds it anyway.
+		if (m_filter != nullptr && !IsRehashing()) {
+			++m_filterErased;
+			if (m_filterErased > (m_count + m_filterErased) / 3)
+				StartRehash(m_size);
 		}
+		return true;
 	}
 
+	// Makes room for at least count elements without exceeding the maximum load factor.
+	void Reserve(size_t count)
+	{
+		size_t buckets = BucketPolicy::BucketCount(static_cast<size_t>(std::ceil(count / m_maxLoadFactor)));
+		if (buckets > Size())
+			Rehash(buckets);
+	}
+
+	// Starts moving the elements into a table of at least the given number of buckets (never fewer than the
+	// maximum load factor allows). The move happens a few buckets at a time on the following operations.
+	void Rehash(size_t buckets)
+	{
+		size_t minBuckets = static_cast<size_t>(std::ceil(m_count / m_maxLoadFactor));
+		if (buckets < minBuckets)
+			buckets = minBuckets;
+		buckets = BucketPolicy::BucketCount(buckets);
+
+		if (IsRehashing())
+			FinishRehash();
+		if (buckets != m_size)
+			StartRehash(buckets);
+	}
+
+	// Swaps the allocators only if the allocator propagates on swap; otherwise both must compare equal.
 	void Swap(HashTable& other) noexcept
 	{
-		std::swap(m_size, other.m_size);
-		std::swap(m_table, other.m_table);
+		SwapContents(other);
+		if constexpr (NodeTraits::propagate_on_container_swap::value)
+			std::swap(m_allocator, other.m_allocator);
+	}
+
+	//Snapshots
+	// Writes the elements to a snapshot file that a HashTableView<Key, Value, SnapshotHash> maps back and
+	// queries without deserializing. The file is bucketed by SnapshotHash(seed) rather than by this table's
+	// hasher, so its layout does not depend on the hasher's state or on std::hash of the running build. Key and
+	// Value must be trivially copyable, and callers must include HashTableSnapshot.h.
+	template<typename SnapshotHash = FastHash<Key>>
+	void Save(const std::string& path, uint64_t seed = 0) const
+	{
+		WriteHashTableSnapshot<Key, Value, SnapshotHash>(path, seed, m_count, [this](auto function) {
+			ForEachNode([&function](const Node* node) { function(node->key, node->value); });
+		});
 	}
 
 	//Iterators
+	// Iteration is O(n) anyway, so beginning one completes a pending rehash and walks a single table.
 	Iterator begin()
 	{
+		FinishRehash();
 		for (size_t i = 0; i < m_size; ++i) {
 			if (m_table[i] != nullptr)
-				return Iterator(m_table[i], m_table, m_size);
+				return Iterator(m_table[i], m_table, m_size, i);
 		}
-		return Iterator(nullptr, m_table, m_size);
+		return end();
 	}
 
 	Iterator end()
 	{
-		return Iterator(nullptr, m_table + m_size, m_size);
+		return Iterator(nullptr, m_table, m_size, m_size);
 	}
 
 private:
+	size_t NodeHash(const Node* node) const
+	{
+		if constexpr (CacheHash)
+			return node->hash;
+		else
+			return m_hash(node->key);
+	}
+
+	bool NodeMatches(const Node* node, const Key& key, size_t hash) const
+	{
+		if constexpr (CacheHash) {
+			if (node->hash != hash)
+				return false;
+		}
+		return m_equal(node->key, key);
+	}
+
+	// While a rehash is in progress the old filter stays in charge, since inserts keep adding to it.
+	Node* FindNode(const Key& key, size_t hash) const
+	{
+		if (m_filter != nullptr && !m_filter->MayContain(hash))
+			return nullptr;
+
+		if (IsRehashing()) {
+			for (Node* current = m_rehashTable[BucketPolicy::Index(hash, m_rehashSize)]; current != nullptr; current = current->next) {
+				if (NodeMatches(current, key, hash))
+					return current;
+			}
+		}
+
+		for (Node* current = m_table[BucketPolicy::Index(hash, m_size)]; current != nullptr; current = current->next) {
+			if (NodeMatches(current, key, hash))
+				return current;
+		}
+
+		if (m_filter != nullptr)
+			m_filter->RecordFalsePositive();
+		return nullptr;
+	}
+
+	bool EraseFromBucket(Node*& head, const Key& key, size_t hash)
+	{
+		for (Node** link = &head; *link != nullptr; link = &(*link)->next) {
+			if (NodeMatches(*link, key, hash)) {
+				Node* node = *link;
+				*link = node->next;
+				DestroyNode(node);
+				--m_count;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void PrefetchBucket(size_t hash) const
+	{
+		HashPrefetch(&m_table[BucketPolicy::Index(hash, m_size)]);
+		if (IsRehashing())
+			HashPrefetch(&m_rehashTable[BucketPolicy::Index(hash, m_rehashSize)]);
+	}
+
+	void PrefetchHead(size_t hash) const
+	{
+		HashPrefetch(m_table[BucketPolicy::Index(hash, m_size)]);
+		if (IsRehashing())
+			HashPrefetch(m_rehashTable[BucketPolicy::Index(hash, m_rehashSize)]);
+	}
+
+	// Calls function(i, hash of keys[i]) for every key in order. Keys are taken BatchSize at a time: all of
+	// them are hashed and their bucket slots prefetched, then their first nodes, and only then is any chain
+	// walked, so the loads of a whole group are in flight together.
+	template<typename Function>
+	void ForEachBatchKey(std::span<const Key> keys, Function function) const
+	{
+		size_t hashes[BatchSize];
+		for (size_t begin = 0; begin < keys.size(); begin += BatchSize) {
+			size_t count = std::min(BatchSize, keys.size() - begin);
+			for (size_t i = 0; i < count; ++i) {
+				hashes[i] = m_hash(keys[begin + i]);
+				PrefetchBucket(hashes[i]);
+			}
+			for (size_t i = 0; i < count; ++i)
+				PrefetchHead(hashes[i]);
+			for (size_t i = 0; i < count; ++i)
+				function(begin + i, hashes[i]);
+		}
+	}
+
+	// Links a new node for a key known to be absent, growing the table first if the load factor demands it.
+	Node* EmplaceNode(const Key& key, const Value& value, size_t hash)
+	{
+		if (!IsRehashing() && static_cast<float>(m_count + 1) > m_maxLoadFactor * static_cast<float>(m_size))
+			Rehash(m_size * 2);
+
+		Node** table = IsRehashing() ? m_rehashTable : m_table;
+		size_t index = BucketPolicy::Index(hash, IsRehashing() ? m_rehashSize : m_size);
+		table[index] = CreateNode(key, value, hash, table[index]);
+		++m_count;
+		if (m_filter != nullptr) {
+			m_filter->Add(hash);
+			if (m_rehashFilter != nullptr)
+				m_rehashFilter->Add(hash);
+		}
+
+		return table[index];
+	}
+
+	// Begins moving the nodes into a new table, which may have as many buckets as the current one when only the
+	// filter needs rebuilding. No rehash may be in progress.
+	void StartRehash(size_t buckets)
+	{
+		m_rehashTable = AllocateBuckets(buckets);
+		m_rehashSize = buckets;
+		m_rehashIndex = 0;
+		if (m_filter != nullptr)
+			m_rehashFilter = std::make_unique<BloomFilter>(FilterKeys(buckets), m_filter->BitsPerKey());
+		RehashStep();
+	}
+
+	void RehashStep()
+	{
+		if (!IsRehashing())
+			return;
+
+		size_t moved = 0;
+		size_t visited = 0;
+		while (m_rehashIndex < m_size && moved < RehashStepBuckets && visited < RehashStepBuckets * 10) {
+			Node* current = m_table[m_rehashIndex];
+			m_table[m_rehashIndex++] = nullptr;
+			++visited;
+			if (current != nullptr)
+				++moved;
+
+			while (current != nullptr) {
+				Node* next = current->next;
+				size_t hash = NodeHash(current);
+				size_t index = BucketPolicy::Index(hash, m_rehashSize);
+				if (m_rehashFilter != nullptr)
+					m_rehashFilter->Add(hash);
+				current->next = m_rehashTable[index];
+				m_rehashTable[index] = current;
+				current = next;
+			}
+		}
+
+		if (m_rehashIndex == m_size) {
+			FreeBuckets(m_table, m_size);
+			m_table = m_rehashTable;
+			m_size = m_rehashSize;
+			m_rehashTable = nullptr;
+			m_rehashSize = 0;
+			m_rehashIndex = 0;
+			if (m_rehashFilter != nullptr) {
+				m_rehashFilter->SetStats(m_filter->Stats());
+				m_filter = std::move(m_rehashFilter);
+				m_filterErased = 0;
+			}
+		}
+	}
+
+	void FinishRehash()
+	{
+		while (IsRehashing())
+			RehashStep();
+	}
+
+	template<typename Function>
+	void ForEachNode(Function function) const
+	{
+		for (size_t i = 0; i < m_size; ++i) {
+			for (const Node* current = m_table[i]; current != nullptr; current = current->next)
+				function(current);
+		}
+		for (size_t i = 0; i < m_rehashSize; ++i) {
+			for (const Node* current = m_rehashTable[i]; current != nullptr; current = current->next)
+				function(current);
+		}
+	}
+
+	// Keys the filter of a table with the given bucket count has to hold before the table grows again.
+	size_t FilterKeys(size_t buckets) const noexcept
+	{
+		return std::max(static_cast<size_t>(std::ceil(m_maxLoadFactor * static_cast<float>(buckets))), m_count);
+	}
+
+	template<typename... Args>
+	Node* CreateNode(Args&&... args)
+	{
+		Node* node = NodeTraits::allocate(m_allocator, 1);
+		try {
+			NodeTraits::construct(m_allocator, node, m_allocator, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			NodeTraits::deallocate(m_allocator, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void DestroyNode(Node* node) noexcept
+	{
+		NodeTraits::destroy(m_allocator, node);
+		NodeTraits::deallocate(m_allocator, node, 1);
+	}
+
+	Node** AllocateBuckets(size_t size)
+	{
+		BucketAllocator allocator(m_allocator);
+		Node** table = BucketTraits::allocate(allocator, size);
+		std::uninitialized_fill_n(table, size, nullptr);
+		return table;
+	}
+
+	void FreeBuckets(Node** table, size_t size) noexcept
+	{
+		if (table == nullptr)
+			return;
+		BucketAllocator allocator(m_allocator);
+		BucketTraits::deallocate(allocator, table, size);
+	}
+
+	void SwapContents(HashTable& other) noexcept
+	{
+		std::swap(m_table, other.m_table);
+		std::swap(m_size, other.m_size);
+		std::swap(m_rehashTable, other.m_rehashTable);
+		std::swap(m_rehashSize, other.m_rehashSize);
+		std::swap(m_rehashIndex, other.m_rehashIndex);
+		std::swap(m_count, other.m_count);
+		std::swap(m_maxLoadFactor, other.m_maxLoadFactor);
+		std::swap(m_hash, other.m_hash);
+		std::swap(m_equal, other.m_equal);
+		std::swap(m_filter, other.m_filter);
+		std::swap(m_rehashFilter, other.m_rehashFilter);
+		std::swap(m_filterErased, other.m_filterErased);
+	}
+
+	void ClearTable(Node** table, size_t size) noexcept
+	{
+		for (size_t i = 0; i < size; ++i) {
+			Node* current = table[i];
+			while (current != nullptr) {
+				Node* next = current->next;
+				DestroyNode(current);
+				current = next;
+			}
+			table[i] = nullptr;
+		}
+	}
+
+private:
+	[[no_unique_address]] NodeAllocator m_allocator;
 	Node** m_table;
 	size_t m_size;
+	Node** m_rehashTable;
+	size_t m_rehashSize;
+	size_t m_rehashIndex;
+	size_t m_count;
+	float m_maxLoadFactor;
+	Hash m_hash;
+	KeyEqual m_equal;
+	std::unique_ptr<BloomFilter> m_filter;
+	// Filter filled while a rehash moves the nodes; it replaces m_filter when the rehash completes.
+	std::unique_ptr<BloomFilter> m_rehashFilter;
+	// Keys erased since the filter was last built, whose bits are still set.
+	size_t m_filterErased;
 };
 
-#endif //_HASHTABLE__
\ No newline at end of file
+// HashTable whose nodes and buckets come from a std::pmr::memory_resource, such as a PoolResource or a
+// MonotonicArena. The Bloom filter, if attached, stays on the default heap.
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+	typename BucketPolicy = ModuloBuckets, bool CacheHash = false>
+using PmrHashTable = HashTable<Key, Value, Hash, KeyEqual, BucketPolicy, CacheHash,
+	std::pmr::polymorphic_allocator<std::pair<const Key, Value>>>;
+
+#endif //_HASHTABLE_
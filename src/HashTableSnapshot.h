@@ -0,0 +1,287 @@
+#ifndef _HASHTABLESNAPSHOT_
+#define _HASHTABLESNAPSHOT_
+
+#include<cstdint>
+#include<cstdio>
+#include<filesystem>
+#include<fstream>
+#include<functional>
+#include<stdexcept>
+#include<string>
+#include<type_traits>
+#include<vector>
+
+#include"Hash.h"
+#include"HashTable.h"
+#include"MappedFile.h"
+
+// Snapshot file layout, in native byte order:
+//     SnapshotHeader
+//     uint64_t bucketStart[bucketCount + 1]   first entry of every bucket, plus the entry count
+//     SnapshotEntry entries[count]            grouped by bucket, at entriesOffset (a multiple of 64)
+// The checksum chains HashBytes over the bucket starts into HashBytes over the entries.
+struct alignas(64) SnapshotHeader
+{
+	static constexpr uint64_t Magic = 0x50414E5348534148ull; // "HASHSNAP"
+	static constexpr uint32_t CurrentVersion = 1;
+	// Reads back differently on a machine of the other endianness.
+	static constexpr uint32_t ByteOrder = 0x01020304u;
+
+	uint64_t magic;
+	uint32_t version;
+	uint32_t byteOrder;
+	uint32_t keySize;
+	uint32_t valueSize;
+	uint32_t entrySize;
+	uint32_t entryAlignment;
+	uint64_t hashSeed;
+	uint64_t bucketCount;
+	uint64_t count;
+	uint64_t entriesOffset;
+	uint64_t fileSize;
+	uint64_t checksum;
+};
+
+template<typename Key, typename Value>
+struct SnapshotEntry
+{
+	Key key;
+	Value value;
+};
+
+template<typename Key, typename Value>
+concept SnapshotStorable = std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value> &&
+	alignof(SnapshotEntry<Key, Value>) <= 64;
+
+// Writes count entries, produced by forEach(function(key, value)), to a snapshot bucketed by
+// Hash(seed). The file is written next to path, synced and renamed over it, so readers never see a partial
+// snapshot, even after a crash. Declared in HashTable.h for HashTable::Save.
+template<typename Key, typename Value, typename Hash, typename ForEach>
+void WriteHashTableSnapshot(const std::string& path, uint64_t seed, size_t count, ForEach forEach)
+{
+	static_assert(SnapshotStorable<Key, Value>, "snapshot keys and values must be trivially copyable");
+	using Entry = SnapshotEntry<Key, Value>;
+
+	const Hash hash(seed);
+	const size_t buckets = PowerOfTwoBuckets::BucketCount(count);
+	std::vector<uint64_t> bucketStart(buckets + 1, 0);
+	std::vector<size_t> bucketOf;
+	bucketOf.reserve(count);
+	forEach([&](const Key& key, const Value&) {
+		bucketOf.push_back(PowerOfTwoBuckets::Index(hash(key), buckets));
+		++bucketStart[bucketOf.back() + 1];
+	});
+	for (size_t bucket = 0; bucket < buckets; ++bucket)
+		bucketStart[bucket + 1] += bucketStart[bucket];
+
+	// Value-initialized entries keep their padding zeroed, so equal tables give byte-identical files.
+	std::vector<Entry> entries(count);
+	std::vector<uint64_t> filled(bucketStart.begin(), bucketStart.end() - 1);
+	size_t index = 0;
+	forEach([&](const Key& key, const Value& value) {
+		Entry& entry = entries[filled[bucketOf[index++]]++];
+		entry.key = key;
+		entry.value = value;
+	});
+
+	const size_t startBytes = bucketStart.size() * sizeof(uint64_t);
+	const size_t entriesOffset = (sizeof(SnapshotHeader) + startBytes + 63) / 64 * 64;
+	const char padding[64] = {};
+
+	SnapshotHeader header{};
+	header.magic = SnapshotHeader::Magic;
+	header.version = SnapshotHeader::CurrentVersion;
+	header.byteOrder = SnapshotHeader::ByteOrder;
+	header.keySize = sizeof(Key);
+	header.valueSize = sizeof(Value);
+	header.entrySize = sizeof(Entry);
+	header.entryAlignment = alignof(Entry);
+	header.hashSeed = seed;
+	header.bucketCount = buckets;
+	header.count = count;
+	header.entriesOffset = entriesOffset;
+	header.fileSize = entriesOffset + count * sizeof(Entry);
+	header.checksum = HashBytes(entries.data(), count * sizeof(Entry), HashBytes(bucketStart.data(), startBytes));
+
+	const std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(bucketStart.data()), static_cast<std::streamsize>(startBytes));
+		file.write(padding, static_cast<std::streamsize>(entriesOffset - sizeof(SnapshotHeader) - startBytes));
+		file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(count * sizeof(Entry)));
+		file.close();
+		if (!file || !SyncFile(temporary)) {
+			std::remove(temporary.c_str());
+			throw std::runtime_error("HashTable snapshot: cannot write " + temporary);
+		}
+	}
+	std::filesystem::rename(temporary, path);
+}
+
+template<typename HashTableView>
+class HashTableViewIterator
+{
+public:
+	using ValueType = typename HashTableView::ValueType;
+	using KeyType = typename HashTableView::KeyType;
+	using Entry = typename HashTableView::Entry;
+	using ReferenceType = const ValueType&;
+	using PointerType = const ValueType*;
+
+public:
+	explicit HashTableViewIterator(const Entry* entry) noexcept : m_current(entry) {}
+
+	ReferenceType operator*() const noexcept { return m_current->value; }
+
+	ReferenceType Value() const noexcept { return m_current->value; }
+	const KeyType& Key() const noexcept { return m_current->key; }
+	PointerType operator->() const noexcept { return &m_current->value; }
+	bool operator==(const HashTableViewIterator& other) const noexcept { return m_current == other.m_current; }
+	bool operator!=(const HashTableViewIterator& other) const noexcept { return m_current != other.m_current; }
+	HashTableViewIterator& operator++() noexcept
+	{
+		++m_current;
+		return *this;
+	}
+	HashTableViewIterator operator++(int) noexcept
+	{
+		HashTableViewIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+private:
+	const Entry* m_current;
+};
+
+// Read-only table served straight from a memory-mapped snapshot written by HashTable::Save. Opening one only
+// maps the file and validates it; lookups hash the key, read the bucket's entry range and compare the keys in
+// place, so pages are read in as they are first touched. Hash must match the one the snapshot was saved with;
+// it is constructed from the seed stored in the file.
+template<typename Key, typename Value, typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+	requires SnapshotStorable<Key, Value>
+class HashTableView
+{
+public:
+	using ValueType = Value;
+	using KeyType = Key;
+	using Entry = SnapshotEntry<Key, Value>;
+	using Iterator = HashTableViewIterator<HashTableView>;
+public:
+	//Constructors
+	// Throws std::runtime_error if the file is missing, was written by another format version or for other
+	// key and value types, is truncated or has bucket offsets outside its entries, or, when verifyChecksum is
+	// set, does not match its checksum. Skipping the checksum avoids reading the entries up front.
+	explicit HashTableView(const std::string& path, bool verifyChecksum = true, const KeyEqual& equal = KeyEqual())
+		: m_file(path), m_hash(0), m_equal(equal)
+	{
+		if (m_file.Size() < sizeof(SnapshotHeader))
+			throw std::runtime_error("HashTableView: " + path + " is not a snapshot");
+
+		const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>(m_file.Data());
+		if (header.magic != SnapshotHeader::Magic || header.byteOrder != SnapshotHeader::ByteOrder)
+			throw std::runtime_error("HashTableView: " + path + " is not a snapshot");
+		if (header.version != SnapshotHeader::CurrentVersion)
+			throw std::runtime_error("HashTableView: " + path + " has unsupported version " + std::to_string(header.version));
+		if (header.keySize != sizeof(Key) || header.valueSize != sizeof(Value) || header.entrySize != sizeof(Entry) ||
+			header.entryAlignment != alignof(Entry))
+			throw std::runtime_error("HashTableView: " + path + " holds other key or value types");
+
+		// The layout is checked whether or not the checksum is, so a damaged file cannot send lookups outside the
+		// mapping. Bounding the counts by the file size first keeps the products below from overflowing.
+		const uint64_t fileSize = m_file.Size();
+		if (header.fileSize != fileSize || header.bucketCount == 0 || (header.bucketCount & (header.bucketCount - 1)) != 0 ||
+			header.bucketCount >= fileSize / sizeof(uint64_t) || header.count > fileSize / sizeof(Entry) ||
+			header.entriesOffset > fileSize || header.entriesOffset % 64 != 0)
+			throw std::runtime_error("HashTableView: " + path + " is truncated or corrupt");
+		const uint64_t startBytes = (header.bucketCount + 1) * sizeof(uint64_t);
+		if (header.entriesOffset < sizeof(SnapshotHeader) + startBytes || fileSize - header.entriesOffset != header.count * sizeof(Entry))
+			throw std::runtime_error("HashTableView: " + path + " is truncated or corrupt");
+
+		m_bucketStart = reinterpret_cast<const uint64_t*>(m_file.Data() + sizeof(SnapshotHeader));
+		m_entries = reinterpret_cast<const Entry*>(m_file.Data() + header.entriesOffset);
+		m_size = static_cast<size_t>(header.bucketCount);
+		m_count = static_cast<size_t>(header.count);
+		if (m_bucketStart[0] != 0 || m_bucketStart[m_size] != m_count)
+			throw std::runtime_error("HashTableView: " + path + " is truncated or corrupt");
+		for (size_t bucket = 0; bucket < m_size; ++bucket) {
+			if (m_bucketStart[bucket] > m_bucketStart[bucket + 1])
+				throw std::runtime_error("HashTableView: " + path + " is truncated or corrupt");
+		}
+		if (verifyChecksum && HashBytes(m_entries, header.count * sizeof(Entry), HashBytes(m_bucketStart, startBytes)) != header.checksum)
+			throw std::runtime_error("HashTableView: " + path + " does not match its checksum");
+
+		m_seed = header.hashSeed;
+		m_hash = Hash(m_seed);
+	}
+
+	HashTableView(HashTableView&&) noexcept = default;
+	HashTableView& operator=(HashTableView&&) noexcept = default;
+
+	//Lookup
+	const Value* Find(const Key& key) const
+	{
+		size_t bucket = PowerOfTwoBuckets::Index(m_hash(key), m_size);
+		const Entry* end = m_entries + m_bucketStart[bucket + 1];
+		for (const Entry* entry = m_entries + m_bucketStart[bucket]; entry != end; ++entry) {
+			if (m_equal(entry->key, key))
+				return &entry->value;
+		}
+		return nullptr;
+	}
+
+	bool Contains(const Key& key) const
+	{
+		return Find(key) != nullptr;
+	}
+
+	//Capacity
+	size_t Size() const noexcept
+	{
+		return m_size;
+	}
+
+	size_t Count() const noexcept
+	{
+		return m_count;
+	}
+
+	bool IsEmpty() const noexcept
+	{
+		return m_count == 0;
+	}
+
+	float LoadFactor() const noexcept
+	{
+		return static_cast<float>(m_count) / static_cast<float>(m_size);
+	}
+
+	//Hash policy
+	uint64_t Seed() const noexcept
+	{
+		return m_seed;
+	}
+
+	//Iterators
+	Iterator begin() const noexcept
+	{
+		return Iterator(m_entries);
+	}
+
+	Iterator end() const noexcept
+	{
+		return Iterator(m_entries + m_count);
+	}
+
+private:
+	MappedFile m_file;
+	const uint64_t* m_bucketStart = nullptr;
+	const Entry* m_entries = nullptr;
+	size_t m_size = 0;
+	size_t m_count = 0;
+	uint64_t m_seed = 0;
+	Hash m_hash;
+	KeyEqual m_equal;
+};
+
+#endif //_HASHTABLESNAPSHOT_
@@ -1,6 +1,11 @@
 #ifndef _LINKEDLIST_
 #define _LINKEDLIST_
 
+#include<initializer_list>
+#include<memory>
+#include<memory_resource>
+#include<utility>
+
 template<typename LinkedList>
 class BaseListIterator
 {
@@ -15,6 +20,7 @@ public:
 	bool operator!=(const BaseListIterator& other) const noexcept { return m_current != other.m_current; }
 	ReferenceType Value() const noexcept { return m_current->data; }
 protected:
+	friend LinkedList;
 	NodePtr m_current;
 };
 
@@ -108,30 +114,39 @@ public:
 	}
 };
 
-template<typename T>
+// Nodes come from Allocator, rebound to the node type. The elements are constructed with uses-allocator
+// construction, so the elements of a PmrLinkedList<std::pmr::string> allocate from the list's resource too.
+template<typename T, typename Allocator = std::allocator<T>>
 class LinkedList
 {
 private:
 	struct Node {
-		Node() : data{ 0 }, next{ nullptr }, previous{ nullptr } {}
-		Node(const T& value) : data{ value }, next{ nullptr }, previous{ nullptr } {}
+		template<typename NodeAllocator, typename... Args>
+		Node(const NodeAllocator& allocator, Args&&... args)
+			: data(std::make_obj_using_allocator<T>(allocator, std::forward<Args>(args)...)), next{ nullptr }, previous{ nullptr } {}
 		T data;
 		Node* next;
 		Node* previous;
 	};
 
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using NodeTraits = std::allocator_traits<NodeAllocator>;
+
 public:
 	using ValueType = T;
+	using AllocatorType = Allocator;
 	using NodePtr = Node*;
-	using Iterator = ListIterator<LinkedList<T>>;
-	using ConstIterator = ListConstIterator<LinkedList<T>>;
-	using ReverseIterator = ListReverseIterator<LinkedList<T>>;
+	using Iterator = ListIterator<LinkedList>;
+	using ConstIterator = ListConstIterator<LinkedList>;
+	using ReverseIterator = ListReverseIterator<LinkedList>;
 public:
 	//Constructors
-	LinkedList()
-		: m_head(nullptr), m_tail(nullptr), m_size(0) {}
+	LinkedList() : LinkedList(Allocator()) {}
+
+	explicit LinkedList(const Allocator& allocator)
+		: m_size(0), m_head(nullptr), m_tail(nullptr), m_allocator(allocator) {}
 
-	LinkedList(size_t count, const T& value) : LinkedList()
+	LinkedList(size_t count, const T& value, const Allocator& allocator = Allocator()) : LinkedList(allocator)
 	{
 		while (count > 0) {
 			PushBack(value);
@@ -139,7 +154,7 @@ public:
 		}
 	}
 
-	LinkedList(std::initializer_list<T> list) : LinkedList()
+	LinkedList(std::initializer_list<T> list, const Allocator& allocator = Allocator()) : LinkedList(allocator)
 	{
 		for (const auto& element : list)
 			PushBack(element);
@@ -150,7 +165,10 @@ public:
 		Clear();
 	}
 
-	LinkedList(const LinkedList& other) : LinkedList()
+	LinkedList(const LinkedList& other)
+		: LinkedList(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.GetAllocator())) {}
+
+	LinkedList(const LinkedList& other, const Allocator& allocator) : LinkedList(allocator)
 	{
 		for (ConstIterator it = other.cbegin(); it != other.cend(); ++it) {
 			PushBack(*it);
@@ -158,7 +176,7 @@ public:
 	}
 
 	LinkedList(LinkedList&& other) noexcept
-		: m_head(other.m_head), m_tail(other.m_tail), m_size(other.m_size)
+		: m_size(other.m_size), m_head(other.m_head), m_tail(other.m_tail), m_allocator(other.m_allocator)
 	{
 		other.m_head = nullptr;
 		other.m_tail = nullptr;
@@ -166,10 +184,12 @@ public:
 	}
 
 	//Modifiers
-	void PushBack(const T& value)
+	// The insertion functions return an iterator to the new element. List iterators stay valid until their
+	// element is erased, so they can be kept as handles for O(1) Erase and Splice.
+	Iterator PushBack(const T& value)
 	{
 		NodePtr tempNode{ m_tail };
-		m_tail = new Node{ value };
+		m_tail = CreateNode(value);
 		++m_size;
 		if (tempNode) {
 			tempNode->next = m_tail;
@@ -178,12 +198,13 @@ public:
 		else {
 			m_head = m_tail;
 		}
+		return Iterator(m_tail);
 	}
 
-	void PushFront(const T& value)
+	Iterator PushFront(const T& value)
 	{
 		NodePtr tempNode{ m_head };
-		m_head = new Node{ value };
+		m_head = CreateNode(value);
 		++m_size;
 
 		if (tempNode) {
@@ -193,13 +214,14 @@ public:
 		else {
 			m_tail = m_head;
 		}
+		return Iterator(m_head);
 	}
 
 	template<typename... Args>
-	void EmplaceBack(Args&&... args)
+	Iterator EmplaceBack(Args&&... args)
 	{
 		NodePtr tempNode{ m_tail };
-		m_tail = new Node(std::forward<Args>(args)...);
+		m_tail = CreateNode(std::forward<Args>(args)...);
 		++m_size;
 		if (tempNode) {
 			tempNode->next = m_tail;
@@ -208,13 +230,14 @@ public:
 		else {
 			m_head = m_tail;
 		}
+		return Iterator(m_tail);
 	}
 
 	template<typename... Args>
-	void EmplaceFront(Args&&... args)
+	Iterator EmplaceFront(Args&&... args)
 	{
 		NodePtr tempNode{ m_head };
-		m_head = new Node(std::forward<Args>(args)...);
+		m_head = CreateNode(std::forward<Args>(args)...);
 		++m_size;
 
 		if (tempNode) {
@@ -224,6 +247,34 @@ public:
 		else {
 			m_tail = m_head;
 		}
+		return Iterator(m_head);
+	}
+
+	// Removes the element in O(1) and returns an iterator to the one after it.
+	Iterator Erase(Iterator position)
+	{
+		NodePtr node = position.m_current;
+		NodePtr next = node->next;
+		Unlink(node);
+		DestroyNode(node);
+		return Iterator(next);
+	}
+
+	// Moves element from other, which may be this list, in front of position in O(1). No element is copied
+	// and iterators to the moved element stay valid. Both lists must have equal allocators.
+	void Splice(Iterator position, LinkedList& other, Iterator element)
+	{
+		NodePtr node = element.m_current;
+		if (node == position.m_current)
+			return;
+
+		other.Unlink(node);
+		LinkBefore(position.m_current, node);
+	}
+
+	void MoveToFront(Iterator element)
+	{
+		Splice(begin(), *this, element);
 	}
 
 	void PopBack()
@@ -236,7 +287,7 @@ public:
 			m_tail = tempNode->previous;
 			m_tail->next = nullptr;
 		}
-		delete tempNode;
+		DestroyNode(tempNode);
 		--m_size;
 	}
 
@@ -250,7 +301,7 @@ public:
 			m_head = tempNode->next;
 			m_head->previous = nullptr;
 		}
-		delete tempNode;
+		DestroyNode(tempNode);
 		--m_size;
 	}
 
@@ -259,11 +310,12 @@ public:
 		while (!Empty()) PopFront();
 	}
 
+	// Swaps the allocators only if the allocator propagates on swap; otherwise both must compare equal.
 	void Swap(LinkedList& other) noexcept
 	{
-		std::swap(m_head, other.m_head);
-		std::swap(m_tail, other.m_tail);
-		std::swap(m_size, other.m_size);
+		SwapNodes(other);
+		if constexpr (NodeTraits::propagate_on_container_swap::value)
+			std::swap(m_allocator, other.m_allocator);
 	}
 
 	//Element access
@@ -286,6 +338,11 @@ public:
 		return false;
 	}
 
+	Allocator GetAllocator() const noexcept
+	{
+		return Allocator(m_allocator);
+	}
+
 	//Capacity
 	size_t Size() const noexcept
 	{
@@ -303,20 +360,36 @@ public:
 		if (*this == other)
 			return *this;
 
-		LinkedList(other).Swap(*this);
+		constexpr bool propagate = NodeTraits::propagate_on_container_copy_assignment::value;
+		LinkedList copy(other, propagate ? other.GetAllocator() : GetAllocator());
+		SwapNodes(copy);
+		if constexpr (propagate)
+			std::swap(m_allocator, copy.m_allocator);
 		return *this;
 	}
 
-	LinkedList& operator=(LinkedList&& other) noexcept
+	LinkedList& operator=(LinkedList&& other) noexcept(NodeTraits::propagate_on_container_move_assignment::value
+		|| NodeTraits::is_always_equal::value)
 	{
-		m_head = other.m_head;
-		m_tail = other.m_tail;
-		m_size = other.m_size;
+		if (this == &other)
+			return *this;
 
-		other.m_head = nullptr;
-		other.m_tail = nullptr;
-		other.m_size = 0;
+		constexpr bool propagate = NodeTraits::propagate_on_container_move_assignment::value;
+		if constexpr (!propagate && !NodeTraits::is_always_equal::value) {
+			// Nodes of another allocator cannot be adopted, so the elements move one by one.
+			if (m_allocator != other.m_allocator) {
+				LinkedList moved(GetAllocator());
+				for (T& element : other)
+					moved.EmplaceBack(std::move(element));
+				SwapNodes(moved);
+				return *this;
+			}
+		}
 
+		LinkedList moved(std::move(other));
+		SwapNodes(moved);
+		if constexpr (propagate)
+			std::swap(m_allocator, moved.m_allocator);
 		return *this;
 	}
 
@@ -344,16 +417,80 @@ public:
 
 	//Iterators
 	Iterator begin() { return Iterator(m_head); };
-	Iterator end() { return Iterator(m_tail->next); };
+	Iterator end() { return Iterator(nullptr); };
+	// Iterator to the last element, or end() if the list is empty.
+	Iterator Last() { return Iterator(m_tail); };
 	ConstIterator cbegin() const { return ConstIterator(m_head); };
-	ConstIterator cend() const { return ConstIterator(m_tail->next); };
+	ConstIterator cend() const { return ConstIterator(nullptr); };
 	ReverseIterator rbegin() { return ReverseIterator(m_tail); };
-	ReverseIterator rend() { return ReverseIterator(m_head->previous); };
+	ReverseIterator rend() { return ReverseIterator(nullptr); };
 
 private:
+	template<typename... Args>
+	NodePtr CreateNode(Args&&... args)
+	{
+		NodePtr node = NodeTraits::allocate(m_allocator, 1);
+		try {
+			NodeTraits::construct(m_allocator, node, m_allocator, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			NodeTraits::deallocate(m_allocator, node, 1);
+			throw;
+		}
+		return node;
+	}
+
+	void DestroyNode(NodePtr node) noexcept
+	{
+		NodeTraits::destroy(m_allocator, node);
+		NodeTraits::deallocate(m_allocator, node, 1);
+	}
+
+	void SwapNodes(LinkedList& other) noexcept
+	{
+		std::swap(m_head, other.m_head);
+		std::swap(m_tail, other.m_tail);
+		std::swap(m_size, other.m_size);
+	}
+
+	void Unlink(NodePtr node) noexcept
+	{
+		if (node->previous != nullptr)
+			node->previous->next = node->next;
+		else
+			m_head = node->next;
+		if (node->next != nullptr)
+			node->next->previous = node->previous;
+		else
+			m_tail = node->previous;
+		node->next = node->previous = nullptr;
+		--m_size;
+	}
+
+	// A null position links the node at the back.
+	void LinkBefore(NodePtr position, NodePtr node) noexcept
+	{
+		node->next = position;
+		node->previous = position != nullptr ? position->previous : m_tail;
+		if (node->previous != nullptr)
+			node->previous->next = node;
+		else
+			m_head = node;
+		if (position != nullptr)
+			position->previous = node;
+		else
+			m_tail = node;
+		++m_size;
+	}
+
 	size_t m_size;
 	NodePtr m_head;
 	NodePtr m_tail;
+	[[no_unique_address]] NodeAllocator m_allocator;
 };
 
+// LinkedList whose nodes come from a std::pmr::memory_resource, such as a PoolResource or a MonotonicArena.
+template<typename T>
+using PmrLinkedList = LinkedList<T, std::pmr::polymorphic_allocator<T>>;
+
 #endif //_LINKEDLIST_
\ No newline at end of file
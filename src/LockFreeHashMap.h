@@ -0,0 +1,532 @@
+#ifndef _LOCKFREEHASHMAP_
+#define _LOCKFREEHASHMAP_
+
+#include<atomic>
+#include<bit>
+#include<cstdint>
+#include<functional>
+
+#include"Epoch.h"
+#include"Hash.h"
+
+// Forward iterator over a LockFreeHashMap. It holds an epoch guard, so the element it points to stays readable
+// even if another thread erases it, and it must stay on the thread that created it. Elements inserted or erased
+// during the iteration may or may not be visited; every element present for the whole iteration is visited once.
+template<typename LockFreeHashMap>
+class LockFreeHashIterator
+{
+public:
+	using ValueType = typename LockFreeHashMap::ValueType;
+	using KeyType = typename LockFreeHashMap::KeyType;
+	using NodeBase = typename LockFreeHashMap::NodeBase;
+	using Node = typename LockFreeHashMap::Node;
+	using ReferenceType = const ValueType&;
+	using PointerType = const ValueType*;
+
+public:
+	explicit LockFreeHashIterator(const NodeBase* start) noexcept
+		: m_current(nullptr), m_value(nullptr)
+	{
+		Advance(start);
+	}
+
+	ReferenceType operator*() const noexcept { return *m_value; }
+
+	ReferenceType Value() const noexcept { return *m_value; }
+	const KeyType& Key() const noexcept { return m_current->key; }
+	PointerType operator->() const noexcept { return m_value; }
+	bool operator==(const LockFreeHashIterator& other) const noexcept
+	{
+		return m_current == other.m_current;
+	}
+	bool operator!=(const LockFreeHashIterator& other) const noexcept { return m_current != other.m_current; }
+	LockFreeHashIterator& operator++() noexcept
+	{
+		Advance(m_current);
+		return *this;
+	}
+	LockFreeHashIterator operator++(int) noexcept
+	{
+		LockFreeHashIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+private:
+	// Moves to the first live element after from, skipping bucket markers and erased elements.
+	void Advance(const NodeBase* from) noexcept
+	{
+		m_current = nullptr;
+		m_value = nullptr;
+		for (const NodeBase* node = from != nullptr ? LockFreeHashMap::Next(from) : nullptr; node != nullptr;
+			node = LockFreeHashMap::Next(node)) {
+			if (!LockFreeHashMap::IsElement(node))
+				continue;
+
+			const Node* element = static_cast<const Node*>(node);
+			const ValueType* value = element->value.load(std::memory_order_acquire);
+			if (value != LockFreeHashMap::ErasedValue()) {
+				m_current = element;
+				m_value = value;
+				return;
+			}
+		}
+	}
+
+	EpochReclaimer::Guard m_guard;
+	const Node* m_current;
+	const ValueType* m_value;
+};
+
+// Lock-free hash map for read-mostly workloads, built as a split-ordered list (Shalev and Shavit): all elements
+// live in one lock-free linked list sorted by their bit-reversed hash, and every bucket is a shortcut pointer to a
+// marker node inside that list. Doubling the bucket count only splits buckets in place, so the map grows without
+// moving elements or blocking anyone.
+//
+// Find and Contains are wait-free: they take no lock and perform no atomic read-modify-write, only loads and the
+// store and fence of an epoch guard. Insert and Erase are lock-free. Values are immutable once published; Insert
+// on an existing key swaps in a new value with one compare-and-swap, and readers copy the value out. Unlinked
+// nodes and replaced values are freed through EpochReclaimer once no reader can still see them.
+template<typename Key, typename Value, typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+class LockFreeHashMap
+{
+private:
+	friend class LockFreeHashIterator<LockFreeHashMap>;
+
+	// The low bit of a next pointer marks the node holding it as being unlinked.
+	static constexpr uintptr_t Marked = 1;
+	// Segment s of the bucket directory holds 2^(s-1) buckets, so 64 segments cover every bucket index.
+	static constexpr size_t SegmentCount = 64;
+	static constexpr size_t MaxLoadFactor = 1;
+
+	// List link and split-order key; elements have odd keys and bucket markers even ones.
+	struct NodeBase
+	{
+		explicit NodeBase(uint64_t order) noexcept : next(0), order(order) {}
+
+		std::atomic<uintptr_t> next;
+		uint64_t order;
+	};
+
+	enum BucketState : uint8_t { Unlinked, Linking, Linked };
+
+	// Bucket markers are stored in the bucket directory itself, so finding a bucket and reading the head of its
+	// run is a single memory access. The thread that moves a marker from Unlinked to Linking inserts it.
+	struct Bucket : NodeBase
+	{
+		Bucket() noexcept : NodeBase(0), state(Unlinked) {}
+
+		std::atomic<BucketState> state;
+	};
+
+	// The value an element is inserted with lives in the node, so reading a never-updated element touches a
+	// single allocation; only replacement values are allocated separately.
+	struct Node : NodeBase
+	{
+		Node(uint64_t order, const Key& k, const Value& v) : NodeBase(order), key(k), initial(v), value(&initial) {}
+
+		const Key key;
+		Value initial;
+		std::atomic<Value*> value;
+	};
+
+public:
+	using ValueType = Value;
+	using KeyType = Key;
+	using Iterator = LockFreeHashIterator<LockFreeHashMap>;
+public:
+	//Constructors
+	// buckets is rounded up to a power of two.
+	explicit LockFreeHashMap(size_t buckets = 16, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+		: m_size(std::bit_ceil(buckets > 0 ? buckets : 1)), m_count(0), m_hash(hash), m_equal(equal)
+	{
+		for (std::atomic<Bucket*>& segment : m_segments)
+			segment.store(nullptr, std::memory_order_relaxed);
+		m_head = &BucketAt(0);
+		m_head->state.store(Linked, std::memory_order_release);
+		InitializeBuckets(1, Size());
+	}
+
+	LockFreeHashMap(const LockFreeHashMap&) = delete;
+	LockFreeHashMap& operator=(const LockFreeHashMap&) = delete;
+
+	// Must not run concurrently with any other access; nodes already retired are freed by EpochReclaimer.
+	~LockFreeHashMap()
+	{
+		for (NodeBase* node = m_head; node != nullptr;) {
+			NodeBase* next = Pointer(node->next.load(std::memory_order_relaxed));
+			if (IsElement(node))
+				DeleteNode(static_cast<Node*>(node));
+			node = next;
+		}
+		for (std::atomic<Bucket*>& segment : m_segments)
+			delete[] segment.load(std::memory_order_relaxed);
+	}
+
+	//Lookup
+	// Copies the value of the key into value and returns true if the key is present.
+	bool Find(const Key& key, Value& value) const
+	{
+		EpochReclaimer::Guard guard;
+		const Value* found = FindValue(key);
+		if (found == nullptr)
+			return false;
+
+		value = *found;
+		return true;
+	}
+
+	bool Contains(const Key& key) const
+	{
+		EpochReclaimer::Guard guard;
+		return FindValue(key) != nullptr;
+	}
+
+	//Capacity
+	// Number of buckets; grows by doubling once the average bucket holds more than MaxLoadFactor elements.
+	size_t Size() const noexcept
+	{
+		return m_size.load(std::memory_order_relaxed);
+	}
+
+	// Number of stored elements; exact only while no other thread is modifying the map.
+	size_t Count() const noexcept
+	{
+		return m_count.load(std::memory_order_relaxed);
+	}
+
+	bool IsEmpty() const noexcept
+	{
+		return Count() == 0;
+	}
+
+	float LoadFactor() const noexcept
+	{
+		return static_cast<float>(Count()) / Size();
+	}
+
+	//Modifiers
+	// Erases every element present when the call starts; concurrent inserts may survive it.
+	void Clear()
+	{
+		for (Iterator it = begin(); it != end(); ++it)
+			Erase(it.Key());
+	}
+
+	// Inserts the key or replaces its value.
+	void Insert(const Key& key, const Value& value)
+	{
+		EpochReclaimer::Guard guard;
+		uint64_t hash = HashOf(key);
+		uint64_t order = ElementOrder(hash);
+		NodeBase* start = GetBucket(hash & (Size() - 1));
+		Value* newValue = nullptr;
+		Node* node = nullptr;
+
+		while (true) {
+			std::atomic<uintptr_t>* link;
+			NodeBase* current;
+			if (Search(start, order, &key, link, current)) {
+				Node* found = static_cast<Node*>(current);
+				Value* old = found->value.load(std::memory_order_acquire);
+				if (old != ErasedValue() && newValue == nullptr)
+					newValue = new Value(value);
+				while (old != ErasedValue()) {
+					if (found->value.compare_exchange_weak(old, newValue, std::memory_order_acq_rel)) {
+						RetireValue(found, old);
+						delete node;
+						return;
+					}
+				}
+				// The element is being erased: finish marking it so the next search unlinks it.
+				Mark(found);
+				continue;
+			}
+
+			if (node == nullptr)
+				node = new Node(order, key, value);
+			node->next.store(reinterpret_cast<uintptr_t>(current), std::memory_order_relaxed);
+			uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+			if (link->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node), std::memory_order_release))
+				break;
+		}
+		delete newValue;
+
+		size_t count = m_count.fetch_add(1, std::memory_order_relaxed) + 1;
+		size_t size = Size();
+		if (count > size * MaxLoadFactor && size < (size_t{ 1 } << (SegmentCount - 2)) &&
+			m_size.compare_exchange_strong(size, size * 2, std::memory_order_relaxed))
+			InitializeBuckets(size, size * 2);
+	}
+
+	bool Erase(const Key& key)
+	{
+		EpochReclaimer::Guard guard;
+		uint64_t hash = HashOf(key);
+		uint64_t order = ElementOrder(hash);
+		NodeBase* start = GetBucket(hash & (Size() - 1));
+
+		std::atomic<uintptr_t>* link;
+		NodeBase* current;
+		if (!Search(start, order, &key, link, current))
+			return false;
+
+		// Swapping in the erased marker is the point at which the element disappears for readers.
+		Node* found = static_cast<Node*>(current);
+		Value* old = found->value.load(std::memory_order_acquire);
+		do {
+			if (old == ErasedValue()) {
+				Mark(found);
+				return false;
+			}
+		} while (!found->value.compare_exchange_weak(old, ErasedValue(), std::memory_order_acq_rel));
+
+		RetireValue(found, old);
+		m_count.fetch_sub(1, std::memory_order_relaxed);
+
+		Mark(found);
+		uintptr_t expected = reinterpret_cast<uintptr_t>(found);
+		uintptr_t next = found->next.load(std::memory_order_acquire) & ~Marked;
+		if (link->compare_exchange_strong(expected, next, std::memory_order_release))
+			RetireNode(found);
+		else
+			Search(start, order, &key, link, current);
+		return true;
+	}
+
+	//Iterators
+	Iterator begin() const
+	{
+		return Iterator(m_head);
+	}
+
+	Iterator end() const
+	{
+		return Iterator(nullptr);
+	}
+
+private:
+	static NodeBase* Pointer(uintptr_t link) noexcept
+	{
+		return reinterpret_cast<NodeBase*>(link & ~Marked);
+	}
+
+	static const NodeBase* Next(const NodeBase* node) noexcept
+	{
+		return Pointer(node->next.load(std::memory_order_acquire));
+	}
+
+	static bool IsElement(const NodeBase* node) noexcept
+	{
+		return (node->order & 1) != 0;
+	}
+
+	// Replaced and erased values are swapped for the address of this buffer, which is never a live value.
+	static Value* ErasedValue() noexcept
+	{
+		return reinterpret_cast<Value*>(s_erased);
+	}
+
+	static uint64_t ReverseBits(uint64_t value) noexcept
+	{
+		value = ((value >> 1) & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+		value = ((value >> 2) & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+		value = ((value >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((value & 0x0F0F0F0F0F0F0F0Full) << 4);
+		value = ((value >> 8) & 0x00FF00FF00FF00FFull) | ((value & 0x00FF00FF00FF00FFull) << 8);
+		value = ((value >> 16) & 0x0000FFFF0000FFFFull) | ((value & 0x0000FFFF0000FFFFull) << 16);
+		return (value >> 32) | (value << 32);
+	}
+
+	// Sorting by the reversed hash keeps every bucket contiguous in the list, and splitting bucket b into b and
+	// b + size only inserts a new marker in the middle of it. The top bit keeps element keys odd.
+	static uint64_t ElementOrder(uint64_t hash) noexcept
+	{
+		return ReverseBits(hash | (uint64_t{ 1 } << 63));
+	}
+
+	static uint64_t BucketOrder(size_t bucket) noexcept
+	{
+		return ReverseBits(bucket);
+	}
+
+	// The bucket a new bucket is split from: the same index without its highest set bit.
+	static size_t ParentBucket(size_t bucket) noexcept
+	{
+		return bucket & ~std::bit_floor(bucket);
+	}
+
+	static void DeleteNode(Node* node)
+	{
+		Value* value = node->value.load(std::memory_order_relaxed);
+		if (value != ErasedValue() && value != &node->initial)
+			delete value;
+		delete node;
+	}
+
+	// A replaced value is freed once readers are done with it, unless it is the one stored in the node.
+	static void RetireValue(Node* node, Value* value)
+	{
+		if (value != &node->initial)
+			EpochReclaimer::Retire(value);
+	}
+
+	static void RetireNode(Node* node)
+	{
+		EpochReclaimer::Retire(node, [](void* p) { DeleteNode(static_cast<Node*>(p)); });
+	}
+
+	static void Mark(Node* node)
+	{
+		uintptr_t next = node->next.load(std::memory_order_acquire);
+		while ((next & Marked) == 0 &&
+			!node->next.compare_exchange_weak(next, next | Marked, std::memory_order_acq_rel));
+	}
+
+	// The mixed hash supplies good low bits for the bucket index even when Hash is the identity.
+	uint64_t HashOf(const Key& key) const
+	{
+		return HashMix64(static_cast<uint64_t>(m_hash(key)));
+	}
+
+	static size_t SegmentOf(size_t bucket) noexcept
+	{
+		return std::bit_width(bucket);
+	}
+
+	static size_t SegmentOffset(size_t bucket, size_t segment) noexcept
+	{
+		return segment == 0 ? 0 : bucket - (size_t{ 1 } << (segment - 1));
+	}
+
+	// Returns the marker of the bucket, allocating its segment of the directory on first use.
+	Bucket& BucketAt(size_t bucket)
+	{
+		size_t segment = SegmentOf(bucket);
+		Bucket* buckets = m_segments[segment].load(std::memory_order_acquire);
+		if (buckets == nullptr) {
+			size_t count = segment == 0 ? 1 : size_t{ 1 } << (segment - 1);
+			size_t first = bucket - SegmentOffset(bucket, segment);
+			Bucket* allocated = new Bucket[count];
+			for (size_t i = 0; i < count; ++i)
+				allocated[i].order = BucketOrder(first + i);
+			if (m_segments[segment].compare_exchange_strong(buckets, allocated, std::memory_order_acq_rel))
+				buckets = allocated;
+			else
+				delete[] allocated;
+		}
+		return buckets[SegmentOffset(bucket, segment)];
+	}
+
+	// Read-only bucket lookup: a bucket not linked yet falls back to the bucket it is split from, whose marker
+	// precedes it in the list.
+	const NodeBase* FindBucket(size_t bucket) const
+	{
+		while (true) {
+			size_t segment = SegmentOf(bucket);
+			const Bucket* buckets = m_segments[segment].load(std::memory_order_acquire);
+			if (buckets != nullptr) {
+				const Bucket& marker = buckets[SegmentOffset(bucket, segment)];
+				if (marker.state.load(std::memory_order_acquire) == Linked)
+					return &marker;
+			}
+			bucket = ParentBucket(bucket);
+		}
+	}
+
+	// Returns a marker to search the bucket from, linking the bucket's own marker and its missing parents into
+	// the list first. While another thread is linking the marker the parent's marker is returned instead.
+	NodeBase* GetBucket(size_t bucket)
+	{
+		Bucket& marker = BucketAt(bucket);
+		if (marker.state.load(std::memory_order_acquire) == Linked)
+			return &marker;
+
+		NodeBase* parent = GetBucket(ParentBucket(bucket));
+		BucketState state = Unlinked;
+		if (!marker.state.compare_exchange_strong(state, Linking, std::memory_order_acq_rel))
+			return state == Linked ? &marker : parent;
+
+		while (true) {
+			std::atomic<uintptr_t>* link;
+			NodeBase* current;
+			Search(parent, marker.order, nullptr, link, current);
+			marker.next.store(reinterpret_cast<uintptr_t>(current), std::memory_order_relaxed);
+			uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+			if (link->compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(&marker), std::memory_order_release))
+				break;
+		}
+
+		marker.state.store(Linked, std::memory_order_release);
+		return &marker;
+	}
+
+	// The thread that doubles the bucket count splits all new buckets right away, so readers, which cannot
+	// initialize buckets themselves, do not keep scanning the twice as long run of the parent bucket.
+	void InitializeBuckets(size_t first, size_t last)
+	{
+		EpochReclaimer::Guard guard;
+		for (size_t bucket = first; bucket < last; ++bucket)
+			GetBucket(bucket);
+	}
+
+	// Wait-free read path: walks the bucket's run of the list and ignores marks, since an erased element is
+	// recognized by its value.
+	const Value* FindValue(const Key& key) const
+	{
+		uint64_t hash = HashOf(key);
+		uint64_t order = ElementOrder(hash);
+		for (const NodeBase* node = Next(FindBucket(hash & (Size() - 1))); node != nullptr; node = Next(node)) {
+			if (node->order > order)
+				break;
+			if (node->order == order && m_equal(static_cast<const Node*>(node)->key, key)) {
+				const Value* value = static_cast<const Node*>(node)->value.load(std::memory_order_acquire);
+				if (value != ErasedValue())
+					return value;
+			}
+		}
+		return nullptr;
+	}
+
+	// Michael's list search from start: on return link is the unmarked link that points to current, and current
+	// is either the node of the key (result true) or the first node ordered after it. A null key looks for the
+	// bucket marker of that order. Marked nodes on the way are unlinked and retired.
+	bool Search(NodeBase* start, uint64_t order, const Key* key, std::atomic<uintptr_t>*& link, NodeBase*& current)
+	{
+	retry:
+		link = &start->next;
+		current = Pointer(link->load(std::memory_order_acquire));
+		while (current != nullptr) {
+			uintptr_t next = current->next.load(std::memory_order_acquire);
+			if ((next & Marked) != 0) {
+				uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+				if (!link->compare_exchange_strong(expected, next & ~Marked, std::memory_order_acq_rel))
+					goto retry;
+				RetireNode(static_cast<Node*>(current));
+				current = Pointer(next);
+				continue;
+			}
+			if (link->load(std::memory_order_acquire) != reinterpret_cast<uintptr_t>(current))
+				goto retry;
+
+			if (current->order > order)
+				return false;
+			if (current->order == order && (key == nullptr || m_equal(static_cast<Node*>(current)->key, *key)))
+				return true;
+
+			link = &current->next;
+			current = Pointer(next);
+		}
+		return false;
+	}
+
+private:
+	alignas(Value) static inline unsigned char s_erased[sizeof(Value)] = {};
+
+	std::atomic<Bucket*> m_segments[SegmentCount];
+	Bucket* m_head;
+	std::atomic<size_t> m_size;
+	std::atomic<size_t> m_count;
+	Hash m_hash;
+	KeyEqual m_equal;
+};
+
+#endif //_LOCKFREEHASHMAP_
@@ -0,0 +1,132 @@
+#ifndef _MAPPEDFILE_
+#define _MAPPEDFILE_
+
+#include<cstddef>
+#include<stdexcept>
+#include<string>
+#include<utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include<windows.h>
+#else
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif
+
+// Read-only mapping of a whole file; the pages are loaded on first access.
+class MappedFile
+{
+public:
+	//Constructors
+	explicit MappedFile(const std::string& path)
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::runtime_error("MappedFile: cannot open " + path);
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size)) {
+			CloseHandle(file);
+			throw std::runtime_error("MappedFile: cannot read the size of " + path);
+		}
+		m_size = static_cast<size_t>(size.QuadPart);
+		if (m_size > 0) {
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr) {
+				m_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			throw std::runtime_error("MappedFile: cannot open " + path);
+		struct stat status;
+		if (fstat(file, &status) != 0) {
+			close(file);
+			throw std::runtime_error("MappedFile: cannot read the size of " + path);
+		}
+		m_size = static_cast<size_t>(status.st_size);
+		if (m_size > 0) {
+			void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, file, 0);
+			m_data = data != MAP_FAILED ? data : nullptr;
+		}
+		close(file);
+#endif
+		if (m_size > 0 && m_data == nullptr)
+			throw std::runtime_error("MappedFile: cannot map " + path);
+	}
+
+	MappedFile(MappedFile&& other) noexcept
+		: m_data(other.m_data), m_size(other.m_size)
+	{
+		other.m_data = nullptr;
+		other.m_size = 0;
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile()
+	{
+		if (m_data == nullptr)
+			return;
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+#else
+		munmap(m_data, m_size);
+#endif
+	}
+
+	//Operators
+	MappedFile& operator=(MappedFile&& other) noexcept
+	{
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+		return *this;
+	}
+
+	//Element access
+	const unsigned char* Data() const noexcept
+	{
+		return static_cast<const unsigned char*>(m_data);
+	}
+
+	//Capacity
+	size_t Size() const noexcept
+	{
+		return m_size;
+	}
+
+private:
+	void* m_data = nullptr;
+	size_t m_size = 0;
+};
+
+// Waits until the contents of the file at path are stored on disk. Returns false if it cannot open or sync it.
+inline bool SyncFile(const std::string& path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	bool synced = FlushFileBuffers(file) != 0;
+	CloseHandle(file);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	bool synced = fsync(file) == 0;
+	close(file);
+#endif
+	return synced;
+}
+
+#endif //_MAPPEDFILE_
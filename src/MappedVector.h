@@ -0,0 +1,358 @@
+#ifndef _MAPPEDVECTOR_
+#define _MAPPEDVECTOR_
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include<algorithm>
+#include<cstdint>
+#include<span>
+#include<stdexcept>
+#include<string>
+#include<type_traits>
+#include<utility>
+
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+#include"Vector.h"
+
+// Access pattern hints for MappedVector::Advise, passed on to madvise.
+enum class MappedAccess
+{
+	Normal,
+	// Read ahead aggressively and drop pages soon after they were read.
+	Sequential,
+	// Read no more than the pages touched.
+	Random,
+	// Start reading the whole file in the background.
+	WillNeed,
+};
+
+// Vector of trivially copyable elements stored in a file that is mapped into memory, so it can hold more data
+// than fits in RAM: the kernel pages elements in on access and writes dirty pages back on its own schedule.
+// Growing extends the file and remaps it (with mremap on Linux), so appends never copy existing elements. The
+// file starts with a 64-byte header holding the element count, and Open checks the header and maps an existing
+// file without reading the elements. Writes become durable at Flush; the header and the elements are flushed
+// together, but after a crash without a Flush the file may hold any mix of old and new pages. Not thread-safe.
+template<typename T, typename Growth = GeometricGrowth<>>
+	requires std::is_trivially_copyable_v<T>
+class MappedVector
+{
+private:
+	struct alignas(64) Header
+	{
+		static constexpr uint64_t Magic = 0x4345565F4450414Dull; // "MAPD_VEC"
+		static constexpr uint32_t CurrentVersion = 1;
+
+		uint64_t magic;
+		uint32_t version;
+		uint32_t elementSize;
+		uint64_t size;
+	};
+
+	static_assert(alignof(T) <= alignof(Header), "MappedVector elements must not need more than 64-byte alignment");
+
+public:
+	using ValueType = T;
+	using Iterator = VecIterator<MappedVector>;
+	using ReverseIterator = VecReverseIterator<MappedVector>;
+
+	// Smallest capacity a file is created or grown with, so that short vectors still fill a few pages.
+	static constexpr size_t MinCapacity = std::max<size_t>(16384 / sizeof(T), 1);
+public:
+	//Constructors
+	// Creates the file at path, replacing any existing one, with room for capacity elements.
+	static MappedVector Create(const std::string& path, size_t capacity = 0)
+	{
+		int file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (file < 0)
+			throw std::runtime_error("MappedVector: cannot create " + path);
+
+		MappedVector vector(path, file);
+		vector.Remap(std::max(capacity, MinCapacity));
+		*vector.m_header = Header{ Header::Magic, Header::CurrentVersion, sizeof(T), 0 };
+		return vector;
+	}
+
+	// Maps an existing file written by a MappedVector of the same element type. Throws std::runtime_error if
+	// the file is missing or was not written by one.
+	static MappedVector Open(const std::string& path)
+	{
+		int file = open(path.c_str(), O_RDWR);
+		if (file < 0)
+			throw std::runtime_error("MappedVector: cannot open " + path);
+
+		// The header is read and checked before mapping, so that a file of another format is never resized.
+		MappedVector vector(path, file);
+		struct stat status;
+		Header header;
+		if (fstat(file, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Header)
+			|| pread(file, &header, sizeof(Header), 0) != static_cast<ssize_t>(sizeof(Header)))
+			throw std::runtime_error("MappedVector: " + path + " is too small");
+		if (header.magic != Header::Magic || header.version != Header::CurrentVersion)
+			throw std::runtime_error("MappedVector: " + path + " is not a MappedVector file");
+		if (header.elementSize != sizeof(T))
+			throw std::runtime_error("MappedVector: " + path + " holds elements of another type");
+
+		size_t bytes = static_cast<size_t>(status.st_size) - sizeof(Header);
+		if (bytes % sizeof(T) != 0 || header.size > bytes / sizeof(T))
+			throw std::runtime_error("MappedVector: " + path + " is damaged");
+		vector.Map(bytes / sizeof(T));
+		return vector;
+	}
+
+	MappedVector(MappedVector&& other) noexcept
+		: m_path(std::move(other.m_path)), m_file(std::exchange(other.m_file, -1)),
+		m_header(std::exchange(other.m_header, nullptr)), m_data(std::exchange(other.m_data, nullptr)),
+		m_capacity(std::exchange(other.m_capacity, 0)), m_access(other.m_access) {}
+
+	MappedVector(const MappedVector&) = delete;
+	MappedVector& operator=(const MappedVector&) = delete;
+
+	// Unmaps the file without flushing it; the kernel still writes the dirty pages back eventually.
+	~MappedVector()
+	{
+		Close();
+	}
+
+	//Operators
+	MappedVector& operator=(MappedVector&& other) noexcept
+	{
+		if (this != &other) {
+			Close();
+			m_path = std::move(other.m_path);
+			m_file = std::exchange(other.m_file, -1);
+			m_header = std::exchange(other.m_header, nullptr);
+			m_data = std::exchange(other.m_data, nullptr);
+			m_capacity = std::exchange(other.m_capacity, 0);
+			m_access = other.m_access;
+		}
+		return *this;
+	}
+
+	const T& operator[](size_t index) const
+	{
+		if (index >= Size())
+			throw std::out_of_range("index out of range");
+		return m_data[index];
+	}
+
+	T& operator[](size_t index)
+	{
+		return const_cast<T&>(std::as_const(*this)[index]);
+	}
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return Size() == 0;
+	}
+
+	size_t Size() const noexcept
+	{
+		return m_header != nullptr ? static_cast<size_t>(m_header->size) : 0;
+	}
+
+	size_t Capacity() const noexcept
+	{
+		return m_capacity;
+	}
+
+	// Extends the file until capacity elements fit.
+	void Reserve(size_t capacity)
+	{
+		if (capacity > m_capacity)
+			Remap(capacity);
+	}
+
+	// Truncates the file to the current size.
+	void ShrinkToFit()
+	{
+		if (Size() < m_capacity)
+			Remap(Size());
+	}
+
+	//Element access
+	T* Data() noexcept
+	{
+		return m_data;
+	}
+
+	const T* Data() const noexcept
+	{
+		return m_data;
+	}
+
+	std::span<T> Span() noexcept
+	{
+		return std::span<T>(m_data, Size());
+	}
+
+	std::span<const T> Span() const noexcept
+	{
+		return std::span<const T>(m_data, Size());
+	}
+
+	const std::string& Path() const noexcept
+	{
+		return m_path;
+	}
+
+	//Modifiers
+	void PushBack(const T& value)
+	{
+		EmplaceBack(value);
+	}
+
+	// The element is built before the file grows, so the arguments may refer to elements of this vector.
+	template<typename... Args>
+	T& EmplaceBack(Args&&... args)
+	{
+		T value(std::forward<Args>(args)...);
+		size_t size = Size();
+		if (size == m_capacity)
+			Remap(Growth::Capacity(m_capacity, size + 1));
+
+		m_data[size] = value;
+		m_header->size = size + 1;
+		return m_data[size];
+	}
+
+	void PopBack() noexcept
+	{
+		if (Size() > 0)
+			--m_header->size;
+	}
+
+	template<typename InputIterator>
+	void Append(InputIterator first, InputIterator last)
+	{
+		for (; first != last; ++first)
+			EmplaceBack(*first);
+	}
+
+	// Value-initializes new elements, which overwrites what earlier elements left in the file.
+	void Resize(size_t size)
+	{
+		if (size > m_capacity)
+			Remap(Growth::Capacity(m_capacity, size));
+		if (size > Size())
+			std::fill(m_data + Size(), m_data + size, T{});
+		m_header->size = size;
+	}
+
+	//Operations
+	void Clear() noexcept
+	{
+		m_header->size = 0;
+	}
+
+	// Writes the elements and the header to the file and waits until they are stored.
+	void Flush()
+	{
+		if (msync(m_header, MappedBytes(m_capacity), MS_SYNC) != 0)
+			throw std::runtime_error("MappedVector: cannot flush " + m_path);
+	}
+
+	// Applies an access pattern hint to the whole mapping, including the parts added by later growth.
+	void Advise(MappedAccess access)
+	{
+		m_access = access;
+		ApplyAdvice();
+	}
+
+	//Iterators
+	Iterator begin() { return Iterator(m_data); };
+	Iterator end() { return Iterator(m_data + Size()); };
+	ReverseIterator rbegin() { return ReverseIterator(m_data + Size() - 1); };
+	ReverseIterator rend() { return ReverseIterator(m_data - 1); };
+
+private:
+	MappedVector(const std::string& path, int file)
+		: m_path(path), m_file(file), m_header(nullptr), m_data(nullptr), m_capacity(0), m_access(MappedAccess::Normal) {}
+
+	static size_t MappedBytes(size_t capacity) noexcept
+	{
+		return sizeof(Header) + capacity * sizeof(T);
+	}
+
+	// Sets the file size to hold capacity elements and maps all of it. ftruncate alone leaves a sparse file, so
+	// where posix_fallocate exists the new range is reserved too: a full disk then throws here instead of raising
+	// SIGBUS on the first write to a new page.
+	void Remap(size_t capacity)
+	{
+		size_t oldBytes = m_header != nullptr ? MappedBytes(m_capacity) : 0;
+		size_t bytes = MappedBytes(capacity);
+		if (ftruncate(m_file, static_cast<off_t>(bytes)) != 0)
+			throw std::runtime_error("MappedVector: cannot resize " + m_path);
+#if defined(__linux__) || defined(__FreeBSD__)
+		if (bytes > oldBytes && posix_fallocate(m_file, static_cast<off_t>(oldBytes), static_cast<off_t>(bytes - oldBytes)) != 0) {
+			// The mapping still covers the old size only, so give the rest back.
+			int restored = ftruncate(m_file, static_cast<off_t>(oldBytes));
+			static_cast<void>(restored);
+			throw std::runtime_error("MappedVector: not enough space to grow " + m_path);
+		}
+#endif
+		Map(capacity);
+	}
+
+	// Maps the first capacity elements of the file, which must already be that long.
+	void Map(size_t capacity)
+	{
+		size_t bytes = MappedBytes(capacity);
+		void* mapping;
+		if (m_header == nullptr) {
+			mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+		}
+		else {
+#ifdef __linux__
+			mapping = mremap(m_header, MappedBytes(m_capacity), bytes, MREMAP_MAYMOVE);
+#else
+			munmap(m_header, MappedBytes(m_capacity));
+			m_header = nullptr;
+			m_data = nullptr;
+			m_capacity = 0;
+			mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+#endif
+		}
+		if (mapping == MAP_FAILED)
+			throw std::runtime_error("MappedVector: cannot map " + m_path);
+
+		m_header = static_cast<Header*>(mapping);
+		m_data = reinterpret_cast<T*>(m_header + 1);
+		m_capacity = capacity;
+		ApplyAdvice();
+	}
+
+	void ApplyAdvice() noexcept
+	{
+		static constexpr int Advice[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED };
+		if (m_header != nullptr)
+			madvise(m_header, MappedBytes(m_capacity), Advice[static_cast<int>(m_access)]);
+	}
+
+	void Close() noexcept
+	{
+		if (m_header != nullptr)
+			munmap(m_header, MappedBytes(m_capacity));
+		if (m_file >= 0)
+			close(m_file);
+		m_header = nullptr;
+		m_data = nullptr;
+		m_file = -1;
+	}
+
+private:
+	std::string m_path;
+	int m_file;
+	Header* m_header;
+	T* m_data;
+	size_t m_capacity;
+	MappedAccess m_access;
+};
+
+#endif
+
+#endif //_MAPPEDVECTOR_
@@ -0,0 +1,287 @@
+#ifndef _MEMORYRESOURCE_
+#define _MEMORYRESOURCE_
+
+#include<algorithm>
+#include<bit>
+#include<cstddef>
+#include<cstdint>
+#include<memory_resource>
+
+// Memory resource that hands out memory by bumping a pointer through chunks taken from an upstream resource.
+// Deallocation does nothing; Reset frees everything allocated so far in O(chunks) and keeps the largest chunk,
+// so a request handler that builds its temporary containers in the arena and resets it afterwards reaches a
+// steady state without calling the upstream resource at all. Not thread-safe: give every thread its own.
+class MonotonicArena : public std::pmr::memory_resource
+{
+public:
+	explicit MonotonicArena(size_t chunkSize = 4096, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+		: m_upstream(upstream), m_chunks(nullptr), m_current(nullptr), m_end(nullptr),
+		m_nextChunkSize(std::max(chunkSize, MinChunkSize)), m_allocated(0), m_capacity(0) {}
+
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+	~MonotonicArena()
+	{
+		Release();
+	}
+
+	// Frees every allocation at once. The largest chunk stays for reuse and the others go back upstream.
+	void Reset() noexcept
+	{
+		Chunk* largest = m_chunks;
+		for (Chunk* chunk = m_chunks; chunk != nullptr; chunk = chunk->next) {
+			if (chunk->size > largest->size)
+				largest = chunk;
+		}
+
+		for (Chunk* chunk = m_chunks; chunk != nullptr;) {
+			Chunk* next = chunk->next;
+			if (chunk != largest)
+				FreeChunk(chunk);
+			chunk = next;
+		}
+
+		m_chunks = largest;
+		m_allocated = 0;
+		m_capacity = 0;
+		m_current = m_end = nullptr;
+		if (largest != nullptr) {
+			largest->next = nullptr;
+			m_current = reinterpret_cast<char*>(largest + 1);
+			m_end = reinterpret_cast<char*>(largest) + largest->size;
+			m_capacity = largest->size;
+		}
+	}
+
+	// Frees every allocation and returns all chunks to the upstream resource.
+	void Release() noexcept
+	{
+		while (m_chunks != nullptr) {
+			Chunk* next = m_chunks->next;
+			FreeChunk(m_chunks);
+			m_chunks = next;
+		}
+		m_current = m_end = nullptr;
+		m_allocated = 0;
+		m_capacity = 0;
+	}
+
+	// Bytes handed out since the last Reset or Release.
+	size_t BytesAllocated() const noexcept
+	{
+		return m_allocated;
+	}
+
+	// Bytes of the chunks currently held from the upstream resource.
+	size_t Capacity() const noexcept
+	{
+		return m_capacity;
+	}
+
+	std::pmr::memory_resource* Upstream() const noexcept
+	{
+		return m_upstream;
+	}
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		// Aligning can step past the end of a chunk whose size was not a multiple of the alignment
+		char* data = AlignUp(m_current, alignment);
+		if (data == nullptr || data > m_end || bytes > static_cast<size_t>(m_end - data)) {
+			NewChunk(bytes, alignment);
+			data = AlignUp(m_current, alignment);
+		}
+
+		m_current = data + bytes;
+		m_allocated += bytes;
+		return data;
+	}
+
+	void do_deallocate(void*, size_t, size_t) override {}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+private:
+	// Header at the start of every chunk.
+	struct alignas(std::max_align_t) Chunk
+	{
+		Chunk* next;
+		size_t size;
+	};
+
+	static constexpr size_t MinChunkSize = 256;
+
+	static char* AlignUp(char* pointer, size_t alignment) noexcept
+	{
+		uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+		return reinterpret_cast<char*>((address + alignment - 1) & ~(uintptr_t{ alignment } - 1));
+	}
+
+	// Chunks double in size, so an arena that is never reset still makes O(log n) upstream calls.
+	void NewChunk(size_t bytes, size_t alignment)
+	{
+		size_t size = std::max(m_nextChunkSize, sizeof(Chunk) + bytes + alignment);
+		Chunk* chunk = static_cast<Chunk*>(m_upstream->allocate(size, alignof(Chunk)));
+		chunk->next = m_chunks;
+		chunk->size = size;
+		m_chunks = chunk;
+		m_current = reinterpret_cast<char*>(chunk + 1);
+		m_end = reinterpret_cast<char*>(chunk) + size;
+		m_nextChunkSize = size * 2;
+		m_capacity += size;
+	}
+
+	void FreeChunk(Chunk* chunk) noexcept
+	{
+		m_upstream->deallocate(chunk, chunk->size, alignof(Chunk));
+	}
+
+private:
+	std::pmr::memory_resource* m_upstream;
+	Chunk* m_chunks;
+	char* m_current;
+	char* m_end;
+	size_t m_nextChunkSize;
+	size_t m_allocated;
+	size_t m_capacity;
+};
+
+// Memory resource that recycles blocks through one free list per power-of-two size class from MinBlockSize to
+// MaxBlockSize. Free lists are refilled a page at a time from chunks of the upstream resource, so allocating
+// and freeing the nodes of lists, trees and hash tables rarely leaves the pool. Larger requests go straight to
+// the upstream resource. Memory goes back upstream only on Release or destruction. Not thread-safe: give every
+// thread its own.
+class PoolResource : public std::pmr::memory_resource
+{
+public:
+	static constexpr size_t MinBlockSize = 8;
+	static constexpr size_t MaxBlockSize = 4096;
+
+	explicit PoolResource(size_t chunkSize = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+		: m_upstream(upstream), m_freeLists{}, m_chunks(nullptr), m_current(nullptr), m_end(nullptr),
+		m_chunkPages(std::max<size_t>(chunkSize / PageSize, 1)) {}
+
+	PoolResource(const PoolResource&) = delete;
+	PoolResource& operator=(const PoolResource&) = delete;
+
+	~PoolResource()
+	{
+		Release();
+	}
+
+	// Returns all chunks to the upstream resource, which frees every pooled block at once. Blocks larger than
+	// MaxBlockSize belong to the upstream resource and have to be deallocated one by one.
+	void Release() noexcept
+	{
+		while (m_chunks != nullptr) {
+			ChunkFooter* next = m_chunks->next;
+			m_upstream->deallocate(m_chunks->begin, m_chunks->size, PageSize);
+			m_chunks = next;
+		}
+		std::fill(std::begin(m_freeLists), std::end(m_freeLists), nullptr);
+		m_current = m_end = nullptr;
+	}
+
+	std::pmr::memory_resource* Upstream() const noexcept
+	{
+		return m_upstream;
+	}
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		size_t size = BlockSize(bytes, alignment);
+		if (size > MaxBlockSize)
+			return m_upstream->allocate(bytes, alignment);
+
+		Block*& freeList = m_freeLists[SizeClass(size)];
+		if (freeList == nullptr)
+			Refill(freeList, size);
+
+		Block* block = freeList;
+		freeList = block->next;
+		return block;
+	}
+
+	void do_deallocate(void* data, size_t bytes, size_t alignment) override
+	{
+		size_t size = BlockSize(bytes, alignment);
+		if (size > MaxBlockSize) {
+			m_upstream->deallocate(data, bytes, alignment);
+			return;
+		}
+
+		Block*& freeList = m_freeLists[SizeClass(size)];
+		freeList = ::new (data) Block{ freeList };
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+private:
+	struct Block
+	{
+		Block* next;
+	};
+
+	// Stored at the end of every chunk, behind its pages.
+	struct ChunkFooter
+	{
+		ChunkFooter* next;
+		void* begin;
+		size_t size;
+	};
+
+	static constexpr size_t PageSize = MaxBlockSize;
+	static constexpr size_t ClassCount = std::countr_zero(MaxBlockSize) - std::countr_zero(MinBlockSize) + 1;
+
+	// Blocks are powers of two and pages are aligned to their size, so every block is aligned to its size.
+	static size_t BlockSize(size_t bytes, size_t alignment) noexcept
+	{
+		return std::bit_ceil(std::max({ bytes, alignment, MinBlockSize }));
+	}
+
+	static size_t SizeClass(size_t size) noexcept
+	{
+		return static_cast<size_t>(std::countr_zero(size) - std::countr_zero(MinBlockSize));
+	}
+
+	// Splits the next page into blocks of the given size.
+	void Refill(Block*& freeList, size_t size)
+	{
+		if (m_current == m_end)
+			NewChunk();
+
+		char* page = m_current;
+		m_current += PageSize;
+		for (size_t offset = PageSize; offset >= size; offset -= size)
+			freeList = ::new (page + offset - size) Block{ freeList };
+	}
+
+	void NewChunk()
+	{
+		size_t size = m_chunkPages * PageSize + sizeof(ChunkFooter);
+		char* begin = static_cast<char*>(m_upstream->allocate(size, PageSize));
+		ChunkFooter* footer = ::new (begin + m_chunkPages * PageSize) ChunkFooter{ m_chunks, begin, size };
+		m_chunks = footer;
+		m_current = begin;
+		m_end = begin + m_chunkPages * PageSize;
+	}
+
+private:
+	std::pmr::memory_resource* m_upstream;
+	Block* m_freeLists[ClassCount];
+	ChunkFooter* m_chunks;
+	char* m_current;
+	char* m_end;
+	size_t m_chunkPages;
+};
+
+#endif //_MEMORYRESOURCE_
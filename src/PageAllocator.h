@@ -0,0 +1,140 @@
+#ifndef _PAGEALLOCATOR_
+#define _PAGEALLOCATOR_
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include<algorithm>
+#include<cstddef>
+#include<cstdint>
+#include<cstring>
+#include<new>
+#include<type_traits>
+
+#include<sys/mman.h>
+#include<unistd.h>
+
+#include"Vector.h"
+
+// Allocator that maps blocks of at least MappingThreshold bytes straight from the kernel as anonymous memory and
+// serves smaller ones from operator new. Its reallocate grows or shrinks a block without copying: on Linux,
+// mremap moves the page table entries of the old mapping to a larger range, so neither the bytes nor a second
+// copy of them are ever touched and the resident size stays that of the live data. Other systems map a new
+// block and copy. Vector calls reallocate for trivially relocatable elements. With hugePages, mappings are
+// advised to use transparent huge pages, which cuts TLB misses on scans of multi-gigabyte buffers.
+template<typename T>
+class PageAllocator
+{
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	static constexpr size_t MappingThreshold = 128 * 1024;
+
+	explicit PageAllocator(bool hugePages = false) noexcept : m_hugePages(hugePages) {}
+
+	template<typename U>
+	PageAllocator(const PageAllocator<U>& other) noexcept : m_hugePages(other.HugePages()) {}
+
+	T* allocate(size_t count)
+	{
+		size_t bytes = Bytes(count);
+		if (bytes < MappingThreshold)
+			return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+		return static_cast<T*>(Map(bytes));
+	}
+
+	void deallocate(T* data, size_t count) noexcept
+	{
+		size_t bytes = Bytes(count);
+		if (bytes < MappingThreshold)
+			::operator delete(data, bytes, std::align_val_t(alignof(T)));
+		else
+			munmap(data, MappedBytes(bytes));
+	}
+
+	// Returns a block of newCount elements whose first min(oldCount, newCount) elements hold the bytes of data,
+	// and frees data, which may be null if oldCount is 0. T must be trivially relocatable.
+	T* reallocate(T* data, size_t oldCount, size_t newCount)
+	{
+		size_t oldBytes = data != nullptr ? Bytes(oldCount) : 0;
+		size_t newBytes = Bytes(newCount);
+		if (newCount == 0) {
+			if (data != nullptr)
+				deallocate(data, oldCount);
+			return nullptr;
+		}
+#ifdef __linux__
+		if (oldBytes >= MappingThreshold && newBytes >= MappingThreshold) {
+			if (MappedBytes(oldBytes) == MappedBytes(newBytes))
+				return data;
+			void* moved = mremap(data, MappedBytes(oldBytes), MappedBytes(newBytes), MREMAP_MAYMOVE);
+			if (moved == MAP_FAILED)
+				throw std::bad_alloc();
+			Advise(moved, MappedBytes(newBytes));
+			return static_cast<T*>(moved);
+		}
+#endif
+		T* newData = allocate(newCount);
+		if (data != nullptr) {
+			std::memcpy(static_cast<void*>(newData), static_cast<const void*>(data), std::min(oldBytes, newBytes));
+			deallocate(data, oldCount);
+		}
+		return newData;
+	}
+
+	bool HugePages() const noexcept
+	{
+		return m_hugePages;
+	}
+
+	template<typename U>
+	bool operator==(const PageAllocator<U>&) const noexcept
+	{
+		return true;
+	}
+
+private:
+	static size_t Bytes(size_t count)
+	{
+		if (count > SIZE_MAX / sizeof(T))
+			throw std::bad_array_new_length();
+		return count * sizeof(T);
+	}
+
+	static size_t MappedBytes(size_t bytes) noexcept
+	{
+		static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		return (bytes + pageSize - 1) / pageSize * pageSize;
+	}
+
+	void* Map(size_t bytes) const
+	{
+		void* data = mmap(nullptr, MappedBytes(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (data == MAP_FAILED)
+			throw std::bad_alloc();
+		Advise(data, MappedBytes(bytes));
+		return data;
+	}
+
+	void Advise(void* data, size_t bytes) const noexcept
+	{
+#ifdef MADV_HUGEPAGE
+		if (m_hugePages)
+			madvise(data, bytes, MADV_HUGEPAGE);
+#else
+		(void)data;
+		(void)bytes;
+#endif
+	}
+
+private:
+	bool m_hugePages;
+};
+
+// Vector of trivially copyable elements that grows through mremap instead of copying, for multi-gigabyte arrays.
+template<typename T, typename Growth = GeometricGrowth<>>
+using PageVector = Vector<T, Growth, PageAllocator<T>>;
+
+#endif
+
+#endif //_PAGEALLOCATOR_
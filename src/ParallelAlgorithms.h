@@ -0,0 +1,281 @@
+#ifndef _PARALLELALGORITHMS_
+#define _PARALLELALGORITHMS_
+
+#include<algorithm>
+#include<cstddef>
+#include<functional>
+#include<iterator>
+#include<memory>
+#include<numeric>
+#include<span>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include"Algorithms.h"
+#include"Sort.h"
+#include"ThreadPool.h"
+#include"Vector.h"
+
+// Parallel algorithms over contiguous ranges: Vector, Array (through their Span members), std::span and any
+// contiguous standard container. Every algorithm cuts its range into pieces of about grainSize elements and
+// runs them on a ThreadPool through recursive Join calls, so idle workers steal the largest remaining halves.
+struct ParallelOptions
+{
+	// nullptr runs on ThreadPool::Shared().
+	ThreadPool* pool = nullptr;
+	// Elements one task works on without splitting further. 0 picks about eight pieces per thread, but no piece
+	// smaller than MinGrainSize, so a small range runs on the calling thread.
+	size_t grainSize = 0;
+
+	static constexpr size_t MinGrainSize = 4096;
+
+	ThreadPool& Pool() const
+	{
+		return pool != nullptr ? *pool : ThreadPool::Shared();
+	}
+
+	size_t GrainSize(size_t size) const
+	{
+		if (grainSize > 0)
+			return grainSize;
+		return std::max(size / (8 * Pool().ThreadCount()), MinGrainSize);
+	}
+};
+
+template<typename Range>
+auto ParallelSpan(Range&& range)
+{
+	if constexpr (requires { range.Span(); })
+		return range.Span();
+	else
+		return std::span(range);
+}
+
+template<typename Function>
+void ParallelForRange(ThreadPool& pool, size_t begin, size_t end, size_t grainSize, Function& function)
+{
+	if (end - begin <= grainSize) {
+		function(begin, end);
+		return;
+	}
+
+	size_t middle = begin + (end - begin) / 2;
+	pool.Join([&] { ParallelForRange(pool, middle, end, grainSize, function); },
+		[&] { ParallelForRange(pool, begin, middle, grainSize, function); });
+}
+
+// Calls function(begin, end) for pieces of [begin, end) that together cover it exactly once.
+template<typename Function>
+void ParallelFor(size_t begin, size_t end, Function function, const ParallelOptions& options = {})
+{
+	if (begin >= end)
+		return;
+
+	ThreadPool& pool = options.Pool();
+	size_t grainSize = options.GrainSize(end - begin);
+	if (end - begin <= grainSize) {
+		function(begin, end);
+		return;
+	}
+	pool.Execute([&] { ParallelForRange(pool, begin, end, grainSize, function); });
+}
+
+// Calls function(element) for every element, in no particular order.
+template<typename Range, typename Function>
+void ParallelForEach(Range&& range, Function function, const ParallelOptions& options = {})
+{
+	auto data = ParallelSpan(range);
+	ParallelFor(0, data.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			function(data[i]);
+	}, options);
+}
+
+// Stores function(input[i]) to output[i]. Each piece runs through the vectorized Transform. output may be input.
+template<typename Input, typename Output, typename Function>
+void ParallelTransform(Input&& input, Output&& output, Function function, const ParallelOptions& options = {})
+{
+	auto source = ParallelSpan(input);
+	auto destination = ParallelSpan(output);
+	using T = std::remove_const_t<typename decltype(source)::element_type>;
+	if (destination.size() < source.size())
+		throw std::invalid_argument("ParallelTransform output is smaller than its input");
+
+	ParallelFor(0, source.size(), [&](size_t begin, size_t end) {
+		Transform(std::span<const T>(source.subspan(begin, end - begin)), destination.subspan(begin, end - begin), function);
+	}, options);
+}
+
+// Combines init and all elements with operation, which must be associative but need not be commutative: the
+// pieces are reduced in parallel and their results combined in order. Sums of arithmetic elements of the type
+// of init run through the vectorized Sum. The grain size decides how floating-point sums are grouped, so a
+// fixed grain size gives the same result on any number of threads.
+template<typename Range, typename T, typename Operation = std::plus<>>
+T ParallelReduce(Range&& range, T init, Operation operation = {}, const ParallelOptions& options = {})
+{
+	auto data = ParallelSpan(range);
+	using Element = std::remove_const_t<typename decltype(data)::element_type>;
+	if (data.empty())
+		return init;
+
+	size_t grainSize = options.GrainSize(data.size());
+	size_t pieces = (data.size() + grainSize - 1) / grainSize;
+	Vector<T> results(pieces, init);
+	ParallelFor(0, pieces, [&](size_t begin, size_t end) {
+		for (size_t piece = begin; piece < end; ++piece) {
+			auto values = data.subspan(piece * grainSize, std::min(grainSize, data.size() - piece * grainSize));
+			if constexpr (std::is_arithmetic_v<T> && std::is_same_v<Element, T> &&
+				(std::is_same_v<Operation, std::plus<>> || std::is_same_v<Operation, std::plus<T>>))
+				results[piece] = Sum(std::span<const T>(values));
+			else
+				results[piece] = std::accumulate(values.begin() + 1, values.end(), T(values[0]), operation);
+		}
+	}, ParallelOptions{ &options.Pool(), 1 });
+
+	for (size_t piece = 0; piece < pieces; ++piece)
+		init = operation(std::move(init), results[piece]);
+	return init;
+}
+
+// Two passes over the pieces: the first reduces each piece, a serial scan over the piece results gives every
+// piece its starting value, and the second scans each piece from it. offsets[0] is only used with init.
+template<typename Input, typename Output, typename T, typename Operation>
+void ParallelScanPieces(Input input, Output output, const T* init, Operation& operation, const ParallelOptions& options)
+{
+	using Element = std::remove_const_t<typename Input::element_type>;
+	size_t grainSize = options.GrainSize(input.size());
+	size_t pieces = (input.size() + grainSize - 1) / grainSize;
+	const ParallelOptions perPiece{ &options.Pool(), 1 };
+	auto piece = [&](auto span, size_t index) {
+		return span.subspan(index * grainSize, std::min(grainSize, input.size() - index * grainSize));
+	};
+
+	Vector<Element> offsets(pieces, input[0]);
+	ParallelFor(0, pieces - 1, [&](size_t begin, size_t end) {
+		for (size_t index = begin; index < end; ++index) {
+			auto values = piece(input, index);
+			offsets[index + 1] = std::accumulate(values.begin() + 1, values.end(), values[0], operation);
+		}
+	}, perPiece);
+
+	if (init != nullptr)
+		offsets[0] = *init;
+	for (size_t index = 1; index < pieces; ++index) {
+		if (index > 1 || init != nullptr)
+			offsets[index] = operation(offsets[index - 1], offsets[index]);
+	}
+
+	ParallelFor(0, pieces, [&](size_t begin, size_t end) {
+		for (size_t index = begin; index < end; ++index) {
+			auto values = piece(input, index);
+			auto results = piece(output, index);
+			if (init != nullptr)
+				std::exclusive_scan(values.begin(), values.end(), results.begin(), offsets[index], operation);
+			else if (index == 0)
+				std::inclusive_scan(values.begin(), values.end(), results.begin(), operation);
+			else
+				std::inclusive_scan(values.begin(), values.end(), results.begin(), operation, offsets[index]);
+		}
+	}, perPiece);
+}
+
+// output[i] = input[0] op ... op input[i]. operation must be associative. output may be input.
+template<typename Input, typename Output, typename Operation = std::plus<>>
+void ParallelInclusiveScan(Input&& input, Output&& output, Operation operation = {}, const ParallelOptions& options = {})
+{
+	auto source = ParallelSpan(input);
+	auto destination = ParallelSpan(output);
+	using Element = std::remove_const_t<typename decltype(source)::element_type>;
+	if (destination.size() < source.size())
+		throw std::invalid_argument("ParallelInclusiveScan output is smaller than its input");
+	if (!source.empty())
+		ParallelScanPieces(source, destination, static_cast<const Element*>(nullptr), operation, options);
+}
+
+// output[i] = init op input[0] op ... op input[i - 1]. operation must be associative. output may be input.
+template<typename Input, typename Output, typename T, typename Operation = std::plus<>>
+void ParallelExclusiveScan(Input&& input, Output&& output, T init, Operation operation = {}, const ParallelOptions& options = {})
+{
+	auto source = ParallelSpan(input);
+	auto destination = ParallelSpan(output);
+	using Element = std::remove_const_t<typename decltype(source)::element_type>;
+	if (destination.size() < source.size())
+		throw std::invalid_argument("ParallelExclusiveScan output is smaller than its input");
+	if (!source.empty()) {
+		Element start(std::move(init));
+		ParallelScanPieces(source, destination, &start, operation, options);
+	}
+}
+
+// Merges the sorted ranges first and second into output by moving. Large merges split the longer range at its
+// middle element and the other one at the matching bound, and merge both halves in parallel. Equal elements of
+// first stay ahead of those of second.
+template<typename T, typename Compare>
+void ParallelMergeRange(ThreadPool& pool, T* first, size_t firstSize, T* second, size_t secondSize, T* output,
+	Compare& compare, size_t grainSize)
+{
+	if (firstSize + secondSize <= grainSize) {
+		std::merge(std::make_move_iterator(first), std::make_move_iterator(first + firstSize),
+			std::make_move_iterator(second), std::make_move_iterator(second + secondSize), output, compare);
+		return;
+	}
+
+	size_t firstSplit, secondSplit;
+	if (firstSize >= secondSize) {
+		firstSplit = firstSize / 2;
+		secondSplit = std::lower_bound(second, second + secondSize, first[firstSplit], compare) - second;
+	}
+	else {
+		secondSplit = secondSize / 2;
+		firstSplit = std::upper_bound(first, first + firstSize, second[secondSplit], compare) - first;
+	}
+
+	pool.Join([&] {
+		ParallelMergeRange(pool, first + firstSplit, firstSize - firstSplit, second + secondSplit,
+			secondSize - secondSplit, output + firstSplit + secondSplit, compare, grainSize);
+	}, [&] {
+		ParallelMergeRange(pool, first, firstSplit, second, secondSplit, output, compare, grainSize);
+	});
+}
+
+// Sorts data, leaving the result in buffer if toBuffer and in data otherwise. The halves are sorted into the
+// other array, so every merge level moves the elements once and no level copies them back.
+template<typename T, typename Compare>
+void ParallelSortRange(ThreadPool& pool, T* data, T* buffer, size_t size, bool toBuffer, Compare& compare, size_t grainSize)
+{
+	if (size <= grainSize) {
+		::Sort(std::span<T>(data, size), compare);
+		if (toBuffer)
+			std::move(data, data + size, buffer);
+		return;
+	}
+
+	size_t middle = size / 2;
+	pool.Join([&] { ParallelSortRange(pool, data + middle, buffer + middle, size - middle, !toBuffer, compare, grainSize); },
+		[&] { ParallelSortRange(pool, data, buffer, middle, !toBuffer, compare, grainSize); });
+
+	T* from = toBuffer ? data : buffer;
+	T* to = toBuffer ? buffer : data;
+	ParallelMergeRange(pool, from, middle, from + middle, size - middle, to, compare, grainSize);
+}
+
+// Merge sort: the pieces are sorted with the pattern-defeating quicksort of Sort.h and merged in parallel
+// through a buffer of the same size, so it is not stable. T must be default constructible and move assignable.
+template<typename Range, typename Compare = std::less<>>
+void ParallelSort(Range&& range, Compare compare = {}, const ParallelOptions& options = {})
+{
+	auto data = ParallelSpan(range);
+	using T = typename decltype(data)::element_type;
+	ThreadPool& pool = options.Pool();
+	size_t grainSize = options.GrainSize(data.size());
+	if (data.size() <= grainSize) {
+		::Sort(std::span<T>(data.data(), data.size()), compare);
+		return;
+	}
+
+	std::unique_ptr<T[]> buffer = std::make_unique_for_overwrite<T[]>(data.size());
+	pool.Execute([&] { ParallelSortRange(pool, data.data(), buffer.get(), data.size(), false, compare, grainSize); });
+}
+
+#endif //_PARALLELALGORITHMS_
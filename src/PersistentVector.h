@@ -0,0 +1,834 @@
+#ifndef _PERSISTENTVECTOR_
+#define _PERSISTENTVECTOR_
+
+#include<algorithm>
+#include<atomic>
+#include<cstddef>
+#include<cstdint>
+#include<initializer_list>
+#include<iterator>
+#include<memory>
+#include<new>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+template<typename PersistentVector>
+class PersistentIterator
+{
+public:
+	using ValueType = const typename PersistentVector::ValueType;
+	using PointerType = ValueType*;
+	using ReferenceType = ValueType&;
+
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = std::remove_const_t<ValueType>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = PointerType;
+	using reference = ReferenceType;
+public:
+	PersistentIterator() noexcept : m_vector(nullptr), m_index(0), m_leaf(nullptr), m_leafStart(0), m_leafEnd(0) {}
+	PersistentIterator(const PersistentVector* vector, size_t index) noexcept
+		: m_vector(vector), m_index(index), m_leaf(nullptr), m_leafStart(index), m_leafEnd(index)
+	{
+		if (m_index < m_vector->Size())
+			Seek();
+	}
+
+	PointerType operator->() const noexcept { return &**this; }
+	ReferenceType operator*() const noexcept { return m_leaf[m_index - m_leafStart]; }
+
+	bool operator==(const PersistentIterator& other) const noexcept { return m_index == other.m_index; }
+	bool operator!=(const PersistentIterator& other) const noexcept { return m_index != other.m_index; }
+
+	// Steps within the current leaf and looks up the next leaf only when leaving it.
+	PersistentIterator& operator++() noexcept {
+		++m_index;
+		if (m_index == m_leafEnd && m_index < m_vector->Size())
+			Seek();
+		return *this;
+	}
+	PersistentIterator operator++(int) noexcept {
+		PersistentIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+	PersistentIterator& operator--() noexcept {
+		--m_index;
+		if (m_index < m_leafStart)
+			Seek();
+		return *this;
+	}
+	PersistentIterator operator--(int) noexcept {
+		PersistentIterator iterator = *this;
+		--(*this);
+		return iterator;
+	}
+
+private:
+	void Seek() noexcept
+	{
+		m_leaf = m_vector->LeafOf(m_index, m_leafStart, m_leafEnd);
+	}
+
+private:
+	const PersistentVector* m_vector;
+	size_t m_index;
+	PointerType m_leaf;
+	size_t m_leafStart;
+	size_t m_leafEnd;
+};
+
+// Persistent vector: copies share their storage, so a copy is an O(1) snapshot that later changes to either
+// vector never affect. The elements live in an RRB tree (relaxed radix balanced tree), a 32-ary trie whose
+// inner nodes record the element counts of their children: indexing descends log32(n) levels, starting at the
+// child the radix of the index names and scanning right past children that hold fewer elements. The last
+// elements sit in a separate tail leaf, so PushBack and PopBack mostly touch one leaf. Set, PushBack and
+// PopBack copy the nodes on their path that are shared with another vector and change the others in place;
+// a vector that shares nothing, such as one being filled before its first snapshot, is therefore mutated in
+// place like a transient, close to the speed of a Vector. Append concatenates two vectors in O(log n) by
+// merging the nodes along the seam, and Slice shares every node outside the two cut paths. Node reference
+// counts are atomic, so snapshots may be read, copied and destroyed on other threads; a single vector object
+// is not thread-safe. Elements are read-only through references and iterators, and changed through Set.
+template<typename T>
+class PersistentVector
+{
+	template<typename> friend class PersistentIterator;
+
+	static constexpr size_t BranchBits = 5;
+	static constexpr size_t Branching = size_t{ 1 } << BranchBits;
+	// Extra children a concatenated level may keep over the minimum, bounding the scan steps of a lookup.
+	static constexpr size_t ExtraSteps = 2;
+
+	struct Node
+	{
+		Node() noexcept : refs(1), count(0) {}
+
+		std::atomic<uint32_t> refs;
+		// Elements of a leaf, children of an inner node.
+		uint32_t count;
+	};
+
+	struct Leaf : Node
+	{
+		T* Elements() noexcept
+		{
+			return std::launder(reinterpret_cast<T*>(storage));
+		}
+
+		alignas(T) unsigned char storage[Branching * sizeof(T)];
+	};
+
+	struct Inner : Node
+	{
+		// Each child with the number of elements in it and the children before it, side by side so that a
+		// lookup reads both from one cache line.
+		struct Child
+		{
+			Node* node;
+			size_t size;
+		} children[Branching];
+	};
+
+public:
+	using ValueType = T;
+	using Iterator = PersistentIterator<PersistentVector>;
+	using ConstIterator = Iterator;
+	using ReverseIterator = std::reverse_iterator<Iterator>;
+public:
+	//Constructors
+	PersistentVector() noexcept : m_root(nullptr), m_tail(nullptr), m_treeSize(0), m_height(0) {}
+
+	PersistentVector(size_t size, const T& value) : PersistentVector()
+	{
+		for (size_t i = 0; i < size; ++i)
+			EmplaceBack(value);
+	}
+
+	PersistentVector(std::initializer_list<T> values) : PersistentVector()
+	{
+		Append(values.begin(), values.end());
+	}
+
+	// O(1): the copy shares every node with other.
+	PersistentVector(const PersistentVector& other) noexcept
+		: m_root(other.m_root != nullptr ? Retain(other.m_root) : nullptr),
+		m_tail(other.m_tail != nullptr ? static_cast<Leaf*>(Retain(other.m_tail)) : nullptr),
+		m_treeSize(other.m_treeSize), m_height(other.m_height) {}
+
+	PersistentVector(PersistentVector&& other) noexcept
+		: m_root(std::exchange(other.m_root, nullptr)), m_tail(std::exchange(other.m_tail, nullptr)),
+		m_treeSize(std::exchange(other.m_treeSize, 0)), m_height(std::exchange(other.m_height, 0)) {}
+
+	~PersistentVector()
+	{
+		Clear();
+	}
+
+	//Operators
+	PersistentVector& operator=(const PersistentVector& other) noexcept
+	{
+		PersistentVector copy(other);
+		Swap(copy);
+		return *this;
+	}
+
+	PersistentVector& operator=(PersistentVector&& other) noexcept
+	{
+		PersistentVector moved(std::move(other));
+		Swap(moved);
+		return *this;
+	}
+
+	const T& operator[](size_t index) const
+	{
+		if (index >= Size())
+			throw std::out_of_range("index out of range");
+		size_t leafStart;
+		size_t leafEnd;
+		return LeafOf(index, leafStart, leafEnd)[index - leafStart];
+	}
+
+	bool operator==(const PersistentVector& other) const
+	{
+		return Size() == other.Size() && std::equal(begin(), end(), other.begin());
+	}
+
+	bool operator!=(const PersistentVector& other) const
+	{
+		return !(*this == other);
+	}
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return Size() == 0;
+	}
+
+	size_t Size() const noexcept
+	{
+		return m_treeSize + (m_tail != nullptr ? m_tail->count : 0);
+	}
+
+	//Element access
+	// A copy sharing all nodes with this vector, to hand to readers.
+	PersistentVector Snapshot() const noexcept
+	{
+		return *this;
+	}
+
+	// A vector of the elements [first, last). Only the nodes on the paths to the two ends are copied.
+	PersistentVector Slice(size_t first, size_t last) const
+	{
+		if (first > last || last > Size())
+			throw std::out_of_range("slice out of range");
+
+		PersistentVector slice;
+		if (first == last)
+			return slice;
+
+		if (first < m_treeSize) {
+			size_t treeLast = std::min(last, m_treeSize);
+			slice.m_root = SliceTree(m_root, m_height, first, treeLast);
+			slice.m_height = m_height;
+			slice.m_treeSize = treeLast - first;
+			slice.SquashRoot();
+		}
+		if (last > m_treeSize) {
+			size_t tailFirst = first > m_treeSize ? first - m_treeSize : 0;
+			size_t tailLast = last - m_treeSize;
+			if (tailFirst == 0 && tailLast == m_tail->count)
+				slice.m_tail = static_cast<Leaf*>(Retain(m_tail));
+			else
+				slice.m_tail = NewLeaf(m_tail->Elements() + tailFirst, tailLast - tailFirst);
+		}
+		return slice;
+	}
+
+	//Modifiers
+	void PushBack(const T& value)
+	{
+		EmplaceBack(value);
+	}
+
+	void PushBack(T&& value)
+	{
+		EmplaceBack(std::move(value));
+	}
+
+	template<typename... Args>
+	const T& EmplaceBack(Args&&... args)
+	{
+		if (m_tail != nullptr && m_tail->count == Branching)
+			PushTailIntoTree();
+		if (m_tail == nullptr)
+			m_tail = new Leaf;
+		else
+			MakeUnique(m_tail);
+
+		T* element = m_tail->Elements() + m_tail->count;
+		::new (static_cast<void*>(element)) T(std::forward<Args>(args)...);
+		++m_tail->count;
+		return *element;
+	}
+
+	void PopBack()
+	{
+		if (Empty())
+			return;
+
+		if (m_tail == nullptr || m_tail->count == 0) {
+			Release(m_tail, 0);
+			m_tail = nullptr;
+			m_tail = PopLeafFromTree();
+		}
+		MakeUnique(m_tail);
+		--m_tail->count;
+		std::destroy_at(m_tail->Elements() + m_tail->count);
+	}
+
+	// Replaces the element at index, copying the nodes on its path that other vectors share.
+	void Set(size_t index, T value)
+	{
+		if (index >= Size())
+			throw std::out_of_range("index out of range");
+
+		if (index >= m_treeSize) {
+			MakeUnique(m_tail);
+			m_tail->Elements()[index - m_treeSize] = std::move(value);
+			return;
+		}
+
+		Node** slot = &m_root;
+		for (size_t height = m_height; height > 0; --height) {
+			MakeUnique(*slot, height);
+			Inner* inner = static_cast<Inner*>(*slot);
+			size_t child = ChildIndex(inner, height, index);
+			if (child > 0)
+				index -= inner->children[child - 1].size;
+			slot = &inner->children[child].node;
+		}
+		MakeUnique(*slot, 0);
+		static_cast<Leaf*>(*slot)->Elements()[index] = std::move(value);
+	}
+
+	template<typename InputIterator>
+	void Append(InputIterator first, InputIterator last)
+	{
+		for (; first != last; ++first)
+			EmplaceBack(*first);
+	}
+
+	// Appends the elements of other in O(log n): the two trees are joined along the seam, and only the nodes
+	// there are rebuilt.
+	void Append(const PersistentVector& other)
+	{
+		PersistentVector right(other);
+		if (right.Empty())
+			return;
+		if (Empty()) {
+			Swap(right);
+			return;
+		}
+		if (right.m_treeSize == 0) {
+			Append(right.m_tail->Elements(), right.m_tail->Elements() + right.m_tail->count);
+			return;
+		}
+
+		if (m_tail != nullptr && m_tail->count > 0) {
+			PushTailIntoTree();
+		}
+		else {
+			Release(m_tail, 0);
+			m_tail = nullptr;
+		}
+
+		size_t height;
+		Node* root = ConcatSubTree(m_root, m_height, right.m_root, right.m_height, true, height);
+		Release(m_root, m_height);
+		m_root = root;
+		m_height = height;
+		m_treeSize += right.m_treeSize;
+		m_tail = std::exchange(right.m_tail, nullptr);
+		SquashRoot();
+	}
+
+	//Operations
+	void Clear() noexcept
+	{
+		Release(m_root, m_height);
+		Release(m_tail, 0);
+		m_root = nullptr;
+		m_tail = nullptr;
+		m_treeSize = 0;
+		m_height = 0;
+	}
+
+	void Swap(PersistentVector& other) noexcept
+	{
+		std::swap(m_root, other.m_root);
+		std::swap(m_tail, other.m_tail);
+		std::swap(m_treeSize, other.m_treeSize);
+		std::swap(m_height, other.m_height);
+	}
+
+	//Iterators
+	Iterator begin() const { return Iterator(this, 0); };
+	Iterator end() const { return Iterator(this, Size()); };
+	ReverseIterator rbegin() const { return ReverseIterator(end()); };
+	ReverseIterator rend() const { return ReverseIterator(begin()); };
+
+private:
+	static Node* Retain(Node* node) noexcept
+	{
+		node->refs.fetch_add(1, std::memory_order_relaxed);
+		return node;
+	}
+
+	// Drops one reference to a node of the given height, freeing it and its subtree with the last one.
+	static void Release(Node* node, size_t height) noexcept
+	{
+		if (node == nullptr || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		if (height == 0) {
+			Leaf* leaf = static_cast<Leaf*>(node);
+			std::destroy_n(leaf->Elements(), leaf->count);
+			delete leaf;
+		}
+		else {
+			Inner* inner = static_cast<Inner*>(node);
+			for (size_t i = 0; i < inner->count; ++i)
+				Release(inner->children[i].node, height - 1);
+			delete inner;
+		}
+	}
+
+	static size_t NodeSize(Node* node, size_t height) noexcept
+	{
+		if (height == 0 || node->count == 0)
+			return node->count;
+		return static_cast<Inner*>(node)->children[node->count - 1].size;
+	}
+
+	// The child of an inner node that holds its element index. No child holds more than 32^height elements,
+	// so the radix of the index is the first candidate.
+	static size_t ChildIndex(const Inner* inner, size_t height, size_t index) noexcept
+	{
+		size_t child = index >> (BranchBits * height);
+		while (inner->children[child].size <= index)
+			++child;
+		return child;
+	}
+
+	// Appends copies of count elements to a leaf, counting each one as soon as it is constructed.
+	static void CopyInto(Leaf* leaf, const T* from, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i) {
+			::new (static_cast<void*>(leaf->Elements() + leaf->count)) T(from[i]);
+			++leaf->count;
+		}
+	}
+
+	static Leaf* NewLeaf(const T* from, size_t count)
+	{
+		Leaf* leaf = new Leaf;
+		try {
+			CopyInto(leaf, from, count);
+		}
+		catch (...) {
+			Release(leaf, 0);
+			throw;
+		}
+		return leaf;
+	}
+
+	// Takes over the reference to child.
+	static void AddChild(Inner* inner, Node* child, size_t childHeight) noexcept
+	{
+		size_t before = inner->count > 0 ? inner->children[inner->count - 1].size : 0;
+		inner->children[inner->count].node = child;
+		inner->children[inner->count].size = before + NodeSize(child, childHeight);
+		++inner->count;
+	}
+
+	static Node* CopyNode(Node* node, size_t height)
+	{
+		if (height == 0)
+			return NewLeaf(static_cast<Leaf*>(node)->Elements(), node->count);
+
+		Inner* from = static_cast<Inner*>(node);
+		Inner* copy = new Inner;
+		for (size_t i = 0; i < from->count; ++i) {
+			copy->children[i].node = Retain(from->children[i].node);
+			copy->children[i].size = from->children[i].size;
+		}
+		copy->count = from->count;
+		return copy;
+	}
+
+	// Makes slot point to a node no other vector reaches, copying the node if it is shared. A node is only
+	// reached through its parents, so after the nodes above it were made unique a count of one means that
+	// nothing else can see it.
+	static void MakeUnique(Node*& slot, size_t height)
+	{
+		if (slot->refs.load(std::memory_order_acquire) == 1)
+			return;
+		Node* copy = CopyNode(slot, height);
+		Release(slot, height);
+		slot = copy;
+	}
+
+	static void MakeUnique(Leaf*& leaf)
+	{
+		Node* slot = leaf;
+		MakeUnique(slot, 0);
+		leaf = static_cast<Leaf*>(slot);
+	}
+
+	// The first element of the leaf holding element index, with the range of indices that leaf holds.
+	const T* LeafOf(size_t index, size_t& leafStart, size_t& leafEnd) const noexcept
+	{
+		if (index >= m_treeSize) {
+			leafStart = m_treeSize;
+			leafEnd = Size();
+			return m_tail->Elements();
+		}
+
+		Node* node = m_root;
+		size_t start = 0;
+		for (size_t height = m_height; height > 0; --height) {
+			Inner* inner = static_cast<Inner*>(node);
+			size_t child = ChildIndex(inner, height, index - start);
+			if (child > 0)
+				start += inner->children[child - 1].size;
+			node = inner->children[child].node;
+		}
+		leafStart = start;
+		leafEnd = start + node->count;
+		return static_cast<Leaf*>(node)->Elements();
+	}
+
+	// Wraps node in height single-child inner nodes. If that throws, node is left to the caller.
+	static Node* NewPath(Node* node, size_t height)
+	{
+		Node* path = node;
+		size_t built = 0;
+		try {
+			for (; built < height; ++built) {
+				Inner* inner = new Inner;
+				AddChild(inner, path, built);
+				path = inner;
+			}
+		}
+		catch (...) {
+			while (built-- > 0) {
+				Inner* inner = static_cast<Inner*>(path);
+				path = inner->children[0].node;
+				delete inner;
+			}
+			throw;
+		}
+		return path;
+	}
+
+	// Appends leaf as the last leaf under slot, or returns false if that subtree has no room.
+	static bool PushLeaf(Node*& slot, size_t height, Node* leaf)
+	{
+		if (height == 1) {
+			if (slot->count == Branching)
+				return false;
+			MakeUnique(slot, height);
+			AddChild(static_cast<Inner*>(slot), leaf, 0);
+			return true;
+		}
+
+		MakeUnique(slot, height);
+		Inner* inner = static_cast<Inner*>(slot);
+		if (PushLeaf(inner->children[inner->count - 1].node, height - 1, leaf)) {
+			inner->children[inner->count - 1].size += leaf->count;
+			return true;
+		}
+		if (inner->count == Branching)
+			return false;
+		AddChild(inner, NewPath(leaf, height - 1), height - 1);
+		return true;
+	}
+
+	// Moves the tail into the tree as its last leaf, adding a level when the tree is full.
+	void PushTailIntoTree()
+	{
+		Node* leaf = m_tail;
+		size_t size = m_tail->count;
+		if (m_root == nullptr) {
+			m_root = leaf;
+			m_height = 0;
+		}
+		else if (m_height == 0 || !PushLeaf(m_root, m_height, leaf)) {
+			Inner* root = new Inner;
+			Node* path;
+			try {
+				path = NewPath(leaf, m_height);
+			}
+			catch (...) {
+				delete root;
+				throw;
+			}
+			AddChild(root, m_root, m_height);
+			AddChild(root, path, m_height);
+			m_root = root;
+			++m_height;
+		}
+		m_treeSize += size;
+		m_tail = nullptr;
+	}
+
+	// Removes the last leaf under slot, which holds at least two leaves, and hands over its reference.
+	static Node* PopLeaf(Node*& slot, size_t height)
+	{
+		MakeUnique(slot, height);
+		Inner* inner = static_cast<Inner*>(slot);
+		size_t last = inner->count - 1;
+		if (height == 1) {
+			--inner->count;
+			return inner->children[last].node;
+		}
+
+		Node* leaf = PopLeaf(inner->children[last].node, height - 1);
+		if (inner->children[last].node->count == 0) {
+			Release(inner->children[last].node, height - 1);
+			--inner->count;
+		}
+		else {
+			inner->children[last].size -= leaf->count;
+		}
+		return leaf;
+	}
+
+	Leaf* PopLeafFromTree()
+	{
+		Node* leaf;
+		if (m_height == 0) {
+			leaf = std::exchange(m_root, nullptr);
+		}
+		else {
+			leaf = PopLeaf(m_root, m_height);
+			SquashRoot();
+		}
+		m_treeSize -= leaf->count;
+		return static_cast<Leaf*>(leaf);
+	}
+
+	// Drops roots with a single child, which slicing and concatenation leave behind.
+	void SquashRoot() noexcept
+	{
+		while (m_height > 0 && m_root->count == 1) {
+			Node* child = Retain(static_cast<Inner*>(m_root)->children[0].node);
+			Release(m_root, m_height);
+			m_root = child;
+			--m_height;
+		}
+	}
+
+	// A node holding the elements [first, last) of node, sharing the children that lie entirely inside.
+	static Node* SliceTree(Node* node, size_t height, size_t first, size_t last)
+	{
+		if (first == 0 && last == NodeSize(node, height))
+			return Retain(node);
+		if (height == 0)
+			return NewLeaf(static_cast<Leaf*>(node)->Elements() + first, last - first);
+
+		Inner* inner = static_cast<Inner*>(node);
+		size_t from = ChildIndex(inner, height, first);
+		size_t to = ChildIndex(inner, height, last - 1);
+		Inner* slice = new Inner;
+		try {
+			for (size_t child = from; child <= to; ++child) {
+				size_t start = child > 0 ? inner->children[child - 1].size : 0;
+				size_t childFirst = child == from ? first - start : 0;
+				size_t childLast = child == to ? last - start : inner->children[child].size - start;
+				AddChild(slice, SliceTree(inner->children[child].node, height - 1, childFirst, childLast), height - 1);
+			}
+		}
+		catch (...) {
+			Release(slice, height);
+			throw;
+		}
+		return slice;
+	}
+
+	// Joins the trees left and right. Unless top, the result is one level above the higher of the two and has
+	// one or two children; the top call may return a node of that height itself.
+	static Node* ConcatSubTree(Node* left, size_t leftHeight, Node* right, size_t rightHeight, bool top, size_t& height)
+	{
+		size_t centreHeight;
+		if (leftHeight > rightHeight) {
+			Inner* inner = static_cast<Inner*>(left);
+			Node* centre = ConcatSubTree(inner->children[inner->count - 1].node, leftHeight - 1, right, rightHeight, false, centreHeight);
+			return Rebalance(inner, static_cast<Inner*>(centre), nullptr, leftHeight, top, height);
+		}
+		if (leftHeight < rightHeight) {
+			Inner* inner = static_cast<Inner*>(right);
+			Node* centre = ConcatSubTree(left, leftHeight, inner->children[0].node, rightHeight - 1, false, centreHeight);
+			return Rebalance(nullptr, static_cast<Inner*>(centre), inner, rightHeight, top, height);
+		}
+		if (leftHeight == 0) {
+			std::unique_ptr<Inner> inner(new Inner);
+			if (top && left->count + right->count <= Branching) {
+				Leaf* merged = NewLeaf(static_cast<Leaf*>(left)->Elements(), left->count);
+				try {
+					CopyInto(merged, static_cast<Leaf*>(right)->Elements(), right->count);
+				}
+				catch (...) {
+					Release(merged, 0);
+					throw;
+				}
+				AddChild(inner.get(), merged, 0);
+			}
+			else {
+				AddChild(inner.get(), Retain(left), 0);
+				AddChild(inner.get(), Retain(right), 0);
+			}
+			height = 1;
+			return inner.release();
+		}
+
+		Inner* leftInner = static_cast<Inner*>(left);
+		Inner* rightInner = static_cast<Inner*>(right);
+		Node* centre = ConcatSubTree(leftInner->children[leftInner->count - 1].node, leftHeight - 1, rightInner->children[0].node,
+			rightHeight - 1, false, centreHeight);
+		return Rebalance(leftInner, static_cast<Inner*>(centre), rightInner, leftHeight, top, height);
+	}
+
+	// Redistributes the children of left but its last, of centre, and of right but its first, all of them at
+	// height - 1, into as few nodes as ConcatPlan allows, and returns them under new nodes of the given height.
+	// Takes over the reference to centre.
+	static Node* Rebalance(Inner* left, Inner* centre, Inner* right, size_t nodeHeight, bool top, size_t& height)
+	{
+		Node* all[2 * Branching];
+		size_t count = 0;
+		if (left != nullptr) {
+			for (size_t i = 0; i + 1 < left->count; ++i)
+				all[count++] = left->children[i].node;
+		}
+		for (size_t i = 0; i < centre->count; ++i)
+			all[count++] = centre->children[i].node;
+		if (right != nullptr) {
+			for (size_t i = 1; i < right->count; ++i)
+				all[count++] = right->children[i].node;
+		}
+
+		size_t plan[2 * Branching];
+		size_t planCount = ConcatPlan(all, count, plan);
+		bool split = planCount > Branching;
+		std::unique_ptr<Inner> first;
+		std::unique_ptr<Inner> second;
+		std::unique_ptr<Inner> parent;
+		Node* nodes[2 * Branching];
+		try {
+			first.reset(new Inner);
+			if (split)
+				second.reset(new Inner);
+			if (split || !top)
+				parent.reset(new Inner);
+			ExecutePlan(all, nodeHeight - 1, plan, planCount, nodes);
+		}
+		catch (...) {
+			Release(centre, nodeHeight);
+			throw;
+		}
+		Release(centre, nodeHeight);
+
+		for (size_t i = 0; i < planCount; ++i)
+			AddChild(i < Branching ? first.get() : second.get(), nodes[i], nodeHeight - 1);
+		if (!parent) {
+			height = nodeHeight;
+			return first.release();
+		}
+		AddChild(parent.get(), first.release(), nodeHeight);
+		if (split)
+			AddChild(parent.get(), second.release(), nodeHeight);
+		height = nodeHeight + 1;
+		return parent.release();
+	}
+
+	// Node sizes for the count nodes of all that keep the number of nodes at most ExtraSteps above the
+	// minimum: from left to right, each node with room takes over the contents of its successors until one
+	// of them has been emptied. Returns the new node count.
+	static size_t ConcatPlan(Node* const* all, size_t count, size_t* plan) noexcept
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < count; ++i) {
+			plan[i] = all[i]->count;
+			total += plan[i];
+		}
+
+		size_t optimal = (total + Branching - 1) / Branching;
+		size_t i = 0;
+		while (optimal + ExtraSteps < count) {
+			while (plan[i] > Branching - ExtraSteps / 2)
+				++i;
+
+			size_t remaining = plan[i];
+			while (remaining > 0) {
+				size_t size = std::min(remaining + plan[i + 1], Branching);
+				plan[i] = size;
+				remaining = remaining + plan[i + 1] - size;
+				++i;
+			}
+			for (size_t j = i; j + 1 < count; ++j)
+				plan[j] = plan[j + 1];
+			--count;
+			--i;
+		}
+		return count;
+	}
+
+	// Builds the nodes of the plan from the contents of all, reusing the nodes whose contents stay together.
+	static void ExecutePlan(Node* const* all, size_t height, const size_t* plan, size_t planCount, Node** nodes)
+	{
+		size_t index = 0;
+		size_t offset = 0;
+		size_t made = 0;
+		try {
+			for (size_t p = 0; p < planCount; ++p) {
+				if (offset == 0 && all[index]->count == plan[p]) {
+					nodes[made++] = Retain(all[index++]);
+					continue;
+				}
+
+				Node* node = height == 0 ? static_cast<Node*>(new Leaf) : static_cast<Node*>(new Inner);
+				nodes[made++] = node;
+				while (node->count < plan[p]) {
+					size_t take = std::min<size_t>(plan[p] - node->count, all[index]->count - offset);
+					if (height == 0) {
+						CopyInto(static_cast<Leaf*>(node), static_cast<Leaf*>(all[index])->Elements() + offset, take);
+					}
+					else {
+						Inner* from = static_cast<Inner*>(all[index]);
+						for (size_t i = 0; i < take; ++i)
+							AddChild(static_cast<Inner*>(node), Retain(from->children[offset + i].node), height - 1);
+					}
+					offset += take;
+					if (offset == all[index]->count) {
+						++index;
+						offset = 0;
+					}
+				}
+			}
+		}
+		catch (...) {
+			while (made > 0)
+				Release(nodes[--made], height);
+			throw;
+		}
+	}
+
+private:
+	Node* m_root;
+	Leaf* m_tail;
+	size_t m_treeSize;
+	size_t m_height;
+};
+
+#endif //_PERSISTENTVECTOR_
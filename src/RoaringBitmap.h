@@ -0,0 +1,1791 @@
+#ifndef _ROARINGBITMAP_
+#define _ROARINGBITMAP_
+
+#include<algorithm>
+#include<bit>
+#include<cstddef>
+#include<cstdint>
+#include<cstdio>
+#include<filesystem>
+#include<fstream>
+#include<initializer_list>
+#include<iterator>
+#include<optional>
+#include<span>
+#include<stdexcept>
+#include<string>
+#include<type_traits>
+#include<utility>
+
+#if defined(__SSE2__)
+#include<emmintrin.h>
+#endif
+
+#include"Algorithms.h"
+#include"MappedFile.h"
+#include"Vector.h"
+
+#ifdef ALGORITHMS_VECTOR
+#define ROARING_INLINE [[gnu::always_inline]] inline
+#else
+#define ROARING_INLINE inline
+#endif
+
+// Set operations on sorted arrays of distinct 16-bit values, the array containers of a RoaringBitmap. Each writes
+// its result to output and returns its size; output needs room for the largest possible result plus 8 values.
+inline size_t ScalarIntersectArrays(const uint16_t* first, size_t firstSize, const uint16_t* second, size_t secondSize,
+	uint16_t* output) noexcept
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t size = 0;
+	while (i < firstSize && j < secondSize) {
+		if (first[i] < second[j]) {
+			++i;
+		}
+		else if (second[j] < first[i]) {
+			++j;
+		}
+		else {
+			output[size++] = first[i];
+			++i;
+			++j;
+		}
+	}
+	return size;
+}
+
+inline size_t ScalarUnionArrays(const uint16_t* first, size_t firstSize, const uint16_t* second, size_t secondSize,
+	uint16_t* output) noexcept
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t size = 0;
+	while (i < firstSize && j < secondSize) {
+		if (first[i] < second[j]) {
+			output[size++] = first[i++];
+		}
+		else if (second[j] < first[i]) {
+			output[size++] = second[j++];
+		}
+		else {
+			output[size++] = first[i];
+			++i;
+			++j;
+		}
+	}
+	size = std::copy(first + i, first + firstSize, output + size) - output;
+	return std::copy(second + j, second + secondSize, output + size) - output;
+}
+
+inline size_t ScalarDifferenceArrays(const uint16_t* first, size_t firstSize, const uint16_t* second, size_t secondSize,
+	uint16_t* output) noexcept
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t size = 0;
+	while (i < firstSize && j < secondSize) {
+		if (first[i] < second[j]) {
+			output[size++] = first[i++];
+		}
+		else if (second[j] < first[i]) {
+			++j;
+		}
+		else {
+			++i;
+			++j;
+		}
+	}
+	return std::copy(first + i, first + firstSize, output + size) - output;
+}
+
+// For arrays of very different sizes, which go through the small array and find each of its values in the large
+// one by galloping: the search starts where the previous one ended and doubles its step until it passes the value.
+inline size_t GallopLowerBound(const uint16_t* data, size_t position, size_t size, uint16_t value) noexcept
+{
+	if (position == size || data[position] >= value)
+		return position;
+	size_t step = 1;
+	while (position + step < size && data[position + step] < value) {
+		position += step;
+		step *= 2;
+	}
+	return std::lower_bound(data + position + 1, data + std::min(position + step, size), value) - data;
+}
+
+inline size_t GallopIntersectArrays(const uint16_t* small, size_t smallSize, const uint16_t* large, size_t largeSize,
+	uint16_t* output) noexcept
+{
+	size_t size = 0;
+	size_t position = 0;
+	for (size_t i = 0; i < smallSize && position < largeSize; ++i) {
+		position = GallopLowerBound(large, position, largeSize, small[i]);
+		if (position < largeSize && large[position] == small[i])
+			output[size++] = small[i];
+	}
+	return size;
+}
+
+// Copies the stretches of the large array between the values of the small one.
+inline size_t GallopUnionArrays(const uint16_t* small, size_t smallSize, const uint16_t* large, size_t largeSize,
+	uint16_t* output) noexcept
+{
+	size_t size = 0;
+	size_t position = 0;
+	for (size_t i = 0; i < smallSize; ++i) {
+		size_t next = GallopLowerBound(large, position, largeSize, small[i]);
+		size = std::copy(large + position, large + next, output + size) - output;
+		output[size++] = small[i];
+		position = next < largeSize && large[next] == small[i] ? next + 1 : next;
+	}
+	return std::copy(large + position, large + largeSize, output + size) - output;
+}
+
+inline size_t GallopDifferenceArrays(const uint16_t* first, size_t firstSize, const uint16_t* second, size_t secondSize,
+	uint16_t* output) noexcept
+{
+	size_t size = 0;
+	size_t position = 0;
+	if (firstSize < secondSize) {
+		for (size_t i = 0; i < firstSize; ++i) {
+			position = GallopLowerBound(second, position, secondSize, first[i]);
+			if (position == secondSize || second[position] != first[i])
+				output[size++] = first[i];
+		}
+		return size;
+	}
+	for (size_t i = 0; i < secondSize; ++i) {
+		size_t next = GallopLowerBound(first, position, firstSize, second[i]);
+		size = std::copy(first + position, first + next, output + size) - output;
+		position = next < firstSize && first[next] == second[i] ? next + 1 : next;
+	}
+	return std::copy(first + position, first + firstSize, output + size) - output;
+}
+
+// Whether one array is so much larger than the other that galloping beats a merge.
+inline bool UseGallop(size_t firstSize, size_t secondSize) noexcept
+{
+	return firstSize * 64 < secondSize || secondSize * 64 < firstSize;
+}
+
+#ifdef ALGORITHMS_VECTOR
+// The vector kernels work on blocks of eight values in a 16-byte register. An intersection or difference compares
+// every value of a block of one array with all eight of a block of the other, by comparing with the block and its
+// seven rotations, and advances the block that ends first. A union merges two blocks with a min/max network, keeps
+// the smaller half and drops the values equal to their predecessor, as in Lemire, Katsov and Kurz, "SIMD
+// compression and the intersection of sorted integers". Like the kernels of Algorithms.h they are compiled for
+// the baseline instruction set and, on x86, for AVX2, which has unsigned 16-bit min and max and byte shuffles.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+using RoaringLanes = SimdVector<uint16_t, 16>;
+// What comparing two RoaringLanes gives: all bits of a lane set where the comparison holds.
+using RoaringMask = SimdVector<int16_t, 16>;
+
+// Lane i takes lane i + 1, and the last lane the first. GCC lowers the generic shuffle to lane inserts on SSE2,
+// so x86 shifts the register bytewise instead.
+ROARING_INLINE RoaringLanes RotateLanes(RoaringLanes values) noexcept
+{
+#if defined(__SSE2__)
+	__m128i bytes = std::bit_cast<__m128i>(values);
+	return std::bit_cast<RoaringLanes>(_mm_or_si128(_mm_srli_si128(bytes, 2), _mm_slli_si128(bytes, 14)));
+#elif defined(__clang__)
+	return __builtin_shufflevector(values, values, 1, 2, 3, 4, 5, 6, 7, 0);
+#else
+	return __builtin_shuffle(values, RoaringLanes{ 1, 2, 3, 4, 5, 6, 7, 0 });
+#endif
+}
+
+// The last lane of previous followed by the first seven lanes of values.
+ROARING_INLINE RoaringLanes ShiftInLane(RoaringLanes previous, RoaringLanes values) noexcept
+{
+#if defined(__SSE2__)
+	return std::bit_cast<RoaringLanes>(_mm_or_si128(_mm_srli_si128(std::bit_cast<__m128i>(previous), 14),
+		_mm_slli_si128(std::bit_cast<__m128i>(values), 2)));
+#elif defined(__clang__)
+	return __builtin_shufflevector(previous, values, 7, 8, 9, 10, 11, 12, 13, 14);
+#else
+	return __builtin_shuffle(previous, values, RoaringLanes{ 7, 8, 9, 10, 11, 12, 13, 14 });
+#endif
+}
+
+// SSE2 has no unsigned 16-bit minimum or maximum, but its saturating subtraction gives both.
+ROARING_INLINE RoaringLanes MinLanes(RoaringLanes first, RoaringLanes second) noexcept
+{
+#if defined(__SSE2__)
+	return first - std::bit_cast<RoaringLanes>(_mm_subs_epu16(std::bit_cast<__m128i>(first), std::bit_cast<__m128i>(second)));
+#else
+	return first < second ? first : second;
+#endif
+}
+
+ROARING_INLINE RoaringLanes MaxLanes(RoaringLanes first, RoaringLanes second) noexcept
+{
+#if defined(__SSE2__)
+	return second + std::bit_cast<RoaringLanes>(_mm_subs_epu16(std::bit_cast<__m128i>(first), std::bit_cast<__m128i>(second)));
+#else
+	return first < second ? second : first;
+#endif
+}
+
+// The lanes of first that equal any lane of second.
+ROARING_INLINE RoaringMask MatchLanes(RoaringLanes first, RoaringLanes second) noexcept
+{
+	RoaringMask matches = first == second;
+#pragma GCC unroll 7
+	for (int rotation = 1; rotation < 8; ++rotation) {
+		second = RotateLanes(second);
+		matches |= first == second;
+	}
+	return matches;
+}
+
+// Writes the lanes of values whose mask lane is set to output, in order, and returns their number. All eight
+// lanes are stored, so output needs room for eight values.
+ROARING_INLINE size_t StoreLanes(uint16_t* output, RoaringLanes values, RoaringMask keep) noexcept
+{
+	size_t size = 0;
+#pragma GCC unroll 8
+	for (int lane = 0; lane < 8; ++lane) {
+		output[size] = values[lane];
+		size += static_cast<size_t>(keep[lane] & 1);
+	}
+	return size;
+}
+
+// Stores the lanes of values that differ from the lane before them, the first lane being compared with the last
+// lane of previous.
+ROARING_INLINE size_t StoreUniqueLanes(uint16_t* output, RoaringLanes previous, RoaringLanes values) noexcept
+{
+	return StoreLanes(output, values, ShiftInLane(previous, values) != values);
+}
+
+// Merges two sorted blocks: low receives the smallest eight of their values in order, high the largest eight.
+ROARING_INLINE void MergeLanes(RoaringLanes first, RoaringLanes second, RoaringLanes& low, RoaringLanes& high) noexcept
+{
+	RoaringLanes minimum = MinLanes(first, second);
+	high = MaxLanes(first, second);
+#pragma GCC unroll 7
+	for (int step = 0; step < 7; ++step) {
+		minimum = RotateLanes(minimum);
+		RoaringLanes smaller = MinLanes(minimum, high);
+		high = MaxLanes(minimum, high);
+		minimum = smaller;
+	}
+	low = RotateLanes(minimum);
+}
+
+ROARING_INLINE size_t SimdIntersectArraysKernel(const uint16_t* first, size_t firstSize, const uint16_t* second,
+	size_t secondSize, uint16_t* output) noexcept
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t size = 0;
+	while (i + 8 <= firstSize && j + 8 <= secondSize) {
+		RoaringLanes block = SimdLoad<RoaringLanes>(first + i);
+		size += StoreLanes(output + size, block, MatchLanes(block, SimdLoad<RoaringLanes>(second + j)));
+		uint16_t firstLast = first[i + 7];
+		uint16_t secondLast = second[j + 7];
+		i += firstLast <= secondLast ? 8 : 0;
+		j += secondLast <= firstLast ? 8 : 0;
+	}
+	return size + ScalarIntersectArrays(first + i, firstSize - i, second + j, secondSize - j, output + size);
+}
+
+ROARING_INLINE size_t SimdDifferenceArraysKernel(const uint16_t* first, size_t firstSize, const uint16_t* second,
+	size_t secondSize, uint16_t* output) noexcept
+{
+	size_t i = 0;
+	size_t j = 0;
+	size_t size = 0;
+	// The lanes of the current block of first found in the blocks of second compared with it so far.
+	RoaringMask found = {};
+	bool started = false;
+	while (i + 8 <= firstSize && j + 8 <= secondSize) {
+		RoaringLanes block = SimdLoad<RoaringLanes>(first + i);
+		found |= MatchLanes(block, SimdLoad<RoaringLanes>(second + j));
+		uint16_t firstLast = first[i + 7];
+		uint16_t secondLast = second[j + 7];
+		started = firstLast > secondLast;
+		if (!started) {
+			size += StoreLanes(output + size, block, ~found);
+			found = RoaringMask{};
+			i += 8;
+		}
+		if (secondLast <= firstLast)
+			j += 8;
+	}
+	// A block of first that met the end of the blocks of second still needs its other values checked.
+	if (started) {
+		uint16_t rest[8];
+		size_t restSize = StoreLanes(rest, SimdLoad<RoaringLanes>(first + i), ~found);
+		size += ScalarDifferenceArrays(rest, restSize, second + j, secondSize - j, output + size);
+		i += 8;
+	}
+	return size + ScalarDifferenceArrays(first + i, firstSize - i, second + j, secondSize - j, output + size);
+}
+
+ROARING_INLINE size_t SimdUnionArraysKernel(const uint16_t* first, size_t firstSize, const uint16_t* second,
+	size_t secondSize, uint16_t* output) noexcept
+{
+	if (firstSize < 8 || secondSize < 8)
+		return ScalarUnionArrays(first, firstSize, second, secondSize, output);
+
+	size_t firstBlocksEnd = firstSize / 8 * 8;
+	size_t secondBlocksEnd = secondSize / 8 * 8;
+	RoaringLanes low;
+	RoaringLanes high;
+	MergeLanes(SimdLoad<RoaringLanes>(first), SimdLoad<RoaringLanes>(second), low, high);
+	// Eight distinct values cannot start with 0xFFFF, so the first store keeps its first value.
+	size_t size = StoreUniqueLanes(output, SimdBroadcast<RoaringLanes>(uint16_t{ 0xFFFF }), low);
+	RoaringLanes previous = low;
+	size_t i = 8;
+	size_t j = 8;
+	// Taking the block with the smaller first value keeps every stored value at most all values still to load.
+	while (i < firstBlocksEnd && j < secondBlocksEnd) {
+		RoaringLanes block;
+		if (first[i] <= second[j]) {
+			block = SimdLoad<RoaringLanes>(first + i);
+			i += 8;
+		}
+		else {
+			block = SimdLoad<RoaringLanes>(second + j);
+			j += 8;
+		}
+		MergeLanes(block, high, low, high);
+		size += StoreUniqueLanes(output + size, previous, low);
+		previous = low;
+	}
+
+	// The values of high and the fewer than eight left of the array whose blocks ran out are merged with the rest
+	// of the other array. Only the first merged value can repeat the last stored one.
+	uint16_t pending[24];
+	size_t pendingSize = StoreUniqueLanes(pending, previous, high);
+	const uint16_t* rest = i == firstBlocksEnd ? second + j : first + i;
+	size_t restSize = i == firstBlocksEnd ? secondSize - j : firstSize - i;
+	if (i == firstBlocksEnd)
+		pendingSize = std::copy(first + i, first + firstSize, pending + pendingSize) - pending;
+	else
+		pendingSize = std::copy(second + j, second + secondSize, pending + pendingSize) - pending;
+	std::sort(pending, pending + pendingSize);
+	pendingSize = std::unique(pending, pending + pendingSize) - pending;
+
+	size_t tail = ScalarUnionArrays(pending, pendingSize, rest, restSize, output + size);
+	if (tail > 0 && output[size] == output[size - 1]) {
+		std::copy(output + size + 1, output + size + tail, output + size);
+		--tail;
+	}
+	return size + tail;
+}
+
+#define ROARING_DEFINE_KERNELS(Name, Target) \
+	struct Name \
+	{ \
+		Target static size_t Intersect(const uint16_t* first, size_t firstSize, const uint16_t* second, \
+			size_t secondSize, uint16_t* output) noexcept \
+		{ return SimdIntersectArraysKernel(first, firstSize, second, secondSize, output); } \
+		Target static size_t Union(const uint16_t* first, size_t firstSize, const uint16_t* second, \
+			size_t secondSize, uint16_t* output) noexcept \
+		{ return SimdUnionArraysKernel(first, firstSize, second, secondSize, output); } \
+		Target static size_t Difference(const uint16_t* first, size_t firstSize, const uint16_t* second, \
+			size_t secondSize, uint16_t* output) noexcept \
+		{ return SimdDifferenceArraysKernel(first, firstSize, second, secondSize, output); } \
+	};
+
+ROARING_DEFINE_KERNELS(RoaringKernels128, )
+#ifdef ALGORITHMS_X86
+ROARING_DEFINE_KERNELS(RoaringKernelsAvx2, ALGORITHMS_TARGET_AVX2)
+#endif
+#undef ROARING_DEFINE_KERNELS
+
+#pragma GCC diagnostic pop
+
+// Calls call(Kernels) with the array kernels of the active instruction set, AVX2 standing in for AVX-512.
+template<typename Call>
+inline decltype(auto) RoaringDispatch(Call&& call)
+{
+#ifdef ALGORITHMS_X86
+	if (ActiveSimdIsa() >= SimdIsa::Avx2)
+		return call(RoaringKernelsAvx2{});
+#endif
+	return call(RoaringKernels128{});
+}
+#endif
+
+inline size_t IntersectArrays(const uint16_t* first, size_t firstSize, const uint16_t* second, size_t secondSize,
+	uint16_t* output) noexcept
+{
+	if (UseGallop(firstSize, secondSize)) {
+		return firstSize < secondSize ? GallopIntersectArrays(first, firstSize, second, secondSize, output)
+			: GallopIntersectArrays(second, secondSize, first, firstSize, output);
+	}
+#ifdef ALGORITHMS_VECTOR
+	if (ActiveSimdIsa() != SimdIsa::Scalar)
+		return RoaringDispatch([&](auto kernels) { return kernels.Intersect(first, firstSize, second, secondSize, output); });
+#endif
+	return ScalarIntersectArrays(first, firstSize, second, secondSize, output);
+}
+
+inline size_t UnionArrays(const uint16_t* first, size_t firstSize, const uint16_t* second, size_t secondSize,
+	uint16_t* output) noexcept
+{
+	if (UseGallop(firstSize, secondSize)) {
+		return firstSize < secondSize ? GallopUnionArrays(first, firstSize, second, secondSize, output)
+			: GallopUnionArrays(second, secondSize, first, firstSize, output);
+	}
+#ifdef ALGORITHMS_VECTOR
+	if (ActiveSimdIsa() != SimdIsa::Scalar)
+		return RoaringDispatch([&](auto kernels) { return kernels.Union(first, firstSize, second, secondSize, output); });
+#endif
+	return ScalarUnionArrays(first, firstSize, second, secondSize, output);
+}
+
+inline size_t DifferenceArrays(const uint16_t* first, size_t firstSize, const uint16_t* second, size_t secondSize,
+	uint16_t* output) noexcept
+{
+	if (UseGallop(firstSize, secondSize))
+		return GallopDifferenceArrays(first, firstSize, second, secondSize, output);
+#ifdef ALGORITHMS_VECTOR
+	if (ActiveSimdIsa() != SimdIsa::Scalar)
+		return RoaringDispatch([&](auto kernels) { return kernels.Difference(first, firstSize, second, secondSize, output); });
+#endif
+	return ScalarDifferenceArrays(first, firstSize, second, secondSize, output);
+}
+
+template<typename Roaring>
+class RoaringIterator
+{
+public:
+	using ValueType = uint32_t;
+	using PointerType = const ValueType*;
+	using ReferenceType = const ValueType&;
+
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = ValueType;
+	using difference_type = std::ptrdiff_t;
+	using pointer = PointerType;
+	using reference = ReferenceType;
+public:
+	RoaringIterator() noexcept : m_bitmap(nullptr), m_container(0), m_position(0), m_word(0), m_value(0) {}
+	RoaringIterator(const Roaring* bitmap, size_t container) noexcept
+		: m_bitmap(bitmap), m_container(container), m_position(0), m_word(0), m_value(0)
+	{
+		Enter();
+	}
+
+	PointerType operator->() const noexcept { return &m_value; }
+	ReferenceType operator*() const noexcept { return m_value; }
+
+	bool operator==(const RoaringIterator& other) const noexcept { return m_container == other.m_container && m_value == other.m_value; }
+	bool operator!=(const RoaringIterator& other) const noexcept { return !(*this == other); }
+
+	RoaringIterator& operator++() noexcept {
+		Advance();
+		return *this;
+	}
+	RoaringIterator operator++(int) noexcept {
+		RoaringIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+
+private:
+	using Container = typename Roaring::Container;
+	using ContainerType = typename Roaring::ContainerType;
+
+	const Container& Current() const noexcept
+	{
+		return m_bitmap->m_containers.Data()[m_container];
+	}
+
+	uint32_t High() const noexcept
+	{
+		return static_cast<uint32_t>(m_bitmap->m_keys.Data()[m_container]) << 16;
+	}
+
+	// Moves to the first value of container m_container, or to the end. Containers are never empty.
+	void Enter() noexcept
+	{
+		m_position = 0;
+		m_value = 0;
+		if (m_container == m_bitmap->m_keys.Size())
+			return;
+
+		const Container& container = Current();
+		if (container.type == ContainerType::Bitmap) {
+			while (container.words.Data()[m_position] == 0)
+				++m_position;
+			m_word = container.words.Data()[m_position];
+			m_value = High() | static_cast<uint32_t>(m_position * 64 + std::countr_zero(m_word));
+		}
+		else {
+			m_value = High() | container.values.Data()[0];
+		}
+	}
+
+	void Advance() noexcept
+	{
+		const Container& container = Current();
+		switch (container.type) {
+		case ContainerType::Array:
+			if (++m_position < container.values.Size()) {
+				m_value = High() | container.values.Data()[m_position];
+				return;
+			}
+			break;
+		case ContainerType::Bitmap:
+			m_word &= m_word - 1;
+			while (m_word == 0 && ++m_position < Roaring::BitmapWords)
+				m_word = container.words.Data()[m_position];
+			if (m_word != 0) {
+				m_value = High() | static_cast<uint32_t>(m_position * 64 + std::countr_zero(m_word));
+				return;
+			}
+			break;
+		case ContainerType::Run: {
+			const uint16_t* runs = container.values.Data();
+			if ((m_value & 0xFFFF) < static_cast<uint32_t>(runs[2 * m_position]) + runs[2 * m_position + 1]) {
+				++m_value;
+				return;
+			}
+			if (++m_position < container.values.Size() / 2) {
+				m_value = High() | runs[2 * m_position];
+				return;
+			}
+			break;
+		}
+		}
+		++m_container;
+		Enter();
+	}
+
+private:
+	const Roaring* m_bitmap;
+	size_t m_container;
+	// Index of the value, word or run within the container.
+	size_t m_position;
+	// The bits of the current bitmap word not visited yet.
+	uint64_t m_word;
+	uint32_t m_value;
+};
+
+// Compressed set of 32-bit integers in the style of Roaring bitmaps (Chambi, Lemire, Kaser and Godin, "Better
+// bitmap performance with Roaring bitmaps"). The values are split by their high 16 bits into chunks of 65536, each
+// stored in the smallest of three containers: a sorted array of the low 16 bits for up to 4096 values, a bitmap of
+// 1024 words for more, or a list of runs of consecutive values, which Optimize chooses where it is smaller. A
+// sparse posting list thus costs about 2 bytes per value, a dense one 1 bit, and a range a few bytes per run.
+// Intersections, unions and differences work container by container: pairs of arrays go through the vectorized
+// array kernels above, bitmaps through the two-input Transform of Algorithms.h, and runs are merged as intervals.
+// Every container stores its cardinality, so Cardinality is a sum over the containers. Serialize writes the
+// portable format of the Roaring format specification (little-endian, readable by the other Roaring libraries),
+// and RoaringView answers queries directly on such bytes, for example a file mapped into memory.
+class RoaringBitmap
+{
+	template<typename> friend class RoaringIterator;
+	friend class RoaringView;
+
+public:
+	using ValueType = uint32_t;
+	using Iterator = RoaringIterator<RoaringBitmap>;
+	using ConstIterator = Iterator;
+public:
+	//Constructors
+	RoaringBitmap() = default;
+
+	RoaringBitmap(std::initializer_list<uint32_t> values)
+	{
+		for (uint32_t value : values)
+			Add(value);
+	}
+
+	//Operators
+	bool operator==(const RoaringBitmap& other) const
+	{
+		if (m_keys != other.m_keys)
+			return false;
+		for (size_t i = 0; i < m_containers.Size(); ++i) {
+			if (!ContainersEqual(m_containers.Data()[i], other.m_containers.Data()[i]))
+				return false;
+		}
+		return true;
+	}
+
+	bool operator!=(const RoaringBitmap& other) const
+	{
+		return !(*this == other);
+	}
+
+	RoaringBitmap& operator&=(const RoaringBitmap& other)
+	{
+		*this = Combine(*this, other, false, false, AndContainers);
+		return *this;
+	}
+
+	RoaringBitmap& operator|=(const RoaringBitmap& other)
+	{
+		*this = Combine(*this, other, true, true, OrContainers);
+		return *this;
+	}
+
+	friend RoaringBitmap operator&(const RoaringBitmap& first, const RoaringBitmap& second)
+	{
+		return Combine(first, second, false, false, AndContainers);
+	}
+
+	friend RoaringBitmap operator|(const RoaringBitmap& first, const RoaringBitmap& second)
+	{
+		return Combine(first, second, true, true, OrContainers);
+	}
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return m_keys.Size() == 0;
+	}
+
+	// Number of values, from the counts the containers keep.
+	uint64_t Cardinality() const noexcept
+	{
+		uint64_t cardinality = 0;
+		for (const Container& container : m_containers.Span())
+			cardinality += container.cardinality;
+		return cardinality;
+	}
+
+	// Memory held by the keys and the containers.
+	size_t Bytes() const noexcept
+	{
+		size_t bytes = m_keys.Capacity() * sizeof(uint16_t) + m_containers.Capacity() * sizeof(Container);
+		for (const Container& container : m_containers.Span())
+			bytes += container.values.Capacity() * sizeof(uint16_t) + container.words.Capacity() * sizeof(uint64_t);
+		return bytes;
+	}
+
+	//Lookup
+	bool Contains(uint32_t value) const noexcept
+	{
+		size_t index = ContainerIndex(static_cast<uint16_t>(value >> 16));
+		return index < m_keys.Size() && m_keys.Data()[index] == value >> 16
+			&& ContainerContains(m_containers.Data()[index], static_cast<uint16_t>(value));
+	}
+
+	//Modifiers
+	// Returns false if value was already present. Adding values in increasing order appends in O(1).
+	bool Add(uint32_t value)
+	{
+		uint16_t key = static_cast<uint16_t>(value >> 16);
+		size_t index = ContainerIndex(key);
+		if (index == m_keys.Size() || m_keys.Data()[index] != key)
+			InsertContainer(index, key, Container());
+		return ContainerAdd(m_containers.Data()[index], static_cast<uint16_t>(value));
+	}
+
+	// Returns false if value was not present.
+	bool Remove(uint32_t value)
+	{
+		uint16_t key = static_cast<uint16_t>(value >> 16);
+		size_t index = ContainerIndex(key);
+		if (index == m_keys.Size() || m_keys.Data()[index] != key)
+			return false;
+		Container& container = m_containers.Data()[index];
+		if (!ContainerRemove(container, static_cast<uint16_t>(value)))
+			return false;
+		if (container.cardinality == 0)
+			EraseContainer(index);
+		return true;
+	}
+
+	// Removes the values of other.
+	RoaringBitmap& AndNot(const RoaringBitmap& other)
+	{
+		*this = Combine(*this, other, true, false, AndNotContainers);
+		return *this;
+	}
+
+	void Clear() noexcept
+	{
+		m_keys.Clear();
+		m_containers.Clear();
+	}
+
+	// Stores every container whose values form few enough runs as runs, and every other one as an array or a
+	// bitmap, whichever is smallest, and releases the spare capacity. Worth calling once a bitmap is built,
+	// before it is queried or serialized.
+	void Optimize()
+	{
+		for (Container& container : m_containers.Span()) {
+			if (container.type != ContainerType::Run && RunBytes(CountRuns(container)) < ContainerBytes(container))
+				ToRuns(container);
+			Normalize(container);
+			container.values.ShrinkToFit();
+		}
+		m_keys.ShrinkToFit();
+		m_containers.ShrinkToFit();
+	}
+
+	void Swap(RoaringBitmap& other) noexcept
+	{
+		m_keys.Swap(other.m_keys);
+		m_containers.Swap(other.m_containers);
+	}
+
+	//Operations
+	// Size of the intersection with other, without building it.
+	uint64_t AndCardinality(const RoaringBitmap& other) const
+	{
+		uint64_t cardinality = 0;
+		size_t i = 0;
+		size_t j = 0;
+		while (i < m_keys.Size() && j < other.m_keys.Size()) {
+			if (m_keys.Data()[i] < other.m_keys.Data()[j]) {
+				++i;
+			}
+			else if (other.m_keys.Data()[j] < m_keys.Data()[i]) {
+				++j;
+			}
+			else {
+				cardinality += AndCardinality(m_containers.Data()[i], other.m_containers.Data()[j]);
+				++i;
+				++j;
+			}
+		}
+		return cardinality;
+	}
+
+	// Calls function(value) for every value in increasing order, faster than the iterators.
+	template<typename Function>
+	void ForEach(Function function) const
+	{
+		for (size_t i = 0; i < m_keys.Size(); ++i) {
+			uint32_t high = static_cast<uint32_t>(m_keys.Data()[i]) << 16;
+			ForEachLow(m_containers.Data()[i], [&](uint32_t low) { function(high | low); });
+		}
+	}
+
+	//Serialization
+	size_t SerializedBytes() const noexcept
+	{
+		size_t bytes = HeaderBytes(m_keys.Size(), HasRuns());
+		for (const Container& container : m_containers.Span())
+			bytes += ContainerBytes(container);
+		return bytes;
+	}
+
+	// The portable Roaring format: a cookie, the key and cardinality - 1 of every container, their offsets, and
+	// the containers, with every number little-endian.
+	Vector<unsigned char> Serialize() const
+	{
+		Vector<unsigned char> bytes;
+		bytes.Resize(SerializedBytes());
+		unsigned char* output = bytes.Data();
+		size_t count = m_keys.Size();
+		bool hasRuns = HasRuns();
+
+		size_t position;
+		if (hasRuns) {
+			StoreLittle<uint32_t>(output, SerialCookie | static_cast<uint32_t>(count - 1) << 16);
+			for (size_t i = 0; i < count; ++i) {
+				if (m_containers.Data()[i].type == ContainerType::Run)
+					output[4 + i / 8] |= static_cast<unsigned char>(1 << (i % 8));
+			}
+			position = 4 + (count + 7) / 8;
+		}
+		else {
+			StoreLittle<uint32_t>(output, SerialCookieNoRuns);
+			StoreLittle<uint32_t>(output + 4, static_cast<uint32_t>(count));
+			position = 8;
+		}
+		for (size_t i = 0; i < count; ++i) {
+			StoreLittle<uint16_t>(output + position + 4 * i, m_keys.Data()[i]);
+			StoreLittle<uint16_t>(output + position + 4 * i + 2, static_cast<uint16_t>(m_containers.Data()[i].cardinality - 1));
+		}
+		position += 4 * count;
+
+		size_t offsets = position;
+		size_t offset = HeaderBytes(count, hasRuns);
+		for (size_t i = 0; i < count; ++i) {
+			const Container& container = m_containers.Data()[i];
+			if (HasOffsets(count, hasRuns))
+				StoreLittle<uint32_t>(output + offsets + 4 * i, static_cast<uint32_t>(offset));
+			unsigned char* data = output + offset;
+			switch (container.type) {
+			case ContainerType::Array:
+				for (size_t k = 0; k < container.values.Size(); ++k)
+					StoreLittle<uint16_t>(data + 2 * k, container.values.Data()[k]);
+				break;
+			case ContainerType::Bitmap:
+				for (size_t k = 0; k < BitmapWords; ++k)
+					StoreLittle<uint64_t>(data + 8 * k, container.words.Data()[k]);
+				break;
+			case ContainerType::Run:
+				StoreLittle<uint16_t>(data, static_cast<uint16_t>(container.values.Size() / 2));
+				for (size_t k = 0; k < container.values.Size(); ++k)
+					StoreLittle<uint16_t>(data + 2 + 2 * k, container.values.Data()[k]);
+				break;
+			}
+			offset += ContainerBytes(container);
+		}
+		return bytes;
+	}
+
+	// Reads the portable format. Throws std::runtime_error if the bytes are truncated or not a valid bitmap.
+	static RoaringBitmap Deserialize(std::span<const unsigned char> bytes);
+
+	// Writes the portable format next to path, syncs it and renames it over path, so readers never see a partial
+	// file, even after a crash.
+	void Save(const std::string& path) const
+	{
+		Vector<unsigned char> bytes = Serialize();
+		const std::string temporary = path + ".tmp";
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(bytes.Data()), static_cast<std::streamsize>(bytes.Size()));
+			file.close();
+			if (!file || !SyncFile(temporary)) {
+				std::remove(temporary.c_str());
+				throw std::runtime_error("RoaringBitmap: cannot write " + temporary);
+			}
+		}
+		std::filesystem::rename(temporary, path);
+	}
+
+	//Iterators
+	Iterator begin() const { return Iterator(this, 0); };
+	Iterator end() const { return Iterator(this, m_keys.Size()); };
+
+private:
+	enum class ContainerType : uint8_t
+	{
+		Array,
+		Bitmap,
+		Run,
+	};
+
+	struct Container
+	{
+		ContainerType type = ContainerType::Array;
+		uint32_t cardinality = 0;
+		// Array: the sorted values. Run: the start and the length - 1 of every run, in order.
+		Vector<uint16_t> values;
+		// Bitmap: BitmapWords words, value v in bit v % 64 of word v / 64.
+		Vector<uint64_t> words;
+	};
+
+	static constexpr uint32_t ArrayMaxSize = 4096;
+	static constexpr size_t BitmapWords = 1024;
+
+	static constexpr uint32_t SerialCookieNoRuns = 12346;
+	static constexpr uint32_t SerialCookie = 12347;
+	// Serialized bitmaps with runs and fewer containers than this have no offsets.
+	static constexpr size_t NoOffsetThreshold = 4;
+
+	// Index of the container with key, or of the first one with a larger key. Checks the last container first,
+	// where values added in increasing order go.
+	size_t ContainerIndex(uint16_t key) const noexcept
+	{
+		size_t count = m_keys.Size();
+		if (count == 0 || m_keys.Data()[count - 1] < key)
+			return count;
+		if (m_keys.Data()[count - 1] == key)
+			return count - 1;
+		return std::lower_bound(m_keys.Data(), m_keys.Data() + count, key) - m_keys.Data();
+	}
+
+	void InsertContainer(size_t index, uint16_t key, Container&& container)
+	{
+		m_keys.PushBack(key);
+		m_containers.PushBack(std::move(container));
+		uint16_t* keys = m_keys.Data();
+		Container* containers = m_containers.Data();
+		std::rotate(keys + index, keys + m_keys.Size() - 1, keys + m_keys.Size());
+		std::rotate(containers + index, containers + m_containers.Size() - 1, containers + m_containers.Size());
+	}
+
+	void EraseContainer(size_t index)
+	{
+		std::move(m_keys.Data() + index + 1, m_keys.Data() + m_keys.Size(), m_keys.Data() + index);
+		std::move(m_containers.Data() + index + 1, m_containers.Data() + m_containers.Size(), m_containers.Data() + index);
+		m_keys.PopBack();
+		m_containers.PopBack();
+	}
+
+	// Merges the containers of first and second by key into a new bitmap: keys in both get operation(first,
+	// second), keys only in first are kept if keepFirst and keys only in second if keepSecond. Empty results are
+	// dropped. The kept containers of first are moved unless it is const.
+	template<typename First, typename Operation>
+	static RoaringBitmap Combine(First& first, const RoaringBitmap& second, bool keepFirst, bool keepSecond, Operation operation)
+	{
+		RoaringBitmap result;
+		size_t i = 0;
+		size_t j = 0;
+		while (i < first.m_keys.Size() || j < second.m_keys.Size()) {
+			bool fromFirst = j == second.m_keys.Size()
+				|| (i < first.m_keys.Size() && first.m_keys.Data()[i] < second.m_keys.Data()[j]);
+			bool fromSecond = i == first.m_keys.Size()
+				|| (j < second.m_keys.Size() && second.m_keys.Data()[j] < first.m_keys.Data()[i]);
+			if (fromFirst) {
+				if (keepFirst) {
+					result.m_keys.PushBack(first.m_keys.Data()[i]);
+					if constexpr (std::is_const_v<First>)
+						result.m_containers.PushBack(first.m_containers.Data()[i]);
+					else
+						result.m_containers.PushBack(std::move(first.m_containers.Data()[i]));
+				}
+				++i;
+			}
+			else if (fromSecond) {
+				if (keepSecond) {
+					result.m_keys.PushBack(second.m_keys.Data()[j]);
+					result.m_containers.PushBack(second.m_containers.Data()[j]);
+				}
+				++j;
+			}
+			else {
+				Container container = operation(first.m_containers.Data()[i], second.m_containers.Data()[j]);
+				if (container.cardinality > 0) {
+					result.m_keys.PushBack(first.m_keys.Data()[i]);
+					result.m_containers.PushBack(std::move(container));
+				}
+				++i;
+				++j;
+			}
+		}
+		return result;
+	}
+
+	bool HasRuns() const noexcept
+	{
+		for (const Container& container : m_containers.Span()) {
+			if (container.type == ContainerType::Run)
+				return true;
+		}
+		return false;
+	}
+
+	static bool HasOffsets(size_t count, bool hasRuns) noexcept
+	{
+		return !hasRuns || count >= NoOffsetThreshold;
+	}
+
+	static size_t HeaderBytes(size_t count, bool hasRuns) noexcept
+	{
+		size_t bytes = hasRuns ? 4 + (count + 7) / 8 : 8;
+		return bytes + 4 * count + (HasOffsets(count, hasRuns) ? 4 * count : 0);
+	}
+
+	static size_t RunBytes(size_t runs) noexcept
+	{
+		return 2 + 4 * runs;
+	}
+
+	// Serialized size of a container, and its size in memory up to a constant.
+	static size_t ContainerBytes(const Container& container) noexcept
+	{
+		switch (container.type) {
+		case ContainerType::Array:
+			return 2 * container.values.Size();
+		case ContainerType::Bitmap:
+			return 8 * BitmapWords;
+		default:
+			return RunBytes(container.values.Size() / 2);
+		}
+	}
+
+	template<typename U>
+	static void StoreLittle(unsigned char* bytes, U value) noexcept
+	{
+		for (size_t i = 0; i < sizeof(U); ++i)
+			bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+	}
+
+	template<typename U>
+	static U LoadLittle(const unsigned char* bytes) noexcept
+	{
+		U value = 0;
+		for (size_t i = 0; i < sizeof(U); ++i)
+			value = static_cast<U>(value | static_cast<U>(bytes[i]) << (8 * i));
+		return value;
+	}
+
+	// Number of runs that start at or before value.
+	static size_t RunsStartingBefore(const Container& container, uint32_t value) noexcept
+	{
+		const uint16_t* runs = container.values.Data();
+		size_t low = 0;
+		size_t high = container.values.Size() / 2;
+		while (low < high) {
+			size_t middle = low + (high - low) / 2;
+			if (runs[2 * middle] <= value)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+		return low;
+	}
+
+	static uint32_t RunLast(const Container& container, size_t run) noexcept
+	{
+		return static_cast<uint32_t>(container.values.Data()[2 * run]) + container.values.Data()[2 * run + 1];
+	}
+
+	static bool ContainerContains(const Container& container, uint16_t value) noexcept
+	{
+		switch (container.type) {
+		case ContainerType::Array:
+			return std::binary_search(container.values.Data(), container.values.Data() + container.values.Size(), value);
+		case ContainerType::Bitmap:
+			return (container.words.Data()[value / 64] >> (value % 64)) & 1;
+		default: {
+			size_t run = RunsStartingBefore(container, value);
+			return run > 0 && value <= RunLast(container, run - 1);
+		}
+		}
+	}
+
+	// Calls function(low) for the low 16 bits of every value of the container in increasing order.
+	template<typename Function>
+	static void ForEachLow(const Container& container, Function&& function)
+	{
+		switch (container.type) {
+		case ContainerType::Array:
+			for (uint16_t value : container.values.Span())
+				function(static_cast<uint32_t>(value));
+			break;
+		case ContainerType::Bitmap:
+			for (size_t i = 0; i < BitmapWords; ++i) {
+				for (uint64_t word = container.words.Data()[i]; word != 0; word &= word - 1)
+					function(static_cast<uint32_t>(i * 64 + std::countr_zero(word)));
+			}
+			break;
+		case ContainerType::Run:
+			for (size_t run = 0; run < container.values.Size() / 2; ++run) {
+				uint32_t last = RunLast(container, run);
+				for (uint32_t value = container.values.Data()[2 * run]; value <= last; ++value)
+					function(value);
+			}
+			break;
+		}
+	}
+
+	static void InsertValues(Vector<uint16_t>& values, size_t index, std::initializer_list<uint16_t> inserted)
+	{
+		size_t size = values.Size();
+		for (uint16_t value : inserted)
+			values.PushBack(value);
+		std::rotate(values.Data() + index, values.Data() + size, values.Data() + values.Size());
+	}
+
+	static void EraseValues(Vector<uint16_t>& values, size_t index, size_t count)
+	{
+		std::move(values.Data() + index + count, values.Data() + values.Size(), values.Data() + index);
+		for (size_t i = 0; i < count; ++i)
+			values.PopBack();
+	}
+
+	static bool ContainerAdd(Container& container, uint16_t value)
+	{
+		Vector<uint16_t>& values = container.values;
+		switch (container.type) {
+		case ContainerType::Array: {
+			size_t size = values.Size();
+			if (size == 0 || values.Data()[size - 1] < value) {
+				values.PushBack(value);
+			}
+			else {
+				size_t index = std::lower_bound(values.Data(), values.Data() + size, value) - values.Data();
+				if (values.Data()[index] == value)
+					return false;
+				InsertValues(values, index, { value });
+			}
+			if (++container.cardinality > ArrayMaxSize)
+				ToBitmap(container);
+			return true;
+		}
+		case ContainerType::Bitmap: {
+			uint64_t& word = container.words.Data()[value / 64];
+			uint64_t bit = uint64_t{ 1 } << (value % 64);
+			if (word & bit)
+				return false;
+			word |= bit;
+			++container.cardinality;
+			return true;
+		}
+		case ContainerType::Run: {
+			size_t run = RunsStartingBefore(container, value);
+			if (run > 0 && value <= RunLast(container, run - 1))
+				return false;
+			bool extendsPrevious = run > 0 && RunLast(container, run - 1) + 1 == value;
+			bool extendsNext = run < values.Size() / 2 && values.Data()[2 * run] == value + 1;
+			if (extendsPrevious && extendsNext) {
+				values.Data()[2 * run - 1] = static_cast<uint16_t>(values.Data()[2 * run - 1] + values.Data()[2 * run + 1] + 2);
+				EraseValues(values, 2 * run, 2);
+			}
+			else if (extendsPrevious) {
+				++values.Data()[2 * run - 1];
+			}
+			else if (extendsNext) {
+				--values.Data()[2 * run];
+				++values.Data()[2 * run + 1];
+			}
+			else {
+				InsertValues(values, 2 * run, { value, 0 });
+			}
+			++container.cardinality;
+			return true;
+		}
+		}
+		return false;
+	}
+
+	static bool ContainerRemove(Container& container, uint16_t value)
+	{
+		Vector<uint16_t>& values = container.values;
+		switch (container.type) {
+		case ContainerType::Array: {
+			uint16_t* position = std::lower_bound(values.Data(), values.Data() + values.Size(), value);
+			if (position == values.Data() + values.Size() || *position != value)
+				return false;
+			EraseValues(values, position - values.Data(), 1);
+			--container.cardinality;
+			return true;
+		}
+		case ContainerType::Bitmap: {
+			uint64_t& word = container.words.Data()[value / 64];
+			uint64_t bit = uint64_t{ 1 } << (value % 64);
+			if (!(word & bit))
+				return false;
+			word &= ~bit;
+			if (--container.cardinality <= ArrayMaxSize)
+				ToArray(container);
+			return true;
+		}
+		case ContainerType::Run: {
+			size_t run = RunsStartingBefore(container, value);
+			if (run == 0 || value > RunLast(container, run - 1))
+				return false;
+			--run;
+			uint32_t start = values.Data()[2 * run];
+			uint32_t last = RunLast(container, run);
+			if (start == last) {
+				EraseValues(values, 2 * run, 2);
+			}
+			else if (value == start) {
+				++values.Data()[2 * run];
+				--values.Data()[2 * run + 1];
+			}
+			else if (value == last) {
+				--values.Data()[2 * run + 1];
+			}
+			else {
+				values.Data()[2 * run + 1] = static_cast<uint16_t>(value - 1 - start);
+				InsertValues(values, 2 * run + 2, { static_cast<uint16_t>(value + 1), static_cast<uint16_t>(last - value - 1) });
+			}
+			--container.cardinality;
+			return true;
+		}
+		}
+		return false;
+	}
+
+	// Sets the bits first to last, inclusive.
+	static void SetRange(uint64_t* words, uint32_t first, uint32_t last) noexcept
+	{
+		size_t firstWord = first / 64;
+		size_t lastWord = last / 64;
+		uint64_t firstMask = ~uint64_t{ 0 } << (first % 64);
+		uint64_t lastMask = ~uint64_t{ 0 } >> (63 - last % 64);
+		if (firstWord == lastWord) {
+			words[firstWord] |= firstMask & lastMask;
+			return;
+		}
+		words[firstWord] |= firstMask;
+		std::fill(words + firstWord + 1, words + lastWord, ~uint64_t{ 0 });
+		words[lastWord] |= lastMask;
+	}
+
+	// The words of the container as a bitmap, converting arrays and runs into scratch.
+	static const uint64_t* BitmapOf(const Container& container, Vector<uint64_t>& scratch)
+	{
+		if (container.type == ContainerType::Bitmap)
+			return container.words.Data();
+		scratch.Resize(BitmapWords);
+		std::fill(scratch.Data(), scratch.Data() + BitmapWords, uint64_t{ 0 });
+		if (container.type == ContainerType::Array) {
+			for (uint16_t value : container.values.Span())
+				scratch.Data()[value / 64] |= uint64_t{ 1 } << (value % 64);
+		}
+		else {
+			for (size_t run = 0; run < container.values.Size() / 2; ++run)
+				SetRange(scratch.Data(), container.values.Data()[2 * run], RunLast(container, run));
+		}
+		return scratch.Data();
+	}
+
+	static void ToBitmap(Container& container)
+	{
+		Vector<uint64_t> words;
+		BitmapOf(container, words);
+		container.words = std::move(words);
+		container.values = Vector<uint16_t>();
+		container.type = ContainerType::Bitmap;
+	}
+
+	static void ToArray(Container& container)
+	{
+		Vector<uint16_t> values;
+		values.Reserve(container.cardinality);
+		ForEachLow(container, [&values](uint32_t value) { values.PushBack(static_cast<uint16_t>(value)); });
+		container.values = std::move(values);
+		container.words = Vector<uint64_t>();
+		container.type = ContainerType::Array;
+	}
+
+	static void ToRuns(Container& container)
+	{
+		Container runs;
+		ForEachLow(container, [&runs](uint32_t value) { AppendRun(runs, value, value); });
+		container.values = std::move(runs.values);
+		container.words = Vector<uint64_t>();
+		container.type = ContainerType::Run;
+	}
+
+	static size_t CountRuns(const Container& container) noexcept
+	{
+		size_t runs = 0;
+		switch (container.type) {
+		case ContainerType::Array:
+			for (size_t i = 0; i < container.values.Size(); ++i)
+				runs += i == 0 || container.values.Data()[i] != container.values.Data()[i - 1] + 1;
+			break;
+		case ContainerType::Bitmap: {
+			// A run starts at every set bit whose lower neighbour is clear.
+			uint64_t carry = 0;
+			for (uint64_t word : container.words.Span()) {
+				runs += static_cast<size_t>(std::popcount(word & ~(word << 1 | carry)));
+				carry = word >> 63;
+			}
+			break;
+		}
+		case ContainerType::Run:
+			runs = container.values.Size() / 2;
+			break;
+		}
+		return runs;
+	}
+
+	// Keeps arrays at most ArrayMaxSize values and bitmaps above, and runs only while they are the smallest form.
+	static void Normalize(Container& container)
+	{
+		switch (container.type) {
+		case ContainerType::Array:
+			if (container.cardinality > ArrayMaxSize)
+				ToBitmap(container);
+			break;
+		case ContainerType::Bitmap:
+			if (container.cardinality <= ArrayMaxSize)
+				ToArray(container);
+			break;
+		case ContainerType::Run: {
+			size_t otherBytes = container.cardinality <= ArrayMaxSize ? 2 * container.cardinality : 8 * BitmapWords;
+			if (RunBytes(container.values.Size() / 2) >= otherBytes) {
+				if (container.cardinality <= ArrayMaxSize)
+					ToArray(container);
+				else
+					ToBitmap(container);
+			}
+			break;
+		}
+		}
+	}
+
+	// Appends the run first to last to a run container, merging it with the last run if they touch. Runs must be
+	// appended in order of their starts.
+	static void AppendRun(Container& container, uint32_t first, uint32_t last)
+	{
+		Vector<uint16_t>& values = container.values;
+		size_t size = values.Size();
+		if (size > 0 && first <= RunLast(container, size / 2 - 1) + 1) {
+			uint32_t start = values.Data()[size - 2];
+			values.Data()[size - 1] = static_cast<uint16_t>(std::max(last, RunLast(container, size / 2 - 1)) - start);
+		}
+		else {
+			values.PushBack(static_cast<uint16_t>(first));
+			values.PushBack(static_cast<uint16_t>(last - first));
+		}
+	}
+
+	static void CountRunCardinality(Container& container) noexcept
+	{
+		container.cardinality = 0;
+		for (size_t run = 0; run < container.values.Size() / 2; ++run)
+			container.cardinality += static_cast<uint32_t>(container.values.Data()[2 * run + 1]) + 1;
+	}
+
+	static Container RunContainer()
+	{
+		Container container;
+		container.type = ContainerType::Run;
+		return container;
+	}
+
+	static Container BitmapContainer(Vector<uint64_t>&& words)
+	{
+		Container container;
+		container.type = ContainerType::Bitmap;
+		container.cardinality = static_cast<uint32_t>(PopCount(words.Span()));
+		container.words = std::move(words);
+		return container;
+	}
+
+	// A bitmap container holding operation applied to the words of first and second.
+	template<typename Operation>
+	static Container CombineBitmaps(const Container& first, const Container& second, Operation operation)
+	{
+		Vector<uint64_t> scratch;
+		Vector<uint64_t> words;
+		const uint64_t* firstWords = BitmapOf(first, words);
+		if (firstWords != words.Data())
+			words = first.words;
+		const uint64_t* secondWords = BitmapOf(second, scratch);
+		Transform<uint64_t, uint64_t, uint64_t>(words.Span(), std::span<const uint64_t>(secondWords, BitmapWords), words.Span(), operation);
+		return BitmapContainer(std::move(words));
+	}
+
+	// The values of array that other contains, or does not contain if excluded is set.
+	static Container FilterArray(const Container& array, const Container& other, bool excluded)
+	{
+		Container result;
+		result.values.Reserve(array.cardinality);
+		for (uint16_t value : array.values.Span()) {
+			if (ContainerContains(other, value) != excluded)
+				result.values.PushBack(value);
+		}
+		result.cardinality = static_cast<uint32_t>(result.values.Size());
+		return result;
+	}
+
+	template<typename Kernel>
+	static Container CombineArrays(const Container& first, const Container& second, size_t maxSize, Kernel kernel)
+	{
+		Container result;
+		result.values.Resize(maxSize + 8);
+		size_t size = kernel(first.values.Data(), first.values.Size(), second.values.Data(), second.values.Size(), result.values.Data());
+		result.values.Resize(size);
+		result.cardinality = static_cast<uint32_t>(size);
+		return result;
+	}
+
+	static Container AndContainers(const Container& first, const Container& second)
+	{
+		Container result;
+		if (first.type == ContainerType::Array && second.type == ContainerType::Array) {
+			result = CombineArrays(first, second, std::min(first.values.Size(), second.values.Size()), IntersectArrays);
+		}
+		else if (first.type == ContainerType::Array || second.type == ContainerType::Array) {
+			bool firstIsArray = first.type == ContainerType::Array;
+			result = FilterArray(firstIsArray ? first : second, firstIsArray ? second : first, false);
+		}
+		else if (first.type == ContainerType::Run && second.type == ContainerType::Run) {
+			result = RunContainer();
+			size_t i = 0;
+			size_t j = 0;
+			while (i < first.values.Size() / 2 && j < second.values.Size() / 2) {
+				uint32_t start = std::max(first.values.Data()[2 * i], second.values.Data()[2 * j]);
+				uint32_t last = std::min(RunLast(first, i), RunLast(second, j));
+				if (start <= last)
+					AppendRun(result, start, last);
+				if (RunLast(first, i) < RunLast(second, j))
+					++i;
+				else
+					++j;
+			}
+			CountRunCardinality(result);
+		}
+		else {
+			result = CombineBitmaps(first, second, [](uint64_t a, uint64_t b) { return a & b; });
+		}
+		Normalize(result);
+		return result;
+	}
+
+	static Container OrContainers(const Container& first, const Container& second)
+	{
+		Container result;
+		if (first.type == ContainerType::Array && second.type == ContainerType::Array
+			&& first.cardinality + second.cardinality <= ArrayMaxSize) {
+			result = CombineArrays(first, second, first.values.Size() + second.values.Size(), UnionArrays);
+		}
+		else if (first.type == ContainerType::Run && second.type == ContainerType::Run) {
+			result = RunContainer();
+			size_t i = 0;
+			size_t j = 0;
+			while (i < first.values.Size() / 2 || j < second.values.Size() / 2) {
+				bool fromFirst = j == second.values.Size() / 2
+					|| (i < first.values.Size() / 2 && first.values.Data()[2 * i] <= second.values.Data()[2 * j]);
+				if (fromFirst) {
+					AppendRun(result, first.values.Data()[2 * i], RunLast(first, i));
+					++i;
+				}
+				else {
+					AppendRun(result, second.values.Data()[2 * j], RunLast(second, j));
+					++j;
+				}
+			}
+			CountRunCardinality(result);
+		}
+		else {
+			result = CombineBitmaps(first, second, [](uint64_t a, uint64_t b) { return a | b; });
+		}
+		Normalize(result);
+		return result;
+	}
+
+	static Container AndNotContainers(const Container& first, const Container& second)
+	{
+		Container result;
+		if (first.type == ContainerType::Array && second.type == ContainerType::Array) {
+			result = CombineArrays(first, second, first.values.Size(), DifferenceArrays);
+		}
+		else if (first.type == ContainerType::Array) {
+			result = FilterArray(first, second, true);
+		}
+		else if (first.type == ContainerType::Run && second.type == ContainerType::Run) {
+			result = RunContainer();
+			size_t j = 0;
+			for (size_t i = 0; i < first.values.Size() / 2; ++i) {
+				uint32_t next = first.values.Data()[2 * i];
+				uint32_t last = RunLast(first, i);
+				while (j < second.values.Size() / 2 && RunLast(second, j) < next)
+					++j;
+				for (size_t k = j; k < second.values.Size() / 2 && second.values.Data()[2 * k] <= last && next <= last; ++k) {
+					if (second.values.Data()[2 * k] > next)
+						AppendRun(result, next, second.values.Data()[2 * k] - 1u);
+					next = RunLast(second, k) + 1;
+				}
+				if (next <= last)
+					AppendRun(result, next, last);
+			}
+			CountRunCardinality(result);
+		}
+		else {
+			result = CombineBitmaps(first, second, [](uint64_t a, uint64_t b) { return a & ~b; });
+		}
+		Normalize(result);
+		return result;
+	}
+
+	static uint64_t AndCardinality(const Container& first, const Container& second)
+	{
+		if (first.type == ContainerType::Array && second.type == ContainerType::Array) {
+			uint16_t buffer[ArrayMaxSize + 8];
+			return IntersectArrays(first.values.Data(), first.values.Size(), second.values.Data(), second.values.Size(), buffer);
+		}
+		if (first.type == ContainerType::Array || second.type == ContainerType::Array) {
+			const Container& array = first.type == ContainerType::Array ? first : second;
+			const Container& other = first.type == ContainerType::Array ? second : first;
+			uint64_t cardinality = 0;
+			for (uint16_t value : array.values.Span())
+				cardinality += ContainerContains(other, value);
+			return cardinality;
+		}
+		return AndContainers(first, second).cardinality;
+	}
+
+	static bool ContainersEqual(const Container& first, const Container& second)
+	{
+		if (first.cardinality != second.cardinality)
+			return false;
+		if (first.type == second.type)
+			return first.values == second.values && first.words == second.words;
+		Container firstArray = first;
+		Container secondArray = second;
+		ToArray(firstArray);
+		ToArray(secondArray);
+		return firstArray.values == secondArray.values;
+	}
+
+private:
+	Vector<uint16_t> m_keys;
+	Vector<Container> m_containers;
+};
+
+// Read-only RoaringBitmap served straight from bytes in the portable format, such as a file mapped into memory.
+// Opening one reads only the header, which holds the key and cardinality of every container; Contains then reads
+// one container in place, so the pages of a mapped file are loaded as queries touch them. And decodes only the
+// containers whose keys the other bitmap has, which suits intersecting a short query with a large mapped index.
+class RoaringView
+{
+	using Container = RoaringBitmap::Container;
+	using ContainerType = RoaringBitmap::ContainerType;
+
+public:
+	//Constructors
+	// Views bytes, which must outlive the view. Throws std::runtime_error if they are not a serialized bitmap.
+	explicit RoaringView(std::span<const unsigned char> bytes)
+	{
+		Parse(bytes);
+	}
+
+	// Maps the file at path. Throws std::runtime_error if it is missing or not a serialized bitmap.
+	explicit RoaringView(const std::string& path) : m_file(std::in_place, path)
+	{
+		Parse(std::span<const unsigned char>(m_file->Data(), m_file->Size()));
+	}
+
+	RoaringView(RoaringView&&) noexcept = default;
+	RoaringView& operator=(RoaringView&&) noexcept = default;
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return m_count == 0;
+	}
+
+	uint64_t Cardinality() const noexcept
+	{
+		return m_cardinality;
+	}
+
+	//Lookup
+	bool Contains(uint32_t value) const noexcept
+	{
+		size_t low = 0;
+		size_t high = m_count;
+		uint16_t key = static_cast<uint16_t>(value >> 16);
+		while (low < high) {
+			size_t middle = low + (high - low) / 2;
+			if (Key(middle) < key)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+		if (low == m_count || Key(low) != key)
+			return false;
+
+		const unsigned char* data = m_bytes.data() + m_offsets.Data()[low];
+		uint16_t target = static_cast<uint16_t>(value);
+		switch (Type(low)) {
+		case ContainerType::Array: {
+			size_t first = 0;
+			size_t last = Cardinality(low);
+			while (first < last) {
+				size_t middle = first + (last - first) / 2;
+				if (Load<uint16_t>(data + 2 * middle) < target)
+					first = middle + 1;
+				else
+					last = middle;
+			}
+			return first < Cardinality(low) && Load<uint16_t>(data + 2 * first) == target;
+		}
+		case ContainerType::Bitmap:
+			return (Load<uint64_t>(data + 8 * (target / 64)) >> (target % 64)) & 1;
+		default: {
+			// The number of runs starting at or before the value, then whether the last of them reaches it.
+			size_t first = 0;
+			size_t last = Load<uint16_t>(data);
+			while (first < last) {
+				size_t middle = first + (last - first) / 2;
+				if (Load<uint16_t>(data + 2 + 4 * middle) <= target)
+					first = middle + 1;
+				else
+					last = middle;
+			}
+			return first > 0 && target <= Load<uint16_t>(data + 4 * first - 2) + static_cast<uint32_t>(Load<uint16_t>(data + 4 * first));
+		}
+		}
+	}
+
+	//Operations
+	// Decodes every container into a RoaringBitmap, checking that each is well formed.
+	RoaringBitmap ToBitmap() const
+	{
+		RoaringBitmap bitmap;
+		for (size_t i = 0; i < m_count; ++i) {
+			bitmap.m_keys.PushBack(Key(i));
+			bitmap.m_containers.PushBack(ReadContainer(i));
+		}
+		return bitmap;
+	}
+
+	// The intersection with other, decoding only the containers whose keys other has.
+	RoaringBitmap And(const RoaringBitmap& other) const
+	{
+		RoaringBitmap result;
+		size_t i = 0;
+		size_t j = 0;
+		while (i < m_count && j < other.m_keys.Size()) {
+			uint16_t key = Key(i);
+			if (key < other.m_keys.Data()[j]) {
+				++i;
+			}
+			else if (other.m_keys.Data()[j] < key) {
+				++j;
+			}
+			else {
+				Container container = RoaringBitmap::AndContainers(ReadContainer(i), other.m_containers.Data()[j]);
+				if (container.cardinality > 0) {
+					result.m_keys.PushBack(key);
+					result.m_containers.PushBack(std::move(container));
+				}
+				++i;
+				++j;
+			}
+		}
+		return result;
+	}
+
+	template<typename Function>
+	void ForEach(Function function) const
+	{
+		for (size_t i = 0; i < m_count; ++i) {
+			uint32_t high = static_cast<uint32_t>(Key(i)) << 16;
+			RoaringBitmap::ForEachLow(ReadContainer(i), [&](uint32_t low) { function(high | low); });
+		}
+	}
+
+private:
+	template<typename U>
+	static U Load(const unsigned char* bytes) noexcept
+	{
+		return RoaringBitmap::LoadLittle<U>(bytes);
+	}
+
+	[[noreturn]] static void Corrupt()
+	{
+		throw std::runtime_error("RoaringView: the bytes are truncated or not a serialized RoaringBitmap");
+	}
+
+	uint16_t Key(size_t index) const noexcept
+	{
+		return Load<uint16_t>(m_header + 4 * index);
+	}
+
+	uint32_t Cardinality(size_t index) const noexcept
+	{
+		return static_cast<uint32_t>(Load<uint16_t>(m_header + 4 * index + 2)) + 1;
+	}
+
+	ContainerType Type(size_t index) const noexcept
+	{
+		if (m_runFlags != nullptr && (m_runFlags[index / 8] >> (index % 8)) & 1)
+			return ContainerType::Run;
+		return Cardinality(index) > RoaringBitmap::ArrayMaxSize ? ContainerType::Bitmap : ContainerType::Array;
+	}
+
+	// Reads the header and checks that the keys increase and every container lies within the bytes.
+	void Parse(std::span<const unsigned char> bytes)
+	{
+		m_bytes = bytes;
+		if (bytes.size() < 4)
+			Corrupt();
+		uint32_t cookie = Load<uint32_t>(bytes.data());
+		size_t position;
+		if ((cookie & 0xFFFF) == RoaringBitmap::SerialCookie) {
+			m_count = (cookie >> 16) + 1;
+			m_runFlags = bytes.data() + 4;
+			position = 4 + (m_count + 7) / 8;
+		}
+		else if (cookie == RoaringBitmap::SerialCookieNoRuns && bytes.size() >= 8) {
+			m_count = Load<uint32_t>(bytes.data() + 4);
+			position = 8;
+		}
+		else {
+			Corrupt();
+		}
+		if (m_count > 65536 || RoaringBitmap::HeaderBytes(m_count, m_runFlags != nullptr) > bytes.size())
+			Corrupt();
+		m_header = bytes.data() + position;
+
+		bool hasOffsets = RoaringBitmap::HasOffsets(m_count, m_runFlags != nullptr);
+		size_t offset = RoaringBitmap::HeaderBytes(m_count, m_runFlags != nullptr);
+		m_offsets.Reserve(m_count);
+		m_cardinality = 0;
+		for (size_t i = 0; i < m_count; ++i) {
+			if (i > 0 && Key(i) <= Key(i - 1))
+				Corrupt();
+			if (hasOffsets)
+				offset = Load<uint32_t>(m_header + 4 * m_count + 4 * i);
+			size_t size;
+			switch (Type(i)) {
+			case ContainerType::Array:
+				size = 2 * Cardinality(i);
+				break;
+			case ContainerType::Bitmap:
+				size = 8 * RoaringBitmap::BitmapWords;
+				break;
+			default:
+				if (offset + 2 > bytes.size())
+					Corrupt();
+				size = RoaringBitmap::RunBytes(Load<uint16_t>(bytes.data() + offset));
+				break;
+			}
+			if (offset > bytes.size() || size > bytes.size() - offset)
+				Corrupt();
+			m_offsets.PushBack(static_cast<uint32_t>(offset));
+			m_cardinality += Cardinality(i);
+			offset += size;
+		}
+	}
+
+	// Decodes container index, checking that its values are sorted, its runs disjoint and its cardinality right.
+	Container ReadContainer(size_t index) const
+	{
+		Container container;
+		container.type = Type(index);
+		container.cardinality = Cardinality(index);
+		const unsigned char* data = m_bytes.data() + m_offsets.Data()[index];
+		switch (container.type) {
+		case ContainerType::Array:
+			container.values.Resize(container.cardinality);
+			for (size_t k = 0; k < container.cardinality; ++k) {
+				container.values.Data()[k] = Load<uint16_t>(data + 2 * k);
+				if (k > 0 && container.values.Data()[k] <= container.values.Data()[k - 1])
+					Corrupt();
+			}
+			break;
+		case ContainerType::Bitmap:
+			container.words.Resize(RoaringBitmap::BitmapWords);
+			for (size_t k = 0; k < RoaringBitmap::BitmapWords; ++k)
+				container.words.Data()[k] = Load<uint64_t>(data + 8 * k);
+			if (PopCount(container.words.Span()) != container.cardinality)
+				Corrupt();
+			break;
+		case ContainerType::Run: {
+			size_t runs = Load<uint16_t>(data);
+			container.values.Resize(2 * runs);
+			uint64_t cardinality = 0;
+			for (size_t k = 0; k < 2 * runs; ++k)
+				container.values.Data()[k] = Load<uint16_t>(data + 2 + 2 * k);
+			for (size_t run = 0; run < runs; ++run) {
+				uint32_t start = container.values.Data()[2 * run];
+				if (start + static_cast<uint32_t>(container.values.Data()[2 * run + 1]) > 0xFFFF
+					|| (run > 0 && start <= RoaringBitmap::RunLast(container, run - 1) + 1))
+					Corrupt();
+				cardinality += static_cast<uint64_t>(container.values.Data()[2 * run + 1]) + 1;
+			}
+			if (runs == 0 || cardinality != container.cardinality)
+				Corrupt();
+			break;
+		}
+		}
+		return container;
+	}
+
+private:
+	std::optional<MappedFile> m_file;
+	std::span<const unsigned char> m_bytes;
+	size_t m_count = 0;
+	// One bit per container telling whether it holds runs, or null if none does.
+	const unsigned char* m_runFlags = nullptr;
+	// The key and cardinality - 1 of every container.
+	const unsigned char* m_header = nullptr;
+	Vector<uint32_t> m_offsets;
+	uint64_t m_cardinality = 0;
+};
+
+inline RoaringBitmap RoaringBitmap::Deserialize(std::span<const unsigned char> bytes)
+{
+	return RoaringView(bytes).ToBitmap();
+}
+
+#endif //_ROARINGBITMAP_
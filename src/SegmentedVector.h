@@ -0,0 +1,392 @@
+#ifndef _SEGMENTEDVECTOR_
+#define _SEGMENTEDVECTOR_
+
+#include<algorithm>
+#include<bit>
+#include<cstddef>
+#include<initializer_list>
+#include<iterator>
+#include<memory>
+#include<span>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include"Vector.h"
+
+template<typename SegmentedVector>
+class SegIterator
+{
+public:
+	using ValueType = std::conditional_t<std::is_const_v<SegmentedVector>,
+		const typename SegmentedVector::ValueType, typename SegmentedVector::ValueType>;
+	using PointerType = ValueType*;
+	using ReferenceType = ValueType&;
+
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = std::remove_const_t<ValueType>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = PointerType;
+	using reference = ReferenceType;
+public:
+	SegIterator() noexcept : m_chunks(nullptr), m_index(0) {}
+	SegIterator(PointerType const* chunks, size_t index) noexcept : m_chunks(chunks), m_index(index) {}
+
+	PointerType operator->() const noexcept { return &**this; }
+	ReferenceType operator*() const noexcept { return SegmentedVector::Element(m_chunks, m_index); }
+	ReferenceType operator[](difference_type offset) const noexcept { return *(*this + offset); }
+
+	bool operator==(const SegIterator& other) const noexcept { return m_index == other.m_index; }
+	bool operator!=(const SegIterator& other) const noexcept { return m_index != other.m_index; }
+	bool operator<(const SegIterator& other) const noexcept { return m_index < other.m_index; }
+
+	SegIterator& operator++() noexcept { ++m_index; return *this; }
+	SegIterator operator++(int) noexcept {
+		SegIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+	SegIterator& operator--() noexcept { --m_index; return *this; }
+	SegIterator operator--(int) noexcept {
+		SegIterator iterator = *this;
+		--(*this);
+		return iterator;
+	}
+
+	SegIterator& operator+=(difference_type offset) noexcept { m_index += offset; return *this; }
+	SegIterator& operator-=(difference_type offset) noexcept { m_index -= offset; return *this; }
+	SegIterator operator+(difference_type offset) const noexcept { return SegIterator(m_chunks, m_index + offset); }
+	SegIterator operator-(difference_type offset) const noexcept { return SegIterator(m_chunks, m_index - offset); }
+	difference_type operator-(const SegIterator& other) const noexcept
+	{
+		return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+	}
+
+private:
+	PointerType const* m_chunks;
+	size_t m_index;
+};
+
+// Elements per chunk of a SegmentedVector by default: the largest power of two that fits in 16 KiB.
+template<typename T>
+inline constexpr size_t SegmentedChunkSize = std::bit_floor(std::max<size_t>(16384 / sizeof(T), 1));
+
+// Vector made of fixed-size chunks reached through a directory of chunk pointers. Growing adds a chunk and never
+// moves an element, so pointers and references to elements stay valid until the element is removed, and no
+// PushBack costs more than one chunk allocation. Indexing is a shift, a mask and one extra load. Only the
+// directory of pointers is reallocated as it grows, which invalidates iterators but not references.
+template<typename T, size_t ChunkSize = SegmentedChunkSize<T>, typename Allocator = std::allocator<T>>
+class SegmentedVector
+{
+	static_assert(std::has_single_bit(ChunkSize), "the chunk size of a SegmentedVector must be a power of two");
+
+	using AllocatorTraits = std::allocator_traits<Allocator>;
+	using DirectoryAllocator = typename AllocatorTraits::template rebind_alloc<T*>;
+	using Directory = Vector<T*, GeometricGrowth<>, DirectoryAllocator>;
+	static_assert(std::is_same_v<typename AllocatorTraits::pointer, T*>, "SegmentedVector needs an allocator of raw pointers");
+
+	template<typename> friend class SegIterator;
+
+public:
+	using ValueType = T;
+	using AllocatorType = Allocator;
+	using Iterator = SegIterator<SegmentedVector>;
+	using ConstIterator = SegIterator<const SegmentedVector>;
+	using ReverseIterator = std::reverse_iterator<Iterator>;
+
+	static constexpr size_t ChunkElements = ChunkSize;
+public:
+	//Constructors
+	SegmentedVector() : SegmentedVector(Allocator()) {}
+
+	explicit SegmentedVector(const Allocator& allocator)
+		: m_allocator(allocator), m_chunks(DirectoryAllocator(allocator)), m_size(0) {}
+
+	SegmentedVector(size_t size, const T& value, const Allocator& allocator = Allocator())
+		: SegmentedVector(allocator)
+	{
+		Resize(size, value);
+	}
+
+	SegmentedVector(std::initializer_list<T> list, const Allocator& allocator = Allocator())
+		: SegmentedVector(allocator)
+	{
+		Append(list.begin(), list.end());
+	}
+
+	~SegmentedVector()
+	{
+		Clear();
+		FreeChunks(0);
+	}
+
+	//Copy Constructor
+	SegmentedVector(const SegmentedVector& other)
+		: SegmentedVector(other, AllocatorTraits::select_on_container_copy_construction(other.m_allocator)) {}
+
+	SegmentedVector(const SegmentedVector& other, const Allocator& allocator)
+		: SegmentedVector(allocator)
+	{
+		Append(other.begin(), other.end());
+	}
+
+	//Move Constructor
+	SegmentedVector(SegmentedVector&& other) noexcept
+		: m_allocator(other.m_allocator), m_chunks(std::move(other.m_chunks)), m_size(std::exchange(other.m_size, 0)) {}
+
+	//Operators
+	const T& operator[](size_t index) const
+	{
+		if (index >= m_size)
+			throw std::out_of_range("index out of range");
+		return Element(m_chunks.Data(), index);
+	}
+
+	T& operator[](size_t index)
+	{
+		return const_cast<T&>(std::as_const(*this)[index]);
+	}
+
+	SegmentedVector& operator=(const SegmentedVector& other)
+	{
+		if (this == &other)
+			return *this;
+
+		constexpr bool propagate = AllocatorTraits::propagate_on_container_copy_assignment::value;
+		SegmentedVector copy(other, propagate ? other.m_allocator : m_allocator);
+		SwapStorage(copy);
+		if constexpr (propagate)
+			std::swap(m_allocator, copy.m_allocator);
+		return *this;
+	}
+
+	SegmentedVector& operator=(SegmentedVector&& other) noexcept(AllocatorTraits::propagate_on_container_move_assignment::value
+		|| AllocatorTraits::is_always_equal::value)
+	{
+		constexpr bool propagate = AllocatorTraits::propagate_on_container_move_assignment::value;
+		if constexpr (!propagate && !AllocatorTraits::is_always_equal::value) {
+			// Chunks of another allocator cannot be adopted, so the elements move one by one.
+			if (m_allocator != other.m_allocator) {
+				SegmentedVector moved(m_allocator);
+				moved.Append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+				SwapStorage(moved);
+				return *this;
+			}
+		}
+
+		SegmentedVector moved(std::move(other));
+		SwapStorage(moved);
+		if constexpr (propagate)
+			std::swap(m_allocator, moved.m_allocator);
+		return *this;
+	}
+
+	bool operator==(const SegmentedVector& other) const
+	{
+		return m_size == other.m_size && std::equal(begin(), end(), other.begin());
+	}
+
+	bool operator!=(const SegmentedVector& other) const
+	{
+		return !(*this == other);
+	}
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	size_t Size() const noexcept
+	{
+		return m_size;
+	}
+
+	size_t Capacity() const noexcept
+	{
+		return m_chunks.Size() * ChunkSize;
+	}
+
+	// Allocates chunks until capacity elements fit.
+	void Reserve(size_t capacity)
+	{
+		while (Capacity() < capacity)
+			AddChunk();
+	}
+
+	// Frees the chunks that hold no element.
+	void ShrinkToFit()
+	{
+		FreeChunks((m_size + ChunkSize - 1) / ChunkSize);
+		m_chunks.ShrinkToFit();
+	}
+
+	//Element access
+	size_t ChunkCount() const noexcept
+	{
+		return m_chunks.Size();
+	}
+
+	// The elements stored in one chunk, for loops that want contiguous memory.
+	std::span<T> Chunk(size_t chunk) noexcept
+	{
+		return std::span<T>(m_chunks[chunk], ChunkLength(chunk));
+	}
+
+	std::span<const T> Chunk(size_t chunk) const noexcept
+	{
+		return std::span<const T>(m_chunks[chunk], ChunkLength(chunk));
+	}
+
+	Allocator GetAllocator() const noexcept
+	{
+		return m_allocator;
+	}
+
+	//Modifiers
+	void PushBack(const T& value)
+	{
+		EmplaceBack(value);
+	}
+
+	void PushBack(T&& value)
+	{
+		EmplaceBack(std::move(value));
+	}
+
+	// Existing elements never move, so the arguments may refer to elements of this vector.
+	template<typename... Args>
+	T& EmplaceBack(Args&&... args)
+	{
+		if (m_size == Capacity())
+			AddChunk();
+
+		T* element = &Element(m_chunks.Data(), m_size);
+		AllocatorTraits::construct(m_allocator, element, std::forward<Args>(args)...);
+		++m_size;
+		return *element;
+	}
+
+	void PopBack()
+	{
+		if (m_size > 0) {
+			--m_size;
+			AllocatorTraits::destroy(m_allocator, &Element(m_chunks.Data(), m_size));
+		}
+	}
+
+	template<typename InputIterator>
+	void Append(InputIterator first, InputIterator last)
+	{
+		using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>)
+			Reserve(m_size + static_cast<size_t>(std::distance(first, last)));
+		for (; first != last; ++first)
+			EmplaceBack(*first);
+	}
+
+	// Value-initializes new elements when growing, so new arithmetic elements are zero.
+	void Resize(size_t size)
+	{
+		ResizeWith(size, [this](T* element) { AllocatorTraits::construct(m_allocator, element); });
+	}
+
+	void Resize(size_t size, const T& value)
+	{
+		ResizeWith(size, [this, &value](T* element) { AllocatorTraits::construct(m_allocator, element, value); });
+	}
+
+	//Operations
+	// Destroys the elements but keeps the chunks.
+	void Clear() noexcept
+	{
+		DestroyFrom(0);
+	}
+
+	// Swaps the allocators only if the allocator propagates on swap; otherwise both must compare equal.
+	void Swap(SegmentedVector& other) noexcept
+	{
+		SwapStorage(other);
+		if constexpr (AllocatorTraits::propagate_on_container_swap::value)
+			std::swap(m_allocator, other.m_allocator);
+	}
+
+	//Iterators
+	Iterator begin() { return Iterator(m_chunks.Data(), 0); };
+	Iterator end() { return Iterator(m_chunks.Data(), m_size); };
+	ConstIterator begin() const { return ConstIterator(m_chunks.Data(), 0); };
+	ConstIterator end() const { return ConstIterator(m_chunks.Data(), m_size); };
+	ReverseIterator rbegin() { return ReverseIterator(end()); };
+	ReverseIterator rend() { return ReverseIterator(begin()); };
+
+private:
+	static constexpr size_t ChunkShift = std::countr_zero(ChunkSize);
+
+	template<typename Pointer>
+	static auto& Element(Pointer const* chunks, size_t index) noexcept
+	{
+		return chunks[index >> ChunkShift][index & (ChunkSize - 1)];
+	}
+
+	size_t ChunkLength(size_t chunk) const noexcept
+	{
+		size_t first = chunk * ChunkSize;
+		return m_size > first ? std::min(m_size - first, ChunkSize) : 0;
+	}
+
+	void AddChunk()
+	{
+		T* chunk = AllocatorTraits::allocate(m_allocator, ChunkSize);
+		try {
+			m_chunks.PushBack(chunk);
+		}
+		catch (...) {
+			AllocatorTraits::deallocate(m_allocator, chunk, ChunkSize);
+			throw;
+		}
+	}
+
+	// Frees the chunks from index keep on, which must hold no elements.
+	void FreeChunks(size_t keep) noexcept
+	{
+		while (m_chunks.Size() > keep) {
+			AllocatorTraits::deallocate(m_allocator, m_chunks[m_chunks.Size() - 1], ChunkSize);
+			m_chunks.PopBack();
+		}
+	}
+
+	void DestroyFrom(size_t size) noexcept
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			for (size_t i = size; i < m_size; ++i)
+				AllocatorTraits::destroy(m_allocator, &Element(m_chunks.Data(), i));
+		}
+		m_size = std::min(m_size, size);
+	}
+
+	template<typename Construct>
+	void ResizeWith(size_t size, Construct construct)
+	{
+		if (size <= m_size) {
+			DestroyFrom(size);
+			return;
+		}
+
+		Reserve(size);
+		for (; m_size < size; ++m_size)
+			construct(&Element(m_chunks.Data(), m_size));
+	}
+
+	void SwapStorage(SegmentedVector& other) noexcept
+	{
+		m_chunks.Swap(other.m_chunks);
+		std::swap(m_size, other.m_size);
+	}
+
+private:
+	[[no_unique_address]] Allocator m_allocator;
+	Directory m_chunks;
+	size_t m_size;
+};
+
+#endif //_SEGMENTEDVECTOR_
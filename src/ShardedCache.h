@@ -0,0 +1,173 @@
+#ifndef _SHARDEDCACHE_
+#define _SHARDEDCACHE_
+
+#include<algorithm>
+#include<bit>
+#include<memory>
+#include<mutex>
+#include<optional>
+#include<thread>
+
+#include"Cache.h"
+
+// Concurrent Cache that splits the keys over a power-of-two number of independently locked Cache shards, each
+// with an equal share of the capacity. A Get reorders its shard, so every access takes the shard's mutex
+// exclusively; spreading the keys keeps threads mostly on different mutexes. Values are returned by copy because
+// a pointer would outlive the lock.
+template<typename Key, typename Value, CachePolicy Policy = CachePolicy::Lru, typename Weigher = CacheWeigher,
+	typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ShardedCache
+{
+private:
+	using Shard = Cache<Key, Value, Policy, Weigher, Hash, KeyEqual>;
+
+	static constexpr size_t CacheLineSize = 64;
+
+	// Shards are cache-line aligned so that taking one lock never invalidates the line of a neighbouring one. A
+	// Cache can be neither default-constructed nor moved, so each is built in place once the array exists.
+	struct alignas(CacheLineSize) LockedShard
+	{
+		mutable std::mutex mutex;
+		std::optional<Shard> cache;
+	};
+
+public:
+	using ValueType = Value;
+	using KeyType = Key;
+public:
+	//Constructors
+	// shards is rounded up to a power of two.
+	explicit ShardedCache(size_t capacityBytes, size_t shards = DefaultShardCount(), const Weigher& weigher = Weigher(),
+		const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+		: m_shards(new LockedShard[std::bit_ceil(shards > 0 ? shards : 1)]), m_shardCount(std::bit_ceil(shards > 0 ? shards : 1)),
+		m_hash(hash)
+	{
+		for (size_t i = 0; i < m_shardCount; ++i)
+			m_shards[i].cache.emplace(capacityBytes / m_shardCount, weigher, hash, equal);
+	}
+
+	ShardedCache(const ShardedCache&) = delete;
+	ShardedCache& operator=(const ShardedCache&) = delete;
+
+	//Lookup
+	// Copies the cached value into value and marks it as recently used; returns false on a miss.
+	bool Get(const Key& key, Value& value)
+	{
+		LockedShard& shard = ShardFor(key);
+		std::lock_guard lock(shard.mutex);
+		const Value* found = shard.cache->Get(key);
+		if (found == nullptr)
+			return false;
+
+		value = *found;
+		return true;
+	}
+
+	bool Contains(const Key& key) const
+	{
+		const LockedShard& shard = ShardFor(key);
+		std::lock_guard lock(shard.mutex);
+		return shard.cache->Contains(key);
+	}
+
+	//Capacity
+	size_t ShardCount() const noexcept
+	{
+		return m_shardCount;
+	}
+
+	// Totals over all shards; exact only while no other thread is modifying the cache.
+	size_t Count() const
+	{
+		return Sum([](const Shard& cache) { return cache.Count(); });
+	}
+
+	bool IsEmpty() const
+	{
+		return Count() == 0;
+	}
+
+	size_t Bytes() const
+	{
+		return Sum([](const Shard& cache) { return cache.Bytes(); });
+	}
+
+	size_t Capacity() const
+	{
+		return Sum([](const Shard& cache) { return cache.Capacity(); });
+	}
+
+	CacheStats Stats() const
+	{
+		CacheStats stats;
+		for (size_t i = 0; i < m_shardCount; ++i) {
+			std::lock_guard lock(m_shards[i].mutex);
+			stats += m_shards[i].cache->Stats();
+		}
+		return stats;
+	}
+
+	//Modifiers
+	void Put(const Key& key, const Value& value)
+	{
+		LockedShard& shard = ShardFor(key);
+		std::lock_guard lock(shard.mutex);
+		shard.cache->Put(key, value);
+	}
+
+	bool Erase(const Key& key)
+	{
+		LockedShard& shard = ShardFor(key);
+		std::lock_guard lock(shard.mutex);
+		return shard.cache->Erase(key);
+	}
+
+	void Clear()
+	{
+		for (size_t i = 0; i < m_shardCount; ++i) {
+			std::lock_guard lock(m_shards[i].mutex);
+			m_shards[i].cache->Clear();
+		}
+	}
+
+private:
+	static size_t DefaultShardCount()
+	{
+		return std::max<size_t>(16, 4 * std::thread::hardware_concurrency());
+	}
+
+	// Same split as ShardedHashTable: the shard comes from the remixed hash, so keys of one shard still spread
+	// over all buckets of its index.
+	size_t ShardIndex(const Key& key) const
+	{
+		return static_cast<size_t>(HashMix64(static_cast<uint64_t>(m_hash(key)))) & (m_shardCount - 1);
+	}
+
+	LockedShard& ShardFor(const Key& key)
+	{
+		return m_shards[ShardIndex(key)];
+	}
+
+	const LockedShard& ShardFor(const Key& key) const
+	{
+		return m_shards[ShardIndex(key)];
+	}
+
+	template<typename Function>
+	size_t Sum(Function function) const
+	{
+		size_t sum = 0;
+		for (size_t i = 0; i < m_shardCount; ++i) {
+			std::lock_guard lock(m_shards[i].mutex);
+			sum += function(*m_shards[i].cache);
+		}
+		return sum;
+	}
+
+private:
+	std::unique_ptr<LockedShard[]> m_shards;
+	size_t m_shardCount;
+	Hash m_hash;
+};
+
+#endif //_SHARDEDCACHE_
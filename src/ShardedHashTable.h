@@ -0,0 +1,197 @@
+#ifndef _SHARDEDHASHTABLE_
+#define _SHARDEDHASHTABLE_
+
+#include<algorithm>
+#include<atomic>
+#include<bit>
+#include<memory>
+#include<mutex>
+#include<shared_mutex>
+#include<thread>
+
+#include"HashTable.h"
+
+// Concurrent hash table that splits the key space over a power-of-two number of independent HashTable shards.
+// Every shard has its own reader-writer lock and grows incrementally on its own, so writers only contend when
+// they hit the same shard and a resize never stalls the rest of the table. Values are returned by copy because
+// a reference would outlive the shard lock.
+template<typename Key, typename Value, typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ShardedHashTable
+{
+private:
+	using Table = HashTable<Key, Value, Hash, KeyEqual, PowerOfTwoBuckets>;
+
+	static constexpr size_t CacheLineSize = 64;
+
+	// Shards are cache-line aligned so that taking one lock never invalidates the line of a neighbouring one.
+	struct alignas(CacheLineSize) Shard
+	{
+		mutable std::shared_mutex mutex;
+		Table table;
+	};
+
+public:
+	using ValueType = Value;
+	using KeyType = Key;
+public:
+	//Constructors
+	// shards is rounded up to a power of two; the default gives every hardware thread several shards.
+	explicit ShardedHashTable(size_t shards = DefaultShardCount(), const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+		: m_shards(new Shard[std::bit_ceil(shards > 0 ? shards : 1)]), m_shardCount(std::bit_ceil(shards > 0 ? shards : 1)),
+		m_hash(hash)
+	{
+		for (size_t i = 0; i < m_shardCount; ++i)
+			m_shards[i].table = Table(16, 1.0f, hash, equal);
+	}
+
+	ShardedHashTable(const ShardedHashTable&) = delete;
+	ShardedHashTable& operator=(const ShardedHashTable&) = delete;
+
+	//Lookup
+	// Copies the value of the key into value and returns true if the key is present.
+	bool Find(const Key& key, Value& value) const
+	{
+		const Shard& shard = ShardFor(key);
+		std::shared_lock lock(shard.mutex);
+		const Value* found = shard.table.Find(key);
+		if (found == nullptr)
+			return false;
+
+		value = *found;
+		return true;
+	}
+
+	bool Contains(const Key& key) const
+	{
+		const Shard& shard = ShardFor(key);
+		std::shared_lock lock(shard.mutex);
+		return shard.table.Contains(key);
+	}
+
+	//Capacity
+	size_t ShardCount() const noexcept
+	{
+		return m_shardCount;
+	}
+
+	// Number of stored elements; exact only while no other thread is modifying the table.
+	size_t Count() const
+	{
+		size_t count = 0;
+		for (size_t i = 0; i < m_shardCount; ++i) {
+			std::shared_lock lock(m_shards[i].mutex);
+			count += m_shards[i].table.Count();
+		}
+		return count;
+	}
+
+	bool IsEmpty() const
+	{
+		return Count() == 0;
+	}
+
+	// Spreads room for count elements evenly over the shards.
+	void Reserve(size_t count)
+	{
+		for (size_t i = 0; i < m_shardCount; ++i) {
+			std::unique_lock lock(m_shards[i].mutex);
+			m_shards[i].table.Reserve(count / m_shardCount + 1);
+		}
+	}
+
+	//Modifiers
+	void Insert(const Key& key, const Value& value)
+	{
+		Shard& shard = ShardFor(key);
+		std::unique_lock lock(shard.mutex);
+		shard.table.Insert(key, value);
+	}
+
+	// Calls function(Value&) on the value of the key, inserting a default value first if it is missing,
+	// while the shard is locked. Use it for read-modify-write updates such as counters.
+	template<typename Function>
+	void Update(const Key& key, Function function)
+	{
+		Shard& shard = ShardFor(key);
+		std::unique_lock lock(shard.mutex);
+		function(shard.table[key]);
+	}
+
+	bool Erase(const Key& key)
+	{
+		Shard& shard = ShardFor(key);
+		std::unique_lock lock(shard.mutex);
+		return shard.table.Erase(key);
+	}
+
+	// Clears the shards in parallel on up to threads threads.
+	void Clear(size_t threads = std::thread::hardware_concurrency())
+	{
+		ForEachShard(threads, [](Shard& shard) {
+			std::unique_lock lock(shard.mutex);
+			shard.table.Clear();
+		});
+	}
+
+	//Traversal
+	// Calls function(const Key&, Value&) for every element. Shards are visited in parallel on up to threads
+	// threads, so function must be safe to call concurrently. Each shard is write-locked while visited because
+	// starting an iteration completes the shard's pending rehash.
+	template<typename Function>
+	void ForEach(Function function, size_t threads = std::thread::hardware_concurrency())
+	{
+		ForEachShard(threads, [&function](Shard& shard) {
+			std::unique_lock lock(shard.mutex);
+			for (auto it = shard.table.begin(); it != shard.table.end(); ++it)
+				function(it.Key(), *it);
+		});
+	}
+
+private:
+	static size_t DefaultShardCount()
+	{
+		return std::max<size_t>(16, 4 * std::thread::hardware_concurrency());
+	}
+
+	// The shard comes from the low bits of the remixed hash while the shard's own table indexes by the top bits
+	// of the original hash, so keys of one shard still spread over all of its buckets.
+	size_t ShardIndex(const Key& key) const
+	{
+		return static_cast<size_t>(HashMix64(static_cast<uint64_t>(m_hash(key)))) & (m_shardCount - 1);
+	}
+
+	Shard& ShardFor(const Key& key)
+	{
+		return m_shards[ShardIndex(key)];
+	}
+
+	const Shard& ShardFor(const Key& key) const
+	{
+		return m_shards[ShardIndex(key)];
+	}
+
+	template<typename Function>
+	void ForEachShard(size_t threads, Function function)
+	{
+		threads = std::clamp<size_t>(threads, 1, m_shardCount);
+		std::atomic<size_t> next{ 0 };
+		auto worker = [&]() {
+			for (size_t i = next.fetch_add(1); i < m_shardCount; i = next.fetch_add(1))
+				function(m_shards[i]);
+		};
+
+		std::unique_ptr<std::thread[]> workers(new std::thread[threads - 1]);
+		for (size_t i = 0; i < threads - 1; ++i)
+			workers[i] = std::thread(worker);
+		worker();
+		for (size_t i = 0; i < threads - 1; ++i)
+			workers[i].join();
+	}
+
+private:
+	std::unique_ptr<Shard[]> m_shards;
+	size_t m_shardCount;
+	Hash m_hash;
+};
+
+#endif //_SHARDEDHASHTABLE_
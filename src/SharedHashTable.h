@@ -0,0 +1,439 @@
+#ifndef _SHAREDHASHTABLE_
+#define _SHAREDHASHTABLE_
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cstdint>
+#include<functional>
+#include<new>
+#include<stdexcept>
+#include<string>
+#include<thread>
+#include<type_traits>
+#include<utility>
+
+#include<fcntl.h>
+#include<pthread.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+#include"Hash.h"
+
+// Hash table that lives entirely inside a named POSIX shared memory segment, so processes on one machine share
+// a single copy. Every process may map the segment at a different address, so nodes are linked by their byte
+// offset from the start of the segment instead of by pointer. Lookups from any number of processes run
+// concurrently under the read side of a process-shared reader-writer lock and modifications take its write side.
+// The segment is sized for a fixed capacity when it is created: the bucket array and the node pool never move,
+// and erased nodes are recycled through a free list. Keys and values must be trivially copyable, and every
+// process has to use the same Hash, which is constructed from the seed stored in the segment. A process that
+// dies while holding the lock leaves the segment locked.
+template<typename Key, typename Value, typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+	requires std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>
+class SharedHashTable
+{
+private:
+	// Offset of a node from the start of the segment; 0 is the null offset since the header sits there.
+	using NodeOffset = uint64_t;
+
+	struct Node
+	{
+		Key key;
+		Value value;
+		NodeOffset next;
+	};
+
+	struct Header
+	{
+		static constexpr uint64_t Magic = 0x4C42545F4D485348ull; // "HSHM_TBL"
+		static constexpr uint32_t CurrentVersion = 1;
+
+		uint64_t magic;
+		uint32_t version;
+		uint32_t keySize;
+		uint32_t valueSize;
+		uint32_t nodeSize;
+		// Set by the creator once the segment is initialized; attaching processes wait for it.
+		std::atomic<uint32_t> ready;
+		pthread_rwlock_t lock;
+		uint64_t seed;
+		uint64_t segmentSize;
+		uint64_t bucketCount;
+		uint64_t capacity;
+		uint64_t count;
+		// Nodes below this index have been handed out at least once.
+		uint64_t usedNodes;
+		NodeOffset freeList;
+		uint64_t bucketsOffset;
+		uint64_t nodesOffset;
+	};
+
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory needs address-free atomics");
+
+	// How long Attach waits for a segment that is still being initialized.
+	static constexpr auto AttachTimeout = std::chrono::seconds(5);
+
+	class ReadLock
+	{
+	public:
+		explicit ReadLock(pthread_rwlock_t& lock) : m_lock(lock) { pthread_rwlock_rdlock(&m_lock); }
+		~ReadLock() { pthread_rwlock_unlock(&m_lock); }
+		ReadLock(const ReadLock&) = delete;
+		ReadLock& operator=(const ReadLock&) = delete;
+	private:
+		pthread_rwlock_t& m_lock;
+	};
+
+	class WriteLock
+	{
+	public:
+		explicit WriteLock(pthread_rwlock_t& lock) : m_lock(lock) { pthread_rwlock_wrlock(&m_lock); }
+		~WriteLock() { pthread_rwlock_unlock(&m_lock); }
+		WriteLock(const WriteLock&) = delete;
+		WriteLock& operator=(const WriteLock&) = delete;
+	private:
+		pthread_rwlock_t& m_lock;
+	};
+
+public:
+	using ValueType = Value;
+	using KeyType = Key;
+public:
+	//Constructors
+	// Creates the segment name (a single path component starting with '/') with room for capacity elements and
+	// maps it. Throws std::runtime_error if a segment of that name already exists or cannot be created.
+	static SharedHashTable Create(const std::string& name, size_t capacity, uint64_t seed = 0, const KeyEqual& equal = KeyEqual())
+	{
+		const uint64_t buckets = PowerOfTwoBuckets::BucketCount(capacity);
+		const uint64_t bucketsOffset = AlignUp(sizeof(Header), alignof(NodeOffset));
+		const uint64_t nodesOffset = AlignUp(bucketsOffset + buckets * sizeof(NodeOffset), alignof(Node));
+		const uint64_t segmentSize = nodesOffset + capacity * sizeof(Node);
+
+		int file = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+		if (file < 0)
+			throw std::runtime_error("SharedHashTable: cannot create " + name);
+		if (ftruncate(file, static_cast<off_t>(segmentSize)) != 0) {
+			close(file);
+			shm_unlink(name.c_str());
+			throw std::runtime_error("SharedHashTable: cannot size " + name);
+		}
+
+		SharedHashTable table = [&] {
+			try {
+				return SharedHashTable(name, file, segmentSize, equal);
+			}
+			catch (...) {
+				shm_unlink(name.c_str());
+				throw;
+			}
+		}();
+		// The new segment reads as zeros, so every bucket starts out empty.
+		Header* header = new (table.m_base) Header{};
+		header->magic = Header::Magic;
+		header->version = Header::CurrentVersion;
+		header->keySize = sizeof(Key);
+		header->valueSize = sizeof(Value);
+		header->nodeSize = sizeof(Node);
+		header->seed = seed;
+		header->segmentSize = segmentSize;
+		header->bucketCount = buckets;
+		header->capacity = capacity;
+		header->bucketsOffset = bucketsOffset;
+		header->nodesOffset = nodesOffset;
+
+		pthread_rwlockattr_t attributes;
+		pthread_rwlockattr_init(&attributes);
+		pthread_rwlockattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+		int result = pthread_rwlock_init(&header->lock, &attributes);
+		pthread_rwlockattr_destroy(&attributes);
+		if (result != 0) {
+			Remove(name);
+			throw std::runtime_error("SharedHashTable: cannot initialize the lock of " + name);
+		}
+
+		table.Bind();
+		header->ready.store(1, std::memory_order_release);
+		return table;
+	}
+
+	// Maps an existing segment created by Create with the same key and value types. Throws std::runtime_error
+	// if it does not exist, holds other types or was not initialized in time.
+	static SharedHashTable Attach(const std::string& name, const KeyEqual& equal = KeyEqual())
+	{
+		int file = shm_open(name.c_str(), O_RDWR, 0);
+		if (file < 0)
+			throw std::runtime_error("SharedHashTable: cannot open " + name);
+
+		// The creator sizes the segment right after creating it.
+		const auto deadline = std::chrono::steady_clock::now() + AttachTimeout;
+		struct stat status {};
+		while (fstat(file, &status) == 0 && static_cast<size_t>(status.st_size) < sizeof(Header) && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::yield();
+		if (static_cast<size_t>(status.st_size) < sizeof(Header)) {
+			close(file);
+			throw std::runtime_error("SharedHashTable: " + name + " was not initialized");
+		}
+
+		SharedHashTable table(name, file, static_cast<size_t>(status.st_size), equal);
+		const Header* header = table.m_header;
+		while (header->ready.load(std::memory_order_acquire) == 0 && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::yield();
+		if (header->ready.load(std::memory_order_acquire) == 0 || header->magic != Header::Magic)
+			throw std::runtime_error("SharedHashTable: " + name + " was not initialized");
+		if (header->version != Header::CurrentVersion)
+			throw std::runtime_error("SharedHashTable: " + name + " has unsupported version " + std::to_string(header->version));
+		if (header->keySize != sizeof(Key) || header->valueSize != sizeof(Value) || header->nodeSize != sizeof(Node))
+			throw std::runtime_error("SharedHashTable: " + name + " holds other key or value types");
+		if (header->segmentSize != table.m_size)
+			throw std::runtime_error("SharedHashTable: " + name + " is truncated");
+
+		table.Bind();
+		return table;
+	}
+
+	// Deletes the segment name. Processes that have it mapped keep using it until they detach.
+	static bool Remove(const std::string& name)
+	{
+		return shm_unlink(name.c_str()) == 0;
+	}
+
+	SharedHashTable(SharedHashTable&& other) noexcept
+		: m_name(std::move(other.m_name)), m_base(std::exchange(other.m_base, nullptr)), m_size(std::exchange(other.m_size, 0)),
+		m_header(std::exchange(other.m_header, nullptr)), m_buckets(std::exchange(other.m_buckets, nullptr)),
+		m_hash(other.m_hash), m_equal(other.m_equal) {}
+
+	SharedHashTable(const SharedHashTable&) = delete;
+	SharedHashTable& operator=(const SharedHashTable&) = delete;
+
+	~SharedHashTable()
+	{
+		Detach();
+	}
+
+	//Operators
+	SharedHashTable& operator=(SharedHashTable&& other) noexcept
+	{
+		SharedHashTable moved(std::move(other));
+		std::swap(m_name, moved.m_name);
+		std::swap(m_base, moved.m_base);
+		std::swap(m_size, moved.m_size);
+		std::swap(m_header, moved.m_header);
+		std::swap(m_buckets, moved.m_buckets);
+		std::swap(m_hash, moved.m_hash);
+		std::swap(m_equal, moved.m_equal);
+		return *this;
+	}
+
+	// Unmaps the segment from this process; the table and its contents stay in the segment.
+	void Detach() noexcept
+	{
+		if (m_base != nullptr)
+			munmap(m_base, m_size);
+		m_base = nullptr;
+		m_header = nullptr;
+		m_buckets = nullptr;
+		m_size = 0;
+	}
+
+	bool IsAttached() const noexcept
+	{
+		return m_base != nullptr;
+	}
+
+	const std::string& Name() const noexcept
+	{
+		return m_name;
+	}
+
+	//Lookup
+	// Copies the value of the key into value and returns true if the key is present.
+	bool Find(const Key& key, Value& value) const
+	{
+		ReadLock lock(m_header->lock);
+		const Node* node = FindNode(key);
+		if (node == nullptr)
+			return false;
+
+		value = node->value;
+		return true;
+	}
+
+	bool Contains(const Key& key) const
+	{
+		ReadLock lock(m_header->lock);
+		return FindNode(key) != nullptr;
+	}
+
+	//Capacity
+	size_t Count() const
+	{
+		ReadLock lock(m_header->lock);
+		return static_cast<size_t>(m_header->count);
+	}
+
+	bool IsEmpty() const
+	{
+		return Count() == 0;
+	}
+
+	// Maximum number of elements, fixed when the segment was created.
+	size_t Capacity() const noexcept
+	{
+		return static_cast<size_t>(m_header->capacity);
+	}
+
+	size_t Size() const noexcept
+	{
+		return static_cast<size_t>(m_header->bucketCount);
+	}
+
+	float LoadFactor() const
+	{
+		return static_cast<float>(Count()) / static_cast<float>(Size());
+	}
+
+	// Bytes of the shared segment.
+	size_t SegmentSize() const noexcept
+	{
+		return m_size;
+	}
+
+	//Modifiers
+	// Inserts or overwrites the key. Throws std::length_error if the key is new and the table is at capacity.
+	void Insert(const Key& key, const Value& value)
+	{
+		WriteLock lock(m_header->lock);
+		if (Node* node = FindNode(key))
+			node->value = value;
+		else
+			EmplaceNode(key, value);
+	}
+
+	// Calls function(Value&) on the value of the key, inserting a value-initialized one first if it is missing,
+	// while the table is write-locked.
+	template<typename Function>
+	void Update(const Key& key, Function function)
+	{
+		WriteLock lock(m_header->lock);
+		Node* node = FindNode(key);
+		if (node == nullptr)
+			node = EmplaceNode(key, Value{});
+		function(node->value);
+	}
+
+	bool Erase(const Key& key)
+	{
+		WriteLock lock(m_header->lock);
+		for (NodeOffset* link = &m_buckets[BucketOf(key)]; *link != 0; link = &NodeAt(*link)->next) {
+			Node* node = NodeAt(*link);
+			if (m_equal(node->key, key)) {
+				NodeOffset offset = *link;
+				*link = node->next;
+				node->next = m_header->freeList;
+				m_header->freeList = offset;
+				--m_header->count;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Clear()
+	{
+		WriteLock lock(m_header->lock);
+		std::fill(m_buckets, m_buckets + m_header->bucketCount, NodeOffset{ 0 });
+		m_header->count = 0;
+		m_header->usedNodes = 0;
+		m_header->freeList = 0;
+	}
+
+	//Traversal
+	// Calls function(const Key&, const Value&) for every element while the table is read-locked.
+	template<typename Function>
+	void ForEach(Function function) const
+	{
+		ReadLock lock(m_header->lock);
+		for (uint64_t bucket = 0; bucket < m_header->bucketCount; ++bucket) {
+			for (NodeOffset offset = m_buckets[bucket]; offset != 0; offset = NodeAt(offset)->next)
+				function(NodeAt(offset)->key, NodeAt(offset)->value);
+		}
+	}
+
+private:
+	SharedHashTable(const std::string& name, int file, size_t size, const KeyEqual& equal)
+		: m_name(name), m_size(size), m_hash(0), m_equal(equal)
+	{
+		void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		close(file);
+		if (base == MAP_FAILED)
+			throw std::runtime_error("SharedHashTable: cannot map " + name);
+		m_base = static_cast<unsigned char*>(base);
+		m_header = reinterpret_cast<Header*>(m_base);
+	}
+
+	// Resolves the bucket array and the hasher once the header is known to be valid.
+	void Bind() noexcept
+	{
+		m_buckets = reinterpret_cast<NodeOffset*>(m_base + m_header->bucketsOffset);
+		m_hash = Hash(m_header->seed);
+	}
+
+	static constexpr uint64_t AlignUp(uint64_t offset, uint64_t alignment) noexcept
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	Node* NodeAt(NodeOffset offset) const noexcept
+	{
+		return reinterpret_cast<Node*>(m_base + offset);
+	}
+
+	size_t BucketOf(const Key& key) const
+	{
+		return PowerOfTwoBuckets::Index(m_hash(key), static_cast<size_t>(m_header->bucketCount));
+	}
+
+	Node* FindNode(const Key& key) const
+	{
+		for (NodeOffset offset = m_buckets[BucketOf(key)]; offset != 0; offset = NodeAt(offset)->next) {
+			Node* node = NodeAt(offset);
+			if (m_equal(node->key, key))
+				return node;
+		}
+		return nullptr;
+	}
+
+	// Takes a node from the free list, or the next never-used one, and links it at the head of its bucket.
+	Node* EmplaceNode(const Key& key, const Value& value)
+	{
+		NodeOffset offset = m_header->freeList;
+		if (offset != 0)
+			m_header->freeList = NodeAt(offset)->next;
+		else if (m_header->usedNodes < m_header->capacity)
+			offset = m_header->nodesOffset + m_header->usedNodes++ * sizeof(Node);
+		else
+			throw std::length_error("SharedHashTable: " + m_name + " is full");
+
+		NodeOffset& head = m_buckets[BucketOf(key)];
+		Node* node = new (NodeAt(offset)) Node{ key, value, head };
+		head = offset;
+		++m_header->count;
+		return node;
+	}
+
+private:
+	std::string m_name;
+	unsigned char* m_base = nullptr;
+	size_t m_size = 0;
+	Header* m_header = nullptr;
+	NodeOffset* m_buckets = nullptr;
+	Hash m_hash;
+	KeyEqual m_equal;
+};
+
+#endif
+
+#endif //_SHAREDHASHTABLE_
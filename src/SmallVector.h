@@ -0,0 +1,296 @@
+#ifndef _SMALLVECTOR_
+#define _SMALLVECTOR_
+
+#include<algorithm>
+#include<cstring>
+#include<initializer_list>
+#include<memory>
+#include<new>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+#include"Vector.h"
+
+// Vector that keeps up to N elements inside the object and only allocates once it grows past them, so short
+// vectors never touch the heap. Moving a heap-backed SmallVector steals its buffer; moving an inline one moves
+// its at most N elements. The interface matches Vector.
+template<typename T, size_t N = 8>
+class SmallVector
+{
+	static_assert(N > 0, "SmallVector needs inline room for at least one element");
+
+public:
+	using ValueType = T;
+	using Iterator = VecIterator<SmallVector<T, N>>;
+	using ReverseIterator = VecReverseIterator<SmallVector<T, N>>;
+public:
+	//Constructors
+	SmallVector() noexcept
+		: m_data(InlineData()), m_size(0), m_capacity(N) {}
+
+	SmallVector(size_t size, const T& value) : SmallVector()
+	{
+		Grow(size);
+		std::uninitialized_fill_n(m_data, size, value);
+		m_size = size;
+	}
+
+	SmallVector(std::initializer_list<T> list) : SmallVector()
+	{
+		Grow(list.size());
+		std::uninitialized_copy(list.begin(), list.end(), m_data);
+		m_size = list.size();
+	}
+
+	SmallVector(const SmallVector& other) : SmallVector()
+	{
+		Grow(other.m_size);
+		std::uninitialized_copy(other.m_data, other.m_data + other.m_size, m_data);
+		m_size = other.m_size;
+	}
+
+	SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : SmallVector()
+	{
+		TakeFrom(other);
+	}
+
+	~SmallVector()
+	{
+		Clear();
+		Deallocate();
+	}
+
+	//Operators
+	const T& operator[](size_t index) const
+	{
+		if (index >= m_size)
+			throw std::out_of_range("index out of range");
+		return m_data[index];
+	}
+
+	T& operator[](size_t index)
+	{
+		return const_cast<T&>(std::as_const(*this)[index]);
+	}
+
+	SmallVector& operator=(const SmallVector& other)
+	{
+		SmallVector copy(other);
+		Swap(copy);
+		return *this;
+	}
+
+	SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+	{
+		if (this != &other) {
+			Clear();
+			Deallocate();
+			m_data = InlineData();
+			m_capacity = N;
+			TakeFrom(other);
+		}
+		return *this;
+	}
+
+	bool operator==(const SmallVector& other) const
+	{
+		if (m_size != other.m_size)
+			return false;
+
+		for (size_t i = 0; i < m_size; ++i) {
+			if (m_data[i] != other.m_data[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	bool operator!=(const SmallVector& other) const
+	{
+		return !(*this == other);
+	}
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	size_t Size() const noexcept
+	{
+		return m_size;
+	}
+
+	size_t Capacity() const noexcept
+	{
+		return m_capacity;
+	}
+
+	// True while the elements live in the inline buffer.
+	bool IsInline() const noexcept
+	{
+		return m_data == InlineData();
+	}
+
+	T* Data() noexcept
+	{
+		return m_data;
+	}
+
+	const T* Data() const noexcept
+	{
+		return m_data;
+	}
+
+	//Modifiers
+	void PushBack(const T& value)
+	{
+		EmplaceBack(value);
+	}
+
+	void PushBack(T&& value)
+	{
+		EmplaceBack(std::move(value));
+	}
+
+	template<typename... Args>
+	T& EmplaceBack(Args&&... args)
+	{
+		if (m_size == m_capacity)
+			return GrowAndEmplaceBack(std::forward<Args>(args)...);
+
+		T* element = new (m_data + m_size) T(std::forward<Args>(args)...);
+		++m_size;
+		return *element;
+	}
+
+	void PopBack()
+	{
+		if (m_size > 0) {
+			--m_size;
+			m_data[m_size].~T();
+		}
+	}
+
+	//Operations
+	// Destroys the elements but keeps the capacity.
+	void Clear() noexcept
+	{
+		std::destroy_n(m_data, m_size);
+		m_size = 0;
+	}
+
+	void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+	{
+		if (!IsInline() && !other.IsInline()) {
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+			std::swap(m_capacity, other.m_capacity);
+			return;
+		}
+
+		SmallVector temporary(std::move(other));
+		other = std::move(*this);
+		*this = std::move(temporary);
+	}
+
+	//Iterators
+	Iterator begin() { return Iterator(m_data); };
+	Iterator end() { return Iterator(m_data + m_size); };
+	ReverseIterator rbegin() { return ReverseIterator(m_data + m_size - 1); };
+	ReverseIterator rend() { return ReverseIterator(m_data - 1); };
+
+private:
+	T* InlineData() noexcept
+	{
+		return reinterpret_cast<T*>(m_inline);
+	}
+
+	const T* InlineData() const noexcept
+	{
+		return reinterpret_cast<const T*>(m_inline);
+	}
+
+	static T* Allocate(size_t capacity)
+	{
+		if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			return static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+		else
+			return static_cast<T*>(::operator new(capacity * sizeof(T)));
+	}
+
+	static void Free(T* data, size_t capacity) noexcept
+	{
+		if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			::operator delete(data, capacity * sizeof(T), std::align_val_t(alignof(T)));
+		else
+			::operator delete(data, capacity * sizeof(T));
+	}
+
+	void Deallocate() noexcept
+	{
+		if (!IsInline())
+			Free(m_data, m_capacity);
+	}
+
+	// Makes room for at least capacity elements, doubling the current capacity at a minimum.
+	void Grow(size_t capacity)
+	{
+		if (capacity <= m_capacity)
+			return;
+
+		capacity = std::max(capacity, m_capacity * 2);
+		T* data = Allocate(capacity);
+		RelocateElements(m_data, m_size, data);
+		Deallocate();
+		m_data = data;
+		m_capacity = capacity;
+	}
+
+	// The new element is constructed before the old ones move, so arguments that refer to an element of this
+	// vector stay valid.
+	template<typename... Args>
+	T& GrowAndEmplaceBack(Args&&... args)
+	{
+		size_t capacity = m_capacity * 2;
+		T* data = Allocate(capacity);
+		T* element;
+		try {
+			element = new (data + m_size) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			Free(data, capacity);
+			throw;
+		}
+
+		RelocateElements(m_data, m_size, data);
+		Deallocate();
+		m_data = data;
+		m_capacity = capacity;
+		++m_size;
+		return *element;
+	}
+
+	// Takes the elements of other, which must leave this vector empty and inline, and leaves other empty.
+	void TakeFrom(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+	{
+		if (other.IsInline()) {
+			RelocateElements(other.m_data, other.m_size, m_data);
+			m_size = std::exchange(other.m_size, 0);
+			return;
+		}
+
+		m_data = std::exchange(other.m_data, other.InlineData());
+		m_size = std::exchange(other.m_size, 0);
+		m_capacity = std::exchange(other.m_capacity, N);
+	}
+
+private:
+	T* m_data;
+	size_t m_size;
+	size_t m_capacity;
+	alignas(T) unsigned char m_inline[N * sizeof(T)];
+};
+
+#endif //_SMALLVECTOR_
@@ -0,0 +1,400 @@
+#ifndef _SOAVECTOR_
+#define _SOAVECTOR_
+
+#include<algorithm>
+#include<array>
+#include<cstddef>
+#include<initializer_list>
+#include<memory>
+#include<new>
+#include<span>
+#include<stdexcept>
+#include<tuple>
+#include<type_traits>
+#include<utility>
+
+#include"Vector.h"
+
+template<typename SoAVector, typename Reference>
+class SoAIterator
+{
+public:
+	SoAIterator() noexcept : m_vector(nullptr), m_index(0) {}
+	SoAIterator(SoAVector* vector, size_t index) noexcept : m_vector(vector), m_index(index) {}
+
+	Reference operator*() const { return m_vector->Row(m_index); }
+
+	bool operator==(const SoAIterator& other) const noexcept { return m_index == other.m_index; }
+	bool operator!=(const SoAIterator& other) const noexcept { return m_index != other.m_index; }
+
+	SoAIterator& operator++() noexcept { ++m_index; return *this; }
+	SoAIterator operator++(int) noexcept {
+		SoAIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+	SoAIterator& operator--() noexcept { --m_index; return *this; }
+	SoAIterator operator--(int) noexcept {
+		SoAIterator iterator = *this;
+		--(*this);
+		return iterator;
+	}
+
+private:
+	SoAVector* m_vector;
+	size_t m_index;
+};
+
+// Structure-of-arrays vector: every field of a row lives in its own contiguous column, so a loop over one field
+// reads only that field's bytes and Column<I>() hands a column to the vectorized algorithms. All columns share
+// one allocation with every column aligned to ColumnAlignment bytes, and grow together like a Vector. Rows are
+// read and written through tuples of references: auto [x, y] = vector[i] binds to the elements.
+template<typename... Fields>
+class SoAVector
+{
+	static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+
+public:
+	using ValueType = std::tuple<Fields...>;
+	using Reference = std::tuple<Fields&...>;
+	using ConstReference = std::tuple<const Fields&...>;
+	using Iterator = SoAIterator<SoAVector, Reference>;
+	using ConstIterator = SoAIterator<const SoAVector, ConstReference>;
+	using Growth = GeometricGrowth<>;
+
+	template<size_t I>
+	using FieldType = std::tuple_element_t<I, ValueType>;
+
+	static constexpr size_t FieldCount = sizeof...(Fields);
+	static constexpr size_t ColumnAlignment = std::max({ size_t{ 64 }, alignof(Fields)... });
+
+public:
+	//Constructors
+	SoAVector() noexcept : m_storage(nullptr), m_columns{}, m_size(0), m_capacity(0) {}
+
+	SoAVector(std::initializer_list<ValueType> rows) : SoAVector()
+	{
+		Reserve(rows.size());
+		for (const ValueType& row : rows)
+			PushBack(row);
+	}
+
+	SoAVector(const SoAVector& other) : SoAVector()
+	{
+		Reserve(other.m_size);
+		for (size_t i = 0; i < other.m_size; ++i)
+			std::apply([this](const Fields&... fields) { EmplaceBack(fields...); }, other.Row(i));
+	}
+
+	SoAVector(SoAVector&& other) noexcept
+		: m_storage(std::exchange(other.m_storage, nullptr)), m_columns(other.m_columns),
+		m_size(std::exchange(other.m_size, 0)), m_capacity(std::exchange(other.m_capacity, 0))
+	{
+		other.m_columns = {};
+	}
+
+	~SoAVector()
+	{
+		Clear();
+		Free(m_storage, m_capacity);
+	}
+
+	//Operators
+	SoAVector& operator=(const SoAVector& other)
+	{
+		SoAVector copy(other);
+		Swap(copy);
+		return *this;
+	}
+
+	SoAVector& operator=(SoAVector&& other) noexcept
+	{
+		SoAVector moved(std::move(other));
+		Swap(moved);
+		return *this;
+	}
+
+	Reference operator[](size_t index)
+	{
+		CheckIndex(index);
+		return Row(index);
+	}
+
+	ConstReference operator[](size_t index) const
+	{
+		CheckIndex(index);
+		return Row(index);
+	}
+
+	bool operator==(const SoAVector& other) const
+	{
+		if (m_size != other.m_size)
+			return false;
+
+		for (size_t i = 0; i < m_size; ++i) {
+			if (Row(i) != other.Row(i))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool operator!=(const SoAVector& other) const
+	{
+		return !(*this == other);
+	}
+
+	//Capacity
+	bool Empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	size_t Size() const noexcept
+	{
+		return m_size;
+	}
+
+	size_t Capacity() const noexcept
+	{
+		return m_capacity;
+	}
+
+	void Reserve(size_t capacity)
+	{
+		if (capacity > m_capacity)
+			Reallocate(capacity);
+	}
+
+	void ShrinkToFit()
+	{
+		if (m_size < m_capacity)
+			Reallocate(m_size);
+	}
+
+	//Columns
+	template<size_t I>
+	FieldType<I>* Data() noexcept
+	{
+		return static_cast<FieldType<I>*>(m_columns[I]);
+	}
+
+	template<size_t I>
+	const FieldType<I>* Data() const noexcept
+	{
+		return static_cast<const FieldType<I>*>(m_columns[I]);
+	}
+
+	template<size_t I>
+	std::span<FieldType<I>> Column() noexcept
+	{
+		return std::span<FieldType<I>>(Data<I>(), m_size);
+	}
+
+	template<size_t I>
+	std::span<const FieldType<I>> Column() const noexcept
+	{
+		return std::span<const FieldType<I>>(Data<I>(), m_size);
+	}
+
+	//Modifiers
+	void PushBack(const Fields&... fields)
+	{
+		EmplaceBack(fields...);
+	}
+
+	void PushBack(const ValueType& row)
+	{
+		std::apply([this](const Fields&... fields) { EmplaceBack(fields...); }, row);
+	}
+
+	void PushBack(ValueType&& row)
+	{
+		std::apply([this](Fields&... fields) { EmplaceBack(std::move(fields)...); }, row);
+	}
+
+	// Constructs every field of the new row from the argument at its position.
+	template<typename... Args>
+	Reference EmplaceBack(Args&&... args)
+	{
+		static_assert(sizeof...(Args) == FieldCount, "EmplaceBack takes one argument per field");
+		if (m_size == m_capacity)
+			return GrowAndEmplaceBack(std::forward<Args>(args)...);
+
+		ConstructRow(m_columns, m_size, std::forward<Args>(args)...);
+		++m_size;
+		return Row(m_size - 1);
+	}
+
+	void PopBack()
+	{
+		if (m_size > 0) {
+			--m_size;
+			DestroyRows(m_size, 1, std::index_sequence_for<Fields...>());
+		}
+	}
+
+	// Destroys the rows but keeps the capacity.
+	void Clear() noexcept
+	{
+		DestroyRows(0, m_size, std::index_sequence_for<Fields...>());
+		m_size = 0;
+	}
+
+	void Swap(SoAVector& other) noexcept
+	{
+		std::swap(m_storage, other.m_storage);
+		std::swap(m_columns, other.m_columns);
+		std::swap(m_size, other.m_size);
+		std::swap(m_capacity, other.m_capacity);
+	}
+
+	//Iterators
+	Iterator begin() { return Iterator(this, 0); };
+	Iterator end() { return Iterator(this, m_size); };
+	ConstIterator begin() const { return ConstIterator(this, 0); };
+	ConstIterator end() const { return ConstIterator(this, m_size); };
+
+	// Unchecked row access for the iterators.
+	Reference Row(size_t index) noexcept
+	{
+		return RowAt(index, std::index_sequence_for<Fields...>());
+	}
+
+	ConstReference Row(size_t index) const noexcept
+	{
+		return RowAt(index, std::index_sequence_for<Fields...>());
+	}
+
+private:
+	using Columns = std::array<void*, FieldCount>;
+
+	void CheckIndex(size_t index) const
+	{
+		if (index >= m_size)
+			throw std::out_of_range("index out of range");
+	}
+
+	template<size_t... I>
+	Reference RowAt(size_t index, std::index_sequence<I...>) noexcept
+	{
+		return Reference(Data<I>()[index]...);
+	}
+
+	template<size_t... I>
+	ConstReference RowAt(size_t index, std::index_sequence<I...>) const noexcept
+	{
+		return ConstReference(Data<I>()[index]...);
+	}
+
+	static constexpr size_t AlignUp(size_t offset) noexcept
+	{
+		return (offset + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;
+	}
+
+	// Bytes of one allocation holding capacity rows; column I starts at ColumnOffset<I>.
+	template<size_t I>
+	static constexpr size_t ColumnOffset(size_t capacity) noexcept
+	{
+		if constexpr (I == 0)
+			return 0;
+		else
+			return AlignUp(ColumnOffset<I - 1>(capacity) + capacity * sizeof(FieldType<I - 1>));
+	}
+
+	static constexpr size_t StorageSize(size_t capacity) noexcept
+	{
+		return ColumnOffset<FieldCount>(capacity);
+	}
+
+	template<size_t... I>
+	static Columns ColumnsOf(void* storage, size_t capacity, std::index_sequence<I...>) noexcept
+	{
+		return Columns{ static_cast<void*>(static_cast<char*>(storage) + ColumnOffset<I>(capacity))... };
+	}
+
+	static void* Allocate(size_t capacity)
+	{
+		return ::operator new(StorageSize(capacity), std::align_val_t(ColumnAlignment));
+	}
+
+	static void Free(void* storage, size_t capacity) noexcept
+	{
+		if (storage != nullptr)
+			::operator delete(storage, StorageSize(capacity), std::align_val_t(ColumnAlignment));
+	}
+
+	// Constructs the fields of row index in the given columns. If a field throws, the fields constructed
+	// before it are destroyed again.
+	template<size_t I = 0, typename Arg, typename... Args>
+	static void ConstructRow(const Columns& columns, size_t index, Arg&& arg, Args&&... args)
+	{
+		FieldType<I>* field = static_cast<FieldType<I>*>(columns[I]) + index;
+		::new (static_cast<void*>(field)) FieldType<I>(std::forward<Arg>(arg));
+		if constexpr (sizeof...(Args) > 0) {
+			try {
+				ConstructRow<I + 1>(columns, index, std::forward<Args>(args)...);
+			}
+			catch (...) {
+				std::destroy_at(field);
+				throw;
+			}
+		}
+	}
+
+	template<size_t... I>
+	void DestroyRows(size_t first, size_t count, std::index_sequence<I...>) noexcept
+	{
+		(std::destroy_n(Data<I>() + first, count), ...);
+	}
+
+	template<size_t... I>
+	void RelocateColumns(const Columns& to, std::index_sequence<I...>)
+	{
+		(RelocateElements(Data<I>(), m_size, static_cast<FieldType<I>*>(to[I])), ...);
+	}
+
+	void Reallocate(size_t capacity)
+	{
+		void* storage = capacity > 0 ? Allocate(capacity) : nullptr;
+		Columns columns = storage != nullptr ? ColumnsOf(storage, capacity, std::index_sequence_for<Fields...>()) : Columns{};
+		RelocateColumns(columns, std::index_sequence_for<Fields...>());
+		Free(m_storage, m_capacity);
+		m_storage = storage;
+		m_columns = columns;
+		m_capacity = capacity;
+	}
+
+	// The new row is constructed before the old ones move, so arguments that refer to an element of this vector
+	// stay valid.
+	template<typename... Args>
+	Reference GrowAndEmplaceBack(Args&&... args)
+	{
+		size_t capacity = Growth::Capacity(m_capacity, m_size + 1);
+		void* storage = Allocate(capacity);
+		Columns columns = ColumnsOf(storage, capacity, std::index_sequence_for<Fields...>());
+		try {
+			ConstructRow(columns, m_size, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			Free(storage, capacity);
+			throw;
+		}
+
+		RelocateColumns(columns, std::index_sequence_for<Fields...>());
+		Free(m_storage, m_capacity);
+		m_storage = storage;
+		m_columns = columns;
+		m_capacity = capacity;
+		++m_size;
+		return Row(m_size - 1);
+	}
+
+private:
+	void* m_storage;
+	Columns m_columns;
+	size_t m_size;
+	size_t m_capacity;
+};
+
+#endif //_SOAVECTOR_
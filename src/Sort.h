@@ -0,0 +1,548 @@
+#ifndef _SORT_
+#define _SORT_
+
+#include<algorithm>
+#include<bit>
+#include<concepts>
+#include<cstddef>
+#include<cstdint>
+#include<functional>
+#include<span>
+#include<type_traits>
+#include<utility>
+
+// In-place sorting of contiguous elements. Sort and StableSort without a comparator order integers,
+// floating-point numbers and enums with a most-significant-digit radix sort that permutes the elements in place
+// one byte at a time. Sort of other types, and every Sort with a comparator, uses a pattern-defeating quicksort:
+// introsort with median-of-three or ninther pivots, block partitioning without branches for cheap comparisons,
+// detection of already partitioned runs, and a heapsort fallback after too many unbalanced partitions, so it
+// stays O(n log n). StableSort of other types uses std::stable_sort.
+
+// Element types the radix sorts order by their bytes.
+template<typename T>
+concept RadixSortable = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, float> || std::same_as<T, double>
+	|| std::is_enum_v<T>;
+
+// Maps a value to an unsigned integer whose order is the order of the values: the sign bit of signed integers
+// is flipped, and negative floating-point numbers have all bits flipped. -0.0 sorts before 0.0, and NaNs sort
+// after infinity, or before minus infinity if their sign bit is set.
+template<RadixSortable T>
+constexpr auto RadixKey(T value) noexcept
+{
+	if constexpr (std::is_enum_v<T>) {
+		return RadixKey(static_cast<std::underlying_type_t<T>>(value));
+	}
+	else {
+		using Key = std::make_unsigned_t<std::conditional_t<std::is_floating_point_v<T>,
+			std::conditional_t<sizeof(T) == 4, int32_t, int64_t>, T>>;
+		constexpr Key SignBit = Key{ 1 } << (sizeof(Key) * 8 - 1);
+		Key key = std::bit_cast<Key>(value);
+		if constexpr (std::is_floating_point_v<T>)
+			return static_cast<Key>(key ^ (static_cast<Key>(-static_cast<Key>(key >> (sizeof(Key) * 8 - 1))) | SignBit));
+		else if constexpr (std::is_signed_v<T>)
+			return static_cast<Key>(key ^ SignBit);
+		else
+			return key;
+	}
+}
+
+// Orders radix sortable values the way the radix sorts do, for the small ranges they leave to comparison sorts.
+struct RadixKeyLess
+{
+	template<typename T>
+	constexpr bool operator()(const T& first, const T& second) const noexcept
+	{
+		return RadixKey(first) < RadixKey(second);
+	}
+};
+
+// Partitions smaller than this are insertion sorted.
+inline constexpr size_t SortInsertionThreshold = 24;
+// Partitions larger than this take their pivot as the median of three medians of three.
+inline constexpr size_t SortNintherThreshold = 128;
+// Moves an insertion sort may make on a presumably sorted partition before it gives up.
+inline constexpr size_t SortPartialInsertionLimit = 8;
+// Elements a branchless partition compares before it swaps the misplaced ones.
+inline constexpr size_t SortBlockSize = 64;
+// Ranges smaller than this are left to the comparison sort by the radix sorts.
+inline constexpr size_t RadixSortThreshold = 128;
+
+// Comparators known to be cheap, for which partitioning without branches pays off.
+template<typename Compare, typename T>
+inline constexpr bool IsCheapCompare = std::is_trivially_copyable_v<T> && sizeof(T) <= 2 * sizeof(void*)
+	&& (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::greater<>>
+		|| std::is_same_v<Compare, std::greater<T>> || std::is_same_v<Compare, RadixKeyLess>);
+
+template<typename T, typename Compare>
+void InsertionSort(T* first, T* last, Compare& compare)
+{
+	if (first == last)
+		return;
+
+	for (T* current = first + 1; current != last; ++current) {
+		T* sift = current;
+		if (compare(*sift, *(sift - 1))) {
+			T value = std::move(*sift);
+			do {
+				*sift = std::move(*(sift - 1));
+				--sift;
+			} while (sift != first && compare(value, *(sift - 1)));
+			*sift = std::move(value);
+		}
+	}
+}
+
+// Insertion sort for a range whose predecessor is no greater than any of its elements and stops the scans.
+template<typename T, typename Compare>
+void UnguardedInsertionSort(T* first, T* last, Compare& compare)
+{
+	if (first == last)
+		return;
+
+	for (T* current = first + 1; current != last; ++current) {
+		T* sift = current;
+		if (compare(*sift, *(sift - 1))) {
+			T value = std::move(*sift);
+			do {
+				*sift = std::move(*(sift - 1));
+				--sift;
+			} while (compare(value, *(sift - 1)));
+			*sift = std::move(value);
+		}
+	}
+}
+
+// Insertion sorts the range unless that takes more than SortPartialInsertionLimit moves; returns whether the
+// range ended up sorted.
+template<typename T, typename Compare>
+bool PartialInsertionSort(T* first, T* last, Compare& compare)
+{
+	if (first == last)
+		return true;
+
+	size_t moves = 0;
+	for (T* current = first + 1; current != last; ++current) {
+		T* sift = current;
+		if (compare(*sift, *(sift - 1))) {
+			T value = std::move(*sift);
+			do {
+				*sift = std::move(*(sift - 1));
+				--sift;
+			} while (sift != first && compare(value, *(sift - 1)));
+			*sift = std::move(value);
+			moves += static_cast<size_t>(current - sift);
+		}
+		if (moves > SortPartialInsertionLimit)
+			return false;
+	}
+	return true;
+}
+
+template<typename T, typename Compare>
+void SortTwo(T* first, T* second, Compare& compare)
+{
+	if (compare(*second, *first))
+		std::iter_swap(first, second);
+}
+
+template<typename T, typename Compare>
+void SortThree(T* first, T* second, T* third, Compare& compare)
+{
+	SortTwo(first, second, compare);
+	SortTwo(second, third, compare);
+	SortTwo(first, second, compare);
+}
+
+// Partitions [first, last) around the pivot *first into the elements less than it and the rest, and returns the
+// pivot's final position and whether the range was already partitioned.
+template<typename T, typename Compare>
+std::pair<T*, bool> PartitionRight(T* first, T* last, Compare& compare)
+{
+	T pivot = std::move(*first);
+	T* left = first;
+	T* right = last;
+
+	while (compare(*++left, pivot)) {}
+	if (left - 1 == first)
+		while (left < right && !compare(*--right, pivot)) {}
+	else
+		while (!compare(*--right, pivot)) {}
+
+	bool alreadyPartitioned = left >= right;
+	while (left < right) {
+		std::iter_swap(left, right);
+		while (compare(*++left, pivot)) {}
+		while (!compare(*--right, pivot)) {}
+	}
+
+	T* pivotPosition = left - 1;
+	*first = std::move(*pivotPosition);
+	*pivotPosition = std::move(pivot);
+	return { pivotPosition, alreadyPartitioned };
+}
+
+// Exchanges count misplaced elements from the left block with count from the right one. Moving them as one cycle
+// costs fewer moves than swapping pairs. When both blocks hold the same number, as on descending input, pairwise
+// swaps are used instead: they reverse the blocks into ascending order, which the partial insertion sort then
+// finishes in linear time.
+template<typename T>
+void SwapOffsets(T* leftBase, T* rightBase, const unsigned char* leftOffsets, const unsigned char* rightOffsets,
+	size_t count, bool useSwaps)
+{
+	if (useSwaps) {
+		for (size_t i = 0; i < count; ++i)
+			std::iter_swap(leftBase + leftOffsets[i], rightBase - rightOffsets[i]);
+	}
+	else if (count > 0) {
+		T* left = leftBase + leftOffsets[0];
+		T* right = rightBase - rightOffsets[0];
+		T value = std::move(*left);
+		*left = std::move(*right);
+		for (size_t i = 1; i < count; ++i) {
+			left = leftBase + leftOffsets[i];
+			*right = std::move(*left);
+			right = rightBase - rightOffsets[i];
+			*left = std::move(*right);
+		}
+		*right = std::move(value);
+	}
+}
+
+// PartitionRight for cheap comparisons. Following BlockQuicksort, it compares a block of elements from each end,
+// recording the offsets of the misplaced ones with arithmetic instead of branches, and then swaps them in pairs,
+// so the unpredictable comparison results never cost a branch misprediction.
+template<typename T, typename Compare>
+std::pair<T*, bool> PartitionRightBranchless(T* first, T* last, Compare& compare)
+{
+	T pivot = std::move(*first);
+	T* left = first;
+	T* right = last;
+
+	while (compare(*++left, pivot)) {}
+	if (left - 1 == first)
+		while (left < right && !compare(*--right, pivot)) {}
+	else
+		while (!compare(*--right, pivot)) {}
+
+	bool alreadyPartitioned = left >= right;
+	if (!alreadyPartitioned) {
+		std::iter_swap(left, right);
+		++left;
+
+		alignas(64) unsigned char leftOffsets[SortBlockSize];
+		alignas(64) unsigned char rightOffsets[SortBlockSize];
+		T* leftBase = left;
+		T* rightBase = right;
+		size_t leftCount = 0;
+		size_t rightCount = 0;
+		size_t leftStart = 0;
+		size_t rightStart = 0;
+
+		while (left < right) {
+			size_t unknown = static_cast<size_t>(right - left);
+			size_t leftSplit = leftCount == 0 ? (rightCount == 0 ? unknown / 2 : unknown) : 0;
+			size_t rightSplit = rightCount == 0 ? unknown - leftSplit : 0;
+
+			if (leftSplit >= SortBlockSize) {
+				for (size_t i = 0; i < SortBlockSize; ++i) {
+					leftOffsets[leftCount] = static_cast<unsigned char>(i);
+					leftCount += !compare(*left, pivot);
+					++left;
+				}
+			}
+			else {
+				for (size_t i = 0; i < leftSplit; ++i) {
+					leftOffsets[leftCount] = static_cast<unsigned char>(i);
+					leftCount += !compare(*left, pivot);
+					++left;
+				}
+			}
+
+			if (rightSplit >= SortBlockSize) {
+				for (size_t i = 1; i <= SortBlockSize; ++i) {
+					rightOffsets[rightCount] = static_cast<unsigned char>(i);
+					rightCount += compare(*--right, pivot);
+				}
+			}
+			else {
+				for (size_t i = 1; i <= rightSplit; ++i) {
+					rightOffsets[rightCount] = static_cast<unsigned char>(i);
+					rightCount += compare(*--right, pivot);
+				}
+			}
+
+			size_t count = std::min(leftCount, rightCount);
+			SwapOffsets(leftBase, rightBase, leftOffsets + leftStart, rightOffsets + rightStart, count, leftCount == rightCount);
+			leftCount -= count;
+			rightCount -= count;
+			leftStart += count;
+			rightStart += count;
+
+			if (leftCount == 0) {
+				leftStart = 0;
+				leftBase = left;
+			}
+			if (rightCount == 0) {
+				rightStart = 0;
+				rightBase = right;
+			}
+		}
+
+		// One block may still hold misplaced elements; they go next to the boundary.
+		if (leftCount > 0) {
+			while (leftCount-- > 0)
+				std::iter_swap(leftBase + leftOffsets[leftStart + leftCount], --right);
+			left = right;
+		}
+		if (rightCount > 0) {
+			while (rightCount-- > 0)
+				std::iter_swap(rightBase - rightOffsets[rightStart + rightCount], left++);
+		}
+	}
+
+	T* pivotPosition = left - 1;
+	*first = std::move(*pivotPosition);
+	*pivotPosition = std::move(pivot);
+	return { pivotPosition, alreadyPartitioned };
+}
+
+// Partitions [first, last) around the pivot *first into the elements equal to it and the greater ones, and
+// returns the pivot's final position. Used when the pivot equals the predecessor of the range, which makes all
+// of the equal elements land in one partition that needs no further sorting.
+template<typename T, typename Compare>
+T* PartitionLeft(T* first, T* last, Compare& compare)
+{
+	T pivot = std::move(*first);
+	T* left = first;
+	T* right = last;
+
+	while (compare(pivot, *--right)) {}
+	if (right + 1 == last)
+		while (left < right && !compare(pivot, *++left)) {}
+	else
+		while (!compare(pivot, *++left)) {}
+
+	while (left < right) {
+		std::iter_swap(left, right);
+		while (compare(pivot, *--right)) {}
+		while (!compare(pivot, *++left)) {}
+	}
+
+	T* pivotPosition = right;
+	*first = std::move(*pivotPosition);
+	*pivotPosition = std::move(pivot);
+	return pivotPosition;
+}
+
+template<bool Branchless, typename T, typename Compare>
+void PdqSortLoop(T* first, T* last, Compare& compare, int badAllowed, bool leftmost)
+{
+	while (true) {
+		size_t size = static_cast<size_t>(last - first);
+		if (size < SortInsertionThreshold) {
+			if (leftmost)
+				InsertionSort(first, last, compare);
+			else
+				UnguardedInsertionSort(first, last, compare);
+			return;
+		}
+
+		size_t half = size / 2;
+		if (size > SortNintherThreshold) {
+			SortThree(first, first + half, last - 1, compare);
+			SortThree(first + 1, first + (half - 1), last - 2, compare);
+			SortThree(first + 2, first + (half + 1), last - 3, compare);
+			SortThree(first + (half - 1), first + half, first + (half + 1), compare);
+			std::iter_swap(first, first + half);
+		}
+		else {
+			SortThree(first + half, first, last - 1, compare);
+		}
+
+		// A pivot equal to the predecessor means every element equal to it is in place once partitioned.
+		if (!leftmost && !compare(*(first - 1), *first)) {
+			first = PartitionLeft(first, last, compare) + 1;
+			continue;
+		}
+
+		auto [pivot, alreadyPartitioned] = Branchless ? PartitionRightBranchless(first, last, compare) : PartitionRight(first, last, compare);
+		size_t leftSize = static_cast<size_t>(pivot - first);
+		size_t rightSize = static_cast<size_t>(last - (pivot + 1));
+
+		if (leftSize < size / 8 || rightSize < size / 8) {
+			// Too many bad pivots mean an adversarial pattern; heapsort keeps the worst case O(n log n).
+			if (--badAllowed == 0) {
+				std::make_heap(first, last, compare);
+				std::sort_heap(first, last, compare);
+				return;
+			}
+
+			// Otherwise shuffle a few elements to break up the pattern that produced the bad pivot.
+			if (leftSize >= SortInsertionThreshold) {
+				std::iter_swap(first, first + leftSize / 4);
+				std::iter_swap(pivot - 1, pivot - leftSize / 4);
+				if (leftSize > SortNintherThreshold) {
+					std::iter_swap(first + 1, first + (leftSize / 4 + 1));
+					std::iter_swap(first + 2, first + (leftSize / 4 + 2));
+					std::iter_swap(pivot - 2, pivot - (leftSize / 4 + 1));
+					std::iter_swap(pivot - 3, pivot - (leftSize / 4 + 2));
+				}
+			}
+			if (rightSize >= SortInsertionThreshold) {
+				std::iter_swap(pivot + 1, pivot + (1 + rightSize / 4));
+				std::iter_swap(last - 1, last - rightSize / 4);
+				if (rightSize > SortNintherThreshold) {
+					std::iter_swap(pivot + 2, pivot + (2 + rightSize / 4));
+					std::iter_swap(pivot + 3, pivot + (3 + rightSize / 4));
+					std::iter_swap(last - 2, last - (1 + rightSize / 4));
+					std::iter_swap(last - 3, last - (2 + rightSize / 4));
+				}
+			}
+		}
+		else if (alreadyPartitioned && PartialInsertionSort(first, pivot, compare)
+			&& PartialInsertionSort(pivot + 1, last, compare)) {
+			// Both sides were nearly sorted, as in sorted and reversed inputs.
+			return;
+		}
+
+		PdqSortLoop<Branchless>(first, pivot, compare, badAllowed, leftmost);
+		first = pivot + 1;
+		leftmost = false;
+	}
+}
+
+// Pattern-defeating quicksort of [first, last). Not stable.
+template<typename T, typename Compare>
+void PdqSort(T* first, T* last, Compare compare)
+{
+	if (last - first < 2)
+		return;
+	int badAllowed = std::bit_width(static_cast<size_t>(last - first));
+	PdqSortLoop<IsCheapCompare<Compare, T>>(first, last, compare, badAllowed, true);
+}
+
+// Byte digit of a radix key, counting from the least significant byte.
+template<typename Key>
+constexpr size_t RadixDigit(Key key, size_t byte) noexcept
+{
+	return static_cast<size_t>((key >> (byte * 8)) & 0xFF);
+}
+
+// Index of the most significant byte in which the keys of [first, last) differ, or -1 if they are all equal.
+template<typename T>
+int RadixHighestDifferingByte(const T* first, const T* last) noexcept
+{
+	auto key = RadixKey(*first);
+	decltype(key) difference = 0;
+	for (const T* element = first; element != last; ++element)
+		difference |= RadixKey(*element) ^ key;
+	return difference == 0 ? -1 : (std::bit_width(difference) - 1) / 8;
+}
+
+// Most-significant-digit radix sort that permutes the elements in place. Each level finds the highest byte in
+// which the keys still differ, counts its digits and moves every element into its bucket, then sorts the
+// buckets on the lower bytes; small buckets go to PdqSort. The moves are done in rounds that swap each element
+// of a bucket's unfilled part straight to the next free slot of its target bucket, rather than by following
+// one swap cycle at a time, so consecutive swaps do not depend on each other and their cache misses overlap.
+template<typename T>
+void RadixSortInPlace(T* first, T* last)
+{
+	size_t size = static_cast<size_t>(last - first);
+	if (size < RadixSortThreshold) {
+		PdqSort(first, last, RadixKeyLess{});
+		return;
+	}
+
+	int byte = RadixHighestDifferingByte(first, last);
+	if (byte < 0)
+		return;
+
+	size_t counts[256] = {};
+	for (T* element = first; element != last; ++element)
+		++counts[RadixDigit(RadixKey(*element), static_cast<size_t>(byte))];
+
+	size_t heads[256];
+	size_t tails[256];
+	size_t offset = 0;
+	for (size_t digit = 0; digit < 256; ++digit) {
+		heads[digit] = offset;
+		offset += counts[digit];
+		tails[digit] = offset;
+	}
+
+	// Every swap puts one element in its bucket; a round leaves the unfilled part of each bucket no larger.
+	bool unfilled = true;
+	while (unfilled) {
+		unfilled = false;
+		for (size_t digit = 0; digit < 256; ++digit) {
+			size_t tail = tails[digit];
+			for (size_t position = heads[digit]; position < tail; ++position) {
+				size_t target = RadixDigit(RadixKey(first[position]), static_cast<size_t>(byte));
+				std::swap(first[position], first[heads[target]++]);
+			}
+			unfilled |= heads[digit] < tail;
+		}
+	}
+
+	if (byte == 0)
+		return;
+	offset = 0;
+	for (size_t digit = 0; digit < 256; ++digit) {
+		if (counts[digit] > 1)
+			RadixSortInPlace(first + offset, first + offset + counts[digit]);
+		offset += counts[digit];
+	}
+}
+
+// Radix sorts [first, last), returning early if it is already sorted and reversing it if it is descending;
+// elements with equal keys are identical, so reversing them is harmless.
+template<typename T>
+void RadixSort(T* first, T* last)
+{
+	RadixKeyLess less;
+	if (std::is_sorted(first, last, less))
+		return;
+	if (std::is_sorted(first, last, [&less](const T& element, const T& next) { return less(next, element); })) {
+		std::reverse(first, last);
+		return;
+	}
+	RadixSortInPlace(first, last);
+}
+
+// Sorts the elements in ascending order; radix sortable types are radix sorted in place. Not stable.
+template<typename T>
+void Sort(std::span<T> values)
+{
+	if constexpr (RadixSortable<T>) {
+		RadixSort(values.data(), values.data() + values.size());
+	}
+	else {
+		PdqSort(values.data(), values.data() + values.size(), std::less<>{});
+	}
+}
+
+// Sorts the elements by a strict weak ordering with the pattern-defeating quicksort. Not stable.
+template<typename T, typename Compare>
+void Sort(std::span<T> values, Compare compare)
+{
+	PdqSort(values.data(), values.data() + values.size(), compare);
+}
+
+// Sorts the elements in ascending order keeping equal elements in their order. Radix sortable elements with
+// the same key have the same bits, so for them the in-place radix sort is stable too.
+template<typename T>
+void StableSort(std::span<T> values)
+{
+	if constexpr (RadixSortable<T>)
+		RadixSort(values.data(), values.data() + values.size());
+	else
+		std::stable_sort(values.begin(), values.end());
+}
+
+template<typename T, typename Compare>
+void StableSort(std::span<T> values, Compare compare)
+{
+	std::stable_sort(values.begin(), values.end(), compare);
+}
+
+#endif //_SORT_
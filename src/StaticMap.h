@@ -0,0 +1,268 @@
+#ifndef _STATICMAP_
+#define _STATICMAP_
+
+#include<algorithm>
+#include<cstdint>
+#include<functional>
+#include<span>
+#include<stdexcept>
+#include<utility>
+#include<vector>
+
+#include"Array.h"
+#include"Hash.h"
+
+template<typename StaticMap>
+class StaticMapIterator
+{
+public:
+	using ValueType = typename StaticMap::ValueType;
+	using KeyType = typename StaticMap::KeyType;
+	using ReferenceType = const ValueType&;
+	using PointerType = const ValueType*;
+
+public:
+	constexpr explicit StaticMapIterator(const KeyType* keys, const ValueType* values, size_t index) noexcept
+		: m_keys(keys), m_values(values), m_index(index) {}
+
+	constexpr ReferenceType operator*() const noexcept { return m_values[m_index]; }
+
+	constexpr ReferenceType Value() const noexcept { return m_values[m_index]; }
+	constexpr const KeyType& Key() const noexcept { return m_keys[m_index]; }
+	constexpr PointerType operator->() const noexcept { return &m_values[m_index]; }
+	constexpr bool operator==(const StaticMapIterator& other) const noexcept { return m_index == other.m_index; }
+	constexpr bool operator!=(const StaticMapIterator& other) const noexcept { return m_index != other.m_index; }
+	constexpr StaticMapIterator& operator++() noexcept
+	{
+		++m_index;
+		return *this;
+	}
+	constexpr StaticMapIterator operator++(int) noexcept
+	{
+		StaticMapIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+private:
+	const KeyType* m_keys;
+	const ValueType* m_values;
+	size_t m_index;
+};
+
+// Immutable map over a fixed key set with a minimal perfect hash computed when the map is constructed, at compile
+// time for a constexpr map. Keys and values sit in flat Arrays of exactly N slots and every key owns one slot,
+// so a lookup is one read of a small pilot table, one slot probe and one key compare, with no heap and no startup
+// work. The hash follows PTHash: keys are spread over N / 4 + 1 buckets, and each bucket gets a pilot value
+// that moves all of its keys to free slots. Hash must be constexpr and constructible from a uint64_t seed, such as
+// FastHash for integers, enums and strings.
+template<typename Key, typename Value, size_t N, typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>>
+class StaticMap
+{
+	static_assert(N > 0, "StaticMap needs at least one entry");
+
+private:
+	static constexpr size_t BucketCount = N / 4 + 1;
+	// Pilots tried per bucket before the construction starts over with the next hash seed.
+	static constexpr uint32_t MaxPilot = uint32_t{ 1 } << 20;
+	static constexpr uint64_t MaxSeed = 64;
+
+public:
+	using ValueType = Value;
+	using KeyType = Key;
+	using Entry = std::pair<Key, Value>;
+	using Iterator = StaticMapIterator<StaticMap>;
+public:
+	//Constructors
+	// Throws std::invalid_argument on a duplicate key, which makes a constexpr map with duplicates ill-formed.
+	constexpr explicit StaticMap(const Entry (&entries)[N], const KeyEqual& equal = KeyEqual())
+		: m_hash(0), m_equal(equal)
+	{
+		for (uint64_t seed = 0; seed < MaxSeed; ++seed) {
+			m_hash = Hash(seed);
+			if (Build(entries))
+				return;
+		}
+		throw std::runtime_error("StaticMap: no perfect hash found");
+	}
+
+	//Lookup
+	constexpr const Value* Find(const Key& key) const
+	{
+		size_t slot = Slot(static_cast<uint64_t>(m_hash(key)));
+		return m_equal(m_keys.Data()[slot], key) ? &m_values.Data()[slot] : nullptr;
+	}
+
+	constexpr bool Contains(const Key& key) const
+	{
+		return Find(key) != nullptr;
+	}
+
+	// Stores the value pointer of keys[i], or nullptr if it is missing, in results[i].
+	constexpr void FindBatch(std::span<const Key> keys, std::span<const Value*> results) const
+	{
+		for (size_t i = 0; i < keys.size(); ++i)
+			results[i] = Find(keys[i]);
+	}
+
+	constexpr void ContainsBatch(std::span<const Key> keys, std::span<bool> results) const
+	{
+		for (size_t i = 0; i < keys.size(); ++i)
+			results[i] = Contains(keys[i]);
+	}
+
+	//Capacity
+	// Number of slots, which equals the number of elements since the hash is minimal.
+	constexpr size_t Size() const noexcept
+	{
+		return N;
+	}
+
+	constexpr size_t Count() const noexcept
+	{
+		return N;
+	}
+
+	constexpr bool IsEmpty() const noexcept
+	{
+		return false;
+	}
+
+	constexpr float LoadFactor() const noexcept
+	{
+		return 1.0f;
+	}
+
+	//Hash policy
+	constexpr size_t HashFunction(const Key& key) const
+	{
+		return m_hash(key);
+	}
+
+	constexpr const Hash& HashFunctionObject() const noexcept
+	{
+		return m_hash;
+	}
+
+	constexpr const KeyEqual& KeyEqualFunction() const noexcept
+	{
+		return m_equal;
+	}
+
+	//Iterators
+	constexpr Iterator begin() const noexcept
+	{
+		return Iterator(m_keys.Data(), m_values.Data(), 0);
+	}
+
+	constexpr Iterator end() const noexcept
+	{
+		return Iterator(m_keys.Data(), m_values.Data(), N);
+	}
+
+private:
+	// Both divisors are compile-time constants, so the remainders compile to multiplications.
+	static constexpr size_t BucketOf(uint64_t hash) noexcept
+	{
+		return static_cast<size_t>((hash >> 32) % BucketCount);
+	}
+
+	// The pilot reseeds a full mix of the hash; a plain xor would leave keys that agree in the bits the
+	// remainder depends on in the same slot for every pilot.
+	static constexpr size_t Position(uint64_t hash, uint32_t pilot) noexcept
+	{
+		return static_cast<size_t>(HashMix64(hash, pilot) % N);
+	}
+
+	constexpr size_t Slot(uint64_t hash) const noexcept
+	{
+		return Position(hash, m_pilots.Data()[BucketOf(hash)]);
+	}
+
+	// Assigns pilots to the buckets, largest first, and places the entries. Returns false if the current seed
+	// has to be replaced, either because two keys share a full hash or because a bucket found no pilot.
+	constexpr bool Build(const Entry (&entries)[N])
+	{
+		std::vector<uint64_t> hashes(N);
+		std::vector<size_t> bucketStart(BucketCount + 1, 0);
+		for (size_t i = 0; i < N; ++i) {
+			hashes[i] = static_cast<uint64_t>(m_hash(entries[i].first));
+			++bucketStart[BucketOf(hashes[i]) + 1];
+		}
+
+		size_t largest = 0;
+		for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+			largest = std::max(largest, bucketStart[bucket + 1]);
+			bucketStart[bucket + 1] += bucketStart[bucket];
+		}
+
+		std::vector<size_t> members(N);
+		std::vector<size_t> filled(bucketStart.begin(), bucketStart.end() - 1);
+		for (size_t i = 0; i < N; ++i)
+			members[filled[BucketOf(hashes[i])]++] = i;
+
+		std::vector<bool> taken(N, false);
+		std::vector<size_t> positions(largest);
+		for (size_t size = largest; size > 0; --size) {
+			for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+				size_t first = bucketStart[bucket];
+				if (bucketStart[bucket + 1] - first != size)
+					continue;
+
+				for (size_t i = 0; i < size; ++i) {
+					for (size_t j = 0; j < i; ++j) {
+						const Entry& a = entries[members[first + i]];
+						const Entry& b = entries[members[first + j]];
+						if (hashes[members[first + i]] != hashes[members[first + j]])
+							continue;
+						if (m_equal(a.first, b.first))
+							throw std::invalid_argument("StaticMap: duplicate key");
+						return false;
+					}
+				}
+
+				uint32_t pilot = 0;
+				for (; pilot < MaxPilot; ++pilot) {
+					bool placed = true;
+					for (size_t i = 0; i < size && placed; ++i) {
+						positions[i] = Position(hashes[members[first + i]], pilot);
+						placed = !taken[positions[i]];
+						for (size_t j = 0; j < i && placed; ++j)
+							placed = positions[j] != positions[i];
+					}
+					if (placed) {
+						for (size_t i = 0; i < size; ++i)
+							taken[positions[i]] = true;
+						m_pilots[bucket] = pilot;
+						break;
+					}
+				}
+				if (pilot == MaxPilot)
+					return false;
+			}
+		}
+
+		for (size_t i = 0; i < N; ++i) {
+			size_t slot = Slot(hashes[i]);
+			m_keys[slot] = entries[i].first;
+			m_values[slot] = entries[i].second;
+		}
+		return true;
+	}
+
+private:
+	Array<Key, N> m_keys;
+	Array<Value, N> m_values;
+	Array<uint32_t, BucketCount> m_pilots;
+	Hash m_hash;
+	KeyEqual m_equal;
+};
+
+// Deduces the entry count from a braced list:
+//     constexpr auto methods = MakeStaticMap<std::string_view, int>({ { "GET", 1 }, { "PUT", 2 } });
+template<typename Key, typename Value, typename Hash = FastHash<Key>, typename KeyEqual = std::equal_to<Key>, size_t N>
+constexpr StaticMap<Key, Value, N, Hash, KeyEqual> MakeStaticMap(const std::pair<Key, Value> (&entries)[N])
+{
+	return StaticMap<Key, Value, N, Hash, KeyEqual>(entries);
+}
+
+#endif //_STATICMAP_
@@ -0,0 +1,282 @@
+#ifndef _THREADPOOL_
+#define _THREADPOOL_
+
+#include<algorithm>
+#include<atomic>
+#include<condition_variable>
+#include<cstddef>
+#include<deque>
+#include<exception>
+#include<memory>
+#include<mutex>
+#include<thread>
+
+// Fork-join thread pool with work stealing. Every worker owns a deque of tasks: it pushes and pops at the back,
+// so it keeps working on the most recently split and still cache-warm range, while idle workers steal from the
+// front, where the oldest and therefore largest pieces of work are. Join is the only way to create parallel
+// work: it makes its first function stealable, runs the second itself and, while the first is still running
+// elsewhere, executes other tasks instead of blocking. Tasks live in the stack frame of their Join, so splitting
+// work never allocates.
+class ThreadPool
+{
+private:
+	// execute runs the task, stores its exception and sets done, which must be the last access to the task:
+	// the frame that owns it may return as soon as done is set.
+	struct Task
+	{
+		void (*execute)(Task*);
+		std::atomic<bool> done{ false };
+		std::exception_ptr error;
+	};
+
+	template<typename Function>
+	struct FunctionTask : Task
+	{
+		explicit FunctionTask(Function& function) : function(function)
+		{
+			this->execute = [](Task* task) {
+				static_cast<FunctionTask*>(task)->Invoke();
+				task->done.store(true, std::memory_order_release);
+			};
+		}
+
+		void Invoke() noexcept
+		{
+			try {
+				function();
+			}
+			catch (...) {
+				this->error = std::current_exception();
+			}
+		}
+
+		Function& function;
+	};
+
+	// Task submitted from outside the pool, whose submitter sleeps until it is done.
+	template<typename Function>
+	struct ExternalTask : FunctionTask<Function>
+	{
+		explicit ExternalTask(Function& function) : FunctionTask<Function>(function)
+		{
+			this->execute = [](Task* task) {
+				ExternalTask* external = static_cast<ExternalTask*>(task);
+				external->Invoke();
+				std::lock_guard lock(external->mutex);
+				task->done.store(true, std::memory_order_release);
+				external->finished.notify_one();
+			};
+		}
+
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	struct alignas(64) WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<Task*> tasks;
+	};
+
+	// The pool and queue of the worker running on this thread; zero on other threads.
+	struct WorkerContext
+	{
+		ThreadPool* pool;
+		size_t index;
+	};
+
+public:
+	explicit ThreadPool(size_t threads = DefaultThreadCount())
+		: m_queues(std::make_unique<WorkerQueue[]>(std::max<size_t>(threads, 1))),
+		m_threads(std::max<size_t>(threads, 1)), m_workers(std::make_unique<std::thread[]>(m_threads)),
+		m_queued(0), m_sleeping(0), m_stopping(false)
+	{
+		for (size_t i = 0; i < m_threads; ++i)
+			m_workers[i] = std::thread([this, i] { WorkerLoop(i); });
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard lock(m_sleepMutex);
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		for (size_t i = 0; i < m_threads; ++i)
+			m_workers[i].join();
+	}
+
+	// Pool used by the parallel algorithms unless they are given another one, with one worker per hardware
+	// thread. It is created on first use.
+	static ThreadPool& Shared()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	static size_t DefaultThreadCount() noexcept
+	{
+		return std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+	}
+
+	size_t ThreadCount() const noexcept
+	{
+		return m_threads;
+	}
+
+	// Runs function on a worker of this pool and returns once it has finished, rethrowing its exception. Called
+	// from a worker of this pool, it runs function directly.
+	template<typename Function>
+	void Execute(Function&& function)
+	{
+		if (t_context.pool == this) {
+			function();
+			return;
+		}
+
+		ExternalTask<Function> task(function);
+		{
+			std::lock_guard lock(m_queues[0].mutex);
+			m_queues[0].tasks.push_front(&task);
+		}
+		Notify();
+		{
+			std::unique_lock lock(task.mutex);
+			task.finished.wait(lock, [&] { return task.done.load(std::memory_order_acquire); });
+		}
+		if (task.error)
+			std::rethrow_exception(task.error);
+	}
+
+	// Runs both functions, possibly in parallel, and returns once both have finished. If either throws, the
+	// exception is rethrown after both have finished; if both throw, the one from first wins.
+	template<typename First, typename Second>
+	void Join(First&& first, Second&& second)
+	{
+		if (t_context.pool != this) {
+			Execute([&] { Join(first, second); });
+			return;
+		}
+
+		WorkerQueue& queue = m_queues[t_context.index];
+		FunctionTask<First> task(first);
+		{
+			std::lock_guard lock(queue.mutex);
+			queue.tasks.push_back(&task);
+		}
+		Notify();
+
+		std::exception_ptr error;
+		try {
+			second();
+		}
+		catch (...) {
+			error = std::current_exception();
+		}
+
+		// Unless a thief took it, the task is still at the back of the queue.
+		bool popped = false;
+		{
+			std::lock_guard lock(queue.mutex);
+			if (!queue.tasks.empty() && queue.tasks.back() == &task) {
+				queue.tasks.pop_back();
+				popped = true;
+			}
+		}
+		if (popped) {
+			m_queued.fetch_sub(1, std::memory_order_relaxed);
+			Run(&task);
+		}
+		else {
+			while (!task.done.load(std::memory_order_acquire)) {
+				if (Task* other = FindTask(t_context.index))
+					Run(other);
+				else
+					std::this_thread::yield();
+			}
+		}
+
+		if (task.error)
+			std::rethrow_exception(task.error);
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+private:
+	static void Run(Task* task) noexcept
+	{
+		task->execute(task);
+	}
+
+	// Wakes a sleeping worker after a task was queued. The counter is incremented before the sleepers are
+	// checked and a worker registers as sleeping before it checks the counter, so one of them sees the other.
+	void Notify()
+	{
+		m_queued.fetch_add(1);
+		if (m_sleeping.load() > 0) {
+			std::lock_guard lock(m_sleepMutex);
+			m_wake.notify_one();
+		}
+	}
+
+	// Pops from the back of the own queue, or else steals from the front of another.
+	Task* FindTask(size_t index)
+	{
+		if (m_queued.load(std::memory_order_relaxed) == 0)
+			return nullptr;
+
+		for (size_t i = 0; i < m_threads; ++i) {
+			WorkerQueue& queue = m_queues[(index + i) % m_threads];
+			std::lock_guard lock(queue.mutex);
+			if (!queue.tasks.empty()) {
+				Task* task;
+				if (i == 0) {
+					task = queue.tasks.back();
+					queue.tasks.pop_back();
+				}
+				else {
+					task = queue.tasks.front();
+					queue.tasks.pop_front();
+				}
+				m_queued.fetch_sub(1, std::memory_order_relaxed);
+				return task;
+			}
+		}
+		return nullptr;
+	}
+
+	void WorkerLoop(size_t index)
+	{
+		t_context = WorkerContext{ this, index };
+		while (true) {
+			if (Task* task = FindTask(index)) {
+				Run(task);
+				continue;
+			}
+
+			std::unique_lock lock(m_sleepMutex);
+			m_sleeping.fetch_add(1);
+			m_wake.wait(lock, [this] { return m_stopping || m_queued.load() > 0; });
+			m_sleeping.fetch_sub(1);
+			if (m_stopping)
+				return;
+		}
+	}
+
+private:
+	static inline thread_local WorkerContext t_context;
+
+	std::unique_ptr<WorkerQueue[]> m_queues;
+	size_t m_threads;
+	std::unique_ptr<std::thread[]> m_workers;
+	std::atomic<size_t> m_queued;
+	std::atomic<size_t> m_sleeping;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wake;
+	bool m_stopping;
+};
+
+#endif //_THREADPOOL_
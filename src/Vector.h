@@ -1,9 +1,22 @@
 #ifndef _VECTOR_
 #define _VECTOR_
 
+#include<algorithm>
+#include<concepts>
+#include<cstring>
+#include<initializer_list>
+#include<iterator>
+#include<memory>
+#include<memory_resource>
+#include<new>
+#include<span>
 #include<stdexcept>
+#include<type_traits>
 #include<utility>
 
+#include"Algorithms.h"
+#include"Sort.h"
+
 template<typename Vector>
 class BaseVecIterator
 {
@@ -79,58 +92,107 @@ public:
 	}
 };
 
+// Growth policy of Vector: Capacity(current, required) returns the capacity to grow to when required elements
+// no longer fit in current. It multiplies the capacity by Numerator / Denominator, which keeps PushBack amortized
+// O(1) for any factor above one; 2 minimizes reallocations, while factors closer to 1 waste less memory.
+template<size_t Numerator = 2, size_t Denominator = 1>
+struct GeometricGrowth
+{
+	static_assert(Numerator > Denominator, "a growth factor must be greater than one");
+
+	static constexpr size_t Capacity(size_t current, size_t required) noexcept
+	{
+		return std::max(required, std::max<size_t>(current * Numerator / Denominator, current + 1));
+	}
+};
+
+// Types whose objects can be moved to another address with memcpy, without running the move constructor and
+// destructor. Every trivially copyable type qualifies; specialize it for types such as ones holding a unique
+// pointer that are safe to relocate bitwise as well.
+template<typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+// Allocators that can resize a block in place, or move it without touching its bytes, provide
+// reallocate(data, oldCount, newCount). Vector grows through it when its elements are trivially relocatable.
+template<typename Allocator, typename T>
+concept ReallocatingAllocator = requires(Allocator& allocator, T* data, size_t count) {
+	{ allocator.reallocate(data, count, count) } -> std::same_as<T*>;
+};
+
+// Moves count objects to uninitialized memory at to and ends the lifetime of the originals.
 template<typename T>
+void RelocateElements(T* from, size_t count, T* to) noexcept(IsTriviallyRelocatable<T>::value || std::is_nothrow_move_constructible_v<T>)
+{
+	if constexpr (IsTriviallyRelocatable<T>::value) {
+		if (count > 0)
+			std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+	}
+	else {
+		std::uninitialized_move_n(from, count, to);
+		std::destroy_n(from, count);
+	}
+}
+
+// Elements live in raw storage and are only constructed when they are added, so growing never default-constructs
+// spare slots and relocating trivially relocatable elements is one memcpy. Growth follows the Growth policy and
+// storage comes from Allocator, which also constructs non-trivially-copyable elements; trivially copyable ones
+// are filled and copied in bulk.
+template<typename T, typename Growth = GeometricGrowth<>, typename Allocator = std::allocator<T>>
 class Vector
 {
+	using AllocatorTraits = std::allocator_traits<Allocator>;
+	static_assert(std::is_same_v<typename AllocatorTraits::pointer, T*>, "Vector needs an allocator of raw pointers");
+
 public:
 	using ValueType = T;
-	using Iterator = VecIterator<Vector<T>>;
-	using ReverseIterator = VecReverseIterator<Vector<T>>;
+	using AllocatorType = Allocator;
+	using Iterator = VecIterator<Vector>;
+	using ReverseIterator = VecReverseIterator<Vector>;
 public:
 	//Constructors
-	Vector()
-		: m_data{ new T[1] }, m_size{ 0 }, m_capacity{ 1 } {};
+	Vector() : Vector(Allocator()) {}
 
-	Vector(size_t size, const T& value)
-		: m_data{ new T[size] {} }, m_size{ size }, m_capacity{ size * 2 }
+	explicit Vector(const Allocator& allocator)
+		: Vector(allocator, 1) {}
+
+	Vector(size_t size, const T& value, const Allocator& allocator = Allocator())
+		: Vector(allocator, size)
 	{
-		for (size_t i = 0; i < m_size; ++i)
-			m_data[i] = value;
+		ConstructFill(m_data, size, value);
+		m_size = size;
 	}
 
-	Vector(std::initializer_list<T> list)
-		: m_data{ new T[list.size()] }, m_size(list.size()), m_capacity(list.size() * 2)
+	Vector(std::initializer_list<T> list, const Allocator& allocator = Allocator())
+		: Vector(allocator, list.size())
 	{
-		size_t index = 0;
-		for (const auto& element : list) {
-			if (index < m_size)
-				m_data[index++] = std::move(element);
-			else
-				throw std::runtime_error("Buffer overrun detected!");
-		}
+		ConstructCopy(list.begin(), list.end(), m_data);
+		m_size = list.size();
 	}
 
 	~Vector()
 	{
 		Clear();
+		Free(m_data, m_capacity);
 	}
 
 	//Copy Constructor
-	Vector(const Vector& other) : Vector()
+	Vector(const Vector& other)
+		: Vector(other, AllocatorTraits::select_on_container_copy_construction(other.m_allocator)) {}
+
+	Vector(const Vector& other, const Allocator& allocator)
+		: Vector(allocator, other.m_size)
 	{
+		ConstructCopy(other.m_data, other.m_data + other.m_size, m_data);
 		m_size = other.m_size;
-		m_capacity = other.m_capacity;
-		for (size_t i = 0; i < m_size; ++i)
-			m_data[i] = other.m_data[i];
 	}
 
 	//Move Constructor
 	Vector(Vector&& other) noexcept
-		:m_size(other.m_size), m_data(other.m_data), m_capacity(other.m_capacity)
+		: m_allocator(other.m_allocator), m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity)
 	{
 		other.m_data = nullptr;
 		other.m_size = 0;
-		other.m_capacity = 1;
+		other.m_capacity = 0;
 	}
 
 	//Operators
@@ -150,20 +212,43 @@ public:
 	//Copy assigment operator using "copy and swap" idiom
 	Vector& operator=(const Vector& other)
 	{
-		Vector copy(other);
-		Swap(copy);
+		if (this == &other)
+			return *this;
+
+		constexpr bool propagate = AllocatorTraits::propagate_on_container_copy_assignment::value;
+		Vector copy(other, propagate ? other.m_allocator : m_allocator);
+		SwapStorage(copy);
+		if constexpr (propagate)
+			std::swap(m_allocator, copy.m_allocator);
 		return *this;
 	}
 	//Move assigment operator using "move and swap" idiom
-	Vector& operator=(Vector&& other) noexcept
+	Vector& operator=(Vector&& other) noexcept(AllocatorTraits::propagate_on_container_move_assignment::value
+		|| AllocatorTraits::is_always_equal::value)
 	{
+		constexpr bool propagate = AllocatorTraits::propagate_on_container_move_assignment::value;
+		if constexpr (!propagate && !AllocatorTraits::is_always_equal::value) {
+			// Storage of another allocator cannot be adopted, so the elements move one by one.
+			if (m_allocator != other.m_allocator) {
+				Vector moved(m_allocator, other.m_size);
+				moved.Append(std::make_move_iterator(other.m_data), std::make_move_iterator(other.m_data + other.m_size));
+				SwapStorage(moved);
+				return *this;
+			}
+		}
+
 		Vector moved(std::move(other));
-		Swap(moved);
+		SwapStorage(moved);
+		if constexpr (propagate)
+			std::swap(m_allocator, moved.m_allocator);
 		return *this;
 	}
 
 	bool operator==(const Vector& other) const
 	{
+		if constexpr (std::is_arithmetic_v<T>)
+			return Equal(Span(), other.Span());
+
 		if (m_size != other.m_size)
 			return false;
 
@@ -194,49 +279,180 @@ public:
 		return m_capacity;
 	}
 
+	// Makes room for at least capacity elements, allocating exactly that much if it has to grow.
+	void Reserve(size_t capacity)
+	{
+		if (capacity > m_capacity)
+			Realloc(capacity);
+	}
+
+	// Releases the capacity beyond the current size.
+	void ShrinkToFit()
+	{
+		if (m_capacity > m_size)
+			Realloc(m_size);
+	}
+
+	//Element access
+	T* Data() noexcept
+	{
+		return m_data;
+	}
+	const T* Data() const noexcept
+	{
+		return m_data;
+	}
+
+	std::span<T> Span() noexcept
+	{
+		return std::span<T>(m_data, m_size);
+	}
+	std::span<const T> Span() const noexcept
+	{
+		return std::span<const T>(m_data, m_size);
+	}
+
+	Allocator GetAllocator() const noexcept
+	{
+		return m_allocator;
+	}
+
+	//Algorithms
+	// Vectorized versions of the Algorithms.h functions over the elements.
+	T Sum() const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::Sum(Span());
+	}
+	MinMaxResult<T> MinMax() const requires std::is_arithmetic_v<T>
+	{
+		return ::MinMax(Span());
+	}
+	bool Find(const T& value) const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::Find(Span(), value);
+	}
+	size_t IndexOf(const T& value) const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::IndexOf(Span(), value);
+	}
+	size_t Count(const T& value) const noexcept requires std::is_arithmetic_v<T>
+	{
+		return ::Count(Span(), value);
+	}
+	T Dot(const Vector& other) const requires std::is_arithmetic_v<T>
+	{
+		return ::Dot(Span(), other.Span());
+	}
+	// Replaces every element with function(element).
+	template<typename Function>
+	void Transform(Function function)
+	{
+		::Transform<T, T>(Span(), Span(), function);
+	}
+	// Replaces every element with function(element, other[i]); throws std::invalid_argument if the sizes differ.
+	template<typename U, typename UGrowth, typename UAllocator, typename Function>
+	void Transform(const Vector<U, UGrowth, UAllocator>& other, Function function)
+	{
+		::Transform<T, U, T>(Span(), other.Span(), Span(), function);
+	}
+
+	// Sorts in place: radix sort for integers, floating-point numbers and enums, a pattern-defeating quicksort
+	// otherwise and whenever a comparator is given. See Sort.h.
+	void Sort()
+	{
+		::Sort(Span());
+	}
+	template<typename Compare>
+	void Sort(Compare compare)
+	{
+		::Sort(Span(), compare);
+	}
+	void StableSort()
+	{
+		::StableSort(Span());
+	}
+	template<typename Compare>
+	void StableSort(Compare compare)
+	{
+		::StableSort(Span(), compare);
+	}
+
 	//Modifiers
 	constexpr void PushBack(const T& value)
 	{
-		if (m_size >= m_capacity)
-			Realloc(m_capacity + m_capacity / 2);
-
-		m_data[m_size] = value;
-		m_size++;
+		EmplaceBack(value);
 	}
 	constexpr void PushBack(T&& value)
 	{
-		if (m_size >= m_capacity)
-			Realloc(m_capacity * 2);
-
-		m_data[m_size] = std::move(value);
-		m_size++;
+		EmplaceBack(std::move(value));
 	}
 	template<typename... Args>
 	constexpr T& EmplaceBack(Args&&... args)
 	{
-		if (m_size >= m_capacity)
-			Realloc(m_capacity * 2);
-		new(&m_data[m_size]) T(std::forward<Args>(args)...);
-		return m_data[m_size++];
+		if (m_size == m_capacity)
+			return GrowAndEmplaceBack(std::forward<Args>(args)...);
+
+		T* element = m_data + m_size;
+		AllocatorTraits::construct(m_allocator, element, std::forward<Args>(args)...);
+		++m_size;
+		return *element;
 	}
 	constexpr void PopBack()
 	{
 		if (m_size > 0) {
 			m_size--;
-			m_data[m_size].~T();
+			AllocatorTraits::destroy(m_allocator, m_data + m_size);
 		}
 	}
 
+	// Appends the elements of [first, last). With forward iterators the storage grows at most once and
+	// trivially copyable ranges are copied in bulk.
+	template<typename InputIterator>
+	void Append(InputIterator first, InputIterator last)
+	{
+		using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+			size_t count = static_cast<size_t>(std::distance(first, last));
+			if (m_size + count > m_capacity)
+				return GrowAndAppend(first, last, count);
+			ConstructCopy(first, last, m_data + m_size);
+			m_size += count;
+		}
+		else {
+			for (; first != last; ++first)
+				EmplaceBack(*first);
+		}
+	}
+
+	// Value-initializes new elements when growing, so new arithmetic elements are zero.
+	void Resize(size_t size)
+	{
+		ResizeWith(size, [this](T* first, size_t count) { ConstructValues(first, count); });
+	}
+
+	// value may be an element of this vector, so it is copied before growing frees the old storage.
+	void Resize(size_t size, const T& value)
+	{
+		if (size > m_capacity) {
+			T copy(value);
+			ResizeWith(size, [this, &copy](T* first, size_t count) { ConstructFill(first, count, copy); });
+			return;
+		}
+		ResizeWith(size, [this, &value](T* first, size_t count) { ConstructFill(first, count, value); });
+	}
+
 	//Operations
 	constexpr void Clear() noexcept
 	{
-		while (!Empty()) PopBack();
+		Destroy(m_data, m_size);
+		m_size = 0;
 	}
+	// Swaps the allocators only if the allocator propagates on swap; otherwise both must compare equal.
 	constexpr void Swap(Vector& other) noexcept
 	{
-		std::swap(m_size, other.m_size);
-		std::swap(m_capacity, other.m_capacity);
-		std::swap(m_data, other.m_data);
+		SwapStorage(other);
+		if constexpr (AllocatorTraits::propagate_on_container_swap::value)
+			std::swap(m_allocator, other.m_allocator);
 	}
 
 	//Iterators
@@ -246,27 +462,178 @@ public:
 	ReverseIterator rend() { return ReverseIterator(m_data - 1); };
 
 private:
+	// Empty vector with storage for capacity elements. The filling constructors delegate to it, so the
+	// destructor releases the storage if filling throws.
+	Vector(const Allocator& allocator, size_t capacity)
+		: m_allocator(allocator), m_data{ Allocate(capacity) }, m_size{ 0 }, m_capacity{ capacity } {}
+
+	T* Allocate(size_t capacity)
+	{
+		return capacity > 0 ? AllocatorTraits::allocate(m_allocator, capacity) : nullptr;
+	}
+
+	void Free(T* data, size_t capacity) noexcept
+	{
+		if (data != nullptr)
+			AllocatorTraits::deallocate(m_allocator, data, capacity);
+	}
+
+	void Destroy(T* first, size_t count) noexcept
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			for (size_t i = 0; i < count; ++i)
+				AllocatorTraits::destroy(m_allocator, first + i);
+		}
+	}
+
+	// Calls construct(element) for count uninitialized elements from first and destroys the constructed ones
+	// if it throws.
+	template<typename Construct>
+	void ConstructEach(T* first, size_t count, Construct construct)
+	{
+		size_t constructed = 0;
+		try {
+			for (; constructed < count; ++constructed)
+				construct(first + constructed);
+		}
+		catch (...) {
+			Destroy(first, constructed);
+			throw;
+		}
+	}
+
+	template<typename InputIterator>
+	void ConstructCopy(InputIterator first, InputIterator last, T* to)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+			std::uninitialized_copy(first, last, to);
+		else
+			ConstructEach(to, static_cast<size_t>(std::distance(first, last)), [this, &first](T* element) {
+				AllocatorTraits::construct(m_allocator, element, *first);
+				++first;
+			});
+	}
+
+	void ConstructFill(T* first, size_t count, const T& value)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+			std::uninitialized_fill_n(first, count, value);
+		else
+			ConstructEach(first, count, [this, &value](T* element) { AllocatorTraits::construct(m_allocator, element, value); });
+	}
+
+	void ConstructValues(T* first, size_t count)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+			std::uninitialized_value_construct_n(first, count);
+		else
+			ConstructEach(first, count, [this](T* element) { AllocatorTraits::construct(m_allocator, element); });
+	}
+
+	static constexpr bool ReallocatesInPlace = IsTriviallyRelocatable<T>::value && ReallocatingAllocator<Allocator, T>;
+
+	// Moves the elements to new storage of exactly newCapacity elements, which must hold all of them.
 	void Realloc(size_t newCapacity)
 	{
-		T* newData = (T*)::operator new(newCapacity * sizeof(T));
-		if (newCapacity < m_size)
-			m_size = newCapacity;
+		if constexpr (ReallocatesInPlace) {
+			m_data = m_allocator.reallocate(m_data, m_capacity, newCapacity);
+			m_capacity = newCapacity;
+			return;
+		}
+
+		T* newData = Allocate(newCapacity);
+		RelocateElements(m_data, m_size, newData);
+		Free(m_data, m_capacity);
+		m_data = newData;
+		m_capacity = newCapacity;
+	}
 
-		for (size_t i = 0; i < m_size; ++i)
-			newData[i] = std::move(m_data[i]);
+	// The new element is constructed before the old ones move, so arguments that refer to an element of this
+	// vector stay valid.
+	template<typename... Args>
+	T& GrowAndEmplaceBack(Args&&... args)
+	{
+		size_t newCapacity = Growth::Capacity(m_capacity, m_size + 1);
+		if constexpr (ReallocatesInPlace) {
+			T value(std::forward<Args>(args)...);
+			Realloc(newCapacity);
+			T* element = m_data + m_size;
+			AllocatorTraits::construct(m_allocator, element, value);
+			++m_size;
+			return *element;
+		}
 
-		for (size_t i = 0; i < m_size; ++i)
-			m_data[i].~T();
+		T* newData = Allocate(newCapacity);
+		T* element = newData + m_size;
+		try {
+			AllocatorTraits::construct(m_allocator, element, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			Free(newData, newCapacity);
+			throw;
+		}
 
-		::operator delete (m_data, m_capacity * sizeof(T));
+		RelocateElements(m_data, m_size, newData);
+		Free(m_data, m_capacity);
 		m_data = newData;
 		m_capacity = newCapacity;
+		++m_size;
+		return *element;
+	}
+
+	// Like GrowAndEmplaceBack, the new elements are copied before the old ones move, so the range may be part of
+	// this vector. Storage is never reallocated in place here, since that could free the range before the copy.
+	template<typename ForwardIterator>
+	void GrowAndAppend(ForwardIterator first, ForwardIterator last, size_t count)
+	{
+		size_t newCapacity = Growth::Capacity(m_capacity, m_size + count);
+		T* newData = Allocate(newCapacity);
+		try {
+			ConstructCopy(first, last, newData + m_size);
+		}
+		catch (...) {
+			Free(newData, newCapacity);
+			throw;
+		}
+
+		RelocateElements(m_data, m_size, newData);
+		Free(m_data, m_capacity);
+		m_data = newData;
+		m_capacity = newCapacity;
+		m_size += count;
+	}
+
+	template<typename Construct>
+	void ResizeWith(size_t size, Construct construct)
+	{
+		if (size <= m_size) {
+			Destroy(m_data + size, m_size - size);
+			m_size = size;
+			return;
+		}
+
+		if (size > m_capacity)
+			Realloc(Growth::Capacity(m_capacity, size));
+		construct(m_data + m_size, size - m_size);
+		m_size = size;
+	}
+
+	constexpr void SwapStorage(Vector& other) noexcept
+	{
+		std::swap(m_size, other.m_size);
+		std::swap(m_capacity, other.m_capacity);
+		std::swap(m_data, other.m_data);
 	}
 
 private:
+	[[no_unique_address]] Allocator m_allocator;
 	T* m_data;
 	size_t m_size;
 	size_t m_capacity;
 };
 
-#endif //_VECTOR_
\ No newline at end of file
+// Vector whose storage comes from a std::pmr::memory_resource, such as a MonotonicArena or a PoolResource.
+template<typename T, typename Growth = GeometricGrowth<>>
+using PmrVector = Vector<T, Growth, std::pmr::polymorphic_allocator<T>>;
+
+#endif //_VECTOR_
@@ -1,13 +1,54 @@
 ﻿#include<iostream>
+#include<algorithm>
+#include<atomic>
 #include<cassert>
-
+#include<cctype>
+#include<cmath>
+#include<filesystem>
+#include<fstream>
+#include<functional>
+#include<iterator>
+#include<numeric>
+#include<random>
+#include<sstream>
+#include<string>
+#include<thread>
+#include<vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include<sys/wait.h>
+#include<unistd.h>
+#endif
+
+#include"Algorithms.h"
 #include"Array.h"
+#include"BitVector.h"
+#include"BloomFilter.h"
+#include"Cache.h"
+#include"ConcurrentVector.h"
 #include"Vector.h"
+#include"SmallVector.h"
+#include"SegmentedVector.h"
+#include"SoAVector.h"
 #include"LinkedList.h"
 #include"Stack.h"
 #include"Queue.h"
 #include"BinaryTree.h"
 #include"HashTable.h"
+#include"HashTableSnapshot.h"
+#include"FlatHashMap.h"
+#include"LockFreeHashMap.h"
+#include"MappedVector.h"
+#include"MemoryResource.h"
+#include"PersistentVector.h"
+#include"PageAllocator.h"
+#include"RoaringBitmap.h"
+#include"ParallelAlgorithms.h"
+#include"ThreadPool.h"
+#include"ShardedCache.h"
+#include"ShardedHashTable.h"
+#include"SharedHashTable.h"
+#include"StaticMap.h"
 
 void ArrayTests()
 {
@@ -97,6 +138,194 @@ void ArrayTests()
     // All tests passed
     std::cout << "All Array tests passed!\n";
 }
+template<typename T>
+void CheckAlgorithms(const Vector<T>& values, T present, T absent)
+{
+    std::span<const T> span = values.Span();
+    assert(values.Sum() == ScalarSum(span));
+    assert(values.IndexOf(present) == ScalarIndexOf(span, present));
+    assert(values.IndexOf(absent) == NotFound && !values.Find(absent));
+    assert(values.Count(present) == ScalarCount(span, present));
+    assert(values.Dot(values) == ScalarDot(span, span));
+    if (!values.Empty()) {
+        MinMaxResult<T> minMax = values.MinMax();
+        MinMaxResult<T> expected = ScalarMinMax(span);
+        assert(minMax.min == expected.min && minMax.max == expected.max);
+    }
+
+    Vector<T> copy(values);
+    assert(copy == values);
+    for (size_t i = 0; i < copy.Size(); i += 7) {
+        copy[i] = absent;
+        assert(!Equal<T>(copy.Span(), span) && copy != values);
+        copy[i] = values[i];
+    }
+}
+
+void AlgorithmsTests()
+{
+    // Test every instruction set against the scalar loops, on sizes around the register and unroll widths
+    SimdIsa detected = ActiveSimdIsa();
+    for (SimdIsa isa : { SimdIsa::Scalar, SimdIsa::Vector128, SimdIsa::Avx2, SimdIsa::Avx512 }) {
+        SetSimdIsa(isa);
+        std::mt19937 random(42);
+        for (size_t size : { 0, 1, 3, 15, 16, 17, 63, 64, 65, 255, 1000 }) {
+            Vector<int32_t> ints;
+            Vector<uint8_t> bytes;
+            Vector<double> doubles;
+            for (size_t i = 0; i < size; ++i) {
+                ints.PushBack(static_cast<int32_t>(random() % 2001) - 1000);
+                bytes.PushBack(static_cast<uint8_t>(random() % 200));
+                doubles.PushBack(static_cast<double>(random() % 1000));
+            }
+            CheckAlgorithms<int32_t>(ints, size > 0 ? ints[size / 2] : 0, 5000);
+            CheckAlgorithms<uint8_t>(bytes, size > 0 ? bytes[size - 1] : 0, 255);
+            CheckAlgorithms<double>(doubles, size > 0 ? doubles[0] : 0.0, -1.0);
+        }
+
+        // Test integer sums wrap and narrow counters do not overflow
+        Vector<uint64_t> large(100, UINT64_MAX);
+        assert(large.Sum() == static_cast<uint64_t>(-100));
+        Vector<int8_t> many(100000, 3);
+        assert(many.Count(3) == 100000 && many.Sum() == static_cast<int8_t>(300000));
+
+        // Test floating-point comparisons follow ==
+        Vector<float> floats{ 1.0f, -0.0f, 2.0f };
+        assert(floats.IndexOf(0.0f) == 1 && floats.MinMax().max == 2.0f);
+        Vector<float> nans(40, std::nanf(""));
+        assert(nans != nans && !nans.Find(std::nanf("")));
+
+        // Test Transform, including in place
+        Vector<float> squares(100, 0.0f);
+        for (size_t i = 0; i < 100; ++i)
+            squares[i] = static_cast<float>(i);
+        Transform<float, float>(squares.Span(), squares.Span(), [](float x) { return x * x; });
+        assert(squares[9] == 81.0f && squares.Sum() == 328350.0f);
+
+        // Test the two-input Transform, in place, and PopCount
+        Vector<uint64_t> words(37, 0xFF00FF00FF00FF00ull);
+        Vector<uint64_t> masks(37, 0x0FF00FF00FF00FF0ull);
+        Transform<uint64_t, uint64_t, uint64_t>(words.Span(), masks.Span(), words.Span(),
+            [](uint64_t first, uint64_t second) { return first & second; });
+        assert(words[36] == 0x0F000F000F000F00ull && PopCount(words.Span()) == 37 * 16);
+
+        // Test the Transform members of Vector and Array
+        squares.Transform([](float x) { return x + 1.0f; });
+        assert(squares[9] == 82.0f && squares.Sum() == 328450.0f);
+        words.Transform(masks, [](uint64_t first, uint64_t second) { return first ^ second; });
+        assert(words[0] == 0x00F000F000F000F0ull);
+        Array<int, 5> odd{ 1, 3, 5, 7, 9 };
+        Array<int, 5> even{ 2, 4, 6, 8, 10 };
+        odd.Transform([](int x) { return x * 10; });
+        odd.Transform(even, [](int first, int second) { return first + second; });
+        assert(odd[0] == 12 && odd[4] == 100 && odd.Sum() == 280);
+    }
+    SetSimdIsa(detected);
+    assert(ActiveSimdIsa() == detected);
+
+    // Test Array members, which also work in constant expressions
+    constexpr Array<int, 5> array{ 4, -2, 9, 9, 1 };
+    static_assert(array.Sum() == 21 && array.IndexOf(9) == 2 && array.Count(9) == 2);
+    static_assert(array.MinMax().min == -2 && array.Dot(array) == 183);
+    assert(array.Find(1) && !array.Find(3));
+
+    std::cout << "All Algorithms tests passed!" << std::endl;
+}
+
+// Sorts copies of values with Sort and StableSort, with and without a comparator, and checks them against std::sort.
+template<typename T>
+void CheckSort(const Vector<T>& values)
+{
+    std::vector<T> expected(values.Data(), values.Data() + values.Size());
+    std::sort(expected.begin(), expected.end());
+    auto matches = [&expected](const Vector<T>& sorted) {
+        return sorted.Size() == expected.size() && std::equal(sorted.Data(), sorted.Data() + sorted.Size(), expected.begin());
+    };
+
+    Vector<T> sorted(values);
+    sorted.Sort();
+    assert(matches(sorted));
+    sorted = values;
+    sorted.StableSort();
+    assert(matches(sorted));
+    sorted = values;
+    sorted.Sort(std::less<>());
+    assert(matches(sorted));
+    sorted = values;
+    sorted.Sort([](const T& first, const T& second) { return second < first; });
+    assert(std::equal(sorted.Data(), sorted.Data() + sorted.Size(), expected.rbegin()));
+}
+
+void SortTests()
+{
+    // Test radix and comparison sorts on sizes around the thresholds and on the usual patterns
+    std::mt19937_64 random(5);
+    for (size_t size : { 0, 1, 2, 23, 24, 25, 127, 128, 129, 1000, 100000 }) {
+        Vector<int64_t> randomInts, sortedInts, reversedInts, fewUnique, organPipe;
+        Vector<uint8_t> bytes;
+        Vector<int16_t> shorts;
+        Vector<double> doubles;
+        for (size_t i = 0; i < size; ++i) {
+            randomInts.PushBack(static_cast<int64_t>(random()));
+            sortedInts.PushBack(static_cast<int64_t>(i));
+            reversedInts.PushBack(-static_cast<int64_t>(i));
+            fewUnique.PushBack(static_cast<int64_t>(random() % 4) - 2);
+            organPipe.PushBack(static_cast<int64_t>(i < size / 2 ? i : size - i));
+            bytes.PushBack(static_cast<uint8_t>(random()));
+            shorts.PushBack(static_cast<int16_t>(random()));
+            doubles.PushBack(std::ldexp(static_cast<double>(static_cast<int32_t>(random())), static_cast<int>(random() % 64) - 32));
+        }
+        CheckSort(randomInts);
+        CheckSort(sortedInts);
+        CheckSort(reversedInts);
+        CheckSort(fewUnique);
+        CheckSort(organPipe);
+        CheckSort(bytes);
+        CheckSort(shorts);
+        CheckSort(doubles);
+    }
+
+    // Test floating-point keys order signs and infinities
+    Vector<float> floats{ 2.5f, -0.0f, -INFINITY, 1e-30f, -1e30f, INFINITY, -2.5f, 0.0f, -1e-30f };
+    floats.Sort();
+    Vector<float> expectedFloats{ -INFINITY, -1e30f, -2.5f, -1e-30f, -0.0f, 0.0f, 1e-30f, 2.5f, INFINITY };
+    assert(floats == expectedFloats && std::signbit(floats[4]) && !std::signbit(floats[5]));
+
+    // Test enums sort by their underlying value
+    enum class Level : int8_t { Low = -1, Middle = 0, High = 1 };
+    Vector<Level> levels;
+    for (int i = 0; i < 300; ++i)
+        levels.PushBack(static_cast<Level>(i % 3 - 1));
+    levels.Sort();
+    assert(levels[0] == Level::Low && levels[100] == Level::Middle && levels[299] == Level::High);
+
+    // Test types without a radix key use the comparison sort
+    Vector<std::string> words;
+    for (int i = 0; i < 500; ++i)
+        words.PushBack(std::to_string(random() % 1000));
+    Vector<std::string> sortedWords(words);
+    sortedWords.Sort();
+    assert(std::is_sorted(sortedWords.Data(), sortedWords.Data() + sortedWords.Size()));
+    assert(std::is_permutation(sortedWords.Data(), sortedWords.Data() + sortedWords.Size(), words.Data()));
+
+    // Test StableSort keeps equal elements in order
+    Vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < 1000; ++i)
+        pairs.PushBack({ static_cast<int>(random() % 10), i });
+    pairs.StableSort([](const auto& first, const auto& second) { return first.first < second.first; });
+    for (size_t i = 1; i < pairs.Size(); ++i)
+        assert(pairs[i - 1].first < pairs[i].first || (pairs[i - 1].first == pairs[i].first && pairs[i - 1].second < pairs[i].second));
+
+    // Test Array members
+    Array<int, 6> array{ 3, -1, 4, 1, -5, 9 };
+    array.Sort();
+    assert(array[0] == -5 && array[1] == -1 && array[5] == 9);
+    array.Sort(std::greater<>());
+    assert(array[0] == 9 && array[5] == -5);
+
+    std::cout << "All Sort tests passed!" << std::endl;
+}
+
 void VectorTests()
 {
     // Create an instance of Vector
@@ -202,9 +431,117 @@ void VectorTests()
     assert(moveAssignVector[2] == 30);
     assert(moveAssignVector[3] == 40);
 
+    // Test Reserve, Resize and ShrinkToFit
+    Vector<int> sized;
+    sized.Reserve(100);
+    assert(sized.Capacity() == 100 && sized.Empty());
+    sized.Resize(10);
+    assert(sized.Size() == 10 && sized[9] == 0);
+    sized.Resize(12, 7);
+    assert(sized.Size() == 12 && sized[9] == 0 && sized[11] == 7);
+    sized.Resize(3);
+    sized.ShrinkToFit();
+    assert(sized.Size() == 3 && sized.Capacity() == 3);
+
+    // Test Append from forward and input iterators
+    int values[] = { 1, 2, 3, 4, 5 };
+    sized.Append(values, values + 5);
+    assert(sized.Size() == 8 && sized[3] == 1 && sized[7] == 5);
+    std::istringstream stream("6 7 8");
+    sized.Append(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+    assert(sized.Size() == 11 && sized[10] == 8);
+
+    // Test a custom growth policy and non-trivial elements, including pushing an element of the vector itself
+    Vector<std::string, GeometricGrowth<3, 2>> strings{ "alpha", "beta" };
+    strings.PushBack(strings[0]);
+    assert(strings.Size() == 3 && strings.Capacity() == 3 && strings[2] == "alpha");
+    strings.PushBack(strings[1]);
+    assert(strings.Capacity() == 4 && strings[3] == "beta");
+    strings.Resize(6);
+    assert(strings[1] == "beta" && strings[5].empty());
+
+    // Test appending a vector to itself when the storage has to grow
+    sized.ShrinkToFit();
+    sized.Append(sized.Data(), sized.Data() + sized.Size());
+    assert(sized.Size() == 22 && sized[11] == sized[0] && sized[21] == 8);
+    strings.ShrinkToFit();
+    strings.Append(strings.Data(), strings.Data() + strings.Size());
+    assert(strings.Size() == 12 && strings[6] == "alpha" && strings[8] == "alpha" && strings[11].empty());
+
+    // Test resizing with an element of the vector itself when the storage has to grow
+    strings.ShrinkToFit();
+    strings.Resize(strings.Capacity() + 1, strings[0]);
+    assert(strings.Size() == 13 && strings[12] == "alpha");
+    sized.ShrinkToFit();
+    sized.Resize(sized.Capacity() + 1, sized[21]);
+    assert(sized.Size() == 23 && sized[22] == 8);
+
     // All tests passed
     std::cout << "All Vector tests passed!\n";
 }
+void SmallVectorTests()
+{
+    // Test elements stay inline up to N and spill to the heap after that
+    SmallVector<int, 4> small;
+    assert(small.Empty() && small.IsInline() && small.Capacity() == 4);
+    for (int i = 0; i < 4; ++i)
+        small.PushBack(i);
+    assert(small.IsInline() && small.Size() == 4);
+    small.EmplaceBack(4);
+    assert(!small.IsInline() && small.Capacity() == 8);
+    for (int i = 0; i < 5; ++i)
+        assert(small[i] == i);
+    small.PopBack();
+    assert(small.Size() == 4);
+
+    // Test iterators
+    int sum = 0;
+    for (int value : small)
+        sum += value;
+    assert(sum == 6);
+    int expected = 3;
+    for (auto it = small.rbegin(); it != small.rend(); ++it)
+        assert(*it == expected--);
+
+    // Test non-trivial elements, including pushing an element of the vector itself while it grows
+    SmallVector<std::string, 2> strings{ "alpha", "beta" };
+    strings.PushBack(strings[0]);
+    assert(strings.Size() == 3 && strings[2] == "alpha" && !strings.IsInline());
+    strings.EmplaceBack(3, 'x');
+    assert(strings[3] == "xxx");
+
+    // Test copies and moves in the inline and heap states
+    SmallVector<std::string, 2> copy(strings);
+    assert(copy == strings);
+    SmallVector<std::string, 2> moved(std::move(copy));
+    assert(moved == strings && copy.Empty() && copy.IsInline());
+    SmallVector<std::string, 2> inlineStrings{ "one" };
+    SmallVector<std::string, 2> inlineMoved(std::move(inlineStrings));
+    assert(inlineMoved.Size() == 1 && inlineMoved[0] == "one" && inlineMoved.IsInline() && inlineStrings.Empty());
+    inlineMoved.Swap(moved);
+    assert(inlineMoved == strings && moved.Size() == 1 && moved[0] == "one");
+    moved = inlineMoved;
+    assert(moved == strings);
+    moved = SmallVector<std::string, 2>{ "two" };
+    assert(moved.Size() == 1 && moved[0] == "two");
+    moved.Clear();
+    assert(moved.Empty());
+
+    // Test the sized constructor and range checks
+    SmallVector<int, 4> filled(10, 7);
+    assert(filled.Size() == 10 && filled[9] == 7);
+    bool thrown = false;
+    try {
+        filled[10];
+    }
+    catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << "All SmallVector tests passed!" << std::endl;
+}
+
 void LinkedListTests()
 {
     // Create an instance of LinkedList
@@ -321,6 +658,24 @@ void LinkedListTests()
     assert(rit != linkedList.rend());
     assert(*rit == 10);
 
+    // Test O(1) Erase() and Splice() through iterator handles
+    LinkedList<int> handles;
+    LinkedList<int>::Iterator one = handles.PushBack(1);
+    LinkedList<int>::Iterator two = handles.PushBack(2);
+    LinkedList<int>::Iterator three = handles.PushBack(3);
+    handles.MoveToFront(three);
+    assert(handles.Front() == 3 && handles.Back() == 2);
+    assert(handles.Last() == two);
+    handles.Erase(one);
+    assert(handles.Size() == 2 && handles.Front() == 3 && handles.Back() == 2);
+    LinkedList<int> other;
+    other.Splice(other.end(), handles, three);
+    assert(handles.Size() == 1 && other.Size() == 1);
+    assert(*three == 3 && other.Front() == 3 && handles.Front() == 2);
+    handles.Erase(two);
+    assert(handles.Empty());
+    assert(handles.begin() == handles.end());
+
     std::cout << "All LinkedList tests passed!\n";
 }
 void StackTests()
@@ -591,18 +946,2025 @@ void HashTableTests()
     assert(moveAssignedTable[1] == "One");
     assert(moveAssignedTable[2] == "New Two");
 
+    // Test Count() and LoadFactor()
+    assert(moveAssignedTable.Count() == 2);
+    assert(moveAssignedTable.LoadFactor() == 0.2f);
+
+    // Test automatic incremental growth
+    HashTable<int, int> growingTable(4);
+    for (int i = 0; i < 1000; ++i)
+        growingTable.Insert(i, i * 2);
+    assert(growingTable.Count() == 1000);
+    assert(growingTable.Size() >= 1000);
+    assert(growingTable.LoadFactor() <= growingTable.MaxLoadFactor());
+    for (int i = 0; i < 1000; ++i)
+        assert(growingTable[i] == i * 2);
+    assert(growingTable.Count() == 1000);
+
+    size_t iterated = 0;
+    for (auto it = growingTable.begin(); it != growingTable.end(); ++it)
+        ++iterated;
+    assert(iterated == 1000);
+    assert(!growingTable.IsRehashing());
+
+    // Test Rehash() keeps elements reachable while the move is in progress
+    growingTable.Rehash(8192);
+    assert(growingTable.IsRehashing());
+    assert(growingTable.Size() == 8192);
+    for (int i = 0; i < 1000; ++i)
+        assert(growingTable[i] == i * 2);
+    assert(growingTable.Count() == 1000);
+    HashTable<int, int> rehashCopy(growingTable);
+    assert(rehashCopy == growingTable);
+
+    // Test Reserve() and SetMaxLoadFactor()
+    HashTable<int, int> reservedTable;
+    reservedTable.Reserve(100);
+    assert(reservedTable.Size() >= 100);
+    reservedTable.SetMaxLoadFactor(0.5f);
+    assert(reservedTable.MaxLoadFactor() == 0.5f);
+    for (int i = 0; i < 100; ++i)
+        reservedTable[i] = i;
+    assert(reservedTable.Count() == 100);
+    assert(reservedTable.LoadFactor() <= 0.5f);
+
+    // Test Find() and Contains() do not insert
+    assert(reservedTable.Find(5) != nullptr && *reservedTable.Find(5) == 5);
+    assert(reservedTable.Find(500) == nullptr);
+    assert(reservedTable.Contains(99));
+    assert(!reservedTable.Contains(100));
+    assert(reservedTable.Count() == 100);
+
+    // Test bundled hashers
+    FastHash<int> intHash;
+    assert(intHash(1) != intHash(2));
+    assert(FastHash<int>(1)(1) != intHash(1));
+    FastHash<std::string> stringHash;
+    assert(stringHash("hash") == stringHash(std::string("hash")));
+    assert(stringHash("hash") != stringHash("hasH"));
+    assert(stringHash(std::string(100, 'a')) != stringHash(std::string(101, 'a')));
+
+    // Test power-of-two buckets with a fast hasher
+    HashTable<int, int, FastHash<int>, std::equal_to<int>, PowerOfTwoBuckets> powerTable(10);
+    assert(powerTable.Size() == 16);
+    for (int i = 0; i < 1000; ++i)
+        powerTable.Insert(i, -i);
+    assert(powerTable.Count() == 1000);
+    assert((powerTable.Size() & (powerTable.Size() - 1)) == 0);
+    for (int i = 0; i < 1000; ++i)
+        assert(*powerTable.Find(i) == -i);
+    assert(!powerTable.Contains(1000));
+
+    // Test cached hashes and a custom key equality
+    struct CaseInsensitiveHash
+    {
+        size_t operator()(const std::string& key) const
+        {
+            std::string lower(key);
+            for (char& c : lower)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return FastHash<std::string>()(lower);
+        }
+    };
+    struct CaseInsensitiveEqual
+    {
+        bool operator()(const std::string& a, const std::string& b) const
+        {
+            if (a.size() != b.size())
+                return false;
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+                    return false;
+            }
+            return true;
+        }
+    };
+    HashTable<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual, PowerOfTwoBuckets, true> cachedTable(4);
+    cachedTable.Insert("Content-Type", 1);
+    cachedTable.Insert("content-length", 2);
+    cachedTable["CONTENT-TYPE"] = 3;
+    assert(cachedTable.Count() == 2);
+    assert(*cachedTable.Find("content-type") == 3);
+    for (int i = 0; i < 100; ++i)
+        cachedTable.Insert("header-" + std::to_string(i), i);
+    assert(cachedTable.Count() == 102);
+    assert(*cachedTable.Find("HEADER-42") == 42);
+
+    // Test Erase()
+    assert(cachedTable.Erase("Header-42"));
+    assert(!cachedTable.Erase("header-42"));
+    assert(!cachedTable.Contains("header-42"));
+    assert(cachedTable.Count() == 101);
+    for (int i = 0; i < 1000; i += 2)
+        assert(powerTable.Erase(i));
+    assert(powerTable.Count() == 500);
+    for (int i = 0; i < 1000; ++i)
+        assert(powerTable.Contains(i) == (i % 2 == 1));
+
+    // Test InsertBatch(), FindBatch() and ContainsBatch()
+    HashTable<int, int> batchTable;
+    int batchKeys[300];
+    int batchValues[300];
+    for (int i = 0; i < 300; ++i) {
+        batchKeys[i] = i * 7;
+        batchValues[i] = i;
+    }
+    batchTable.InsertBatch(batchKeys, batchValues);
+    assert(batchTable.Count() == 300);
+    batchTable.Rehash(4096);
+    assert(batchTable.IsRehashing());
+
+    int lookupKeys[600];
+    for (int i = 0; i < 600; ++i)
+        lookupKeys[i] = i * 7;
+    int* found[600];
+    batchTable.FindBatch(lookupKeys, found);
+    bool contained[600];
+    batchTable.ContainsBatch(lookupKeys, contained);
+    for (int i = 0; i < 600; ++i) {
+        assert((found[i] != nullptr) == (i < 300));
+        assert(contained[i] == (i < 300));
+        if (i < 300)
+            assert(*found[i] == i);
+    }
+    assert(batchTable.Count() == 300);
+
+    // Test output and value spans shorter than the keys are rejected before anything is written
+    auto rejectsShortSpan = [](auto call) {
+        try {
+            call();
+        }
+        catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    assert(rejectsShortSpan([&] { batchTable.FindBatch(lookupKeys, std::span<int*>(found, 599)); }));
+    assert(rejectsShortSpan([&] { batchTable.ContainsBatch(lookupKeys, std::span<bool>(contained, 10)); }));
+    assert(rejectsShortSpan([&] { batchTable.InsertBatch(lookupKeys, batchValues); }));
+    assert(batchTable.Count() == 300);
+
     std::cout << "All HashTable tests passed!" << std::endl;
 }
 
+void FlatHashMapTests()
+{
+    // Test constructor and capacity
+    FlatHashMap<int, std::string> map;
+    assert(map.IsEmpty());
+    assert(map.Count() == 0);
+    assert(map.Size() == 16);
+
+    // Test Insert() and operator[]
+    map.Insert(1, "One");
+    map.Insert(2, "Two");
+    assert(!map.IsEmpty());
+    assert(map.Count() == 2);
+    assert(map[1] == "One");
+    assert(map[2] == "Two");
+
+    // Test Insert() with existing key
+    map.Insert(2, "New Two");
+    assert(map[2] == "New Two");
+    assert(map.Count() == 2);
+
+    // Test Find() and Contains()
+    assert(map.Find(1) != nullptr && *map.Find(1) == "One");
+    assert(map.Find(3) == nullptr);
+    assert(map.Contains(2));
+    assert(!map.Contains(3));
+
+    // Test growth
+    FlatHashMap<int, int> numbers;
+    for (int i = 0; i < 10000; ++i)
+        numbers[i] = i * 3;
+    assert(numbers.Count() == 10000);
+    assert(numbers.LoadFactor() <= 0.875f);
+    for (int i = 0; i < 10000; ++i)
+        assert(*numbers.Find(i) == i * 3);
+
+    // Test Erase() keeps every remaining key reachable
+    for (int i = 0; i < 10000; i += 2)
+        assert(numbers.Erase(i));
+    assert(!numbers.Erase(0));
+    assert(numbers.Count() == 5000);
+    for (int i = 0; i < 10000; ++i)
+        assert(numbers.Contains(i) == (i % 2 == 1));
+
+    // Test Iterator
+    size_t iterated = 0;
+    long long sum = 0;
+    for (auto it = numbers.begin(); it != numbers.end(); ++it) {
+        assert(*it == it.Key() * 3);
+        sum += it.Key();
+        ++iterated;
+    }
+    assert(iterated == 5000);
+    assert(sum == 25000000);
+
+    // Test Copy constructor and operator=
+    FlatHashMap<int, std::string> copyMap(map);
+    assert(copyMap == map);
+    assert(copyMap[1] == "One");
+
+    FlatHashMap<int, std::string> assignedMap;
+    assignedMap = map;
+    assert(assignedMap == map);
+
+    // Test move constructor and operator=
+    FlatHashMap<int, std::string> movedMap(std::move(copyMap));
+    assert(movedMap == map);
+    FlatHashMap<int, std::string> moveAssignedMap;
+    moveAssignedMap = std::move(assignedMap);
+    assert(moveAssignedMap == map);
+
+    // Test Reserve() and Clear()
+    FlatHashMap<int, int> reserved;
+    reserved.Reserve(1000);
+    size_t reservedSize = reserved.Size();
+    for (int i = 0; i < 1000; ++i)
+        reserved.Insert(i, i);
+    assert(reserved.Size() == reservedSize);
+    reserved.Clear();
+    assert(reserved.IsEmpty());
+    assert(!reserved.Contains(1));
+
+    std::cout << "All FlatHashMap tests passed!" << std::endl;
+}
+
+void ShardedHashTableTests()
+{
+    // Test constructor
+    ShardedHashTable<int, int> table(6);
+    assert(table.ShardCount() == 8);
+    assert(table.IsEmpty());
+
+    // Test Insert(), Find(), Contains() and Erase()
+    table.Insert(1, 10);
+    table.Insert(2, 20);
+    table.Insert(2, 21);
+    int value = 0;
+    assert(table.Find(2, value) && value == 21);
+    assert(!table.Find(3, value));
+    assert(table.Contains(1));
+    assert(table.Count() == 2);
+    assert(table.Erase(1));
+    assert(!table.Erase(1));
+    assert(!table.Contains(1));
+
+    // Test concurrent writers on disjoint key ranges
+    const int threadCount = 4;
+    const int perThread = 5000;
+    std::thread writers[threadCount];
+    for (int t = 0; t < threadCount; ++t) {
+        writers[t] = std::thread([&table, t] {
+            for (int i = 0; i < perThread; ++i)
+                table.Insert(t * perThread + i, i);
+        });
+    }
+    for (std::thread& writer : writers)
+        writer.join();
+    assert(table.Count() == threadCount * perThread);
+    for (int t = 0; t < threadCount; ++t) {
+        for (int i = 0; i < perThread; ++i)
+            assert(table.Find(t * perThread + i, value) && value == i);
+    }
+
+    // Test concurrent Update() on shared keys
+    ShardedHashTable<int, int> counters;
+    for (int t = 0; t < threadCount; ++t) {
+        writers[t] = std::thread([&counters] {
+            for (int i = 0; i < 1000; ++i)
+                counters.Update(i % 10, [](int& counter) { ++counter; });
+        });
+    }
+    for (std::thread& writer : writers)
+        writer.join();
+    for (int i = 0; i < 10; ++i)
+        assert(counters.Find(i, value) && value == threadCount * 100);
+
+    // Test parallel ForEach() and Clear()
+    std::atomic<long long> sum{ 0 };
+    std::atomic<size_t> visited{ 0 };
+    counters.ForEach([&](const int& key, int& counter) {
+        sum += key;
+        ++visited;
+        counter = 0;
+    }, 4);
+    assert(visited == 10);
+    assert(sum == 45);
+    assert(counters.Find(3, value) && value == 0);
+
+    table.Clear(4);
+    assert(table.IsEmpty());
+    assert(!table.Contains(2));
+
+    std::cout << "All ShardedHashTable tests passed!" << std::endl;
+}
+
+void LockFreeHashMapTests()
+{
+    // Test constructor
+    LockFreeHashMap<int, std::string> map(5);
+    assert(map.Size() == 8);
+    assert(map.IsEmpty());
+
+    // Test Insert(), Find(), Contains() and Erase()
+    map.Insert(1, "One");
+    map.Insert(2, "Two");
+    map.Insert(2, "Deux");
+    std::string text;
+    assert(map.Find(2, text) && text == "Deux");
+    assert(!map.Find(3, text));
+    assert(map.Contains(1));
+    assert(map.Count() == 2);
+    assert(map.Erase(1));
+    assert(!map.Erase(1));
+    assert(!map.Contains(1));
+    map.Insert(1, "Un");
+    assert(map.Find(1, text) && text == "Un");
+
+    // Test growth keeps every element reachable
+    LockFreeHashMap<int, int> numbers;
+    for (int i = 0; i < 10000; ++i)
+        numbers.Insert(i, i * 2);
+    assert(numbers.Count() == 10000);
+    assert(numbers.Size() > 16);
+    int value = 0;
+    for (int i = 0; i < 10000; ++i)
+        assert(numbers.Find(i, value) && value == i * 2);
+    for (int i = 0; i < 10000; i += 2)
+        assert(numbers.Erase(i));
+    assert(numbers.Count() == 5000);
+    assert(!numbers.Contains(0));
+    assert(numbers.Contains(1));
+
+    // Test iterators
+    long long sum = 0;
+    size_t visited = 0;
+    for (auto it = numbers.begin(); it != numbers.end(); ++it) {
+        assert(*it == it.Key() * 2);
+        sum += it.Key();
+        ++visited;
+    }
+    assert(visited == 5000);
+    assert(sum == 25000000LL);
+
+    // Test readers running against concurrent writers
+    const int threadCount = 4;
+    const int perThread = 5000;
+    LockFreeHashMap<int, int> shared;
+    std::atomic<bool> failed{ false };
+    std::thread threads[threadCount];
+    for (int t = 0; t < threadCount; ++t) {
+        threads[t] = std::thread([&shared, &failed, t] {
+            int found = 0;
+            for (int i = 0; i < perThread; ++i) {
+                int key = t * perThread + i;
+                shared.Insert(key, key);
+                shared.Insert(key, key + 1);
+                if (!shared.Find(key, found) || found != key + 1)
+                    failed = true;
+                if (i % 3 == 0 && !shared.Erase(key))
+                    failed = true;
+                shared.Find((key * 7) % (threadCount * perThread), found);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    assert(!failed);
+    assert(shared.Count() == threadCount * (perThread - (perThread + 2) / 3));
+    for (int t = 0; t < threadCount; ++t) {
+        for (int i = 0; i < perThread; ++i) {
+            int key = t * perThread + i;
+            assert(shared.Find(key, value) == (i % 3 != 0));
+        }
+    }
+
+    // Test Clear()
+    shared.Clear();
+    assert(shared.IsEmpty());
+    assert(shared.begin() == shared.end());
+
+    std::cout << "All LockFreeHashMap tests passed!" << std::endl;
+}
+
+enum class Opcode { Nop, Load, Store, Jump };
+
+void StaticMapTests()
+{
+    // Test compile-time construction and lookup
+    constexpr auto methods = MakeStaticMap<std::string_view, int>({
+        { "GET", 1 }, { "HEAD", 2 }, { "POST", 3 }, { "PUT", 4 }, { "DELETE", 5 },
+        { "CONNECT", 6 }, { "OPTIONS", 7 }, { "TRACE", 8 }, { "PATCH", 9 } });
+    static_assert(methods.Count() == 9);
+    static_assert(*methods.Find("POST") == 3);
+    static_assert(methods.Contains("PATCH"));
+    static_assert(!methods.Contains("FETCH"));
+    assert(*methods.Find("DELETE") == 5);
+    assert(methods.Find("get") == nullptr);
+    assert(methods.Size() == 9);
+    assert(!methods.IsEmpty());
+
+    // Test enum keys
+    constexpr auto opcodes = MakeStaticMap<Opcode, std::string_view>({
+        { Opcode::Nop, "nop" }, { Opcode::Load, "ld" }, { Opcode::Store, "st" }, { Opcode::Jump, "jmp" } });
+    static_assert(*opcodes.Find(Opcode::Store) == "st");
+    assert(*opcodes.Find(Opcode::Jump) == "jmp");
+
+    // Test iterators visit every entry once
+    int sum = 0;
+    size_t visited = 0;
+    for (auto it = methods.begin(); it != methods.end(); ++it) {
+        assert(*methods.Find(it.Key()) == *it);
+        sum += *it;
+        ++visited;
+    }
+    assert(visited == 9);
+    assert(sum == 45);
+
+    // Test a larger map built at runtime
+    static std::pair<int, int> entries[1000];
+    for (int i = 0; i < 1000; ++i)
+        entries[i] = { i * 7919, i };
+    static const StaticMap<int, int, 1000> numbers(entries);
+    for (int i = 0; i < 1000; ++i)
+        assert(*numbers.Find(i * 7919) == i);
+    assert(!numbers.Contains(1));
+
+    // Test FindBatch() and ContainsBatch()
+    const int keys[] = { 0, 7919, 5, 2 * 7919 };
+    const int* results[4];
+    bool contained[4];
+    numbers.FindBatch(keys, results);
+    numbers.ContainsBatch(keys, contained);
+    assert(*results[0] == 0 && *results[1] == 1 && results[2] == nullptr && *results[3] == 2);
+    assert(contained[0] && !contained[2]);
+
+    // Test duplicate keys are rejected
+    bool threw = false;
+    try {
+        std::pair<int, int> duplicates[] = { { 1, 1 }, { 2, 2 }, { 1, 3 } };
+        StaticMap<int, int, 3> duplicated(duplicates);
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "All StaticMap tests passed!" << std::endl;
+}
+
+void CacheTests()
+{
+    // Test LRU eviction order with a capacity of three entries
+    const size_t entryBytes = CacheWeigher()(0, 0);
+    LruCache<int, int> lru(3 * entryBytes);
+    lru.Put(1, 10);
+    lru.Put(2, 20);
+    lru.Put(3, 30);
+    assert(*lru.Get(1) == 10);
+    lru.Put(4, 40);
+    assert(lru.Count() == 3);
+    assert(!lru.Contains(2));
+    assert(lru.Contains(1) && lru.Contains(3) && lru.Contains(4));
+    assert(lru.Get(2) == nullptr);
+    assert(lru.Bytes() == 3 * entryBytes);
+
+    // Test counters
+    CacheStats stats = lru.Stats();
+    assert(stats.hits == 1 && stats.misses == 1 && stats.evictions == 1);
+    assert(stats.HitRate() == 0.5f);
+
+    // Test Put() on an existing key, Erase() and SetCapacity()
+    lru.Put(3, 31);
+    assert(*lru.Get(3) == 31);
+    assert(lru.Erase(4));
+    assert(!lru.Erase(4));
+    assert(lru.Count() == 2);
+    lru.SetCapacity(entryBytes);
+    assert(lru.Count() == 1 && lru.Contains(3));
+
+    // Test byte-based capacity
+    LruCache<int, std::string> strings(300);
+    strings.Put(1, std::string(100, 'a'));
+    strings.Put(2, std::string(50, 'b'));
+    assert(strings.Count() == 2);
+    strings.Put(3, std::string(60, 'c'));
+    assert(!strings.Contains(1));
+    assert(strings.Bytes() <= 300);
+    strings.Put(4, std::string(500, 'd'));
+    assert(!strings.Contains(4));
+
+    // Test W-TinyLFU keeps frequently used entries through a scan of one-off keys
+    TinyLfuCache<int, int> lfu(100 * entryBytes);
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            if (lfu.Get(i) == nullptr)
+                lfu.Put(i, i);
+        }
+    }
+    for (int i = 1000; i < 5000; ++i)
+        lfu.Put(i, i);
+    int kept = 0;
+    for (int i = 0; i < 50; ++i)
+        kept += lfu.Contains(i);
+    assert(kept >= 45);
+    assert(lfu.Bytes() <= lfu.Capacity());
+    LruCache<int, int> scanned(100 * entryBytes);
+    for (int i = 0; i < 50; ++i)
+        scanned.Put(i, i);
+    for (int i = 1000; i < 5000; ++i)
+        scanned.Put(i, i);
+    assert(!scanned.Contains(0));
+
+    // Test a key requested often while the cache was small is admitted over one-hit keys once the cache is full,
+    // after the index and the sketch have grown several times, and then survives a burst of one-hit keys
+    TinyLfuCache<int, int> growing(1000 * entryBytes);
+    for (int round = 0; round < 20; ++round)
+        assert(growing.Get(7) == nullptr);
+    for (int i = 1000; i < 2000; ++i)
+        growing.Put(i, i);
+    growing.Put(7, 7);
+    for (int i = 2000; i < 6000; ++i)
+        growing.Put(i, i);
+    assert(growing.Contains(7));
+
+    // Test the sharded cache from several threads
+    ShardedCache<int, int, CachePolicy::WTinyLfu> shared(1000 * entryBytes, 8);
+    const int threadCount = 4;
+    std::thread threads[threadCount];
+    for (int t = 0; t < threadCount; ++t) {
+        threads[t] = std::thread([&shared, t] {
+            int value = 0;
+            for (int i = 0; i < 5000; ++i) {
+                int key = (i * 7 + t) % 2000;
+                if (!shared.Get(key, value))
+                    shared.Put(key, key);
+                else
+                    assert(value == key);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    assert(shared.Bytes() <= shared.Capacity());
+    assert(shared.Count() > 0);
+    stats = shared.Stats();
+    assert(stats.hits + stats.misses == threadCount * 5000);
+    shared.Clear();
+    assert(shared.IsEmpty());
+
+    std::cout << "All Cache tests passed!" << std::endl;
+}
+
+void BloomFilterTests()
+{
+    // Test a standalone filter has no false negatives and a low false-positive rate at 10 bits per key
+    const size_t keyCount = 10000;
+    BloomFilter filter(keyCount, 10.0);
+    for (uint64_t i = 0; i < keyCount; ++i)
+        filter.Add(i);
+    for (uint64_t i = 0; i < keyCount; ++i)
+        assert(filter.MayContain(i));
+    size_t falsePositives = 0;
+    for (uint64_t i = keyCount; i < 11 * keyCount; ++i)
+        falsePositives += filter.MayContain(i);
+    assert(falsePositives < keyCount * 10 / 50);
+    assert(filter.Bytes() >= keyCount * 10 / 8);
+
+    // Test counters
+    BloomFilterStats stats = filter.Stats();
+    assert(stats.queries == 11 * keyCount);
+    assert(stats.negatives == 10 * keyCount - falsePositives);
+    filter.ResetStats();
+    assert(filter.Stats().queries == 0);
+    filter.Clear();
+    assert(!filter.MayContain(1) || !filter.MayContain(2));
+
+    // Test a filter attached to a HashTable through growth, erasure and copies
+    HashTable<int, int> table;
+    table.AttachBloomFilter(12.0);
+    for (int i = 0; i < 5000; ++i)
+        table.Insert(i, i * 2);
+    for (int i = 0; i < 5000; ++i)
+        assert(table.Contains(i) && *table.Find(i) == i * 2);
+    for (int i = 5000; i < 10000; ++i)
+        assert(!table.Contains(i));
+    stats = table.Filter()->Stats();
+    assert(stats.negatives + stats.falsePositives >= 5000);
+    assert(stats.negatives > 4 * stats.falsePositives);
+    assert(stats.FalsePositiveRate() < 0.05f);
+
+    for (int i = 0; i < 5000; i += 2)
+        assert(table.Erase(i));
+    for (int i = 0; i < 5000; ++i)
+        assert(table.Contains(i) == (i % 2 == 1));
+    assert(table.Filter()->Stats().queries > stats.queries);
+
+    // Test erasing most keys rebuilds the filter over the following operations rather than in the erasing call
+    HashTable<int, int> erased;
+    erased.AttachBloomFilter(12.0);
+    for (int i = 0; i < 5000; ++i)
+        erased.Insert(i, i);
+    while (erased.IsRehashing())
+        erased.Find(0);
+    const BloomFilter* full = erased.Filter();
+    for (int i = 0; i < 1667; ++i)
+        erased.Erase(i);
+    assert(erased.Filter() == full && erased.IsRehashing());
+    for (int i = 1667; i < 4000; ++i)
+        erased.Erase(i);
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 4000; ++i)
+            assert(erased.Find(i) == nullptr);
+    }
+    assert(!erased.IsRehashing());
+    BloomFilterStats before = erased.Filter()->Stats();
+    for (int i = 0; i < 4000; ++i)
+        assert(!erased.Contains(i));
+    assert(erased.Filter()->Stats().negatives - before.negatives > 3000);
+
+    HashTable<int, int> copy(table);
+    assert(copy.Filter() != nullptr && copy == table);
+    assert(copy.Contains(4999) && !copy.Contains(4998));
+    table.Clear();
+    assert(!table.Contains(1));
+    table[7] = 1;
+    assert(table.Contains(7));
+    table.DetachBloomFilter();
+    assert(table.Filter() == nullptr && table.Contains(7));
+
+    std::cout << "All BloomFilter tests passed!" << std::endl;
+}
+
+void HashTableSnapshotTests()
+{
+    struct Point
+    {
+        int x;
+        double y;
+    };
+
+    const std::string path = (std::filesystem::temp_directory_path() / "HashTableSnapshotTests.snapshot").string();
+
+    // Test Save() and lookups served from the mapped file
+    HashTable<int, Point> table;
+    for (int i = 0; i < 10000; ++i)
+        table.Insert(i * 3, Point{ i, i * 0.5 });
+    table.Save(path, 42);
+    {
+        HashTableView<int, Point> view(path);
+        assert(view.Count() == 10000 && !view.IsEmpty());
+        assert(view.Seed() == 42);
+        assert(view.LoadFactor() <= 1.0f);
+        for (int i = 0; i < 10000; ++i) {
+            const Point* point = view.Find(i * 3);
+            assert(point != nullptr && point->x == i && point->y == i * 0.5);
+            assert(!view.Contains(i * 3 + 1));
+        }
+
+        // Test iteration visits every entry once
+        size_t visited = 0;
+        long long keySum = 0;
+        for (auto it = view.begin(); it != view.end(); ++it) {
+            assert(it.Key() == it->x * 3);
+            keySum += it.Key();
+            ++visited;
+        }
+        assert(visited == 10000 && keySum == 3LL * 9999 * 10000 / 2);
+    }
+
+    // Test an empty table
+    HashTable<int, int> empty;
+    empty.Save(path);
+    {
+        HashTableView<int, int> view(path);
+        assert(view.IsEmpty() && view.Find(1) == nullptr && view.begin() == view.end());
+    }
+
+    // Test stale or foreign files are rejected
+    HashTable<long long, long long> numbers;
+    for (long long i = 0; i < 1000; ++i)
+        numbers[i] = i * i;
+    numbers.Save(path);
+    auto rejects = [&](auto open) {
+        try {
+            open();
+        }
+        catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(rejects([&] { HashTableView<long long, int> view(path); }));
+    assert(!rejects([&] { HashTableView<long long, long long> view(path); }));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-3, std::ios::end);
+        file.put('\x7f');
+    }
+    assert(rejects([&] { HashTableView<long long, long long> view(path); }));
+    {
+        HashTableView<long long, long long> unchecked(path, false);
+        assert(*unchecked.Find(10) == 100);
+    }
+
+    // Test bucket offsets outside the entries and entry counts that overflow are rejected without the checksum
+    auto overwrite = [&](size_t offset, uint64_t value) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    numbers.Save(path);
+    overwrite(sizeof(SnapshotHeader) + sizeof(uint64_t), uint64_t{ 1 } << 40);
+    assert(rejects([&] { HashTableView<long long, long long> view(path, false); }));
+    numbers.Save(path);
+    overwrite(offsetof(SnapshotHeader, count), 1000 + (uint64_t{ 1 } << 60));
+    assert(rejects([&] { HashTableView<long long, long long> view(path, false); }));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offsetof(SnapshotHeader, version));
+        file.put(2);
+    }
+    assert(rejects([&] { HashTableView<long long, long long> view(path, false); }));
+    std::filesystem::resize_file(path, 100);
+    assert(rejects([&] { HashTableView<long long, long long> view(path, false); }));
+    std::filesystem::remove(path);
+    assert(rejects([&] { HashTableView<long long, long long> view(path); }));
+
+    std::cout << "All HashTableSnapshot tests passed!" << std::endl;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+void SharedHashTableTests()
+{
+    const std::string name = "/SharedHashTableTests_" + std::to_string(getpid());
+    using Table = SharedHashTable<int, long long>;
+    Table::Remove(name);
+
+    // Test creation, lookups and attaching a second view of the same segment
+    auto table = Table::Create(name, 20000, 7);
+    assert(table.IsAttached() && table.IsEmpty() && table.Capacity() == 20000);
+    for (int i = 0; i < 100; ++i)
+        table.Insert(i, i * 10LL);
+    long long value = 0;
+    assert(table.Find(42, value) && value == 420);
+    assert(!table.Contains(100));
+    {
+        auto view = Table::Attach(name);
+        assert(view.Count() == 100 && view.Find(99, value) && value == 990);
+        view.Insert(1000, 1);
+        assert(view.Erase(0));
+    }
+    assert(table.Contains(1000) && !table.Contains(0) && table.Count() == 100);
+
+    // Test type mismatches and missing segments are rejected
+    bool rejected = false;
+    try {
+        SharedHashTable<int, int>::Attach(name);
+    }
+    catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    rejected = false;
+    try {
+        Table::Create(name, 10);
+    }
+    catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+
+    // Test several processes inserting, erasing and updating a shared counter concurrently
+    const int processCount = 4;
+    const int keysPerProcess = 2000;
+    pid_t children[processCount];
+    for (int p = 0; p < processCount; ++p) {
+        children[p] = fork();
+        assert(children[p] >= 0);
+        if (children[p] == 0) {
+            bool ok = true;
+            try {
+                auto shared = Table::Attach(name);
+                long long found = 0;
+                for (int i = 0; i < keysPerProcess; ++i) {
+                    int key = 10000 + p * keysPerProcess + i;
+                    shared.Insert(key, key * 2LL);
+                    shared.Update(-1, [](long long& counter) { ++counter; });
+                    ok = ok && shared.Find(key, found) && found == key * 2LL;
+                    ok = ok && shared.Find(50, found) && found == 500;
+                    if (i % 2 == 1)
+                        ok = ok && shared.Erase(key);
+                }
+            }
+            catch (...) {
+                ok = false;
+            }
+            _exit(ok ? 0 : 1);
+        }
+    }
+    for (int p = 0; p < processCount; ++p) {
+        int status = 0;
+        assert(waitpid(children[p], &status, 0) == children[p]);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    assert(table.Find(-1, value) && value == processCount * keysPerProcess);
+    for (int p = 0; p < processCount; ++p) {
+        for (int i = 0; i < keysPerProcess; ++i) {
+            int key = 10000 + p * keysPerProcess + i;
+            assert(table.Find(key, value) == (i % 2 == 0));
+        }
+    }
+    assert(table.Count() == 100 + 1 + processCount * keysPerProcess / 2);
+    size_t visited = 0;
+    table.ForEach([&](const int&, const long long&) { ++visited; });
+    assert(visited == table.Count());
+
+    // Test the capacity limit and recycling of erased nodes
+    table.Clear();
+    assert(table.IsEmpty());
+    for (int i = 0; i < 20000; ++i)
+        table.Insert(i, i);
+    rejected = false;
+    try {
+        table.Insert(20000, 0);
+    }
+    catch (const std::length_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    assert(table.Erase(5));
+    table.Insert(20000, 0);
+    assert(table.Contains(20000));
+
+    table.Detach();
+    assert(!table.IsAttached());
+    assert(Table::Remove(name));
+
+    std::cout << "All SharedHashTable tests passed!" << std::endl;
+}
+#endif
+
+// Upstream resource that tracks the bytes it has handed out and not yet taken back.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    size_t outstanding = 0;
+    size_t allocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        outstanding += bytes;
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* data, size_t bytes, size_t alignment) override
+    {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(data, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+void MemoryResourceTests()
+{
+    // Test the arena honours alignment, grows past its chunk size and reuses its largest chunk after Reset
+    CountingResource upstream;
+    {
+        MonotonicArena arena(1024, &upstream);
+        void* first = arena.allocate(24, 8);
+        void* aligned = arena.allocate(100, 64);
+        assert(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+        assert(arena.allocate(5000, 16) != nullptr);
+        assert(arena.BytesAllocated() == 5124 && upstream.allocations == 2);
+        arena.deallocate(first, 24, 8);
+        arena.Reset();
+        assert(arena.BytesAllocated() == 0 && upstream.allocations == 2 && upstream.outstanding == arena.Capacity());
+        assert(arena.allocate(5000, 16) != nullptr);
+        assert(upstream.allocations == 2);
+
+        // Test containers built in the arena, including strings that take the arena from their container
+        {
+            PmrVector<int> vector(&arena);
+            for (int i = 0; i < 1000; ++i)
+                vector.PushBack(i);
+            PmrLinkedList<std::pmr::string> list(&arena);
+            list.PushBack("a string that does not fit the small-string buffer");
+            list.EmplaceBack(3, 'x');
+            assert(list.Front().get_allocator().resource() == &arena && list.Back() == "xxx");
+            PmrHashTable<int, int> table(&arena);
+            for (int i = 0; i < 1000; ++i)
+                table.Insert(i, -i);
+            assert(vector[999] == 999 && *table.Find(999) == -999);
+        }
+        size_t allocations = upstream.allocations;
+        arena.Reset();
+        assert(upstream.outstanding == arena.Capacity());
+        PmrVector<int> vector(&arena);
+        vector.Reserve(1000);
+        assert(upstream.allocations == allocations);
+    }
+    assert(upstream.outstanding == 0);
+
+    // Test an aligned allocation after an odd-sized one that left the chunk end unaligned takes a new chunk
+    {
+        size_t allocations = upstream.allocations;
+        MonotonicArena arena(256, &upstream);
+        assert(arena.allocate(1001, 1) != nullptr);
+        long* value = static_cast<long*>(arena.allocate(sizeof(long), alignof(long)));
+        assert(reinterpret_cast<uintptr_t>(value) % alignof(long) == 0);
+        *value = 1;
+        assert(upstream.allocations == allocations + 2 && arena.BytesAllocated() == 1001 + sizeof(long));
+    }
+    assert(upstream.outstanding == 0);
+
+    // Test the pool recycles blocks of each size class and returns its chunks on destruction
+    {
+        PoolResource pool(64 * 1024, &upstream);
+        void* block = pool.allocate(40, 8);
+        pool.deallocate(block, 40, 8);
+        assert(pool.allocate(64, 8) == block);
+        void* aligned = pool.allocate(8, 256);
+        assert(reinterpret_cast<uintptr_t>(aligned) % 256 == 0);
+        void* large = pool.allocate(100000, 16);
+        pool.deallocate(large, 100000, 16);
+
+        PmrBinaryTree<int> tree(&pool);
+        for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+            tree.Insert(value);
+        assert(!tree.Insert(40) && tree.Size() == 7);
+        tree.Delete(30);
+        assert(!tree.Find(30) && tree.Find(20));
+
+        PmrHashTable<int, int> table(&pool);
+        for (int i = 0; i < 10000; ++i)
+            table.Insert(i, i);
+        for (int i = 0; i < 10000; i += 2)
+            assert(table.Erase(i));
+        size_t allocations = upstream.allocations;
+        for (int i = 0; i < 10000; i += 2)
+            table.Insert(i, i);
+        assert(upstream.allocations == allocations && table.Count() == 10000);
+    }
+    assert(upstream.outstanding == 0);
+
+    // Test moving between containers of different resources copies into the destination's resource
+    {
+        MonotonicArena arena(1024, &upstream);
+        PmrVector<std::pmr::string> source(std::pmr::new_delete_resource());
+        source.PushBack("a string that does not fit the small-string buffer");
+        PmrVector<std::pmr::string> destination(&arena);
+        destination = std::move(source);
+        assert(destination.Size() == 1 && destination.GetAllocator().resource() == &arena);
+        assert(destination[0].get_allocator().resource() == &arena);
+
+        PmrLinkedList<int> list(&arena);
+        list = PmrLinkedList<int>({ 1, 2, 3 }, std::pmr::new_delete_resource());
+        assert(list.Size() == 3 && list.Back() == 3 && list.GetAllocator().resource() == &arena);
+    }
+    assert(upstream.outstanding == 0);
+
+    std::cout << "All MemoryResource tests passed!" << std::endl;
+}
+
+void ThreadPoolTests()
+{
+    ThreadPool pool(4);
+    assert(pool.ThreadCount() == 4);
+
+    // Test Join runs both functions, also when nested, and Execute runs on a worker
+    std::atomic<int> calls = 0;
+    std::function<void(int)> split = [&](int depth) {
+        if (depth == 0) {
+            ++calls;
+            return;
+        }
+        pool.Join([&] { split(depth - 1); }, [&] { split(depth - 1); });
+    };
+    split(10);
+    assert(calls == 1024);
+    std::thread::id caller = std::this_thread::get_id();
+    pool.Execute([&] { assert(std::this_thread::get_id() != caller); });
+
+    // Test exceptions reach the caller only after both functions finished
+    bool finished = false;
+    try {
+        pool.Join([] { throw std::runtime_error("first"); }, [&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            finished = true;
+        });
+        assert(false);
+    }
+    catch (const std::runtime_error& error) {
+        assert(std::string(error.what()) == "first" && finished);
+    }
+
+    // Test several threads can submit work to the same pool at once
+    std::atomic<int> total = 0;
+    std::thread submitters[4];
+    for (std::thread& submitter : submitters) {
+        submitter = std::thread([&] {
+            for (int i = 0; i < 100; ++i)
+                pool.Join([&] { ++total; }, [&] { ++total; });
+        });
+    }
+    for (std::thread& submitter : submitters)
+        submitter.join();
+    assert(total == 800);
+
+    std::cout << "All ThreadPool tests passed!" << std::endl;
+}
+
+void ParallelAlgorithmsTests()
+{
+    ThreadPool pool(4);
+    std::mt19937_64 random(7);
+
+    // Test every algorithm against its serial counterpart, from ranges below one grain to many grains
+    for (size_t size : { 0, 1, 100, 4097, 100000 }) {
+        ParallelOptions options{ &pool, 1000 };
+        Vector<int64_t> values;
+        std::vector<int64_t> expected;
+        for (size_t i = 0; i < size; ++i) {
+            values.PushBack(static_cast<int64_t>(random() % 1000) - 500);
+            expected.push_back(values[i]);
+        }
+
+        assert(ParallelReduce(values, int64_t{ 3 }, std::plus<>(), options) == std::accumulate(expected.begin(), expected.end(), int64_t{ 3 }));
+        assert(ParallelReduce(values, int64_t{ -1000 }, [](int64_t a, int64_t b) { return std::max(a, b); }, options) ==
+            std::accumulate(expected.begin(), expected.end(), int64_t{ -1000 }, [](int64_t a, int64_t b) { return std::max(a, b); }));
+
+        Vector<int64_t> scanned(size, 0);
+        std::vector<int64_t> expectedScan(size);
+        ParallelInclusiveScan(values, scanned, std::plus<>(), options);
+        std::inclusive_scan(expected.begin(), expected.end(), expectedScan.begin());
+        assert(std::equal(expectedScan.begin(), expectedScan.end(), scanned.Data()));
+        ParallelExclusiveScan(values, scanned, int64_t{ 10 }, std::plus<>(), options);
+        std::exclusive_scan(expected.begin(), expected.end(), expectedScan.begin(), int64_t{ 10 });
+        assert(std::equal(expectedScan.begin(), expectedScan.end(), scanned.Data()));
+
+        ParallelTransform(values, scanned, [](int64_t value) { return value * 3; }, options);
+        ParallelForEach(values, [](int64_t& value) { value *= 3; }, options);
+        assert(values == scanned);
+
+        ParallelSort(values, std::less<>(), options);
+        std::sort(expected.begin(), expected.end());
+        for (int64_t& value : expected)
+            value *= 3;
+        assert(std::equal(expected.begin(), expected.end(), values.Data()));
+    }
+
+    // Test in-place scans, non-commutative reductions and sorting with a comparator
+    Vector<int> ones(10000, 1);
+    ParallelInclusiveScan(ones, ones, std::plus<>(), ParallelOptions{ &pool, 64 });
+    assert(ones[0] == 1 && ones[9999] == 10000);
+    std::vector<std::string> letters;
+    for (size_t i = 0; i < 5000; ++i)
+        letters.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+    std::string joined = ParallelReduce(letters, std::string(">"), std::plus<>(), ParallelOptions{ &pool, 100 });
+    assert(joined.size() == 5001 && joined.substr(0, 4) == ">abc" && joined.back() == 'a' + 4999 % 26);
+    ParallelSort(letters, std::greater<>(), ParallelOptions{ &pool, 100 });
+    assert(std::is_sorted(letters.begin(), letters.end(), std::greater<>()) && letters.front() == "z");
+
+    // Test Array and span ranges, and the shared pool with the default grain size
+    Array<float, 5> array = { 5, 3, 1, 4, 2 };
+    ParallelSort(array);
+    assert(array[0] == 1 && array[4] == 5);
+    assert(ParallelReduce(std::span<const float>(array.Span()), 0.0f) == 15);
+    Vector<uint32_t> large;
+    for (size_t i = 0; i < 1000000; ++i)
+        large.PushBack(static_cast<uint32_t>(random()));
+    ParallelSort(large);
+    assert(std::is_sorted(large.Data(), large.Data() + large.Size()));
+
+    // Test exceptions from the functions reach the caller
+    const uint32_t poison = large[777777];
+    try {
+        ParallelForEach(large, [&](uint32_t& value) {
+            if (value == poison)
+                throw std::out_of_range("element");
+        }, ParallelOptions{ &pool, 1000 });
+        assert(false);
+    }
+    catch (const std::out_of_range&) {
+    }
+
+    std::cout << "All ParallelAlgorithms tests passed!" << std::endl;
+}
+
+void SoAVectorTests()
+{
+    // Test rows are stored column by column in aligned columns
+    using Particles = SoAVector<float, int, std::string>;
+    Particles particles;
+    for (int i = 0; i < 100; ++i)
+        particles.PushBack(i * 0.5f, i, std::to_string(i));
+    assert(particles.Size() == 100 && particles.Capacity() >= 100);
+    assert(reinterpret_cast<uintptr_t>(particles.Data<0>()) % Particles::ColumnAlignment == 0);
+    assert(reinterpret_cast<uintptr_t>(particles.Data<1>()) % Particles::ColumnAlignment == 0);
+    assert(reinterpret_cast<uintptr_t>(particles.Data<2>()) % Particles::ColumnAlignment == 0);
+    assert(particles.Column<1>().size() == 100 && Sum(std::span<const int>(particles.Column<1>())) == 4950);
+    assert(std::get<2>(particles[42]) == "42" && std::get<0>(particles[3]) == 1.5f);
+
+    // Test rows are proxies that write through to the columns
+    for (auto [x, id, name] : particles) {
+        x += 1.0f;
+        name += "!";
+    }
+    auto [x, id, name] = particles[10];
+    assert(x == 6.0f && id == 10 && name == "10!");
+    particles[10] = std::make_tuple(-1.0f, -1, std::string("replaced"));
+    assert(std::get<2>(particles[10]) == "replaced" && particles.Column<0>()[10] == -1.0f);
+
+    // Test growing from a row of the vector itself, popping, copying and moving
+    Particles small;
+    small.EmplaceBack(1.0f, 1, "first");
+    while (small.Size() < small.Capacity())
+        small.PushBack(2.0f, 2, "filler");
+    small.EmplaceBack(std::get<0>(small[0]), std::get<1>(small[0]), std::get<2>(small[0]));
+    assert(std::get<2>(small[small.Size() - 1]) == "first");
+    small.PopBack();
+    Particles copy = small;
+    assert(copy == small);
+    Particles moved = std::move(copy);
+    assert(moved == small && copy.Empty());
+    moved.PushBack(Particles::ValueType(3.0f, 3, "last"));
+    assert(moved != small && moved.Size() == small.Size() + 1);
+
+    // Test reserving, shrinking and const access
+    SoAVector<double, char> columns = { { 1.0, 'a' }, { 2.0, 'b' } };
+    columns.Reserve(1000);
+    assert(columns.Capacity() == 1000 && std::get<1>(columns[1]) == 'b');
+    columns.ShrinkToFit();
+    assert(columns.Capacity() == 2);
+    const SoAVector<double, char>& view = columns;
+    double total = 0;
+    for (auto [value, letter] : view)
+        total += value;
+    assert(total == 3.0 && view.Column<0>()[1] == 2.0);
+    columns.Clear();
+    assert(columns.Empty() && columns.Capacity() == 2);
+
+    try {
+        columns[0];
+        assert(false);
+    }
+    catch (const std::out_of_range&) {
+    }
+
+    std::cout << "All SoAVector tests passed!" << std::endl;
+}
+
+void SegmentedVectorTests()
+{
+    // Test growth keeps the addresses of existing elements
+    SegmentedVector<int, 16> numbers;
+    numbers.PushBack(0);
+    int* first = &numbers[0];
+    for (int i = 1; i < 1000; ++i)
+        numbers.PushBack(i);
+    assert(&numbers[0] == first && *first == 0);
+    assert(numbers.Size() == 1000 && numbers.Capacity() == 1008 && numbers.ChunkCount() == 63);
+    assert(numbers[999] == 999 && numbers.Chunk(62).size() == 8 && numbers.Chunk(1)[0] == 16);
+
+    // Test the iterators walk across chunks in both directions
+    int expected = 0;
+    for (int value : numbers)
+        assert(value == expected++);
+    assert(*numbers.rbegin() == 999 && numbers.end() - numbers.begin() == 1000);
+    assert(*(numbers.begin() + 500) == 500 && std::find(numbers.begin(), numbers.end(), 777) - numbers.begin() == 777);
+
+    // Test pushing an element of the vector itself, also when a chunk is added
+    SegmentedVector<std::string, 4> strings = { "a", "b", "c", "d" };
+    strings.PushBack(strings[0]);
+    strings.EmplaceBack(strings[1]);
+    assert(strings.Size() == 6 && strings[4] == "a" && strings[5] == "b");
+
+    // Test resizing, shrinking, clearing and popping
+    strings.Resize(10, "x");
+    assert(strings.Size() == 10 && strings[9] == "x");
+    strings.Resize(3);
+    assert(strings.Size() == 3 && strings.Capacity() == 12);
+    strings.ShrinkToFit();
+    assert(strings.Capacity() == 4);
+    strings.PopBack();
+    assert(strings.Size() == 2 && strings[1] == "b");
+    strings.Clear();
+    assert(strings.Empty() && strings.Capacity() == 4);
+
+    // Test copying, moving and comparing
+    SegmentedVector<int, 16> copy = numbers;
+    assert(copy == numbers && &copy[0] != &numbers[0]);
+    copy[5] = -5;
+    assert(copy != numbers);
+    SegmentedVector<int, 16> moved = std::move(copy);
+    assert(moved[5] == -5 && copy.Empty());
+    copy = moved;
+    assert(copy == moved);
+    numbers.Swap(moved);
+    assert(numbers[5] == -5 && moved[5] == 5);
+
+    // Test chunks come from the given memory resource
+    MonotonicArena arena;
+    SegmentedVector<double, 64, std::pmr::polymorphic_allocator<double>> values(&arena);
+    values.Resize(200);
+    assert(values[199] == 0.0 && arena.BytesAllocated() >= 4 * 64 * sizeof(double));
+
+    try {
+        numbers[1000];
+        assert(false);
+    }
+    catch (const std::out_of_range&) {
+    }
+
+    std::cout << "All SegmentedVector tests passed!" << std::endl;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+void PageAllocatorTests()
+{
+    // Test growth from heap blocks into mappings keeps the elements, also when pushing an element of the vector
+    PageVector<uint64_t> values;
+    for (uint64_t i = 0; i < 1000000; ++i)
+        values.PushBack(i * 3);
+    assert(values.Size() == 1000000 && values[0] == 0 && values[999999] == 2999997);
+    while (values.Size() < values.Capacity())
+        values.PushBack(1);
+    values.PushBack(values[12345]);
+    assert(values[values.Size() - 1] == 12345 * 3);
+    assert(reinterpret_cast<uintptr_t>(values.Data()) % 4096 == 0);
+
+    // Test reserving, shrinking back below the mapping threshold and copying
+    values.Reserve(4000000);
+    assert(values.Capacity() == 4000000 && values[999999] == 2999997);
+    values.Resize(10);
+    values.ShrinkToFit();
+    assert(values.Capacity() == 10 && values[9] == 27);
+    PageVector<uint64_t> copy = values;
+    assert(copy == values);
+    values.Resize(0);
+    values.ShrinkToFit();
+    assert(values.Capacity() == 0 && values.Empty());
+    values.PushBack(5);
+    assert(values[0] == 5);
+
+    // Test huge page hints and structs
+    struct Point { int x, y; };
+    PageVector<Point> points{ PageAllocator<Point>(true) };
+    for (int i = 0; i < 100000; ++i)
+        points.EmplaceBack(i, -i);
+    assert(points.GetAllocator().HugePages() && points[99999].y == -99999);
+
+    std::cout << "All PageAllocator tests passed!" << std::endl;
+}
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+void MappedVectorTests()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "MappedVectorTests.data").string();
+    struct Event { uint64_t time; int32_t kind; float value; };
+
+    // Test appending grows the file and the elements survive closing and reopening it
+    {
+        MappedVector<Event> events = MappedVector<Event>::Create(path);
+        assert(events.Empty() && events.Capacity() == MappedVector<Event>::MinCapacity);
+        events.Advise(MappedAccess::Sequential);
+        for (uint64_t i = 0; i < 100000; ++i)
+            events.PushBack(Event{ i, static_cast<int32_t>(i % 7), i * 0.5f });
+        events.EmplaceBack(events[3]);
+        assert(events.Size() == 100001 && events[100000].time == 3 && events[99999].value == 49999.5f);
+        events.Flush();
+        assert(std::filesystem::file_size(path) == 64 + events.Capacity() * sizeof(Event));
+    }
+    {
+        MappedVector<Event> events = MappedVector<Event>::Open(path);
+        events.Advise(MappedAccess::Random);
+        assert(events.Size() == 100001 && events[12345].kind == 12345 % 7);
+        uint64_t total = 0;
+        for (const Event& event : events)
+            total += event.time;
+        assert(total == 99999ull * 100000 / 2 + 3);
+
+        // Test resizing zero-fills, and shrinking truncates the file
+        events.PopBack();
+        events.Resize(100010);
+        assert(events[100005].time == 0 && events[100009].value == 0.0f);
+        events.Resize(50);
+        events.ShrinkToFit();
+        assert(events.Capacity() == 50 && std::filesystem::file_size(path) == 64 + 50 * sizeof(Event));
+        MappedVector<Event> moved = std::move(events);
+        assert(moved.Size() == 50 && moved.Span().back().time == 49 && events.Size() == 0);
+    }
+
+    // Test files of other element types and other formats are rejected
+    try {
+        MappedVector<uint64_t>::Open(path);
+        assert(false);
+    }
+    catch (const std::runtime_error&) {
+    }
+    std::ofstream(path, std::ios::trunc) << "not a mapped vector, but long enough to hold a header of sixty-four bytes";
+    uintmax_t foreignSize = std::filesystem::file_size(path);
+    try {
+        MappedVector<Event>::Open(path);
+        assert(false);
+    }
+    catch (const std::runtime_error&) {
+    }
+    assert(std::filesystem::file_size(path) == foreignSize);
+
+    // Test a file ending in part of an element is rejected and left as it was
+    MappedVector<Event>::Create(path).Flush();
+    std::filesystem::resize_file(path, 64 + 10 * sizeof(Event) + 1);
+    try {
+        MappedVector<Event>::Open(path);
+        assert(false);
+    }
+    catch (const std::runtime_error&) {
+    }
+    assert(std::filesystem::file_size(path) == 64 + 10 * sizeof(Event) + 1);
+    std::filesystem::remove(path);
+
+    std::cout << "All MappedVector tests passed!" << std::endl;
+}
+#endif
+
+// Checks a PersistentVector against a model, through operator[], the iterators and the reverse iterators.
+template<typename T>
+bool MatchesModel(const PersistentVector<T>& vector, const std::vector<T>& model)
+{
+    if (vector.Size() != model.size())
+        return false;
+    for (size_t i = 0; i < model.size(); i += 1 + model.size() / 50) {
+        if (vector[i] != model[i])
+            return false;
+    }
+    return std::equal(vector.begin(), vector.end(), model.begin(), model.end())
+        && std::equal(vector.rbegin(), vector.rend(), model.rbegin(), model.rend());
+}
+
+void PersistentVectorTests()
+{
+    // Test PushBack(), operator[] and PopBack() across leaves and levels
+    PersistentVector<int> numbers;
+    assert(numbers.Empty());
+    for (int i = 0; i < 40000; ++i)
+        numbers.PushBack(i);
+    assert(numbers.Size() == 40000);
+    for (int i = 0; i < 40000; ++i)
+        assert(numbers[i] == i);
+    try {
+        numbers[40000];
+        assert(false);
+    }
+    catch (const std::out_of_range&) {
+    }
+    for (int i = 0; i < 39000; ++i)
+        numbers.PopBack();
+    assert(numbers.Size() == 1000 && numbers[999] == 999);
+
+    // Test snapshots are unaffected by later changes, and the other way round
+    PersistentVector<int> snapshot = numbers.Snapshot();
+    numbers.Set(0, -1);
+    numbers.Set(999, -999);
+    numbers.PushBack(1000);
+    numbers.PopBack();
+    numbers.PopBack();
+    assert(snapshot.Size() == 1000 && snapshot[0] == 0 && snapshot[999] == 999);
+    assert(numbers.Size() == 999 && numbers[0] == -1);
+    snapshot.Set(500, 7);
+    assert(numbers[500] == 500);
+
+    // Test iterators and comparison
+    PersistentVector<int> small{ 1, 2, 3 };
+    assert(std::accumulate(small.begin(), small.end(), 0) == 6);
+    assert(*small.rbegin() == 3);
+    assert(small == PersistentVector<int>({ 1, 2, 3 }) && small != snapshot);
+
+    // Test Slice() and Append() against a model, including slices of slices and appending to itself
+    std::vector<int> model(5000);
+    std::iota(model.begin(), model.end(), 0);
+    PersistentVector<int> all;
+    all.Append(model.begin(), model.end());
+    assert(MatchesModel(all.Slice(0, 5000), model));
+    assert(all.Slice(100, 100).Empty());
+    PersistentVector<int> middle = all.Slice(33, 4100).Slice(1, 4000);
+    assert(MatchesModel(middle, std::vector<int>(model.begin() + 34, model.begin() + 4033)));
+    PersistentVector<int> twice(all);
+    twice.Append(twice);
+    std::vector<int> twiceModel(model);
+    twiceModel.insert(twiceModel.end(), model.begin(), model.end());
+    assert(MatchesModel(twice, twiceModel) && MatchesModel(all, model));
+
+    // Test random sequences of every operation, with strings to catch lost or doubled elements
+    std::mt19937 random(23);
+    PersistentVector<std::string> strings;
+    std::vector<std::string> stringModel;
+    std::vector<std::pair<PersistentVector<std::string>, std::vector<std::string>>> snapshots;
+    for (int step = 0; step < 3000; ++step) {
+        size_t size = stringModel.size();
+        switch (random() % 8) {
+        case 0: case 1: case 2: {
+            int count = static_cast<int>(random() % 100);
+            for (int i = 0; i < count; ++i) {
+                std::string value = std::to_string(random());
+                strings.PushBack(value);
+                stringModel.push_back(value);
+            }
+            break;
+        }
+        case 3:
+            for (size_t i = random() % 40; i > 0 && !stringModel.empty(); --i) {
+                strings.PopBack();
+                stringModel.pop_back();
+            }
+            break;
+        case 4:
+            if (size > 0) {
+                size_t index = random() % size;
+                strings.Set(index, "set");
+                stringModel[index] = "set";
+            }
+            break;
+        case 5: {
+            size_t first = size > 0 ? random() % (size + 1) : 0;
+            size_t last = first + (size > first ? random() % (size - first + 1) : 0);
+            strings = strings.Slice(first, last);
+            stringModel = std::vector<std::string>(stringModel.begin() + first, stringModel.begin() + last);
+            break;
+        }
+        case 6: {
+            const auto& [other, otherModel] = snapshots.empty() ? std::make_pair(strings, stringModel) : snapshots[random() % snapshots.size()];
+            strings.Append(other);
+            stringModel.insert(stringModel.end(), otherModel.begin(), otherModel.end());
+            if (stringModel.size() > 20000) {
+                strings = strings.Slice(stringModel.size() - 5000, stringModel.size());
+                stringModel.erase(stringModel.begin(), stringModel.end() - 5000);
+            }
+            break;
+        }
+        default:
+            snapshots.emplace_back(strings.Snapshot(), stringModel);
+            if (snapshots.size() > 8)
+                snapshots.erase(snapshots.begin());
+            break;
+        }
+        assert(MatchesModel(strings, stringModel));
+    }
+    for (const auto& [other, otherModel] : snapshots)
+        assert(MatchesModel(other, otherModel));
+
+    // Test readers scanning snapshots while the writer keeps changing the vector
+    PersistentVector<long long> shared;
+    for (long long i = 0; i < 10000; ++i)
+        shared.PushBack(i);
+    std::atomic<bool> failed{ false };
+    std::thread readers[3];
+    for (std::thread& reader : readers) {
+        reader = std::thread([snapshot = shared.Snapshot(), &failed] {
+            for (int pass = 0; pass < 20; ++pass) {
+                long long expected = 0;
+                for (long long value : snapshot) {
+                    if (value != expected++)
+                        failed = true;
+                }
+            }
+        });
+    }
+    for (long long i = 0; i < 10000; i += 3)
+        shared.Set(static_cast<size_t>(i), -i);
+    for (int i = 0; i < 5000; ++i)
+        shared.PopBack();
+    for (std::thread& reader : readers)
+        reader.join();
+    assert(!failed);
+    assert(shared.Size() == 5000 && shared[3] == -3 && shared[4] == 4);
+
+    std::cout << "All PersistentVector tests passed!" << std::endl;
+}
+
+void ConcurrentVectorTests()
+{
+    // Test PushBack(), EmplaceBack() and operator[]
+    ConcurrentVector<std::string, 4> words;
+    assert(words.Empty());
+    assert(words.PushBack("zero") == 0);
+    assert(words.EmplaceBack(3, 'a') == 1);
+    assert(words.Size() == 2);
+    assert(words[0] == "zero" && words[1] == "aaa");
+    assert(words.TryGet(2) == nullptr);
+    try {
+        words[2];
+        assert(false);
+    }
+    catch (const std::out_of_range&) {
+    }
+
+    // Test growth across segments keeps element addresses
+    ConcurrentVector<int, 4> numbers;
+    numbers.PushBack(0);
+    const int* first = &numbers[0];
+    for (int i = 1; i < 1000; ++i)
+        numbers.PushBack(i);
+    assert(&numbers[0] == first);
+    assert(numbers.Size() == 1000);
+    for (int i = 0; i < 1000; ++i)
+        assert(numbers[i] == i);
+
+    // Test iterators
+    int expected = 0;
+    for (int number : numbers)
+        assert(number == expected++);
+    assert(expected == 1000);
+    const ConcurrentVector<int, 4>& constNumbers = numbers;
+    assert(std::accumulate(constNumbers.begin(), constNumbers.end(), 0) == 499500);
+
+    // Test Clear() and reuse
+    numbers.Clear();
+    assert(numbers.Empty());
+    numbers.Reserve(100);
+    assert(numbers.PushBack(7) == 0);
+    assert(numbers[0] == 7);
+
+    // Test a constructor that throws leaves its index unpublished
+    struct Throwing
+    {
+        explicit Throwing(bool fail) { if (fail) throw std::runtime_error("fail"); }
+    };
+    ConcurrentVector<Throwing> throwing;
+    throwing.EmplaceBack(false);
+    try {
+        throwing.EmplaceBack(true);
+        assert(false);
+    }
+    catch (const std::runtime_error&) {
+    }
+    throwing.EmplaceBack(false);
+    assert(throwing.Size() == 3);
+    assert(throwing.TryGet(0) != nullptr && throwing.TryGet(1) == nullptr && throwing.TryGet(2) != nullptr);
+
+    // Test producers appending while readers scan the published elements
+    const int threadCount = 4;
+    const int perThread = 20000;
+    ConcurrentVector<long long, 8> shared;
+    std::atomic<bool> failed{ false };
+    std::thread threads[threadCount + 1];
+    for (int t = 0; t < threadCount; ++t) {
+        threads[t] = std::thread([&shared, &failed, t] {
+            for (int i = 0; i < perThread; ++i) {
+                long long value = static_cast<long long>(t) * perThread + i;
+                size_t index = shared.PushBack(value);
+                if (shared[index] != value)
+                    failed = true;
+            }
+        });
+    }
+    threads[threadCount] = std::thread([&shared, &failed] {
+        while (shared.Size() < static_cast<size_t>(threadCount) * perThread) {
+            size_t size = shared.Size();
+            for (size_t i = 0; i < size; ++i) {
+                const long long* value = shared.TryGet(i);
+                if (value != nullptr && (*value < 0 || *value >= threadCount * perThread))
+                    failed = true;
+            }
+        }
+    });
+    for (std::thread& thread : threads)
+        thread.join();
+    assert(!failed);
+    assert(shared.Size() == static_cast<size_t>(threadCount) * perThread);
+    std::vector<long long> values(shared.begin(), shared.end());
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < threadCount * perThread; ++i)
+        assert(values[i] == i);
+
+    std::cout << "All ConcurrentVector tests passed!" << std::endl;
+}
+
+// Checks Count, Rank, RankZero, Select, SelectZero and FindNext of bits against the flags they were built from.
+void CheckBitVector(const BitVector& bits, const std::vector<bool>& flags)
+{
+    assert(bits.Size() == flags.size());
+    std::vector<size_t> ones;
+    std::vector<size_t> zeros;
+    for (size_t i = 0; i < flags.size(); ++i) {
+        assert(bits.Test(i) == flags[i]);
+        assert(bits.Rank(i) == ones.size() && bits.RankZero(i) == zeros.size());
+        (flags[i] ? ones : zeros).push_back(i);
+    }
+    assert(bits.Rank(flags.size()) == ones.size() && bits.Count() == ones.size());
+    for (size_t k = 0; k < ones.size(); ++k)
+        assert(bits.Select(k) == ones[k]);
+    for (size_t k = 0; k < zeros.size(); ++k)
+        assert(bits.SelectZero(k) == zeros[k]);
+    assert(bits.Select(ones.size()) == NotFound && bits.SelectZero(zeros.size()) == NotFound);
+
+    size_t next = bits.FindFirst();
+    for (size_t one : ones) {
+        assert(next == one);
+        next = bits.FindNext(next + 1);
+    }
+    assert(next == NotFound);
+}
+
+void BitVectorTests()
+{
+    // Test single bits, growth and shrinking
+    BitVector bits{ true, false, true };
+    assert(bits.Size() == 3 && bits[0] && !bits[1] && bits.Count() == 2);
+    bits.Set(1);
+    bits.Reset(0);
+    bits.Flip(2);
+    assert(!bits[0] && bits[1] && !bits[2]);
+    for (int i = 0; i < 200; ++i)
+        bits.PushBack(i % 3 == 0);
+    assert(bits.Size() == 203 && bits.Count() == 68);
+    bits.Resize(70);
+    assert(bits.Count() == 24 && bits.Words().size() == 2);
+    bits.Resize(130, true);
+    assert(bits.Count() == 84 && !bits.All());
+    while (bits.Size() > 64)
+        bits.PopBack();
+    assert(bits.Words().size() == 1 && bits.Count() == 22);
+    bits.Set();
+    assert(bits.All() && bits.Count() == 64);
+    bits.Reset();
+    assert(bits.None() && !bits.Any());
+
+    bool threw = false;
+    try { bits.Test(64); }
+    catch (const std::out_of_range&) { threw = true; }
+    assert(threw);
+    threw = false;
+    try { bits &= BitVector(63); }
+    catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    // Test the bulk operations against bool vectors, with every instruction set and sizes around word boundaries
+    SimdIsa detected = ActiveSimdIsa();
+    std::mt19937 random(7);
+    for (SimdIsa isa : { SimdIsa::Scalar, SimdIsa::Vector128, SimdIsa::Avx2, SimdIsa::Avx512 }) {
+        SetSimdIsa(isa);
+        for (size_t size : { 0, 1, 63, 64, 65, 1000, 4097 }) {
+            BitVector first(size);
+            BitVector second(size);
+            std::vector<bool> firstFlags(size);
+            std::vector<bool> secondFlags(size);
+            for (size_t i = 0; i < size; ++i) {
+                firstFlags[i] = random() % 2 == 0;
+                secondFlags[i] = random() % 3 == 0;
+                first.Set(i, firstFlags[i]);
+                second.Set(i, secondFlags[i]);
+            }
+
+            auto matches = [](const BitVector& result, const std::vector<bool>& flags) {
+                for (size_t i = 0; i < flags.size(); ++i) {
+                    if (result[i] != flags[i])
+                        return false;
+                }
+                return result.Count() == static_cast<size_t>(std::count(flags.begin(), flags.end(), true));
+            };
+            std::vector<bool> expected(size);
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = firstFlags[i] && secondFlags[i];
+            assert(matches(first & second, expected));
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = firstFlags[i] || secondFlags[i];
+            assert(matches(first | second, expected));
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = firstFlags[i] != secondFlags[i];
+            assert(matches(first ^ second, expected));
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = firstFlags[i] && !secondFlags[i];
+            assert(matches(BitVector(first).AndNot(second), expected));
+            for (size_t i = 0; i < size; ++i)
+                expected[i] = !firstFlags[i];
+            assert(matches(~first, expected) && (~~first) == first);
+        }
+    }
+
+    // Test rank and select on sparse, even and dense bits, across several superblocks, with and without popcnt
+    for (SimdIsa isa : { SimdIsa::Vector128, detected }) {
+        SetSimdIsa(isa);
+        for (uint32_t density : { 0u, 1u, 50u, 999u, 1000u }) {
+            std::vector<bool> flags(20000 + density);
+            BitVector sampled(flags.size());
+            for (size_t i = 0; i < flags.size(); ++i) {
+                flags[i] = random() % 1000 < density;
+                sampled.Set(i, flags[i]);
+            }
+            CheckBitVector(sampled, flags);
+
+            // A change after the index was built is seen by the next query
+            sampled.Flip(12345);
+            flags[12345] = !flags[12345];
+            CheckBitVector(sampled, flags);
+        }
+    }
+    SetSimdIsa(detected);
+
+    // Test a long run of ones followed by a long run of zeros, so the samples skip superblocks
+    BitVector runs(300000);
+    std::vector<bool> runFlags(300000);
+    for (size_t i = 0; i < 100000; ++i) {
+        runs.Set(i);
+        runFlags[i] = true;
+    }
+    runs.Set(299999);
+    runFlags[299999] = true;
+    runs.BuildIndex();
+    CheckBitVector(runs, runFlags);
+
+    // Test moved-from vectors are empty and usable
+    BitVector moved(std::move(runs));
+    assert(moved.Count() == 100001 && runs.Empty());
+    runs.PushBack(true);
+    assert(runs.Size() == 1 && runs.Rank(1) == 1);
+
+    std::cout << "All BitVector tests passed!" << std::endl;
+}
+
+// Values for RoaringBitmapTests: every chunk is left out or filled sparsely, around the array size limit, densely
+// or with runs, so the bitmaps mix all kinds of containers.
+std::vector<uint32_t> RoaringTestValues(std::mt19937& random, uint32_t chunks)
+{
+    std::vector<uint32_t> values;
+    for (uint32_t chunk = 0; chunk < chunks; ++chunk) {
+        uint32_t high = chunk << 16;
+        switch (random() % 5) {
+        case 0:
+            break;
+        case 1:
+            for (int i = 0; i < 300; ++i)
+                values.push_back(high | (random() & 0xFFFF));
+            break;
+        case 2:
+            for (int i = 0; i < 4000 + static_cast<int>(random() % 200); ++i)
+                values.push_back(high | (random() & 0xFFFF));
+            break;
+        case 3:
+            for (uint32_t low = 0; low < 0x10000; ++low) {
+                if (random() % 2 == 0)
+                    values.push_back(high | low);
+            }
+            break;
+        case 4:
+            for (int run = 0; run < 20; ++run) {
+                uint32_t start = random() & 0xFFFF;
+                uint32_t length = random() % 2000;
+                for (uint32_t low = start; low <= std::min(start + length, 0xFFFFu); ++low)
+                    values.push_back(high | low);
+            }
+            break;
+        }
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+}
+
+bool RoaringMatches(const RoaringBitmap& bitmap, const std::vector<uint32_t>& values)
+{
+    std::vector<uint32_t> visited;
+    bitmap.ForEach([&visited](uint32_t value) { visited.push_back(value); });
+    return bitmap.Cardinality() == values.size() && visited == values
+        && std::equal(bitmap.begin(), bitmap.end(), values.begin(), values.end());
+}
+
+void RoaringBitmapTests()
+{
+    // Test single values, and containers turning into bitmaps and back
+    RoaringBitmap bitmap{ 5, 1, 70000, 3 };
+    assert(bitmap.Cardinality() == 4 && bitmap.Contains(70000) && !bitmap.Contains(4));
+    assert(RoaringMatches(bitmap, { 1, 3, 5, 70000 }));
+    assert(!bitmap.Add(3) && bitmap.Remove(70000) && !bitmap.Remove(70000));
+    assert(RoaringMatches(bitmap, { 1, 3, 5 }));
+    for (uint32_t value = 0; value < 10000; value += 2)
+        bitmap.Add(value);
+    assert(bitmap.Cardinality() == 5003 && bitmap.Contains(9998) && !bitmap.Contains(9999));
+    for (uint32_t value = 0; value < 10000; value += 4)
+        bitmap.Remove(value);
+    assert(bitmap.Cardinality() == 2503 && bitmap.Contains(3) && !bitmap.Contains(4) && bitmap.Contains(6));
+    bitmap.Clear();
+    assert(bitmap.Empty() && bitmap.begin() == bitmap.end());
+
+    // Test runs: adding next to and between runs joins them, removing inside one splits it
+    RoaringBitmap runs;
+    for (uint32_t value = 100; value < 200; ++value)
+        runs.Add(value);
+    for (uint32_t value = 201; value < 300; ++value)
+        runs.Add(value);
+    size_t arrayBytes = runs.Bytes();
+    runs.Optimize();
+    assert(runs.Bytes() < arrayBytes);
+    runs.Add(200);
+    runs.Add(99);
+    runs.Add(300);
+    runs.Add(400);
+    std::vector<uint32_t> expected;
+    for (uint32_t value = 99; value <= 300; ++value)
+        expected.push_back(value);
+    expected.push_back(400);
+    assert(RoaringMatches(runs, expected));
+    runs.Remove(150);
+    runs.Remove(99);
+    runs.Remove(400);
+    expected.erase(std::remove_if(expected.begin(), expected.end(), [](uint32_t value) {
+        return value == 150 || value == 99 || value == 400;
+    }), expected.end());
+    assert(RoaringMatches(runs, expected) && !runs.Contains(150) && runs.Contains(151));
+    for (uint32_t value = 0; value < 0x10000; ++value)
+        runs.Add(value);
+    runs.Optimize();
+    assert(runs.Cardinality() == 0x10000 && runs.Bytes() < 1024);
+
+    // Test the array kernels with every instruction set, around the block size, with overlaps and very different sizes
+    SimdIsa detected = ActiveSimdIsa();
+    std::mt19937 random(11);
+    for (SimdIsa isa : { SimdIsa::Scalar, SimdIsa::Vector128, detected }) {
+        SetSimdIsa(isa);
+        for (size_t firstSize : { 0, 1, 7, 8, 9, 16, 23, 100, 1000 }) {
+            for (size_t secondSize : { 0, 3, 8, 15, 17, 64, 1000 }) {
+                for (uint32_t range : { 64u, 3000u }) {
+                    std::vector<uint16_t> first;
+                    std::vector<uint16_t> second;
+                    while (first.size() < std::min<size_t>(firstSize, range)) {
+                        first.push_back(static_cast<uint16_t>(random() % range));
+                        std::sort(first.begin(), first.end());
+                        first.erase(std::unique(first.begin(), first.end()), first.end());
+                    }
+                    while (second.size() < std::min<size_t>(secondSize, range)) {
+                        second.push_back(static_cast<uint16_t>(random() % range));
+                        std::sort(second.begin(), second.end());
+                        second.erase(std::unique(second.begin(), second.end()), second.end());
+                    }
+                    std::vector<uint16_t> output(first.size() + second.size() + 8);
+                    std::vector<uint16_t> reference;
+                    std::set_intersection(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(reference));
+                    size_t size = IntersectArrays(first.data(), first.size(), second.data(), second.size(), output.data());
+                    assert(std::equal(output.begin(), output.begin() + size, reference.begin(), reference.end()));
+                    reference.clear();
+                    std::set_union(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(reference));
+                    size = UnionArrays(first.data(), first.size(), second.data(), second.size(), output.data());
+                    assert(std::equal(output.begin(), output.begin() + size, reference.begin(), reference.end()));
+                    reference.clear();
+                    std::set_difference(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(reference));
+                    size = DifferenceArrays(first.data(), first.size(), second.data(), second.size(), output.data());
+                    assert(std::equal(output.begin(), output.begin() + size, reference.begin(), reference.end()));
+                }
+            }
+        }
+    }
+    SetSimdIsa(detected);
+
+    // Test set operations between every kind of container against the sorted vector algorithms
+    for (int trial = 0; trial < 40; ++trial) {
+        std::vector<uint32_t> firstValues = RoaringTestValues(random, 6);
+        std::vector<uint32_t> secondValues = RoaringTestValues(random, 6);
+        RoaringBitmap first;
+        RoaringBitmap second;
+        for (uint32_t value : firstValues)
+            first.Add(value);
+        for (uint32_t value : secondValues)
+            second.Add(value);
+        if (trial % 2 == 0)
+            first.Optimize();
+        if (trial % 3 == 0)
+            second.Optimize();
+        assert(RoaringMatches(first, firstValues));
+        for (uint32_t value : { 0u, 1u, 65535u, 65536u, 200000u, 393215u })
+            assert(first.Contains(value) == std::binary_search(firstValues.begin(), firstValues.end(), value));
+
+        std::vector<uint32_t> expectedValues;
+        std::set_intersection(firstValues.begin(), firstValues.end(), secondValues.begin(), secondValues.end(), std::back_inserter(expectedValues));
+        assert(RoaringMatches(first & second, expectedValues));
+        assert(first.AndCardinality(second) == expectedValues.size());
+        expectedValues.clear();
+        std::set_union(firstValues.begin(), firstValues.end(), secondValues.begin(), secondValues.end(), std::back_inserter(expectedValues));
+        assert(RoaringMatches(first | second, expectedValues));
+        expectedValues.clear();
+        std::set_difference(firstValues.begin(), firstValues.end(), secondValues.begin(), secondValues.end(), std::back_inserter(expectedValues));
+        assert(RoaringMatches(RoaringBitmap(first).AndNot(second), expectedValues));
+
+        RoaringBitmap optimized = first;
+        optimized.Optimize();
+        assert(optimized == first && (first & first) == first && RoaringBitmap(first).AndNot(first).Empty());
+        assert(optimized.Bytes() <= first.Bytes() || trial % 2 == 0);
+    }
+
+    // Test the serialized bytes follow the portable format
+    RoaringBitmap small{ 1, 2, 3 };
+    Vector<unsigned char> bytes = small.Serialize();
+    const unsigned char portable[] = { 0x3A, 0x30, 0, 0, 1, 0, 0, 0, 0, 0, 2, 0, 16, 0, 0, 0, 1, 0, 2, 0, 3, 0 };
+    assert(bytes.Size() == sizeof(portable) && std::equal(portable, portable + sizeof(portable), bytes.Data()));
+    small.Add(4);
+    small.Optimize();
+    bytes = small.Serialize();
+    const unsigned char portableRuns[] = { 0x3B, 0x30, 0, 0, 1, 0, 0, 3, 0, 1, 0, 1, 0, 3, 0 };
+    assert(bytes.Size() == sizeof(portableRuns) && std::equal(portableRuns, portableRuns + sizeof(portableRuns), bytes.Data()));
+
+    // Test round trips and views, with and without runs and offsets
+    for (int trial = 0; trial < 6; ++trial) {
+        std::vector<uint32_t> values = RoaringTestValues(random, trial < 3 ? 3 : 8);
+        RoaringBitmap original;
+        for (uint32_t value : values)
+            original.Add(value);
+        if (trial % 2 == 1)
+            original.Optimize();
+        bytes = original.Serialize();
+        assert(bytes.Size() == original.SerializedBytes());
+        assert(RoaringBitmap::Deserialize(bytes.Span()) == original);
+
+        RoaringView view(bytes.Span());
+        assert(view.Cardinality() == values.size() && view.ToBitmap() == original);
+        for (int query = 0; query < 1000; ++query) {
+            uint32_t value = random() % (9u << 16);
+            assert(view.Contains(value) == original.Contains(value));
+        }
+        for (uint32_t value : { 0u, 65535u, 65536u })
+            assert(view.Contains(value) == original.Contains(value));
+        std::vector<uint32_t> otherValues = RoaringTestValues(random, 8);
+        RoaringBitmap other;
+        for (uint32_t value : otherValues)
+            other.Add(value);
+        assert(view.And(other) == (original & other));
+        std::vector<uint32_t> visited;
+        view.ForEach([&visited](uint32_t value) { visited.push_back(value); });
+        assert(visited == values);
+    }
+
+    // Test a saved bitmap maps from its file, and damaged bytes are rejected
+    const std::string path = (std::filesystem::temp_directory_path() / "RoaringBitmapTests.roaring").string();
+    RoaringBitmap saved{ 7, 100000, 4000000000u };
+    saved.Save(path);
+    {
+        RoaringView view(path);
+        assert(view.Cardinality() == 3 && view.Contains(4000000000u) && !view.Contains(8));
+    }
+    auto rejects = [](std::span<const unsigned char> damaged) {
+        try { RoaringBitmap::Deserialize(damaged); }
+        catch (const std::runtime_error&) { return true; }
+        return false;
+    };
+    bytes = saved.Serialize();
+    assert(rejects(bytes.Span().first(bytes.Size() - 1)) && rejects(bytes.Span().first(3)));
+    Vector<unsigned char> damaged = bytes;
+    damaged[0] = 0;
+    assert(rejects(damaged.Span()));
+    damaged = bytes;
+    damaged[13] = 0xFF;
+    assert(rejects(damaged.Span()));
+    std::filesystem::remove(path);
+
+    std::cout << "All RoaringBitmap tests passed!" << std::endl;
+}
+
 int main()
 {
     ArrayTests();
     VectorTests();
+    AlgorithmsTests();
+    SortTests();
+    SmallVectorTests();
     LinkedListTests();
     StackTests();
     QueueTests();
     TreeTests();
     HashTableTests();
+    FlatHashMapTests();
+    ShardedHashTableTests();
+    LockFreeHashMapTests();
+    StaticMapTests();
+    CacheTests();
+    BloomFilterTests();
+    HashTableSnapshotTests();
+#if defined(__unix__) || defined(__APPLE__)
+    SharedHashTableTests();
+#endif
+    MemoryResourceTests();
+    ThreadPoolTests();
+    ParallelAlgorithmsTests();
+    SoAVectorTests();
+    SegmentedVectorTests();
+    ConcurrentVectorTests();
+    PersistentVectorTests();
+    BitVectorTests();
+    RoaringBitmapTests();
+#if defined(__unix__) || defined(__APPLE__)
+    PageAllocatorTests();
+    MappedVectorTests();
+#endif
 
     return 0;
 }